@@ -0,0 +1,228 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_ASSETPACK_HPP
+#define CEDAR_ASSETPACK_HPP
+
+#include <vector>
+
+#include "cedar/MappedFile.hpp"
+
+/*
+ * Asset pack file layout
+ */
+#define CEDAR_ASSET_PACK_MAGIC "CPAK"
+#define CEDAR_ASSET_PACK_VERSION 1
+#define CEDAR_ASSET_PACK_HEADER_SIZE 16
+#define CEDAR_ASSET_PACK_ALIGNMENT 4096
+
+/*
+ * Asset compression methods
+ */
+#define CEDAR_ASSET_COMPRESSION_NONE 0
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	/**
+	 * Exception which is thrown when an asset pack could not be mounted, read or written.
+	 */
+	class AssetPackException : public XException
+	{
+	public:
+		/**
+		 * Creates a new asset pack exception.
+		 *
+		 * @param message The message of the exception.
+		 */
+		explicit AssetPackException(const std::string &message);
+	};
+
+	/**
+	 * Struct representing an entry of the table of contents of an asset pack.
+	 *
+	 * <p>The entries are stored sorted by their hash directly after the header of the pack.</p>
+	 */
+	struct AssetPackEntry
+	{
+		/**
+		 * The FNV-1a hash of the normalized path of the asset.
+		 */
+		unsigned long long m_hash;
+		/**
+		 * The offset of the asset data from the beginning of the pack in bytes.
+		 */
+		unsigned long long m_offset;
+		/**
+		 * The size of the asset data in bytes.
+		 */
+		unsigned long long m_size;
+		/**
+		 * The offset of the path of the asset inside the name table in bytes.
+		 */
+		unsigned int m_nameOffset;
+		/**
+		 * The length of the path of the asset in bytes.
+		 */
+		unsigned short m_nameLength;
+		/**
+		 * The compression method of the asset data.
+		 */
+		unsigned char m_compression;
+		/**
+		 * Reserved for future use.
+		 */
+		unsigned char m_reserved;
+	};
+
+	/**
+	 * Class representing a single file archive of assets.
+	 *
+	 * <p>An asset pack consists of a 16 byte header (magic, version, entry count and name table size), the table of
+	 * contents sorted by path hash, a table of the asset paths and the asset data, each starting at a page aligned
+	 * offset. The pack is mapped into memory, so looking up an asset doesn't need any file access.</p>
+	 *
+	 * <p>The loaders of the engine look for assets in the mounted packs first and only fall back to the file system if
+	 * the path is not part of any mounted pack. Packs must be mounted before assets are loaded and must stay mounted
+	 * until all assets that were loaded from them are deleted, since fonts keep referencing the mapped data.</p>
+	 *
+	 * <p>The list of mounted packs is guarded by a lock, so packs can be mounted and unmounted while other threads look
+	 * up assets. The data returned by {@link #findAsset(const std::string &, const unsigned char **, size_t *)} is
+	 * not guarded though, so a pack must not be unmounted while assets are still being loaded from it.</p>
+	 */
+	class AssetPack
+	{
+	private:
+		/**
+		 * The mapped pack file.
+		 */
+		MappedFile *m_file;
+		/**
+		 * A pointer to the table of contents.
+		 */
+		const AssetPackEntry *m_entries;
+		/**
+		 * The number of entries in the table of contents.
+		 */
+		unsigned int m_entryCount;
+		/**
+		 * A pointer to the table of asset paths.
+		 */
+		const char *m_names;
+
+	public:
+		/**
+		 * Maps the asset pack at the given path into memory.
+		 *
+		 * @param path The path to the asset pack.
+		 *
+		 * @throws AssetPackException if the file could not be mapped or is not a valid asset pack.
+		 */
+		explicit AssetPack(const std::string &path);
+
+		/**
+		 * Unmaps the asset pack.
+		 */
+		~AssetPack();
+
+		AssetPack(const AssetPack &) = delete;
+
+		AssetPack &operator=(const AssetPack &) = delete;
+
+		/**
+		 * Looks up the asset with the given path.
+		 *
+		 * @param path The path of the asset.
+		 * @param data A pointer to where the pointer to the asset data will be stored.
+		 * @param size A pointer to where the size of the asset data will be stored.
+		 * @return <code>true</code> if the pack contains the asset.
+		 *
+		 * @throws AssetPackException if the asset is compressed with an unsupported method.
+		 */
+		bool find(const std::string &path, const unsigned char **data, size_t *size) const;
+
+		/**
+		 * Gets the path of the asset pack.
+		 *
+		 * @return The path of the asset pack.
+		 */
+		[[nodiscard]] const std::string &getPath() const;
+
+		/**
+		 * Gets the number of assets inside the pack.
+		 *
+		 * @return The number of assets.
+		 */
+		[[nodiscard]] unsigned int getEntryCount() const;
+
+		/**
+		 * Normalizes the given asset path.
+		 *
+		 * <p>Backslashes are replaced with slashes and leading <code>./</code> are removed.</p>
+		 *
+		 * @param path The path of the asset.
+		 * @return The normalized path.
+		 */
+		static std::string normalizePath(const std::string &path);
+
+		/**
+		 * Calculates the 64 bit FNV-1a hash of the given asset path.
+		 *
+		 * @param path The normalized path of the asset.
+		 * @return The hash of the path.
+		 */
+		static unsigned long long hash(const std::string &path);
+
+		/**
+		 * Writes an asset pack containing the given files.
+		 *
+		 * @param packPath The path the asset pack will be written to.
+		 * @param assets A vector of pairs of asset paths and the paths to the files that will be stored under them.
+		 *
+		 * @throws AssetPackException if a file could not be read, an asset path is used twice or the pack could not
+		 *                            be written.
+		 */
+		static void pack(const std::string &packPath, const std::vector<std::pair<std::string, std::string>> &assets);
+
+		/**
+		 * Mounts the asset pack at the given path.
+		 *
+		 * <p>Packs that are mounted later take precedence over packs that were mounted earlier.</p>
+		 *
+		 * @param path The path to the asset pack.
+		 *
+		 * @throws AssetPackException if the asset pack could not be mapped or is not a valid asset pack.
+		 */
+		static void mount(const std::string &path);
+
+		/**
+		 * Unmounts the asset pack with the given path.
+		 *
+		 * @param path The path the asset pack was mounted with.
+		 * @return <code>true</code> if the asset pack was mounted.
+		 */
+		static bool unmount(const std::string &path);
+
+		/**
+		 * Unmounts all asset packs.
+		 */
+		static void unmountAll();
+
+		/**
+		 * Looks up the asset with the given path in all mounted asset packs.
+		 *
+		 * @param path The path of the asset.
+		 * @param data A pointer to where the pointer to the asset data will be stored.
+		 * @param size A pointer to where the size of the asset data will be stored.
+		 * @return <code>true</code> if a mounted pack contains the asset.
+		 *
+		 * @throws AssetPackException if the asset is compressed with an unsupported method.
+		 */
+		static bool findAsset(const std::string &path, const unsigned char **data, size_t *size);
+	};
+}
+
+#endif //CEDAR_ASSETPACK_HPP
@@ -0,0 +1,82 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_BMFCONVERTER_HPP
+#define CEDAR_BMFCONVERTER_HPP
+
+#include <vector>
+
+#include "cedar/ModelRegistry.hpp"
+#include "cedar/MeshOptimizer.hpp"
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+
+	/**
+	 * Exception which is thrown when a model could not be converted.
+	 */
+	class ModelConversionException : public ModelException
+	{
+	public:
+		/**
+		 * Creates a new model conversion exception.
+		 *
+		 * @param message The message of the exception.
+		 */
+		explicit ModelConversionException(const std::string &message);
+	};
+
+	/**
+	 * Class for converting version 1 bmf models to the quantized version 2 layout.
+	 *
+	 * <p>See {@link ModelRegistry#loadBMFModel(const std::string &, const std::string &, unsigned char *, unsigned int)} for a
+	 * description of the version 2 attribute formats.</p>
+	 */
+	class BMFConverter
+	{
+	private:
+		/**
+		 * Creates a new bmf converter.
+		 */
+		BMFConverter();
+
+	public:
+		/**
+		 * Converts the given version 1 bmf data to version 2.
+		 *
+		 * <p>Positions are quantized relative to the bounding box of the mesh. Uvs must be inside the range [0, 1]
+		 * since they are stored as normalized unsigned integers. Indices are stored as 16 bit unsigned integers if the
+		 * model has no more than 65536 vertices.</p>
+		 *
+		 * <p>Triangle meshes are run through the {@link MeshOptimizer} before they are quantized.</p>
+		 *
+		 * @param data A pointer to the version 1 bmf data.
+		 * @param dataSize The size of the data in bytes.
+		 * @param optimizationFlags The bit mask of {@link MeshOptimizer} passes that will be run on triangle meshes.
+		 * @return The version 2 bmf data.
+		 *
+		 * @throws ModelConversionException when the data is not a valid version 1 bmf model or can not be quantized.
+		 */
+		static std::vector<unsigned char> convert(const unsigned char *data, size_t dataSize,
+												 unsigned int optimizationFlags = CEDAR_MESH_OPTIMIZE_DEFAULT);
+
+		/**
+		 * Converts the given version 1 bmf file to version 2.
+		 *
+		 * @param sourcePath The path to the version 1 bmf file.
+		 * @param destinationPath The path the version 2 bmf file will be written to.
+		 * @param optimizationFlags The bit mask of {@link MeshOptimizer} passes that will be run on triangle meshes.
+		 *
+		 * @throws ModelConversionException when the source file could not be read or converted or the destination
+		 *                                  file could not be written.
+		 */
+		static void convert(const std::string &sourcePath, const std::string &destinationPath,
+							unsigned int optimizationFlags = CEDAR_MESH_OPTIMIZE_DEFAULT);
+	};
+}
+
+#endif //CEDAR_BMFCONVERTER_HPP
@@ -0,0 +1,214 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_BAKEDFONT_HPP
+#define CEDAR_BAKEDFONT_HPP
+
+#include <vector>
+
+#include "cedar/Font.hpp"
+
+/**
+ * The magic number at the start of every baked font file.
+ */
+#define CEDAR_BAKED_FONT_MAGIC "CBF1"
+/**
+ * The version of the baked font format.
+ */
+#define CEDAR_BAKED_FONT_VERSION 1
+/**
+ * Flag of a baked font whose atlas pages are block compressed.
+ */
+#define CEDAR_BAKED_FONT_COMPRESSED 0x1
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	/**
+	 * Exception which is thrown when a font could not be baked.
+	 */
+	class FontBakeException : public FontException
+	{
+	public:
+		/**
+		 * Creates a new font bake exception.
+		 *
+		 * @param message The message of the exception.
+		 */
+		explicit FontBakeException(const std::string &message);
+	};
+
+	/**
+	 * Struct representing the header of a baked font file.
+	 *
+	 * <p>The header is followed by the glyph table, sorted by code point, and the pixels of every atlas page.</p>
+	 */
+	struct BakedFontHeader
+	{
+		/**
+		 * The magic number of the file.
+		 */
+		char m_magic[4];
+		/**
+		 * The version of the format the file was written with.
+		 */
+		unsigned int m_version;
+		/**
+		 * The size of the font in pixel.
+		 */
+		unsigned int m_size;
+		/**
+		 * The rendering mode the font was baked with.
+		 */
+		unsigned int m_renderingMode;
+		/**
+		 * The uncompressed sized internal format of the atlas pages.
+		 */
+		int m_internalFormat;
+		/**
+		 * The width and height of each atlas page in pixel.
+		 */
+		unsigned int m_pageSize;
+		/**
+		 * The number of atlas pages.
+		 */
+		unsigned int m_pageCount;
+		/**
+		 * The number of glyphs in the glyph table.
+		 */
+		unsigned int m_glyphCount;
+		/**
+		 * The flags of the file.
+		 */
+		unsigned int m_flags;
+	};
+
+	/**
+	 * Struct representing an entry of the glyph table of a baked font file.
+	 */
+	struct BakedFontGlyph
+	{
+		/**
+		 * The unicode code point of the glyph.
+		 */
+		unsigned int m_unicode;
+		/**
+		 * The width of the glyph in pixel.
+		 */
+		int m_width;
+		/**
+		 * The height of the glyph in pixel.
+		 */
+		int m_height;
+		/**
+		 * The horizontal bearing of the glyph in pixel.
+		 */
+		int m_bearingX;
+		/**
+		 * The vertical bearing of the glyph in pixel.
+		 */
+		int m_bearingY;
+		/**
+		 * The advance of the glyph in pixel.
+		 */
+		unsigned int m_advance;
+		/**
+		 * The uv coordinates of the glyph on its atlas page.
+		 */
+		float m_uvs[4];
+		/**
+		 * The index of the atlas page of the glyph.
+		 */
+		unsigned int m_page;
+	};
+
+	/**
+	 * Class for baking the glyphs and atlas of a font into a file that can be loaded as a {@link BakedFont}.
+	 */
+	class FontBaker
+	{
+	private:
+		/**
+		 * Private constructor so no instance of the font baker can be created.
+		 */
+		FontBaker();
+
+	public:
+		/**
+		 * Bakes all glyphs the font generated so far.
+		 *
+		 * <p>Compressed atlas pages are a quarter or an eighth of the size, but the glyphs lose some of their
+		 * sharpness.</p>
+		 *
+		 * @param font The font that will be baked.
+		 * @param compress Whether the atlas pages will be block compressed.
+		 * @return The data of the baked font file.
+		 *
+		 * @throws FontBakeException if the atlas pages could not be compressed.
+		 */
+		static std::vector<unsigned char> bake(const Font &font, bool compress = false);
+
+		/**
+		 * Bakes all glyphs the font generated so far and writes them to a file.
+		 *
+		 * @param font The font that will be baked.
+		 * @param destinationPath The path to the file the baked font will be written to.
+		 * @param compress Whether the atlas pages will be block compressed.
+		 *
+		 * @throws FontBakeException if the atlas pages could not be compressed or the file could not be written.
+		 */
+		static void bake(const Font &font, const std::string &destinationPath, bool compress = false);
+	};
+
+	/**
+	 * Class representing a font that was baked by the {@link FontBaker}.
+	 *
+	 * <p>The file is mapped into memory and every atlas page is uploaded with a single call, so the font is ready
+	 * without rasterizing a single glyph. Code points that were not baked use the replacement character, or the
+	 * question mark if that was not baked either.</p>
+	 */
+	class BakedFont : public Font
+	{
+	private:
+		/**
+		 * Gets the glyph for a code point that was not baked.
+		 *
+		 * @param unicode The unicode character of which the glyph will be generated.
+		 * @return A constant pointer to the glyph.
+		 */
+		const Glyph *loadGlyph(unsigned int unicode) override;
+
+		/**
+		 * Sets the swizzle mask and filtering of a new atlas page.
+		 *
+		 * @param texture A pointer to the texture of the new page.
+		 */
+		void initAtlasPage(Texture2D *texture) const override;
+
+	public:
+		/**
+		 * Loads a baked font.
+		 *
+		 * <p>If the path is part of a mounted {@link AssetPack} the font is read from the pack instead of the file system.</p>
+		 *
+		 * @param name The name of the font.
+		 * @param path The path to the baked font file.
+		 *
+		 * @throws FontCreationException if the file could not be opened or is not a valid baked font.
+		 */
+		BakedFont(const std::string &name, const std::string &path);
+
+		/**
+		 * Does nothing, since all glyphs of a baked font are loaded with the font.
+		 *
+		 * @param firstCharacter The unicode of the first character.
+		 * @param lastCharacter The unicode of the last character.
+		 */
+		void generateGlyphs(unsigned int firstCharacter, unsigned int lastCharacter) override;
+	};
+}
+
+#endif //CEDAR_BAKEDFONT_HPP
@@ -0,0 +1,100 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_BLOCKCOMPRESSOR_HPP
+#define CEDAR_BLOCKCOMPRESSOR_HPP
+
+#include <vector>
+
+#include "cedar/XException.hpp"
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	/**
+	 * Exception which is thrown when an image could not be block compressed.
+	 */
+	class BlockCompressionException : public XException
+	{
+	public:
+		/**
+		 * Creates a new block compression exception.
+		 *
+		 * @param message The message of the exception.
+		 */
+		explicit BlockCompressionException(const std::string &message);
+	};
+
+	/**
+	 * Class for compressing images into the block compressed formats graphics cards can sample directly.
+	 *
+	 * <p>The format is chosen by the number of channels of the image:
+	 * <table>
+	 *   <tr><th>Channels</th><th>Format</th><th>Bytes per 4x4 block</th></tr>
+	 *   <tr><td>1</td><td>{@link CEDAR_COMPRESSED_RED_RGTC1} (BC4)</td><td>8</td></tr>
+	 *   <tr><td>2</td><td>{@link CEDAR_COMPRESSED_RG_RGTC2} (BC5)</td><td>16</td></tr>
+	 *   <tr><td>3</td><td>{@link CEDAR_COMPRESSED_RGBA_S3TC_DXT1} (BC1)</td><td>8</td></tr>
+	 *   <tr><td>4</td><td>{@link CEDAR_COMPRESSED_RGBA_S3TC_DXT5} (BC3)</td><td>16</td></tr>
+	 * </table></p>
+	 *
+	 * <p>Colors are fitted along the principal axis of each block, which is fast enough for load time compression
+	 * while being close to the quality of offline tools for most textures. Rows of blocks are compressed in parallel
+	 * on the {@link ThreadPool#getInstance() shared thread pool}.</p>
+	 */
+	class BlockCompressor
+	{
+	private:
+		/**
+		 * Creates a new block compressor.
+		 */
+		BlockCompressor();
+
+	public:
+		/**
+		 * Gets the compressed internal format that is used for images with the given number of channels.
+		 *
+		 * @param channels The number of channels of the image.
+		 * @return The compressed internal format or 0 if the number of channels is not supported.
+		 */
+		static int getCompressedFormat(int channels);
+
+		/**
+		 * Compresses a single 4x4 block of RGBA pixels into a BC1 block.
+		 *
+		 * <p>The block is always encoded in the four color mode, so the alpha channel is ignored.</p>
+		 *
+		 * @param pixels The 16 RGBA pixels of the block in row major order.
+		 * @param block A pointer to the 8 bytes the block is written to.
+		 */
+		static void compressBC1Block(const unsigned char *pixels, unsigned char *block);
+
+		/**
+		 * Compresses a single 4x4 block of one channel values into a BC4 block.
+		 *
+		 * <p>This is also the alpha block of BC3 and each of the two channel blocks of BC5.</p>
+		 *
+		 * @param values The first of the 16 values of the block in row major order.
+		 * @param stride The distance between two values in bytes.
+		 * @param block A pointer to the 8 bytes the block is written to.
+		 */
+		static void compressBC4Block(const unsigned char *values, int stride, unsigned char *block);
+
+		/**
+		 * Compresses the given image.
+		 *
+		 * @param pixels A pointer to the pixels of the image, tightly packed.
+		 * @param width The width of the image in pixels.
+		 * @param height The height of the image in pixels.
+		 * @param channels The number of channels of the image.
+		 * @return The compressed blocks in row major order.
+		 *
+		 * @throws BlockCompressionException if the size is invalid or the number of channels is not supported.
+		 */
+		static std::vector<unsigned char> compress(const unsigned char *pixels, int width, int height, int channels);
+	};
+}
+
+#endif //CEDAR_BLOCKCOMPRESSOR_HPP
@@ -0,0 +1,208 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_DYNAMICMODEL_HPP
+#define CEDAR_DYNAMICMODEL_HPP
+
+#include <vector>
+
+#include "cedar/Model.hpp"
+
+/**
+ * The default number of buffer regions of a dynamic model.
+ *
+ * <p>Three regions allow the cpu to write one region while the gpu still reads the regions of the two previous frames.</p>
+ */
+#define CEDAR_DYNAMIC_MODEL_DEFAULT_REGIONS 3
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	/**
+	 * Class representing a model whose geometry is regenerated by the cpu frequently, e.g. every frame.
+	 *
+	 * <p>The vertex and index buffers are allocated once with immutable storage and stay persistently mapped. They are
+	 * split into a ring of regions, each big enough for the maximum number of vertices and indices. New geometry is
+	 * always written into the next region while the graphics card may still be reading the previous ones. A fence is
+	 * placed after every draw of a region and only waited on when the ring wraps around to that region again, so
+	 * writing geometry does not stall the pipeline.</p>
+	 *
+	 * <p>Geometry is written like this:
+	 * <pre>
+	 * model->beginUpdate();
+	 * memcpy(model->getVertexPointer(), vertices, vertexCount * vertexSize);
+	 * memcpy(model->getIndexPointer(), indices, indexCount * indexSize);
+	 * model->endUpdate(vertexCount, indexCount);
+	 * </pre>
+	 * Indices are relative to the first vertex of the update.</p>
+	 */
+	class DynamicModel : public Model
+	{
+	private:
+		/**
+		 * The size of a single vertex in bytes.
+		 */
+		unsigned int m_vertexSize;
+		/**
+		 * The maximum number of vertices per update.
+		 */
+		unsigned int m_maxVertexCount;
+		/**
+		 * The maximum number of indices per update.
+		 */
+		unsigned int m_maxIndexCount;
+		/**
+		 * The size of a single index in bytes.
+		 */
+		unsigned int m_indexSize;
+		/**
+		 * The number of regions of the buffer ring.
+		 */
+		unsigned int m_regionCount;
+		/**
+		 * The region that is currently written to.
+		 */
+		unsigned int m_writeRegion;
+		/**
+		 * The region that is rendered.
+		 */
+		unsigned int m_renderRegion;
+		/**
+		 * Whether an update is in progress.
+		 */
+		bool m_updating;
+		/**
+		 * A pointer to the persistently mapped vertex buffer.
+		 */
+		unsigned char *m_mappedVertices;
+		/**
+		 * A pointer to the persistently mapped index buffer.
+		 */
+		unsigned char *m_mappedIndices;
+		/**
+		 * The fences that are signaled when the graphics card finished reading a region.
+		 *
+		 * <p>An entry is <code>nullptr</code> if the region has not been drawn since it was last written to.</p>
+		 */
+		mutable std::vector<void *> m_fences;
+
+		/**
+		 * Waits until the graphics card finished reading the given region.
+		 *
+		 * @param region The index of the region.
+		 */
+		void waitForRegion(unsigned int region);
+
+	public:
+		/**
+		 * Creates a new dynamic model and allocates its buffers on the graphics card.
+		 *
+		 * <p>The vertex attribute pointers have to be set with offsets relative to the start of a vertex, like for
+		 * static models. The region offset is applied with a base vertex when the model is rendered.</p>
+		 *
+		 * @param drawingMode The drawing mode of the model.
+		 * @param vertexAttribCount The number of vertex attribute arrays.
+		 * @param vertexSize The size of a single vertex in bytes.
+		 * @param maxVertexCount The maximum number of vertices per update.
+		 * @param maxIndexCount The maximum number of indices per update.
+		 * @param indexType The data type of the indices.
+		 * @param regionCount The number of regions of the buffer ring.
+		 *
+		 * @throws ModelCreationException if one of the sizes is 0 or <code>indexType</code> is an unsupported type.
+		 */
+		DynamicModel(unsigned int drawingMode, unsigned int vertexAttribCount, unsigned int vertexSize, unsigned int maxVertexCount,
+					 unsigned int maxIndexCount, unsigned int indexType = CEDAR_UNSIGNED_INT,
+					 unsigned int regionCount = CEDAR_DYNAMIC_MODEL_DEFAULT_REGIONS);
+
+		/**
+		 * Unmaps and deletes the buffers of the model.
+		 */
+		~DynamicModel() override;
+
+		/**
+		 * Starts writing geometry into the next region.
+		 *
+		 * <p>This only blocks if the graphics card is still reading the region, which only happens if the model is
+		 * updated more often than there are regions in flight.</p>
+		 *
+		 * @throws ModelUpdateException if an update is already in progress.
+		 */
+		void beginUpdate();
+
+		/**
+		 * Finishes writing geometry and makes the written region the one that is rendered.
+		 *
+		 * @param vertexCount The number of vertices that were written.
+		 * @param indexCount The number of indices that were written.
+		 *
+		 * @throws ModelUpdateException if no update is in progress or the counts exceed the capacity of the model.
+		 */
+		void endUpdate(unsigned int vertexCount, unsigned int indexCount);
+
+		/**
+		 * Gets a pointer to the vertices of the region that is currently written.
+		 *
+		 * @return A pointer to the mapped vertices or <code>nullptr</code> if no update is in progress.
+		 */
+		[[nodiscard]] void *getVertexPointer() const;
+
+		/**
+		 * Gets a pointer to the indices of the region that is currently written.
+		 *
+		 * @return A pointer to the mapped indices or <code>nullptr</code> if no update is in progress.
+		 */
+		[[nodiscard]] void *getIndexPointer() const;
+
+		/**
+		 * Writes the given geometry into the next region.
+		 *
+		 * <p>The index type of the model is fixed, so <code>indexType</code> must match it and no narrowing happens.</p>
+		 *
+		 * @param vertexDataSize The size of the vertex data array in bytes.
+		 * @param vertexData The vertex data of the model.
+		 * @param indexDataSize The size of the index data array in bytes.
+		 * @param indexData The indices of the model.
+		 * @param indexType The data type of the indices.
+		 * @param narrowestIndexType Ignored for dynamic models.
+		 *
+		 * @throws ModelUploadException if <code>indexType</code> doesn't match or the data exceeds the capacity of the model.
+		 */
+		void upload(unsigned int vertexDataSize, const void *vertexData, unsigned int indexDataSize, const void *indexData,
+					unsigned int indexType = CEDAR_UNSIGNED_INT, unsigned int narrowestIndexType = CEDAR_UNSIGNED_SHORT) override;
+
+		/**
+		 * Writes the given vertex data into the region that is currently written.
+		 *
+		 * @param offset The offset in bytes inside the region of where the new data will be written.
+		 * @param vertexDataSize The size of the data that will be written in bytes.
+		 * @param vertexData A pointer to the data that will be written.
+		 *
+		 * @throws ModelUpdateException if no update is in progress or the data exceeds the region.
+		 */
+		void update(unsigned int offset, unsigned int vertexDataSize, const void *vertexData) override;
+
+		/**
+		 * Renders the region that was written last and fences it.
+		 */
+		void render() const override;
+
+		/**
+		 * Gets the maximum number of vertices per update.
+		 *
+		 * @return The maximum number of vertices.
+		 */
+		[[nodiscard]] unsigned int getMaxVertexCount() const;
+
+		/**
+		 * Gets the maximum number of indices per update.
+		 *
+		 * @return The maximum number of indices.
+		 */
+		[[nodiscard]] unsigned int getMaxIndexCount() const;
+	};
+}
+
+#endif //CEDAR_DYNAMICMODEL_HPP
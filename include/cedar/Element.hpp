@@ -9,6 +9,7 @@
 
 #include "cedar/InputHandler.hpp"
 #include "cedar/GUIConstants.hpp"
+#include "cedar/TweenManager.hpp"
 #include "cedar/XException.hpp"
 
 /**
@@ -16,6 +17,7 @@
  */
 namespace cedar
 {
+	class Screen;
 
 	/**
 	 * Base class for all element related exceptions.
@@ -80,6 +82,45 @@ namespace cedar
 	 */
 	class Element
 	{
+	private:
+		/**
+		 * A pointer to the screen the element was added to or <code>nullptr</code> if it wasn't added to a screen.
+		 */
+		Screen *m_screen;
+		/**
+		 * The index of the element in the element list of its screen.
+		 */
+		size_t m_screenIndex;
+		/**
+		 * The first column of grid cells of its screen the element was inserted into.
+		 */
+		int m_gridMinX;
+		/**
+		 * The first row of grid cells of its screen the element was inserted into.
+		 */
+		int m_gridMinY;
+		/**
+		 * The last column of grid cells of its screen the element was inserted into.
+		 */
+		int m_gridMaxX;
+		/**
+		 * The last row of grid cells of its screen the element was inserted into.
+		 */
+		int m_gridMaxY;
+		/**
+		 * A pointer to the container that lays out the element or <code>nullptr</code> if the element is not part
+		 * of a container.
+		 */
+		Element *m_parent;
+		/**
+		 * Whether a tween changed a property of the element in the current update.
+		 */
+		bool m_animated;
+		/**
+		 * Whether a tween changed the bounds of the element in the current update.
+		 */
+		bool m_animatedBounds;
+
 	protected:
 		/**
 		 * The x coordinate of the origin of the element.
@@ -187,6 +228,46 @@ namespace cedar
 		 */
 		std::function<void(Element *element, unsigned long currentTime, unsigned long tickCount)> m_updateCallback;
 
+		/**
+		 * Notifies the screen of the element that the position or size of the element changed.
+		 *
+		 * <p>Elements that change {@link #m_posX}, {@link #m_posY}, {@link #m_width} or {@link #m_height} directly
+		 * must call this afterwards, otherwise the element can't be hit at its new bounds.</p>
+		 */
+		virtual void onBoundsChanged();
+
+		/**
+		 * Called when the bounds or the visibility of an element this element lays out changed.
+		 *
+		 * @param child A pointer to the child that changed.
+		 */
+		virtual void onChildChanged(Element *child);
+
+		/**
+		 * Called when the layout of an element this element lays out, or of one of its descendants, became dirty.
+		 *
+		 * <p>The screen only lays out the elements without a parent, so containers must remember that a descendant
+		 * has to be laid out again. By default the notification is passed on to the parent of the element.</p>
+		 *
+		 * @param child A pointer to the child whose layout or the layout of whose descendants became dirty.
+		 */
+		virtual void onChildLayoutInvalidated(Element *child);
+
+		/**
+		 * Called when an element this element lays out is destroyed.
+		 *
+		 * @param child A pointer to the child that is destroyed.
+		 */
+		virtual void onChildRemoved(Element *child);
+
+		/**
+		 * Marks the bounds of the element as dirty in the cache of its screen.
+		 *
+		 * <p>Elements must call this whenever their look changes without their bounds changing, otherwise a cached
+		 * screen keeps showing the old look.</p>
+		 */
+		void markDirty();
+
 	public:
 		/**
 		 * Creates a new element.
@@ -203,8 +284,10 @@ namespace cedar
 
 		/**
 		 * Destroys the element.
+		 *
+		 * <p>The element is removed from its container and its screen.</p>
 		 */
-		~Element();
+		virtual ~Element();
 
 		/**
 		 * Renders the element.
@@ -213,6 +296,50 @@ namespace cedar
 		 */
 		virtual void render(unsigned long currentTime) = 0;
 
+		/**
+		 * Lays out the children of the element if it is a container whose layout is dirty.
+		 *
+		 * <p>This is called by the screen before every update for all elements that are not part of a container.</p>
+		 */
+		virtual void updateLayout();
+
+		/**
+		 * Checks whether the size of the element can be set.
+		 *
+		 * <p>Containers only grow or stretch children that can be resized.</p>
+		 *
+		 * @return <code>true</code> if the size of the element can be set.
+		 */
+		[[nodiscard]] virtual bool isResizable() const;
+
+		/**
+		 * Gets the container that lays out the element.
+		 *
+		 * @return A pointer to the container or <code>nullptr</code> if the element is not part of a container.
+		 */
+		[[nodiscard]] Element *getParent() const;
+
+		/**
+		 * Checks whether the element renders its children itself, clipped to its bounds.
+		 *
+		 * <p>The screen does not render the children of such an element, and they can only be hit inside the bounds
+		 * of the element.</p>
+		 *
+		 * @return <code>true</code> if the element clips its children.
+		 */
+		[[nodiscard]] virtual bool clipsChildren() const;
+
+		/**
+		 * Gets the values a tween writes to when it animates a property of the element.
+		 *
+		 * <p>Elements support the position and, if they are resizable, the size. Elements with a color override
+		 * this to support the color properties as well.</p>
+		 *
+		 * @param property The animated property.
+		 * @return The target of the tween, whose value is <code>nullptr</code> if the property is not supported.
+		 */
+		virtual TweenTarget getTweenTarget(unsigned int property);
+
 		/**
 		 * Gets the x coordinate of the origin of the element.
 		 *
@@ -560,6 +687,9 @@ namespace cedar
 		void setUpdateCallback(const std::function<void(Element *element, unsigned long currentTime, unsigned long tickCount)> &callback);
 
 		friend class Screen;
+		friend class FlexBox;
+		friend class ListView;
+		friend class TweenManager;
 	};
 }
 
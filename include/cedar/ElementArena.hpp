@@ -0,0 +1,96 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_ELEMENTARENA_HPP
+#define CEDAR_ELEMENTARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * The size of the memory blocks of an element arena in bytes.
+ */
+#define CEDAR_ELEMENT_ARENA_BLOCK_SIZE 16384
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	/**
+	 * Struct representing a memory block of an {@link ElementArena}.
+	 */
+	struct ElementArenaBlock
+	{
+		/**
+		 * The memory of the block.
+		 */
+		std::unique_ptr<unsigned char[]> m_memory;
+		/**
+		 * The size of the block in bytes.
+		 */
+		size_t m_size;
+	};
+
+	/**
+	 * Class allocating the memory of elements from large blocks.
+	 *
+	 * <p>Allocations only move an offset inside the current block forward, and the elements of a screen end up next
+	 * to each other in memory. Single allocations can't be freed. Instead the whole arena is reset at once, which
+	 * keeps all blocks so the next elements are placed into the same memory without asking the allocator again.</p>
+	 *
+	 * <p>The arena only hands out memory. Constructing and destroying the objects in it is up to the owner.</p>
+	 */
+	class ElementArena
+	{
+	private:
+		/**
+		 * The memory blocks of the arena.
+		 */
+		std::vector<ElementArenaBlock> m_blocks;
+		/**
+		 * The index of the block the next allocation is taken from.
+		 */
+		size_t m_currentBlock;
+		/**
+		 * The offset of the free memory in the current block in bytes.
+		 */
+		size_t m_offset;
+
+	public:
+		/**
+		 * Creates a new empty element arena.
+		 */
+		ElementArena();
+
+		/**
+		 * Allocates memory from the arena.
+		 *
+		 * <p>Allocations larger than {@link CEDAR_ELEMENT_ARENA_BLOCK_SIZE} get a block of their own.</p>
+		 *
+		 * @param size The size of the memory in bytes.
+		 * @param alignment The alignment of the memory in bytes, must be a power of two.
+		 * @return A pointer to the memory.
+		 */
+		void *allocate(size_t size, size_t alignment);
+
+		/**
+		 * Marks all memory of the arena as free again.
+		 *
+		 * <p>The blocks are kept for the next allocations. All objects in the arena must have been destroyed
+		 * before.</p>
+		 */
+		void reset();
+
+		/**
+		 * Gets the number of bytes the blocks of the arena hold.
+		 *
+		 * @return The capacity of the arena in bytes.
+		 */
+		[[nodiscard]] size_t getCapacity() const;
+	};
+}
+
+#endif //CEDAR_ELEMENTARENA_HPP
@@ -0,0 +1,329 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_FLEXBOX_HPP
+#define CEDAR_FLEXBOX_HPP
+
+#include <vector>
+
+#include "cedar/Element.hpp"
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	/**
+	 * Struct representing a child of a {@link FlexBox}.
+	 */
+	struct FlexItem
+	{
+		/**
+		 * A pointer to the element of the child.
+		 */
+		Element *m_element;
+		/**
+		 * The share of the free space on the main axis the child grows by.
+		 */
+		float m_grow;
+		/**
+		 * The width the child had before it was laid out.
+		 */
+		float m_basisWidth;
+		/**
+		 * The height the child had before it was laid out.
+		 */
+		float m_basisHeight;
+		/**
+		 * The width the child was given by the last arrange pass.
+		 */
+		float m_arrangedWidth;
+		/**
+		 * The height the child was given by the last arrange pass.
+		 */
+		float m_arrangedHeight;
+	};
+
+	/**
+	 * Class representing a container that lays out its children in a row or a column.
+	 *
+	 * <p>The layout follows a subset of the css flexbox model. Children are placed along the main axis with a gap
+	 * between them, free space is given to children with a grow factor or used to justify them, and on the cross
+	 * axis the children are aligned or stretched. Flex boxes can be nested.</p>
+	 *
+	 * <p>The layout is done in two passes. The measure pass calculates the size a flex box needs for its children,
+	 * the arrange pass positions the children inside the bounds of the flex box. Both results are cached, and
+	 * changes of a child, like a new text of a label or a visibility toggle, only mark the flex boxes above it
+	 * dirty. Moving or resizing a flex box or changing its justification only arranges it again without measuring.
+	 * Clean flex boxes above a dirty one only pass the layout on to it. The dirty flex boxes are laid out before
+	 * the next update of the screen.</p>
+	 *
+	 * <p>The flex box does not render anything itself. Its children still have to be added to the screen.</p>
+	 */
+	class FlexBox : public Element
+	{
+	private:
+		/**
+		 * The children of the flex box.
+		 */
+		std::vector<FlexItem> m_items;
+		/**
+		 * The direction of the main axis.
+		 */
+		unsigned int m_direction;
+		/**
+		 * How the children are justified on the main axis.
+		 */
+		unsigned int m_justify;
+		/**
+		 * How the children are aligned on the cross axis.
+		 */
+		unsigned int m_align;
+		/**
+		 * The space between two children in pixel.
+		 */
+		float m_gap;
+		/**
+		 * The space between the bounds of the flex box and its children in pixel.
+		 */
+		float m_padding;
+		/**
+		 * Whether the width of the flex box is the width of its content.
+		 */
+		bool m_autoWidth;
+		/**
+		 * Whether the height of the flex box is the height of its content.
+		 */
+		bool m_autoHeight;
+		/**
+		 * The width of the content including the padding, as calculated by the last measure pass.
+		 */
+		float m_contentWidth;
+		/**
+		 * The height of the content including the padding, as calculated by the last measure pass.
+		 */
+		float m_contentHeight;
+		/**
+		 * Whether the size of the content has to be measured again.
+		 */
+		bool m_measureDirty;
+		/**
+		 * Whether the children have to be arranged again.
+		 */
+		bool m_arrangeDirty;
+		/**
+		 * Whether the layout of a descendant has to be updated, while the flex box itself may be clean.
+		 */
+		bool m_childLayoutDirty;
+		/**
+		 * Whether the flex box is arranging its children right now.
+		 */
+		bool m_arranging;
+
+		/**
+		 * Marks the layout of the flex box as dirty.
+		 *
+		 * @param measure Whether the size of the content may have changed as well.
+		 */
+		void invalidateLayout(bool measure);
+
+		/**
+		 * Measures the size of the content if it is dirty.
+		 */
+		void measure();
+
+		/**
+		 * Positions and sizes the visible children inside the bounds of the flex box.
+		 */
+		void arrange();
+
+		/**
+		 * Lays out the visible children, which only does something for children that are dirty themselves.
+		 */
+		void updateChildLayouts();
+
+		/**
+		 * Gets the width the flex box wants to have in its container.
+		 *
+		 * @return The preferred width in pixel.
+		 */
+		[[nodiscard]] float getPreferredWidth();
+
+		/**
+		 * Gets the height the flex box wants to have in its container.
+		 *
+		 * @return The preferred height in pixel.
+		 */
+		[[nodiscard]] float getPreferredHeight();
+
+	protected:
+		/**
+		 * Notifies the screen and the container of the flex box about its new bounds and marks it for arranging.
+		 */
+		void onBoundsChanged() override;
+
+		/**
+		 * Marks the layout dirty if a child changed outside of the arrange pass.
+		 *
+		 * @param child A pointer to the child that changed.
+		 */
+		void onChildChanged(Element *child) override;
+
+		/**
+		 * Remembers that a descendant has to be laid out and tells the container of the flex box.
+		 *
+		 * @param child A pointer to the child whose layout or the layout of whose descendants became dirty.
+		 */
+		void onChildLayoutInvalidated(Element *child) override;
+
+		/**
+		 * Removes a child that is destroyed from the flex box.
+		 *
+		 * @param child A pointer to the child that is destroyed.
+		 */
+		void onChildRemoved(Element *child) override;
+
+	public:
+		/**
+		 * Creates a new flex box.
+		 *
+		 * @param originX The x coordinate of the origin of the element in pixel.
+		 * @param originY The y coordinate of the origin of the element in pixel.
+		 * @param zIndex The z index of the element.
+		 * @param width The width of the flex box in pixel, 0 to use the width of the content.
+		 * @param height The height of the flex box in pixel, 0 to use the height of the content.
+		 * @param direction The direction of the main axis, either {@link CEDAR_FLEX_ROW} or {@link CEDAR_FLEX_COLUMN}.
+		 * @param alignment The alignment of the element.
+		 */
+		FlexBox(float originX, float originY, unsigned char zIndex, float width, float height, unsigned int direction = CEDAR_FLEX_ROW,
+				unsigned int alignment = CEDAR_ALIGNMENT_TOP | CEDAR_ALIGNMENT_LEFT);
+
+		/**
+		 * Destroys the flex box and releases its children.
+		 */
+		~FlexBox();
+
+		/**
+		 * Does nothing, as the flex box only positions its children.
+		 *
+		 * @param currentTime The current time of the frame in microseconds.
+		 */
+		void render(unsigned long currentTime) override;
+
+		/**
+		 * Lays out the flex box and all dirty flex boxes below it.
+		 */
+		void updateLayout() override;
+
+		/**
+		 * Adds a child to the end of the flex box.
+		 *
+		 * <p>The current size of the child is the size it takes on the main axis before growing.</p>
+		 *
+		 * @param child A pointer to the child.
+		 * @param grow The share of the free space on the main axis the child grows by, 0 if the child keeps its size.
+		 *
+		 * @throws ElementUpdateException if the child is a <code>nullptr</code>, the flex box itself or already part
+		 *                                of a container.
+		 */
+		void addChild(Element *child, float grow = 0.0f);
+
+		/**
+		 * Removes a child from the flex box.
+		 *
+		 * <p>The child keeps the position and size it was given by the last layout.</p>
+		 *
+		 * @param child A pointer to the child.
+		 */
+		void removeChild(Element *child);
+
+		/**
+		 * Gets the direction of the main axis.
+		 *
+		 * @return Either {@link CEDAR_FLEX_ROW} or {@link CEDAR_FLEX_COLUMN}.
+		 */
+		[[nodiscard]] unsigned int getDirection() const;
+
+		/**
+		 * Sets the direction of the main axis.
+		 *
+		 * @param direction Either {@link CEDAR_FLEX_ROW} or {@link CEDAR_FLEX_COLUMN}.
+		 */
+		void setDirection(unsigned int direction);
+
+		/**
+		 * Gets how the children are justified on the main axis.
+		 *
+		 * @return The justification of the children.
+		 */
+		[[nodiscard]] unsigned int getJustify() const;
+
+		/**
+		 * Sets how the children are justified on the main axis.
+		 *
+		 * <p>Has to be one of the following values:
+		 * <ul>
+		 *   <li>{@link CEDAR_FLEX_JUSTIFY_START}</li>
+		 *   <li>{@link CEDAR_FLEX_JUSTIFY_CENTER}</li>
+		 *   <li>{@link CEDAR_FLEX_JUSTIFY_END}</li>
+		 *   <li>{@link CEDAR_FLEX_JUSTIFY_SPACE_BETWEEN}</li>
+		 * </ul></p>
+		 *
+		 * @param justify The justification of the children.
+		 */
+		void setJustify(unsigned int justify);
+
+		/**
+		 * Gets how the children are aligned on the cross axis.
+		 *
+		 * @return The alignment of the children.
+		 */
+		[[nodiscard]] unsigned int getAlign() const;
+
+		/**
+		 * Sets how the children are aligned on the cross axis.
+		 *
+		 * <p>Has to be one of the following values:
+		 * <ul>
+		 *   <li>{@link CEDAR_FLEX_ALIGN_START}</li>
+		 *   <li>{@link CEDAR_FLEX_ALIGN_CENTER}</li>
+		 *   <li>{@link CEDAR_FLEX_ALIGN_END}</li>
+		 *   <li>{@link CEDAR_FLEX_ALIGN_STRETCH}</li>
+		 * </ul></p>
+		 *
+		 * @param align The alignment of the children.
+		 */
+		void setAlign(unsigned int align);
+
+		/**
+		 * Gets the space between two children.
+		 *
+		 * @return The gap in pixel.
+		 */
+		[[nodiscard]] float getGap() const;
+
+		/**
+		 * Sets the space between two children.
+		 *
+		 * @param gap The gap in pixel.
+		 */
+		void setGap(float gap);
+
+		/**
+		 * Gets the space between the bounds of the flex box and its children.
+		 *
+		 * @return The padding in pixel.
+		 */
+		[[nodiscard]] float getPadding() const;
+
+		/**
+		 * Sets the space between the bounds of the flex box and its children.
+		 *
+		 * @param padding The padding in pixel.
+		 */
+		void setPadding(float padding);
+	};
+}
+
+#endif //CEDAR_FLEXBOX_HPP
@@ -6,17 +6,34 @@
 #define CEDAR_FONT_HPP
 
 #include <map>
+#include <vector>
 #include "freetype2/ft2build.h"
 #include FT_FREETYPE_H
 
 #include "cedar/Texture2D.hpp"
+#include "cedar/SkylinePacker.hpp"
 #include "cedar/Glyph.hpp"
 #include "cedar/GlyphData.hpp"
 #include "cedar/Vector4ui.hpp"
 #include "cedar/TextBuffer.hpp"
 #include "cedar/GUIConstants.hpp"
 
-#define CEDAR_FONT_ATLAS_WIDTH 4096
+/**
+ * The width and height of each glyph atlas page in pixel.
+ */
+#define CEDAR_FONT_ATLAS_PAGE_SIZE 1024
+/**
+ * The number of empty pixels around each glyph in the glyph atlas.
+ */
+#define CEDAR_FONT_GLYPH_PADDING 1
+/**
+ * The number of code points starting at 0 whose glyphs are looked up in a direct table.
+ */
+#define CEDAR_FONT_DIRECT_GLYPH_COUNT 256
+/**
+ * The number of glyphs in each block of the glyph arena of a font.
+ */
+#define CEDAR_FONT_GLYPH_BLOCK_SIZE 256
 
 #define UTF8_ACCEPT 0
 #define UTF8_REJECT 1
@@ -68,11 +85,68 @@ namespace cedar
 		explicit FontLoadException(const std::string &message);
 	};
 
+	/**
+	 * Struct representing a page of the glyph atlas of a font.
+	 */
+	struct FontAtlasPage
+	{
+		/**
+		 * A pointer to the texture of the page.
+		 */
+		Texture2D *m_texture;
+		/**
+		 * The packer that places the glyphs on the page.
+		 */
+		SkylinePacker m_packer;
+		/**
+		 * The pixels of the page.
+		 *
+		 * <p>A copy of the page is kept in memory, so glyphs added in one go can be uploaded as a single band of
+		 * rows.</p>
+		 */
+		std::vector<unsigned char> m_pixels;
+		/**
+		 * The first row of the page that changed since the last upload.
+		 */
+		int m_dirtyTop;
+		/**
+		 * The row after the last row of the page that changed since the last upload.
+		 *
+		 * <p>The page has no pending changes if this is not greater than {@link #m_dirtyTop}.</p>
+		 */
+		int m_dirtyBottom;
+	};
+
+	/**
+	 * Struct representing a slot of the glyph hash table of a {@link Font}.
+	 */
+	struct FontGlyphSlot
+	{
+		/**
+		 * The unicode code point of the glyph in this slot.
+		 */
+		unsigned int m_unicode;
+		/**
+		 * A pointer to the glyph or <code>nullptr</code> if the slot is empty.
+		 */
+		Glyph *m_glyph;
+	};
+
 	/**
 	 * Class representing a font with a fixed size.
+	 *
+	 * <p>Glyphs are packed into fixed size atlas pages of {@link CEDAR_FONT_ATLAS_PAGE_SIZE} pixels. Once a glyph
+	 * fits on none of the pages a new one is added, so the uvs of existing glyphs never change and nothing has to be
+	 * read back from the graphics card.</p>
+	 *
+	 * <p>Glyphs are stored in blocks of {@link CEDAR_FONT_GLYPH_BLOCK_SIZE} glyphs, so they stay close together in
+	 * memory and their addresses never change. Glyphs of the first {@link CEDAR_FONT_DIRECT_GLYPH_COUNT} code points
+	 * are found with a direct table lookup, all others with an open addressing hash table.</p>
 	 */
 	class Font
 	{
+		friend class FontBaker;
+
 	protected:
 		/**
 		 * The name of the font.
@@ -89,41 +163,44 @@ namespace cedar
 		 * <ul>
 		 *   <li>{@link CEDAR_RENDERING_SHARP}<li>
 		 *   <li>{@link CEDAR_RENDERING_SMOOTH}</li>
+		 *   <li>{@link CEDAR_RENDERING_SDF}</li>
 		 * </ul></p>
 		 */
 		unsigned int m_renderingMode;
+		/**
+		 * The sized internal format of the glyph atlas pages.
+		 */
 		int m_internalFormat;
 		/**
-		 * A pointer to the glyph atlas of the font.
+		 * The pages of the glyph atlas.
 		 */
-		Texture2D *m_glyphAtlas;
-
+		std::vector<FontAtlasPage> m_atlasPages;
 		/**
-		 * The current offset in the glyph atlas on the x axis.
+		 * Whether the glyph atlas is only kept in memory.
 		 */
-		unsigned int m_currentOffsetX;
+		bool m_headless;
 		/**
-		 * The current offset in the glyph atlas on the y axis.
+		 * The blocks of the glyph arena.
 		 */
-		unsigned int m_currentOffsetY;
+		std::vector<Glyph *> m_glyphBlocks;
 		/**
-		 * The current height of the glyph atlas.
+		 * The number of glyphs in the glyph arena.
 		 */
-		int m_atlasHeight;
+		unsigned int m_glyphCount;
 		/**
-		 * The height of the tallest character in the current row of glyphs.
-		 *
-		 * <p>This is used to calculate the new y offset if the current row is full.</p>
+		 * The glyphs of the first {@link CEDAR_FONT_DIRECT_GLYPH_COUNT} code points, indexed by code point.
 		 */
-		unsigned int m_tallestCharacterInRow;
+		Glyph *m_directGlyphs[CEDAR_FONT_DIRECT_GLYPH_COUNT];
 		/**
-		 * Map for storing glyphs for unicode characters.
+		 * The hash table of the glyphs of all other code points.
+		 *
+		 * <p>The number of slots is always a power of two and collisions are resolved with linear probing.</p>
 		 */
-		std::map<unsigned int, Glyph *> m_glyphs;
+		std::vector<FontGlyphSlot> m_glyphSlots;
 		/**
-		 * Pointer to temporary storage that is used by {@link generate
+		 * The number of glyphs in the {@link #m_glyphSlots hash table}.
 		 */
-		GlyphData *m_glyphData;
+		unsigned int m_hashedGlyphCount;
 
 		/**
 		 * Loads the glyph image of the given unicode code point if it does not exist and generates the glyph.
@@ -134,28 +211,54 @@ namespace cedar
 		virtual const Glyph *loadGlyph(unsigned int unicode) = 0;
 
 		/**
-		 * Creates a glyph from the glyph data {@link #m_glyphData} is currently pointing to and copies it to the atlas.
+		 * Finds the glyph of the given unicode code point.
 		 *
-		 * @return A constant pointer to the created glyph.
+		 * @param unicode The unicode code point.
+		 * @return A pointer to the glyph or <code>nullptr</code> if it was not generated yet.
 		 */
-		virtual const Glyph *createGlyph() = 0;
+		[[nodiscard]] Glyph *findGlyph(unsigned int unicode) const;
 
 		/**
-		 * Resizes the glyph atlas.
+		 * Copies a glyph into the glyph arena and adds it to the lookup tables.
 		 *
-		 * <p>This doubles the height of the glyph atlas and recalculates the uv coordinates of every
-		 * currently loaded glyph.</p>
+		 * @param unicode The unicode code point of the glyph.
+		 * @param glyph The glyph.
+		 * @return A pointer to the glyph in the arena.
 		 */
-		void resize();
+		Glyph *insertGlyph(unsigned int unicode, const Glyph &glyph);
 
 		/**
-		 * Stitches the given glyphs from {@link #m_glyphData} into a single image and uploads it to the glyph atlas.
+		 * Sets up the texture of a new glyph atlas page.
+		 *
+		 * <p>This is called after the storage of the page was allocated. The default implementation does nothing.</p>
+		 *
+		 * @param texture A pointer to the texture of the page.
+		 */
+		virtual void initAtlasPage(Texture2D *texture) const;
+
+		/**
+		 * Adds a new empty page to the glyph atlas.
+		 */
+		void addAtlasPage();
+
+		/**
+		 * Packs the image of the given glyph into the glyph atlas and creates the glyph.
+		 *
+		 * <p>The image is only copied into the memory copy of the page. It is sent to the graphics card by the next
+		 * call to {@link #uploadGlyphs()}. Glyphs without an image don't occupy any space in the atlas.</p>
+		 *
+		 * @param glyphData The glyph data containing the image and metrics of the glyph.
+		 * @param scale The factor the size of the glyph image is scaled by when rendered.
+		 * @return A pointer to the created glyph.
 		 *
-		 * @param firstIndex The first index of the glyphs to stitch.
-		 * @param lastIndex The last (exclusive) index of the glyphs to stitch.
-		 * @param region The coordinates and size of the region that is being uploaded to the glyph atlas.
+		 * @throws FontLoadException if the glyph image is larger than an atlas page.
 		 */
-		virtual void stitchAtlas(unsigned int firstIndex, unsigned int lastIndex, const Vector4ui &region) = 0;
+		Glyph *addGlyph(const GlyphData &glyphData, unsigned int scale = 1);
+
+		/**
+		 * Uploads the rows of all atlas pages that changed since the last upload.
+		 */
+		void uploadGlyphs();
 
 	public:
 
@@ -211,6 +314,7 @@ namespace cedar
 		 * <ul>
 		 *   <li>{@link CEDAR_RENDERING_SHARP}<li>
 		 *   <li>{@link CEDAR_RENDERING_SMOOTH}</li>
+		 *   <li>{@link CEDAR_RENDERING_SDF}</li>
 		 * </ul></p>
 		 *
 		 * @param name The name of the font.
@@ -220,7 +324,7 @@ namespace cedar
 		Font(const std::string &name, unsigned int size, int internalFormat, unsigned int renderingMode = CEDAR_RENDERING_SMOOTH);
 
 		/**
-		 * Deletes the font.
+		 * Deletes the font, its glyph arena and its glyph atlas.
 		 */
 		virtual ~Font();
 
@@ -232,6 +336,17 @@ namespace cedar
 		 */
 		virtual void generateGlyphs(unsigned int firstCharacter, unsigned int lastCharacter) = 0;
 
+		/**
+		 * Sets whether the glyph atlas is only kept in memory.
+		 *
+		 * <p>Headless fonts never create textures for their atlas pages, so glyphs can be generated without an OpenGL
+		 * context, for example to bake the font with the {@link FontBaker}. This must be set before the first glyph is
+		 * generated.</p>
+		 *
+		 * @param headless Whether the glyph atlas is only kept in memory.
+		 */
+		void setHeadless(bool headless);
+
 		/**
 		 * Gets the size of the font in pixel.
 		 *
@@ -246,6 +361,13 @@ namespace cedar
 		 */
 		[[nodiscard]] unsigned int getRenderingMode() const;
 
+		/**
+		 * Checks whether the glyphs of the font are signed distance fields.
+		 *
+		 * @return <code>true</code> if the rendering mode of the font is {@link CEDAR_RENDERING_SDF}.
+		 */
+		[[nodiscard]] bool isDistanceField() const;
+
 		/**
 		 * Gets the glyph of the given unicode character.
 		 *
@@ -257,11 +379,19 @@ namespace cedar
 		[[nodiscard]] const Glyph *getGlyph(unsigned int unicode);
 
 		/**
-		 * Gets the glyph atlas of the font.
+		 * Gets a page of the glyph atlas of the font.
+		 *
+		 * @param page The index of the page.
+		 * @return A constant pointer to the texture of the page or <code>nullptr</code> if the page doesn't exist.
+		 */
+		[[nodiscard]] const Texture2D *getGlyphAtlas(unsigned int page = 0) const;
+
+		/**
+		 * Gets the number of pages of the glyph atlas of the font.
 		 *
-		 * @return A constant pointer to the glyph atlas of the font.
+		 * @return The number of pages.
 		 */
-		[[nodiscard]] const Texture2D *getGlyphAtlas() const;
+		[[nodiscard]] unsigned int getGlyphAtlasCount() const;
 	};
 }
 
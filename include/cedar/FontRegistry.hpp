@@ -31,6 +31,9 @@ namespace cedar
 		 *   <li>{@link CEDAR_RENDERING_SMOOTH}</li>
 		 * </ul></p>
 		 *
+		 * <p>Files ending in <code>.cbf</code> are loaded as a {@link BakedFont}, which ignores the size, character
+		 * range and rendering mode since they are part of the file.</p>
+		 *
 		 * @param name The name of the font.
 		 * @param path The path to the font file.
 		 * @param size The size of the font in pixel.
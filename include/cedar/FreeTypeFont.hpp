@@ -5,10 +5,17 @@
 #ifndef CEDAR_FREETYPEFONT_HPP
 #define CEDAR_FREETYPEFONT_HPP
 
+#include <vector>
+
 #include "Font.hpp"
 #include "freetype2/ft2build.h"
 #include FT_FREETYPE_H
 
+/**
+ * The minimum number of glyphs each task of {@link FreeTypeFont#warmRange(unsigned int, unsigned int)} rasterizes.
+ */
+#define CEDAR_FREETYPE_GLYPHS_PER_TASK 32
+
 /**
  * Base namespace of the cedar engine.
  */
@@ -29,8 +36,30 @@ namespace cedar
 		explicit FreeTypeInitException(const std::string &message);
 	};
 
+	/**
+	 * Struct representing a FreeType face used by a worker thread to rasterize glyphs in parallel.
+	 *
+	 * <p>Every worker face has its own library, since FreeType libraries must not be used by multiple threads at
+	 * once.</p>
+	 */
+	struct FreeTypeWorkerFace
+	{
+		/**
+		 * The FreeType library the face was created with.
+		 */
+		FT_Library m_library;
+		/**
+		 * The FreeType face.
+		 */
+		FT_Face m_face;
+	};
+
 	/**
 	 * Class representing a font that was loaded with FreeType.
+	 *
+	 * <p>Glyphs are rasterized on first use. Ranges of glyphs that are known to be needed, for example when text of
+	 * a new language is about to be shown, can be rasterized in parallel up front with
+	 * {@link #warmRange(unsigned int, unsigned int)}.</p>
 	 */
 	class FreeTypeFont : public Font
 	{
@@ -44,10 +73,28 @@ namespace cedar
 		 */
 		static FT_Library &getFontLibrary();
 
+		/**
+		 * The path to the font file.
+		 */
+		std::string m_path;
 		/**
 		 * The FreeType face of the font.
 		 */
 		FT_Face m_face;
+		/**
+		 * The faces of the worker threads, created on the first call to {@link #warmRange(unsigned int, unsigned int)}.
+		 */
+		std::vector<FreeTypeWorkerFace> m_workerFaces;
+
+		/**
+		 * Opens the font file as a new face and sets its size.
+		 *
+		 * @param library The FreeType library the face is created with.
+		 * @param face A pointer to where the face will be stored.
+		 *
+		 * @throws FontCreationException if the font file could not be loaded.
+		 */
+		void openFace(FT_Library library, FT_Face *face) const;
 
 		/**
 		 * Loads the glyph image of the given unicode code point if it does not exist and generates the glyph.
@@ -58,21 +105,23 @@ namespace cedar
 		const Glyph *loadGlyph(unsigned int unicode) override;
 
 		/**
-		 * Creates a glyph from the glyph data {@link #m_glyphData} is currently pointing to and copies it to the atlas.
+		 * Renders the glyph image of the given unicode code point.
 		 *
-		 * @return A constant pointer to the created glyph.
+		 * <p>This only touches the given face, so it may be called by multiple threads at once as long as each uses a
+		 * different face.</p>
+		 *
+		 * @param face The FreeType face the glyph is rendered with.
+		 * @param unicode The unicode character of which the glyph image will be rendered.
+		 * @param glyphData A pointer to the glyph data the image and metrics are written to.
 		 */
-		const Glyph *createGlyph() override;
+		void renderGlyph(FT_Face face, unsigned int unicode, GlyphData *glyphData) const;
 
 		/**
-		 * Stitches the given glyphs from {@link #m_glyphData} into a single image and uploads it to the glyph atlas.
+		 * Sets the swizzle mask of a new atlas page, so the single red channel is used as the alpha of white text.
 		 *
-		 * @param firstIndex The first index of the glyphs to stitch.
-		 * @param lastIndex The last (exclusive) index of the glyphs to stitch.
-		 * @param region The coordinates and size of the region that is being uploaded to the glyph atlas.
+		 * @param texture A pointer to the texture of the new page.
 		 */
-		void stitchAtlas(unsigned int firstIndex, unsigned int lastIndex, const Vector4ui &region) override;
-
+		void initAtlasPage(Texture2D *texture) const override;
 
 	public:
 		/**
@@ -82,8 +131,11 @@ namespace cedar
 		 * <ul>
 		 *   <li>{@link CEDAR_RENDERING_SHARP}<li>
 		 *   <li>{@link CEDAR_RENDERING_SMOOTH}</li>
+		 *   <li>{@link CEDAR_RENDERING_SDF}</li>
 		 * </ul></p>
 		 *
+		 * <p>If the path is part of a mounted {@link AssetPack} the font is read from the pack instead of the file system.</p>
+		 *
 		 * @param name The name of the font.
 		 * @param path The path to the font file.
 		 * @param size The size of the font in pixel.
@@ -99,10 +151,28 @@ namespace cedar
 		/**
 		 * Generates the glyphs for the characters in the given range.
 		 *
+		 * <p>This is the same as {@link #warmRange(unsigned int, unsigned int)}.</p>
+		 *
 		 * @param firstCharacter The unicode of the first character that will be generated.
 		 * @param lastCharacter The unicode of the last character that will be generated.
 		 */
 		void generateGlyphs(unsigned int firstCharacter, unsigned int lastCharacter) override;
+
+		/**
+		 * Rasterizes the glyphs of all characters in the given range that were not generated yet.
+		 *
+		 * <p>The glyphs are rasterized in parallel on the {@link ThreadPool}, each task with its own FreeType face.
+		 * They are packed into the glyph atlas afterwards and every changed atlas page is uploaded with a single
+		 * call.</p>
+		 *
+		 * <p>This must be called on the OpenGL thread.</p>
+		 *
+		 * @param firstCharacter The unicode of the first character that will be generated.
+		 * @param lastCharacter The unicode of the last character that will be generated.
+		 *
+		 * @throws FontCreationException if the faces of the worker threads could not be created.
+		 */
+		void warmRange(unsigned int firstCharacter, unsigned int lastCharacter);
 	};
 
 }
@@ -120,6 +120,31 @@
 // Depth & Stencil
 #define CEDAR_DEPTH32F_STENCIL8 0x8CAD
 
+/*
+ * Compressed internal formats
+ */
+// S3TC (BC1 - BC3)
+#define CEDAR_COMPRESSED_RGB_S3TC_DXT1 0x83F0
+#define CEDAR_COMPRESSED_RGBA_S3TC_DXT1 0x83F1
+#define CEDAR_COMPRESSED_RGBA_S3TC_DXT3 0x83F2
+#define CEDAR_COMPRESSED_RGBA_S3TC_DXT5 0x83F3
+#define CEDAR_COMPRESSED_SRGB_S3TC_DXT1 0x8C4C
+#define CEDAR_COMPRESSED_SRGB_ALPHA_S3TC_DXT1 0x8C4D
+#define CEDAR_COMPRESSED_SRGB_ALPHA_S3TC_DXT3 0x8C4E
+#define CEDAR_COMPRESSED_SRGB_ALPHA_S3TC_DXT5 0x8C4F
+
+// RGTC (BC4 - BC5)
+#define CEDAR_COMPRESSED_RED_RGTC1 0x8DBB
+#define CEDAR_COMPRESSED_SIGNED_RED_RGTC1 0x8DBC
+#define CEDAR_COMPRESSED_RG_RGTC2 0x8DBD
+#define CEDAR_COMPRESSED_SIGNED_RG_RGTC2 0x8DBE
+
+// BPTC (BC6H - BC7)
+#define CEDAR_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#define CEDAR_COMPRESSED_SRGB_ALPHA_BPTC_UNORM 0x8E8D
+#define CEDAR_COMPRESSED_RGB_BPTC_SIGNED_FLOAT 0x8E8E
+#define CEDAR_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT 0x8E8F
+
 /*
  * Data Types
  */
@@ -8,6 +8,16 @@
 
 #define CEDAR_RENDERING_SHARP 0x00
 #define CEDAR_RENDERING_SMOOTH 0x01
+/**
+ * Defines the glyphs of a font to be signed distance fields.
+ *
+ * <p>Distance field glyphs stay sharp when they are scaled, so one atlas can be used for many text sizes.</p>
+ */
+#define CEDAR_RENDERING_SDF 0x02
+/**
+ * The distance in pixel from the outline of a glyph at which its distance field is saturated.
+ */
+#define CEDAR_FONT_SDF_SPREAD 8
 
 
 /**
@@ -35,4 +45,112 @@
  */
 #define CEDAR_ALIGNMENT_BOTTOM 0x08u
 
+
+/**
+ * Defines a flex box to place its children next to each other.
+ */
+#define CEDAR_FLEX_ROW 0x00u
+/**
+ * Defines a flex box to place its children below each other.
+ */
+#define CEDAR_FLEX_COLUMN 0x01u
+/**
+ * Defines the children of a flex box to be packed at the start of the main axis.
+ */
+#define CEDAR_FLEX_JUSTIFY_START 0x00u
+/**
+ * Defines the children of a flex box to be packed in the center of the main axis.
+ */
+#define CEDAR_FLEX_JUSTIFY_CENTER 0x01u
+/**
+ * Defines the children of a flex box to be packed at the end of the main axis.
+ */
+#define CEDAR_FLEX_JUSTIFY_END 0x02u
+/**
+ * Defines the free space of a flex box to be distributed between its children.
+ */
+#define CEDAR_FLEX_JUSTIFY_SPACE_BETWEEN 0x03u
+/**
+ * Defines the children of a flex box to be placed at the start of the cross axis.
+ */
+#define CEDAR_FLEX_ALIGN_START 0x00u
+/**
+ * Defines the children of a flex box to be centered on the cross axis.
+ */
+#define CEDAR_FLEX_ALIGN_CENTER 0x01u
+/**
+ * Defines the children of a flex box to be placed at the end of the cross axis.
+ */
+#define CEDAR_FLEX_ALIGN_END 0x02u
+/**
+ * Defines the children of a flex box to fill the cross axis.
+ */
+#define CEDAR_FLEX_ALIGN_STRETCH 0x03u
+
+/**
+ * Defines a tween to animate the x coordinate of an element.
+ */
+#define CEDAR_TWEEN_POS_X 0x00u
+/**
+ * Defines a tween to animate the y coordinate of an element.
+ */
+#define CEDAR_TWEEN_POS_Y 0x01u
+/**
+ * Defines a tween to animate the width of an element.
+ */
+#define CEDAR_TWEEN_WIDTH 0x02u
+/**
+ * Defines a tween to animate the height of an element.
+ */
+#define CEDAR_TWEEN_HEIGHT 0x03u
+/**
+ * Defines a tween to animate the red component of the color of an element.
+ */
+#define CEDAR_TWEEN_COLOR_RED 0x04u
+/**
+ * Defines a tween to animate the green component of the color of an element.
+ */
+#define CEDAR_TWEEN_COLOR_GREEN 0x05u
+/**
+ * Defines a tween to animate the blue component of the color of an element.
+ */
+#define CEDAR_TWEEN_COLOR_BLUE 0x06u
+/**
+ * Defines a tween to animate the alpha component of the color of an element.
+ */
+#define CEDAR_TWEEN_COLOR_ALPHA 0x07u
+
+/**
+ * Defines a tween to progress at a constant speed.
+ */
+#define CEDAR_EASING_LINEAR 0x00u
+/**
+ * Defines a tween to start slow and accelerate quadratically.
+ */
+#define CEDAR_EASING_QUAD_IN 0x01u
+/**
+ * Defines a tween to start fast and decelerate quadratically.
+ */
+#define CEDAR_EASING_QUAD_OUT 0x02u
+/**
+ * Defines a tween to accelerate quadratically until the half and decelerate afterwards.
+ */
+#define CEDAR_EASING_QUAD_IN_OUT 0x03u
+/**
+ * Defines a tween to start slow and accelerate cubically.
+ */
+#define CEDAR_EASING_CUBIC_IN 0x04u
+/**
+ * Defines a tween to start fast and decelerate cubically.
+ */
+#define CEDAR_EASING_CUBIC_OUT 0x05u
+/**
+ * Defines a tween to accelerate cubically until the half and decelerate afterwards.
+ */
+#define CEDAR_EASING_CUBIC_IN_OUT 0x06u
+/**
+ * Defines a tween to follow the smoothstep curve.
+ */
+#define CEDAR_EASING_SMOOTHSTEP 0x07u
+
 #endif //CEDAR_GUICONSTANTS_HPP
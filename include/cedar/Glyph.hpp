@@ -41,6 +41,10 @@ namespace cedar
 		 * <p>The uv coordinate are normalized coordinates where 1.0 is the size of the texture.</p>
 		 */
 		Vector4f m_uvs;
+		/**
+		 * The index of the glyph atlas page the glyph is stored on.
+		 */
+		unsigned int m_page;
 
 		/**
 		 * Creates a glyph placeholder.
@@ -54,8 +58,9 @@ namespace cedar
 		 * @param bearing The bearing of the glyph in pixel.
 		 * @param advance The advance of the glyph in pixel.
 		 * @param uvs The top-left and bottom-right uv coordinates of the glyph.
+		 * @param page The index of the glyph atlas page the glyph is stored on.
 		 */
-		Glyph(const Vector2i &size, const Vector2i &bearing, unsigned int advance, const Vector4f &uvs);
+		Glyph(const Vector2i &size, const Vector2i &bearing, unsigned int advance, const Vector4f &uvs, unsigned int page = 0);
 	};
 }
 
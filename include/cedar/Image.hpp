@@ -9,6 +9,7 @@
 #include <memory>
 #include "Element.hpp"
 #include "Texture2D.hpp"
+#include "TextureAtlas.hpp"
 #include "Vector4f.hpp"
 
 /**
@@ -47,6 +48,21 @@ namespace cedar
 		 */
 		Image(float originX, float originY, unsigned char zIndex, float width, float height, const std::shared_ptr<Texture> &texture, const Vector4f &uvSection, unsigned int alignment = CEDAR_ALIGNMENT_TOP | CEDAR_ALIGNMENT_LEFT);
 
+		/**
+		 * Creates a new image that renders a texture region.
+		 *
+		 * <p>Images using regions of the same {@link TextureAtlas} page are rendered in one batch.</p>
+		 *
+		 * @param originX The x coordinate of the origin of the element in pixel.
+		 * @param originY The y coordinate of the origin of the element in pixel.
+		 * @param zIndex The z index of the element.
+		 * @param width The width of the image in pixel.
+		 * @param height The height of the image in pixel.
+		 * @param region The texture region that will be rendered.
+		 * @param alignment The alignment of the element.
+		 */
+		Image(float originX, float originY, unsigned char zIndex, float width, float height, const TextureRegion &region, unsigned int alignment = CEDAR_ALIGNMENT_TOP | CEDAR_ALIGNMENT_LEFT);
+
 		/**
 		 * Renders the Image.
 		 *
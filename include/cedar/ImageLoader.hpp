@@ -5,7 +5,31 @@
 #ifndef CEDAR_IMAGELOADER_HPP
 #define CEDAR_IMAGELOADER_HPP
 
+#include <vector>
+
 #include "Texture2D.hpp"
+#include "PixelBufferRing.hpp"
+
+/**
+ * The magic number at the start of DDS files.
+ */
+#define CEDAR_DDS_MAGIC "DDS "
+/**
+ * The size of the DDS header including the magic number in bytes.
+ */
+#define CEDAR_DDS_HEADER_SIZE 128
+/**
+ * The size of the optional DX10 extension of the DDS header in bytes.
+ */
+#define CEDAR_DDS_DX10_HEADER_SIZE 20
+/**
+ * The identifier at the start of KTX2 files.
+ */
+#define CEDAR_KTX2_IDENTIFIER "\xABKTX 20\xBB\r\n\x1A\n"
+/**
+ * The size of the KTX2 header including the identifier and the index, without the level index, in bytes.
+ */
+#define CEDAR_KTX2_HEADER_SIZE 80
 
 /**
  * Base namespace of the cedar engine.
@@ -27,6 +51,89 @@ namespace cedar
 		explicit TextureLoadException(const std::string &message);
 	};
 
+	/**
+	 * Struct representing a decoded image that was not uploaded to the graphics card yet.
+	 */
+	struct DecodedImage
+	{
+		/**
+		 * The width of the image in pixels.
+		 */
+		int m_width;
+		/**
+		 * The height of the image in pixels.
+		 */
+		int m_height;
+		/**
+		 * The sized internal format of the texture that will be created from the image.
+		 */
+		int m_internalFormat;
+		/**
+		 * The section of the pixel buffer ring that holds the pixels.
+		 *
+		 * <p>{@link PixelBufferAllocation#m_data} is <code>nullptr</code> if the pixels are held in client memory.</p>
+		 */
+		PixelBufferAllocation m_allocation;
+		/**
+		 * A pointer to the pixels in client memory or <code>nullptr</code> if the pixels are held in the pixel buffer ring.
+		 */
+		unsigned char *m_pixels;
+		/**
+		 * The number of mipmap levels of the image.
+		 *
+		 * <p>The levels are stored back to back, starting with the full resolution.</p>
+		 */
+		int m_levels;
+	};
+
+	/**
+	 * Struct representing a single mipmap level of a {@link CompressedImage}.
+	 */
+	struct CompressedImageLevel
+	{
+		/**
+		 * The width of the level in pixels.
+		 */
+		int m_width;
+		/**
+		 * The height of the level in pixels.
+		 */
+		int m_height;
+		/**
+		 * A pointer to the compressed blocks of the level.
+		 */
+		const unsigned char *m_data;
+		/**
+		 * The size of the compressed blocks in bytes.
+		 */
+		size_t m_size;
+	};
+
+	/**
+	 * Struct representing a block compressed image with its mipmap chain.
+	 *
+	 * <p>The levels point into the data the image was parsed from, so that data must stay valid while the image is used.</p>
+	 */
+	struct CompressedImage
+	{
+		/**
+		 * The width of the image in pixels.
+		 */
+		int m_width;
+		/**
+		 * The height of the image in pixels.
+		 */
+		int m_height;
+		/**
+		 * The compressed internal format of the image.
+		 */
+		int m_internalFormat;
+		/**
+		 * The mipmap levels of the image, starting with the full resolution.
+		 */
+		std::vector<CompressedImageLevel> m_levels;
+	};
+
 	/**
 	 * Class for loading images.
 	 */
@@ -42,13 +149,151 @@ namespace cedar
 		/**
 		 * Loads a texture from the given file.
 		 *
+		 * <p>If the path is part of a mounted {@link AssetPack} the image is decoded from the pack instead of the file system.</p>
+		 *
 		 * @param path The path to the texture file.
 		 * @param forceComposition The number of forced color channels.
 		 *                         <p>If 0, the number of color channels will be determined by the file.</p>
+		 * @param generateMipmaps Whether a full mipmap chain is generated and the texture is filtered trilinearly.
 		 * @return A pointer to the loaded texture.
 		 * @throws TextureLoadException when the texture could not be loaded.
 		 */
-		static Texture2D *loadTexture(const std::string &path, int forceComposition = 0);
+		static Texture2D *loadTexture(const std::string &path, int forceComposition = 0, bool generateMipmaps = false);
+
+		/**
+		 * Gets the size of a full mipmap chain of an 8 bit image in bytes.
+		 *
+		 * @param width The width of the image in pixels.
+		 * @param height The height of the image in pixels.
+		 * @param channels The number of channels of the image.
+		 * @return The size of all levels in bytes.
+		 */
+		static size_t getMipmapChainSize(int width, int height, int channels);
+
+		/**
+		 * Halves the size of an 8 bit image by averaging 2x2 pixel boxes.
+		 *
+		 * <p>The new size is rounded down like the mipmap levels of OpenGL, so the last column of an odd width and the
+		 * last row of an odd height are dropped. Only a width or height of 1 stays 1, and that pixel is averaged with
+		 * itself. Large images are split into bands of rows which are downsampled on the
+		 * {@link ThreadPool#getInstance() shared thread pool}.</p>
+		 *
+		 * @param pixels A pointer to the pixels of the image, tightly packed.
+		 * @param width The width of the image in pixels.
+		 * @param height The height of the image in pixels.
+		 * @param channels The number of channels of the image.
+		 * @param destination A pointer to the memory the downsampled image is written to.
+		 */
+		static void downsampleImage(const unsigned char *pixels, int width, int height, int channels, unsigned char *destination);
+
+		/**
+		 * Checks whether the given path refers to a block compressed texture container.
+		 *
+		 * <p>The check is based on the file extension, <code>.dds</code> and <code>.ktx2</code> files are compressed
+		 * containers.</p>
+		 *
+		 * @param path The path to the texture file.
+		 * @return <code>true</code> if the file is a compressed texture container.
+		 */
+		static bool isCompressedContainer(const std::string &path);
+
+		/**
+		 * Loads a block compressed texture with its mipmap chain from a DDS or KTX2 file.
+		 *
+		 * <p>The blocks are uploaded as they are stored in the file, no decoding happens on the cpu. Supported formats
+		 * are BC1 - BC7, cube maps, arrays and supercompressed KTX2 files are not supported.</p>
+		 *
+		 * <p>If the path is part of a mounted {@link AssetPack} the texture is loaded from the pack instead of the file system.</p>
+		 *
+		 * @param path The path to the texture file.
+		 * @return A pointer to the loaded texture.
+		 * @throws TextureLoadException when the texture could not be loaded.
+		 */
+		static Texture2D *loadCompressedTexture(const std::string &path);
+
+		/**
+		 * Parses a DDS or KTX2 file.
+		 *
+		 * <p>This doesn't use the graphics card and can be called from any thread.</p>
+		 *
+		 * @param path The path of the file, only used for error messages.
+		 * @param data A pointer to the file data.
+		 * @param dataSize The size of the file data in bytes.
+		 * @return The parsed image, its levels point into <code>data</code>.
+		 * @throws TextureLoadException when the file is not a valid DDS or KTX2 file or uses an unsupported format.
+		 */
+		static CompressedImage parseCompressedImage(const std::string &path, const unsigned char *data, size_t dataSize);
+
+		/**
+		 * Creates a texture from the given compressed image.
+		 *
+		 * <p>This must be called on the OpenGL thread.</p>
+		 *
+		 * @param image The compressed image.
+		 * @return A pointer to the created texture.
+		 */
+		static Texture2D *createCompressedTexture(const CompressedImage &image);
+
+		/**
+		 * Decodes the given image file.
+		 *
+		 * <p>This doesn't use the graphics card and can be called from any thread. If a pixel buffer ring is given and
+		 * has enough free space the pixels are written into it, otherwise they are kept in client memory.</p>
+		 *
+		 * @param path The path to the image file.
+		 * @param pixelBufferRing A pointer to the pixel buffer ring the pixels will be written to or <code>nullptr</code>.
+		 * @param forceComposition The number of forced color channels.
+		 *                         <p>If 0, the number of color channels will be determined by the file.</p>
+		 * @param generateMipmaps Whether a full mipmap chain is generated on the cpu.
+		 * @return The decoded image.
+		 * @throws TextureLoadException when the image could not be decoded.
+		 */
+		static DecodedImage decodeImage(const std::string &path, PixelBufferRing *pixelBufferRing, int forceComposition = 0,
+										bool generateMipmaps = false);
+
+		/**
+		 * Decodes an image from the given encoded file data.
+		 *
+		 * <p>This doesn't use the graphics card and can be called from any thread.</p>
+		 *
+		 * @param path The path of the image, only used for error messages.
+		 * @param data A pointer to the encoded file data.
+		 * @param dataSize The size of the encoded file data in bytes.
+		 * @param pixelBufferRing A pointer to the pixel buffer ring the pixels will be written to or <code>nullptr</code>.
+		 * @param forceComposition The number of forced color channels.
+		 *                         <p>If 0, the number of color channels will be determined by the file.</p>
+		 * @param generateMipmaps Whether a full mipmap chain is generated on the cpu.
+		 * @return The decoded image.
+		 * @throws TextureLoadException when the image could not be decoded.
+		 */
+		static DecodedImage decodeImage(const std::string &path, const unsigned char *data, size_t dataSize,
+										PixelBufferRing *pixelBufferRing, int forceComposition = 0, bool generateMipmaps = false);
+
+		/**
+		 * Creates a texture from the given decoded image.
+		 *
+		 * <p>This must be called on the OpenGL thread. The pixels of the image are released afterwards, even if the
+		 * texture could not be created.</p>
+		 *
+		 * <p>If the image has a mipmap chain all levels are uploaded. Otherwise, if <code>generateMipmaps</code> is set,
+		 * the graphics card generates the levels from the full resolution.</p>
+		 *
+		 * @param image The decoded image.
+		 * @param pixelBufferRing A pointer to the pixel buffer ring the image was decoded into or <code>nullptr</code>.
+		 * @param generateMipmaps Whether the texture gets a full mipmap chain and is filtered trilinearly.
+		 * @return A pointer to the created texture.
+		 */
+		static Texture2D *createTexture(DecodedImage &image, PixelBufferRing *pixelBufferRing, bool generateMipmaps = false);
+
+		/**
+		 * Releases the pixels of the given decoded image without creating a texture.
+		 *
+		 * <p>This must be called on the OpenGL thread if the pixels are held in the pixel buffer ring.</p>
+		 *
+		 * @param image The decoded image.
+		 * @param pixelBufferRing A pointer to the pixel buffer ring the image was decoded into or <code>nullptr</code>.
+		 */
+		static void freeImage(DecodedImage &image, PixelBufferRing *pixelBufferRing);
 	};
 }
 
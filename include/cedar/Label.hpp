@@ -109,6 +109,23 @@ namespace cedar
 		 */
 		void setTextColor(const Vector4f &color);
 
+		/**
+		 * Checks whether the size of the label can be set.
+		 *
+		 * @return <code>false</code> as the size is controlled by the label's text.
+		 */
+		[[nodiscard]] bool isResizable() const override;
+
+		/**
+		 * Gets the values a tween writes to when it animates a property of the label.
+		 *
+		 * <p>The color properties animate the color of the label's text.</p>
+		 *
+		 * @param property The animated property.
+		 * @return The target of the tween, whose value is <code>nullptr</code> if the property is not supported.
+		 */
+		TweenTarget getTweenTarget(unsigned int property) override;
+
 		/**
 		 * Sets the width of the label.
 		 *
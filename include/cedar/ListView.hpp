@@ -0,0 +1,283 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_LISTVIEW_HPP
+#define CEDAR_LISTVIEW_HPP
+
+#include <functional>
+#include <vector>
+
+#include "cedar/Element.hpp"
+
+/**
+ * The number of rows a list view scrolls per step of the mouse wheel.
+ */
+#define CEDAR_LIST_VIEW_SCROLL_ROWS 3
+/**
+ * The default number of rows a list view keeps above and below the visible rows.
+ */
+#define CEDAR_LIST_VIEW_OVERSCAN 2
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	/**
+	 * Struct representing a row of a {@link ListView} that shows an item.
+	 */
+	struct ListViewRow
+	{
+		/**
+		 * A pointer to the element of the row.
+		 */
+		Element *m_element;
+		/**
+		 * The index of the item the row shows.
+		 */
+		size_t m_index;
+	};
+
+	/**
+	 * Class representing a scrollable list of items that all have the same height.
+	 *
+	 * <p>The list view does not create an element for every item. It only creates rows for the visible items and
+	 * a few items above and below them, using the row factory as a template. When the list is scrolled, rows whose
+	 * item moved out of view are recycled and bound to the items that moved into view by the row binder. So the
+	 * number of elements, and with it the cost of hit testing and rendering, depends on the height of the list view
+	 * instead of the number of items.</p>
+	 *
+	 * <p>The rows are added to the screen of the list view so they receive input events, but they are rendered by
+	 * the list view and clipped to its bounds. Rows should have a z index lower than or equal to the z index of the
+	 * list view. Rows that don't handle scroll events themselves scroll the list view.</p>
+	 */
+	class ListView : public Element
+	{
+	private:
+		/**
+		 * The number of items of the list.
+		 */
+		size_t m_itemCount;
+		/**
+		 * The height of a row in pixel.
+		 */
+		float m_rowHeight;
+		/**
+		 * The distance between the top of the first item and the top of the list view in pixel.
+		 *
+		 * <p>It is stored as a double, so lists with millions of items still scroll by single pixels.</p>
+		 */
+		double m_scrollOffset;
+		/**
+		 * The number of rows kept above and below the visible rows.
+		 */
+		unsigned int m_overscan;
+		/**
+		 * The function that creates a new row.
+		 */
+		std::function<Element *(ListView *listView)> m_rowFactory;
+		/**
+		 * The function that makes a row show an item.
+		 */
+		std::function<void(Element *row, size_t index)> m_rowBinder;
+		/**
+		 * The rows that show an item, sorted by the index of their item.
+		 */
+		std::vector<ListViewRow> m_rows;
+		/**
+		 * The rows that are hidden and can be bound to the next item that moves into view.
+		 */
+		std::vector<Element *> m_freeRows;
+		/**
+		 * The rows of the range that is currently bound, used while the rows are updated.
+		 */
+		std::vector<Element *> m_rowSlots;
+		/**
+		 * Whether the rows have to be updated.
+		 */
+		bool m_rowsDirty;
+		/**
+		 * Whether all rows have to be bound again.
+		 */
+		bool m_rebindRows;
+
+		/**
+		 * Creates a new row with the row factory.
+		 *
+		 * @return A pointer to the new row.
+		 *
+		 * @throws ElementUpdateException if the row factory returned a <code>nullptr</code> or an element that is
+		 *                                already part of a screen or a container.
+		 */
+		Element *createRow();
+
+		/**
+		 * Binds and positions the rows of the items in the visible range and recycles all other rows.
+		 */
+		void updateRows();
+
+		/**
+		 * Marks the rows dirty and tells the container of the list view about it.
+		 *
+		 * @param rebind Whether all rows have to be bound again.
+		 */
+		void invalidateRows(bool rebind);
+
+	protected:
+		/**
+		 * Notifies the screen about the new bounds of the list view and marks its rows dirty.
+		 */
+		void onBoundsChanged() override;
+
+		/**
+		 * Forgets a row that is destroyed.
+		 *
+		 * @param child A pointer to the row that is destroyed.
+		 */
+		void onChildRemoved(Element *child) override;
+
+	public:
+		/**
+		 * Creates a new empty list view.
+		 *
+		 * @param originX The x coordinate of the origin of the element in pixel.
+		 * @param originY The y coordinate of the origin of the element in pixel.
+		 * @param zIndex The z index of the element.
+		 * @param width The width of the list view in pixel.
+		 * @param height The height of the list view in pixel.
+		 * @param rowHeight The height of a row in pixel.
+		 * @param rowFactory The function that creates a new row. The list view owns the rows and deletes them.
+		 * @param rowBinder The function that makes a row show the item with the given index.
+		 * @param alignment The alignment of the element.
+		 *
+		 * @throws ElementCreationException if the row height is not positive or a function is empty.
+		 */
+		ListView(float originX, float originY, unsigned char zIndex, float width, float height, float rowHeight,
+				 const std::function<Element *(ListView *listView)> &rowFactory, const std::function<void(Element *row, size_t index)> &rowBinder,
+				 unsigned int alignment = CEDAR_ALIGNMENT_TOP | CEDAR_ALIGNMENT_LEFT);
+
+		/**
+		 * Destroys the list view and all of its rows.
+		 */
+		~ListView();
+
+		/**
+		 * Renders the visible rows clipped to the bounds of the list view.
+		 *
+		 * @param currentTime The current time of the frame in microseconds.
+		 */
+		void render(unsigned long currentTime) override;
+
+		/**
+		 * Updates the rows if the list view was scrolled, resized or its items changed.
+		 */
+		void updateLayout() override;
+
+		/**
+		 * Checks whether the list view renders its children itself.
+		 *
+		 * @return <code>true</code> as the rows are clipped to the list view.
+		 */
+		[[nodiscard]] bool clipsChildren() const override;
+
+		/**
+		 * Gets the number of items of the list.
+		 *
+		 * @return The number of items.
+		 */
+		[[nodiscard]] size_t getItemCount() const;
+
+		/**
+		 * Sets the number of items of the list.
+		 *
+		 * <p>All rows are bound again, as the items may have changed as well.</p>
+		 *
+		 * @param itemCount The number of items.
+		 */
+		void setItemCount(size_t itemCount);
+
+		/**
+		 * Binds all rows again, after the items of the list changed.
+		 */
+		void notifyDataChanged();
+
+		/**
+		 * Binds the row of an item again, after the item changed.
+		 *
+		 * <p>Does nothing if the item has no row right now.</p>
+		 *
+		 * @param index The index of the item.
+		 */
+		void notifyItemChanged(size_t index);
+
+		/**
+		 * Gets the height of a row.
+		 *
+		 * @return The height of a row in pixel.
+		 */
+		[[nodiscard]] float getRowHeight() const;
+
+		/**
+		 * Gets the distance between the top of the first item and the top of the list view.
+		 *
+		 * @return The scroll offset in pixel.
+		 */
+		[[nodiscard]] double getScrollOffset() const;
+
+		/**
+		 * Gets the largest possible scroll offset, at which the last item is at the bottom of the list view.
+		 *
+		 * @return The largest scroll offset in pixel.
+		 */
+		[[nodiscard]] double getMaxScrollOffset() const;
+
+		/**
+		 * Scrolls the list view to the given offset.
+		 *
+		 * <p>The offset is clamped between 0 and {@link #getMaxScrollOffset()}.</p>
+		 *
+		 * @param scrollOffset The distance between the top of the first item and the top of the list view in pixel.
+		 */
+		void setScrollOffset(double scrollOffset);
+
+		/**
+		 * Scrolls the list view by the given distance.
+		 *
+		 * @param distance The distance in pixel, negative values scroll up.
+		 */
+		void scrollBy(double distance);
+
+		/**
+		 * Scrolls the list view as little as possible so that the item is completely visible.
+		 *
+		 * @param index The index of the item.
+		 */
+		void scrollToItem(size_t index);
+
+		/**
+		 * Gets the number of rows kept above and below the visible rows.
+		 *
+		 * @return The number of overscan rows.
+		 */
+		[[nodiscard]] unsigned int getOverscan() const;
+
+		/**
+		 * Sets the number of rows kept above and below the visible rows.
+		 *
+		 * <p>More overscan rows mean fewer rows have to be bound while scrolling slowly.</p>
+		 *
+		 * @param overscan The number of overscan rows.
+		 */
+		void setOverscan(unsigned int overscan);
+
+		/**
+		 * Gets the number of rows the list view created.
+		 *
+		 * @return The number of rows, including the hidden ones that are waiting to be recycled.
+		 */
+		[[nodiscard]] size_t getRowCount() const;
+	};
+}
+
+#endif //CEDAR_LISTVIEW_HPP
@@ -0,0 +1,98 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_MAPPEDFILE_HPP
+#define CEDAR_MAPPEDFILE_HPP
+
+#include <cstddef>
+
+#include "cedar/XException.hpp"
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	/**
+	 * Exception which is thrown when a file could not be mapped into memory.
+	 */
+	class FileMapException : public XException
+	{
+	public:
+		/**
+		 * Creates a new file map exception.
+		 *
+		 * @param message The message of the exception.
+		 */
+		explicit FileMapException(const std::string &message);
+	};
+
+	/**
+	 * Class representing a file that is mapped read only into memory.
+	 *
+	 * <p>The file is unmapped when the mapped file is destroyed, so pointers to its data must not outlive it.</p>
+	 */
+	class MappedFile
+	{
+	private:
+		/**
+		 * The path to the file.
+		 */
+		std::string m_path;
+		/**
+		 * A pointer to the mapped data of the file.
+		 *
+		 * <p>This is <code>nullptr</code> if the file is empty.</p>
+		 */
+		unsigned char *m_data;
+		/**
+		 * The size of the file in bytes.
+		 */
+		size_t m_size;
+
+	public:
+		/**
+		 * Maps the given file into memory.
+		 *
+		 * @param path The path to the file.
+		 * @param sequential Whether the file will mostly be read sequentially.
+		 *                   <p>If <code>true</code> the kernel is advised to read ahead aggressively.</p>
+		 *
+		 * @throws FileMapException if the file could not be opened or mapped.
+		 */
+		explicit MappedFile(const std::string &path, bool sequential = false);
+
+		/**
+		 * Unmaps the file.
+		 */
+		~MappedFile();
+
+		MappedFile(const MappedFile &) = delete;
+
+		MappedFile &operator=(const MappedFile &) = delete;
+
+		/**
+		 * Gets the path to the file.
+		 *
+		 * @return The path to the file.
+		 */
+		[[nodiscard]] const std::string &getPath() const;
+
+		/**
+		 * Gets a pointer to the mapped data of the file.
+		 *
+		 * @return A pointer to the data or <code>nullptr</code> if the file is empty.
+		 */
+		[[nodiscard]] const unsigned char *getData() const;
+
+		/**
+		 * Gets the size of the file in bytes.
+		 *
+		 * @return The size of the file.
+		 */
+		[[nodiscard]] size_t getSize() const;
+	};
+}
+
+#endif //CEDAR_MAPPEDFILE_HPP
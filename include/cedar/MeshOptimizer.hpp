@@ -0,0 +1,163 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_MESHOPTIMIZER_HPP
+#define CEDAR_MESHOPTIMIZER_HPP
+
+#include <cstddef>
+
+/*
+ * Mesh optimization passes
+ */
+#define CEDAR_MESH_OPTIMIZE_VERTEX_CACHE 0x01u
+#define CEDAR_MESH_OPTIMIZE_VERTEX_FETCH 0x02u
+#define CEDAR_MESH_OPTIMIZE_OVERDRAW 0x04u
+#define CEDAR_MESH_OPTIMIZE_DEFAULT (CEDAR_MESH_OPTIMIZE_VERTEX_CACHE | CEDAR_MESH_OPTIMIZE_VERTEX_FETCH)
+#define CEDAR_MESH_OPTIMIZE_ALL (CEDAR_MESH_OPTIMIZE_DEFAULT | CEDAR_MESH_OPTIMIZE_OVERDRAW)
+
+/**
+ * The size of the fifo cache that is simulated to measure the vertex cache efficiency.
+ */
+#define CEDAR_MESH_SIMULATED_CACHE_SIZE 16
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	/**
+	 * Struct storing the post transform vertex cache efficiency of an index buffer.
+	 */
+	struct VertexCacheStatistics
+	{
+		/**
+		 * The number of vertices that missed the cache and had to be transformed.
+		 */
+		unsigned int m_transformedVertices;
+		/**
+		 * The average cache miss ratio.
+		 *
+		 * <p>This is the number of transformed vertices per triangle. The optimum is around 0.5 for regular grids, the
+		 * worst case is 3.</p>
+		 */
+		float m_acmr;
+		/**
+		 * The average transformed vertex ratio.
+		 *
+		 * <p>This is the number of transformed vertices per referenced vertex. The optimum is 1.</p>
+		 */
+		float m_atvr;
+	};
+
+	/**
+	 * Struct storing the vertex cache efficiency of an index buffer before and after it was optimized.
+	 */
+	struct MeshOptimizationReport
+	{
+		/**
+		 * The cache efficiency of the index buffer before the optimization.
+		 */
+		VertexCacheStatistics m_before;
+		/**
+		 * The cache efficiency of the index buffer after the optimization.
+		 */
+		VertexCacheStatistics m_after;
+	};
+
+	/**
+	 * Class for optimizing indexed triangle lists for the gpu.
+	 *
+	 * <p>All functions expect triangle lists with 32 bit indices that are smaller than the vertex count.</p>
+	 */
+	class MeshOptimizer
+	{
+	private:
+		/**
+		 * Creates a new mesh optimizer.
+		 */
+		MeshOptimizer();
+
+	public:
+		/**
+		 * Reorders the triangles to improve the post transform vertex cache hit rate.
+		 *
+		 * <p>This uses the linear-speed vertex cache optimization by Tom Forsyth which greedily emits the triangle
+		 * whose vertices have the highest score, based on their position in a simulated lru cache and the number of
+		 * triangles that still use them.</p>
+		 *
+		 * @param indices A pointer to the indices that will be reordered.
+		 * @param indexCount The number of indices.
+		 * @param vertexCount The number of vertices.
+		 */
+		static void optimizeVertexCache(unsigned int *indices, size_t indexCount, unsigned int vertexCount);
+
+		/**
+		 * Reorders clusters of triangles to reduce overdraw.
+		 *
+		 * <p>The index buffer is split into clusters at points where the vertex cache would be flushed anyway, or
+		 * where the cache miss ratio of the cluster is still below <code>threshold</code> times the ratio of the whole
+		 * mesh. The clusters are then sorted so that clusters facing away from the center of the mesh are drawn first,
+		 * which makes them likely to occlude the remaining clusters.
+		 * This should be called after {@link #optimizeVertexCache(unsigned int *, size_t, unsigned int)}.</p>
+		 *
+		 * @param indices A pointer to the indices that will be reordered.
+		 * @param indexCount The number of indices.
+		 * @param positions A pointer to the tightly packed xyz positions of the vertices.
+		 * @param vertexCount The number of vertices.
+		 * @param threshold The factor by which the cache miss ratio may worsen.
+		 */
+		static void optimizeOverdraw(unsigned int *indices, size_t indexCount, const float *positions, unsigned int vertexCount,
+									 float threshold = 1.05f);
+
+		/**
+		 * Reorders the vertices in the order they are first referenced by the indices.
+		 *
+		 * <p>Vertices which are not referenced are removed. The indices are remapped accordingly.</p>
+		 *
+		 * @param vertexData A pointer to the interleaved vertex data that will be reordered.
+		 * @param vertexCount The number of vertices.
+		 * @param vertexSize The size of a single vertex in bytes.
+		 * @param indices A pointer to the indices that will be remapped.
+		 * @param indexCount The number of indices.
+		 * @return The number of vertices after the optimization.
+		 */
+		static unsigned int optimizeVertexFetch(unsigned char *vertexData, unsigned int vertexCount, unsigned int vertexSize,
+												unsigned int *indices, size_t indexCount);
+
+		/**
+		 * Measures the post transform vertex cache efficiency of the given indices.
+		 *
+		 * <p>This simulates a fifo cache like the one used by most gpus.</p>
+		 *
+		 * @param indices A pointer to the indices.
+		 * @param indexCount The number of indices.
+		 * @param vertexCount The number of vertices.
+		 * @param cacheSize The number of vertices the simulated cache can hold.
+		 * @return The cache efficiency of the indices.
+		 */
+		static VertexCacheStatistics analyzeVertexCache(const unsigned int *indices, size_t indexCount, unsigned int vertexCount,
+														unsigned int cacheSize = CEDAR_MESH_SIMULATED_CACHE_SIZE);
+
+		/**
+		 * Runs the given optimization passes on a mesh.
+		 *
+		 * <p>The passes are run in the order vertex cache, overdraw and vertex fetch.</p>
+		 *
+		 * @param vertexData A pointer to the interleaved vertex data.
+		 * @param vertexCount A pointer to the number of vertices. The number of vertices after the optimization will be
+		 *                    stored here.
+		 * @param vertexSize The size of a single vertex in bytes.
+		 * @param indices A pointer to the indices.
+		 * @param indexCount The number of indices.
+		 * @param positions A pointer to the tightly packed xyz positions of the vertices.
+		 *                  <p>This is only required for the overdraw pass and may be <code>nullptr</code> otherwise.</p>
+		 * @param flags The bit mask of optimization passes that will be run.
+		 * @return The vertex cache efficiency before and after the optimization.
+		 */
+		static MeshOptimizationReport optimize(unsigned char *vertexData, unsigned int *vertexCount, unsigned int vertexSize,
+											   unsigned int *indices, size_t indexCount, const float *positions, unsigned int flags);
+	};
+}
+
+#endif //CEDAR_MESHOPTIMIZER_HPP
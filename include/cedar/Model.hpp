@@ -7,6 +7,7 @@
 
 #include "cedar/GLConstants.hpp"
 #include "cedar/XException.hpp"
+#include "cedar/Vector3f.hpp"
 
 /**
  * Base namespace of the cedar engine.
@@ -106,6 +107,18 @@ namespace cedar
 		 * The number of vertex attributes.
 		 */
 		unsigned int m_vertexAttribCount;
+		/**
+		 * The offset that is added to the dequantized vertex positions of the model.
+		 *
+		 * <p>This is only relevant if the positions are stored as normalized integers.</p>
+		 */
+		Vector3f m_positionOffset;
+		/**
+		 * The scale that is applied to the dequantized vertex positions of the model.
+		 *
+		 * <p>This is only relevant if the positions are stored as normalized integers.</p>
+		 */
+		Vector3f m_positionScale;
 
 	public:
 		/**
@@ -138,7 +151,7 @@ namespace cedar
 		 *
 		 * <p>If data has been uploaded, the vertex array and buffer objects of the model are deleted from the graphics card as well.</p>
 		 */
-		~Model();
+		virtual ~Model();
 
 		/**
 		 * Uploads the given data to the graphics card.
@@ -150,16 +163,22 @@ namespace cedar
 		 *   <li>{@link CEDAR_UNSIGNED_INT}</li>
 		 * </ul></p>
 		 *
+		 * <p>The indices are repacked to the narrowest index type that can hold the largest index, but never narrower
+		 * than <code>narrowestIndexType</code>. 8 bit indices are not used by default, since some graphics cards handle
+		 * them poorly.</p>
+		 *
 		 * @param vertexDataSize The size of the vertex data array in bytes.
 		 * @param vertexData The vertex data of the model.
 		 * @param indexDataSize The size of the index data array in bytes.
 		 * @param indexData The indices of the model.
 		 * @param indexType The data type of the indices.
+		 * @param narrowestIndexType The narrowest data type the indices may be repacked to.
+		 *                           <p>Pass {@link CEDAR_UNSIGNED_INT} to disable the repacking.</p>
 		 *
-		 * @throws ModelUploadException if <code>indexType</code> is an unsupported type.
+		 * @throws ModelUploadException if <code>indexType</code> or <code>narrowestIndexType</code> is an unsupported type.
 		 */
-		void upload(unsigned int vertexDataSize, const void *vertexData, unsigned int indexDataSize, const void *indexData,
-					unsigned int indexType = CEDAR_UNSIGNED_INT);
+		virtual void upload(unsigned int vertexDataSize, const void *vertexData, unsigned int indexDataSize, const void *indexData,
+							unsigned int indexType = CEDAR_UNSIGNED_INT, unsigned int narrowestIndexType = CEDAR_UNSIGNED_SHORT);
 
 		/**
 		 * Updates the vertex buffer of the model.
@@ -170,12 +189,56 @@ namespace cedar
 		 *
 		 * @throws ModelUpdateException if the model is not initialized yet.
 		 */
-		void update(unsigned int offset, unsigned int vertexDataSize, const void *vertexData);
+		virtual void update(unsigned int offset, unsigned int vertexDataSize, const void *vertexData);
 
 		/**
 		 * Renders the model if there is vertex data on the graphics card.
 		 */
-		void render() const;
+		virtual void render() const;
+
+		/**
+		 * Sets the format of the given vertex attribute array.
+		 *
+		 * <p>The attribute reads floating point values from the vertex buffer of the model. If <code>type</code> is an
+		 * integer type the values are either normalized or converted to floats directly, depending on <code>normalized</code>.</p>
+		 *
+		 * @param index The index of the vertex attribute array.
+		 * @param size The number of components of the attribute.
+		 * @param type The data type of each component.
+		 * @param normalized Whether integer values will be normalized.
+		 * @param stride The number of bytes between two consecutive vertices.
+		 * @param offset The offset in bytes of the attribute inside the vertex.
+		 *
+		 * @throws ModelUpdateException if the model is not initialized yet.
+		 * @throws ModelUpdateException if <code>index</code> is greater or equal to the {@link #m_vertexAttribCount vertex attribute count}.
+		 */
+		void setVertexAttribPointer(unsigned int index, int size, unsigned int type, bool normalized, unsigned int stride, unsigned int offset);
+
+		/**
+		 * Sets the format of the given integer vertex attribute array.
+		 *
+		 * <p>The attribute reads integer values from the vertex buffer of the model without converting them.</p>
+		 *
+		 * @param index The index of the vertex attribute array.
+		 * @param size The number of components of the attribute.
+		 * @param type The integer data type of each component.
+		 * @param stride The number of bytes between two consecutive vertices.
+		 * @param offset The offset in bytes of the attribute inside the vertex.
+		 *
+		 * @throws ModelUpdateException if the model is not initialized yet.
+		 * @throws ModelUpdateException if <code>index</code> is greater or equal to the {@link #m_vertexAttribCount vertex attribute count}.
+		 */
+		void setVertexAttribIPointer(unsigned int index, int size, unsigned int type, unsigned int stride, unsigned int offset);
+
+		/**
+		 * Gets the data type of the indices on the graphics card.
+		 *
+		 * <p>This may be narrower than the index type that was passed to
+		 * {@link #upload(unsigned int, const void *, unsigned int, const void *, unsigned int, unsigned int)}.</p>
+		 *
+		 * @return The data type of the indices.
+		 */
+		[[nodiscard]] unsigned int getIndexType() const;
 
 		/**
 		 * Gets the id of the vertex array object on the graphics card.
@@ -214,6 +277,32 @@ namespace cedar
 		 */
 		void setVertexAttribCount(unsigned int newVertexAttribCount);
 
+		/**
+		 * Gets the offset that is added to the dequantized vertex positions.
+		 *
+		 * <p>A position stored as normalized integers is reconstructed with <code>offset + scale * position</code>.</p>
+		 *
+		 * @return The offset of the vertex positions.
+		 */
+		[[nodiscard]] Vector3f getPositionOffset() const;
+
+		/**
+		 * Gets the scale that is applied to the dequantized vertex positions.
+		 *
+		 * <p>A position stored as normalized integers is reconstructed with <code>offset + scale * position</code>.</p>
+		 *
+		 * @return The scale of the vertex positions.
+		 */
+		[[nodiscard]] Vector3f getPositionScale() const;
+
+		/**
+		 * Sets the offset and scale that are used to dequantize the vertex positions.
+		 *
+		 * @param offset The offset that is added to the dequantized vertex positions.
+		 * @param scale The scale that is applied to the dequantized vertex positions.
+		 */
+		void setPositionQuantization(const Vector3f &offset, const Vector3f &scale);
+
 		/**
 		 * Checks if the model is equal to the other model.
 		 *
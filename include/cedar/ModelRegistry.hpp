@@ -9,6 +9,23 @@
 
 #include "cedar/Model.hpp"
 
+/*
+ * Bits of the bmf vertex attribute bit mask
+ */
+#define CEDAR_BMF_UVS 0x01u
+#define CEDAR_BMF_NORMALS 0x02u
+#define CEDAR_BMF_COLOR 0x04u
+#define CEDAR_BMF_ALPHA 0x08u
+#define CEDAR_BMF_STENCIL 0x10u
+#define CEDAR_BMF_DISPLACEMENT 0x20u
+
+/*
+ * Bmf file layout
+ */
+#define CEDAR_BMF_V1_HEADER_SIZE 10
+#define CEDAR_BMF_V2_HEADER_SIZE 40
+#define CEDAR_BMF_V2_MAGIC "BMF2"
+
 /**
  * Base namespace of the cedar engine.
  */
@@ -39,15 +56,43 @@ namespace cedar
 		/**
 		 * Loads a model from the given file.
 		 *
+		 * <p>Both bmf versions are supported. Version 1 files store every attribute as 32 bit floats and the indices
+		 * as 32 bit unsigned integers.
+		 * Version 2 files start with the magic <code>BMF2</code> and store quantized attributes:
+		 * <ul>
+		 *     <li>positions as normalized 16 bit signed integers, dequantized with the
+		 *     {@link Model#getPositionOffset() position offset} and {@link Model#getPositionScale() position scale}</li>
+		 *     <li>uvs as normalized 16 bit unsigned integers</li>
+		 *     <li>normals as octahedral encoded normalized 16 bit signed integers</li>
+		 *     <li>colors and alpha values as normalized 8 bit unsigned integers</li>
+		 *     <li>indices as 16 bit unsigned integers if the vertex count allows it</li>
+		 * </ul>
+		 * The vertex attribute formats of the model are set up according to the version of the file.
+		 * The attribute indices are the same for both versions.</p>
+		 *
+		 * <p>If the path is part of a mounted {@link AssetPack} the model is read from the pack instead of the file system.</p>
+		 *
+		 * <p>Triangle meshes can optionally be run through the {@link MeshOptimizer} before they are uploaded. Files
+		 * which were created by the {@link BMFConverter} are already optimized.</p>
+		 *
+		 * <p>Octahedral normals have to be decoded in the vertex shader:</p>
+		 * <pre>
+		 * vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+		 * float t = max(-n.z, 0.0);
+		 * n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+		 * n = normalize(n);
+		 * </pre>
+		 *
 		 * @param name The unique name of the model.
 		 * @param path The path to the file.
-		 * @param drawingMode The drawing mode of the model.
 		 * @param bitMask A pointer to an unsigned char where the bit mask of the bmf model will be stored.
+		 * @param optimizationFlags The bit mask of {@link MeshOptimizer} passes that will be run on triangle meshes.
 		 * @return A pointer to the loaded model.
 		 *
 		 * @throws ModelLoadException when the model could not be loaded.
 		 */
-		static Model *loadBMFModel(const std::string &name, const std::string &path, unsigned char *bitMask);
+		static Model *loadBMFModel(const std::string &name, const std::string &path, unsigned char *bitMask,
+								   unsigned int optimizationFlags = CEDAR_NONE);
 
 		/**
 		 * Gets the loaded model with the given name.
@@ -5,17 +5,36 @@
 #ifndef CEDAR_PTFFONT_HPP
 #define CEDAR_PTFFONT_HPP
 
+#include <vector>
+
 #include "cedar/Font.hpp"
-#include <fstream>
+#include "cedar/MappedFile.hpp"
 
 /**
  * Base namespace of the cedar engine.
  */
 namespace cedar
 {
+	/**
+	 * Struct representing an entry of the dictionary of a PTF font.
+	 */
+	struct PTFDictionaryEntry
+	{
+		/**
+		 * The unicode code point of the glyph.
+		 */
+		unsigned int m_unicode;
+		/**
+		 * The offset of the glyph data in the font file.
+		 */
+		unsigned int m_glyphPointer;
+	};
 
 	/**
 	 * Class representing a PTF (Pixel Type Format) Font.
+	 *
+	 * <p>The font file is mapped into memory once and stays mapped for the lifetime of the font, so glyphs are
+	 * read straight from the mapping instead of seeking through the file for every glyph.</p>
 	 */
 	class PTFFont : public Font
 	{
@@ -30,34 +49,54 @@ namespace cedar
 		unsigned int m_paletteSize;
 		/**
 		 * The array of colors the ptf font uses.
+		 *
+		 * <p>The array always has 256 entries, colors past the palette size are transparent, so every palette index
+		 * can be looked up without a bounds check.</p>
 		 */
 		unsigned int *m_palette;
 		/**
-		 * The pointer to the dictionary in the ptf font file.
+		 * The dictionary of the ptf font, sorted by code point.
 		 */
-		unsigned int m_dictionaryPointer;
+		std::vector<PTFDictionaryEntry> m_dictionary;
 		/**
-		 * The dictionary of the ptf font.
+		 * A pointer to the mapped font file or <code>nullptr</code> if the font is read from an {@link AssetPack}.
 		 */
-		std::map<unsigned int, unsigned int> m_dictionary;
+		MappedFile *m_fontFile;
 		/**
-		 * The path to the font file of ptf font.
+		 * A pointer to the data of the font file.
 		 */
-		std::string m_fontPath;
+		const unsigned char *m_fontData;
 		/**
-		 * The input file stream of the ptf font.
+		 * The size of the font file in bytes.
 		 */
-		std::ifstream m_fontFile;
+		size_t m_fontDataSize;
 
 		/**
 		 * Loads the palette of the ptf font.
+		 *
+		 * @throws FontCreationException if the palette is out of bounds of the font file.
 		 */
 		void loadPalette();
 
 		/**
 		 * Loads the dictionary of the ptf font.
+		 *
+		 * @param dictionaryPointer The offset of the dictionary in the font file.
+		 *
+		 * @throws FontCreationException if the dictionary is out of bounds of the font file.
+		 */
+		void loadDictionary(unsigned int dictionaryPointer);
+
+		/**
+		 * Gets the offset of the glyph data of the given unicode code point.
+		 *
+		 * @param unicode The unicode code point.
+		 * @return The offset of the glyph data of the code point or of the replacement glyph if the font does not
+		 *         contain the code point.
+		 *
+		 * @throws FontLoadException if neither the code point nor the replacement glyph are in the dictionary.
 		 */
-		void loadDictionary();
+		[[nodiscard]] unsigned int findGlyphPointer(unsigned int unicode) const;
 
 		/**
 		 * Loads the glyph image of the given unicode code point if it does not exist and generates the glyph.
@@ -68,20 +107,24 @@ namespace cedar
 		const Glyph *loadGlyph(unsigned int unicode) override;
 
 		/**
-		 * Creates a glyph from the glyph data {@link #m_glyphData} is currently pointing to and copies it to the atlas.
+		 * Reads the glyph image of the given unicode code point from the font file and expands it with the palette.
+		 *
+		 * <p>The bearing and advance are already scaled, the size and image are not.</p>
 		 *
-		 * @return A constant pointer to the created glyph.
+		 * @param unicode The unicode character of which the glyph image will be read.
+		 * @param glyphData A pointer to the glyph data the image and metrics are written to.
+		 *
+		 * @throws FontLoadException if neither the code point nor the replacement glyph are in the dictionary or the
+		 *                           glyph data is out of bounds of the font file.
 		 */
-		const Glyph *createGlyph() override;
+		void readGlyph(unsigned int unicode, GlyphData *glyphData);
 
 		/**
-		 * Stitches the given glyphs from {@link #m_glyphData} into a single image and uploads it to the glyph atlas.
+		 * Sets nearest filtering on a new atlas page, so the scaled pixel art glyphs stay sharp.
 		 *
-		 * @param firstIndex The first index of the glyphs to stitch.
-		 * @param lastIndex The last (exclusive) index of the glyphs to stitch.
-		 * @param region The coordinates and size of the region that is being uploaded to the glyph atlas.
+		 * @param texture A pointer to the texture of the new page.
 		 */
-		void stitchAtlas(unsigned int firstIndex, unsigned int lastIndex, const Vector4ui &region) override;
+		void initAtlasPage(Texture2D *texture) const override;
 
 	public:
 		/**
@@ -90,6 +133,8 @@ namespace cedar
 		 * @param name The name of the font.
 		 * @param path The path to the font file.
 		 * @param scale The scale by which the size of the PTF font will be scaled.
+		 *
+		 * @throws FontCreationException if the font file could not be opened or is corrupt.
 		 */
 		PTFFont(const std::string &name, const std::string &path, unsigned int scale);
 
@@ -104,7 +149,7 @@ namespace cedar
 		 * @param firstCharacter The unicode of the first character that will be generated.
 		 * @param lastCharacter The unicode of the last character that will be generated.
 		 */
-		void generateGlyphs(unsigned int firstCharacter, unsigned int lastCharacter);
+		void generateGlyphs(unsigned int firstCharacter, unsigned int lastCharacter) override;
 	};
 
 }
@@ -0,0 +1,196 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_PIXELBUFFERRING_HPP
+#define CEDAR_PIXELBUFFERRING_HPP
+
+#include <deque>
+#include <mutex>
+
+#include "cedar/XException.hpp"
+
+/**
+ * The default capacity of a pixel buffer ring in bytes.
+ */
+#define CEDAR_PIXEL_BUFFER_RING_DEFAULT_CAPACITY (64u * 1024u * 1024u)
+/**
+ * The alignment of allocations inside a pixel buffer ring in bytes.
+ */
+#define CEDAR_PIXEL_BUFFER_RING_ALIGNMENT 64
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	/**
+	 * Exception which is thrown when a pixel buffer ring could not be created.
+	 */
+	class PixelBufferException : public XException
+	{
+	public:
+		/**
+		 * Creates a new pixel buffer exception.
+		 *
+		 * @param message The message of the exception.
+		 */
+		explicit PixelBufferException(const std::string &message);
+	};
+
+	/**
+	 * Struct representing a section of a {@link PixelBufferRing}.
+	 */
+	struct PixelBufferAllocation
+	{
+		/**
+		 * The offset of the section from the start of the pixel buffer in bytes.
+		 */
+		size_t m_offset;
+		/**
+		 * The size of the section in bytes.
+		 */
+		size_t m_size;
+		/**
+		 * A pointer to the mapped memory of the section or <code>nullptr</code> if the allocation failed.
+		 */
+		unsigned char *m_data;
+	};
+
+	/**
+	 * Class representing a persistently mapped pixel unpack buffer that is used as a ring buffer for texture uploads.
+	 *
+	 * <p>Sections of the buffer can be allocated and written from any thread. The texture upload from the section
+	 * and the {@link #release(const PixelBufferAllocation &) release} of the section must happen on the OpenGL thread.
+	 * A released section is reused once the graphics card finished reading it, which is tracked with fences.</p>
+	 *
+	 * <p>Since the upload is read from buffer memory that already belongs to the driver, <code>glTexSubImage2D</code>
+	 * returns without copying the pixels and the transfer overlaps with rendering.</p>
+	 */
+	class PixelBufferRing
+	{
+	private:
+		/**
+		 * Struct representing a section of the ring that is in use.
+		 */
+		struct Block
+		{
+			/**
+			 * The offset of the block in bytes.
+			 */
+			size_t m_offset;
+			/**
+			 * The size of the block in bytes.
+			 */
+			size_t m_size;
+			/**
+			 * Whether the block was released.
+			 */
+			bool m_released;
+			/**
+			 * The fence that is signaled when the graphics card finished reading the block.
+			 */
+			void *m_fence;
+		};
+
+		/**
+		 * The id of the pixel buffer on the graphics card.
+		 */
+		unsigned int m_bufferId;
+		/**
+		 * The capacity of the buffer in bytes.
+		 */
+		size_t m_capacity;
+		/**
+		 * A pointer to the persistently mapped buffer.
+		 */
+		unsigned char *m_mappedData;
+		/**
+		 * The offset where the next allocation starts.
+		 */
+		size_t m_head;
+		/**
+		 * The offset where the oldest block that is in use starts.
+		 */
+		size_t m_tail;
+		/**
+		 * The number of bytes that are in use, including padding at the end of the buffer.
+		 */
+		size_t m_used;
+		/**
+		 * The blocks that are in use, ordered from oldest to newest.
+		 */
+		std::deque<Block> m_blocks;
+		/**
+		 * The mutex that guards the allocation state.
+		 */
+		std::mutex m_mutex;
+
+	public:
+		/**
+		 * Creates a new pixel buffer ring.
+		 *
+		 * <p>This must be called on the OpenGL thread.</p>
+		 *
+		 * @param capacity The capacity of the buffer in bytes.
+		 *
+		 * @throws PixelBufferException if the buffer could not be created or mapped.
+		 */
+		explicit PixelBufferRing(size_t capacity = CEDAR_PIXEL_BUFFER_RING_DEFAULT_CAPACITY);
+
+		/**
+		 * Deletes the pixel buffer ring.
+		 *
+		 * <p>This must be called on the OpenGL thread.</p>
+		 */
+		~PixelBufferRing();
+
+		PixelBufferRing(const PixelBufferRing &) = delete;
+
+		PixelBufferRing &operator=(const PixelBufferRing &) = delete;
+
+		/**
+		 * Allocates a section of the buffer.
+		 *
+		 * <p>This can be called from any thread. It never blocks on the graphics card, if there isn't enough free space
+		 * the allocation fails and the caller should fall back to uploading from client memory.</p>
+		 *
+		 * @param size The size of the section in bytes.
+		 * @return The allocated section. {@link PixelBufferAllocation#m_data} is <code>nullptr</code> if there wasn't
+		 *         enough free space.
+		 */
+		PixelBufferAllocation allocate(size_t size);
+
+		/**
+		 * Releases the given section after all uploads from it were issued.
+		 *
+		 * <p>This must be called on the OpenGL thread.</p>
+		 *
+		 * @param allocation The section that will be released.
+		 */
+		void release(const PixelBufferAllocation &allocation);
+
+		/**
+		 * Reclaims the space of all released sections the graphics card finished reading.
+		 *
+		 * <p>This must be called on the OpenGL thread.</p>
+		 */
+		void reclaim();
+
+		/**
+		 * Gets the id of the pixel buffer on the graphics card.
+		 *
+		 * @return The id of the pixel buffer.
+		 */
+		[[nodiscard]] unsigned int getBufferId() const;
+
+		/**
+		 * Gets the capacity of the buffer in bytes.
+		 *
+		 * @return The capacity of the buffer.
+		 */
+		[[nodiscard]] size_t getCapacity() const;
+	};
+}
+
+#endif //CEDAR_PIXELBUFFERRING_HPP
@@ -6,6 +6,7 @@
 #define CEDAR_RENDERER2D_HPP
 
 #include <memory>
+#include <vector>
 #include "cedar/Vector4f.hpp"
 #include "cedar/ShaderProgram.hpp"
 #include "cedar/Matrix4f.hpp"
@@ -13,6 +14,19 @@
 #include "cedar/Quad.hpp"
 #include "cedar/Font.hpp"
 
+/**
+ * Flag in the texture unit of a quad whose texture is a signed distance field.
+ */
+#define CEDAR_QUAD_DISTANCE_FIELD 0x10000
+/**
+ * Flag in the texture unit of a quad whose texture has premultiplied alpha, like a cached screen.
+ */
+#define CEDAR_QUAD_PREMULTIPLIED 0x20000
+/**
+ * Mask of the bits in the texture unit of a quad that contain the actual texture unit.
+ */
+#define CEDAR_QUAD_TEXTURE_UNIT_MASK 0xFFFF
+
 /**
  * Base namespace of the cedar engine.
  */
@@ -97,6 +111,14 @@ namespace cedar
 		 * The id of the vertex buffer object that stores the information about all instances rendered in this batch.
 		 */
 		static unsigned int instanceVboId;
+		/**
+		 * The stack of clip rectangles, the last one is the active one.
+		 *
+		 * <p>x and y are the coordinates of the top left corner, z and w are the coordinates of the bottom right
+		 * corner.</p>
+		 */
+		static std::vector<Vector4f> clipRects;
+
 		/**
 		 * Creates a new 2D renderer.
 		 */
@@ -113,6 +135,28 @@ namespace cedar
 		 */
 		static void initShader(int maxTextureUnits);
 
+		/**
+		 * Gets the texture unit the given texture is bound to in the current batch.
+		 *
+		 * <p>If the texture is not part of the batch yet it is assigned to the next free unit. If all units are
+		 * taken, the current batch is flushed and a new one is started.</p>
+		 *
+		 * @param textureId The id of the texture.
+		 * @return The index of the texture unit.
+		 */
+		static int getTextureUnit(unsigned int textureId);
+
+		/**
+		 * Clips the quad to the active clip rectangle.
+		 *
+		 * <p>The corners of the quad are moved to the edges of the rectangle and the uv coordinates are moved by the
+		 * same fraction, so the visible part of the quad looks exactly as before.</p>
+		 *
+		 * @param quad A pointer to the quad.
+		 * @return <code>true</code> if a part of the quad is inside the clip rectangle.
+		 */
+		static bool clipQuad(Quad *quad);
+
 	public:
 
 		/**
@@ -148,6 +192,26 @@ namespace cedar
 		 */
 		static void flush();
 
+		/**
+		 * Restricts all following draws to a rectangle.
+		 *
+		 * <p>Quads are clipped on the cpu before they are added to the batch, so clipping does not flush the batch
+		 * and works inside the dirty rectangles of cached screens as well. Clip rectangles are nested, the new
+		 * rectangle is intersected with the active one. Every push must be followed by a
+		 * {@link #popClipRect()}.</p>
+		 *
+		 * @param posX The x coordinate of the rectangle in pixel.
+		 * @param posY The y coordinate of the rectangle in pixel.
+		 * @param width The width of the rectangle in pixel.
+		 * @param height The height of the rectangle in pixel.
+		 */
+		static void pushClipRect(float posX, float posY, float width, float height);
+
+		/**
+		 * Restores the clip rectangle that was active before the last {@link #pushClipRect(float, float, float, float)}.
+		 */
+		static void popClipRect();
+
 		/**
 		 * Draws a colored rectangle.
 		 *
@@ -229,9 +293,10 @@ namespace cedar
 		 * @param color The color of the text.
 		 * @param alignment The alignment of the text.
 		 * @param size A pointer to a vector where the size of the text will be stored if it is not <code>nullptr</code>.
+		 * @param scale The factor the glyphs are scaled by. Only distance field fonts stay sharp when scaled.
 		 */
 		static void drawText(float posX, float posY, float posZ, const std::string &text, const std::shared_ptr<Font> &font, const Vector4f &color,
-					  unsigned int alignment = CEDAR_ALIGNMENT_TOP | CEDAR_ALIGNMENT_LEFT, Vector2f *size = nullptr);
+					  unsigned int alignment = CEDAR_ALIGNMENT_TOP | CEDAR_ALIGNMENT_LEFT, Vector2f *size = nullptr, float scale = 1.0f);
 
 		/**
 		 * Generates a text buffer that can be rendered many times.
@@ -254,9 +319,27 @@ namespace cedar
 		 * @param text The string of the text.
 		 * @param font A shared pointer to the font of the text.
 		 * @param alignment The alignment of the text.
+		 * @param scale The factor the glyphs are scaled by. Only distance field fonts stay sharp when scaled.
 		 * @return A pointer to the generated text buffer.
 		 */
-		static TextBuffer *generateTextBuffer(const std::string &text, const std::shared_ptr<Font> &font, unsigned int alignment = CEDAR_ALIGNMENT_TOP | CEDAR_ALIGNMENT_LEFT);
+		static TextBuffer *generateTextBuffer(const std::string &text, const std::shared_ptr<Font> &font,
+											  unsigned int alignment = CEDAR_ALIGNMENT_TOP | CEDAR_ALIGNMENT_LEFT, float scale = 1.0f);
+
+		/**
+		 * Generates the text into an existing text buffer.
+		 *
+		 * <p>The quads of the buffer are reused if the text fits into its capacity, so changing the text of an
+		 * element does not allocate memory unless the text gets longer than any text the buffer held before.</p>
+		 *
+		 * @param textBuffer A pointer to the text buffer that will be overwritten.
+		 * @param text The string of the text.
+		 * @param font A shared pointer to the font of the text.
+		 * @param alignment The alignment of the text, see
+		 *                  {@link #generateTextBuffer(const std::string &, const std::shared_ptr<Font> &, unsigned int, float)}.
+		 * @param scale The factor the glyphs are scaled by. Only distance field fonts stay sharp when scaled.
+		 */
+		static void updateTextBuffer(TextBuffer *textBuffer, const std::string &text, const std::shared_ptr<Font> &font,
+									 unsigned int alignment = CEDAR_ALIGNMENT_TOP | CEDAR_ALIGNMENT_LEFT, float scale = 1.0f);
 
 		/**
 		 * Draws the text stored in the text buffer.
@@ -268,6 +351,22 @@ namespace cedar
 		 * @param color The color of the text.
 		 */
 		static void drawText(float offsetX, float offsetY, float offsetZ, const TextBuffer *textBuffer, const Vector4f &color);
+
+		/**
+		 * Draws a texture that was rendered to with the renderer, like the cache of a {@link Screen}.
+		 *
+		 * <p>The texture is expected to be upside down and to have premultiplied alpha, which is what the renderer
+		 * produces when blending into a transparent framebuffer with a separate alpha blend function of
+		 * <code>GL_ONE, GL_ONE_MINUS_SRC_ALPHA</code>.</p>
+		 *
+		 * @param posX The x coordinate of the layer.
+		 * @param posY The y coordinate of the layer.
+		 * @param posZ The z index of the layer.
+		 * @param width The width of the layer.
+		 * @param height The height of the layer.
+		 * @param texture A shared pointer to the texture of the layer.
+		 */
+		static void drawLayer(float posX, float posY, float posZ, float width, float height, const std::shared_ptr<Texture> &texture);
 	};
 }
 
@@ -5,9 +5,35 @@
 #ifndef CEDAR_SCREEN_HPP
 #define CEDAR_SCREEN_HPP
 
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "cedar/Element.hpp"
+#include "cedar/ElementArena.hpp"
+#include "cedar/Texture2D.hpp"
+#include "cedar/TweenManager.hpp"
+#include "cedar/Vector4f.hpp"
+
+/**
+ * The width and height of the cells of the grid a screen sorts its elements into in pixel.
+ */
+#define CEDAR_SCREEN_GRID_CELL_SIZE 64
+/**
+ * The maximum number of grid cells an element is inserted into.
+ *
+ * <p>Larger elements, like backgrounds or panels, are kept in a separate list which is checked on every hit test
+ * instead.</p>
+ */
+#define CEDAR_SCREEN_GRID_MAX_CELLS 64
+/**
+ * The maximum number of separate dirty rectangles of a cached screen.
+ *
+ * <p>If more rectangles are invalidated before the cache is rendered, they are merged into their bounding box.</p>
+ */
+#define CEDAR_SCREEN_MAX_DIRTY_RECTS 8
 
 /**
  * Base namespace of the cedar engine.
@@ -87,6 +113,96 @@ namespace cedar
 		 * List with pointers to all elements inside the screen.
 		 */
 		std::vector<Element*> m_elements;
+		/**
+		 * The cells of the grid the elements are sorted into, mapped by their packed column and row.
+		 */
+		std::unordered_map<unsigned long long, std::vector<Element*>> m_gridCells;
+		/**
+		 * List with pointers to all elements that cover too many grid cells to be inserted into the grid.
+		 */
+		std::vector<Element*> m_largeElements;
+		/**
+		 * Whether the screen is rendered into its own texture.
+		 */
+		bool m_cached;
+		/**
+		 * The id of the framebuffer the screen is rendered into, 0 if the screen has no cache.
+		 */
+		unsigned int m_cacheFramebuffer;
+		/**
+		 * A shared pointer to the texture the screen is rendered into.
+		 */
+		std::shared_ptr<Texture> m_cacheTexture;
+		/**
+		 * The rectangles of the cache that have to be rendered again.
+		 *
+		 * <p>x and y are the coordinates of the top left corner, z and w are the coordinates of the bottom right
+		 * corner.</p>
+		 */
+		std::vector<Vector4f> m_dirtyRects;
+		/**
+		 * The tween manager animating the elements of the screen.
+		 */
+		TweenManager m_tweenManager;
+		/**
+		 * The arena the elements created by the screen are allocated from.
+		 */
+		ElementArena m_elementArena;
+		/**
+		 * List with pointers to all elements that were created by the screen, in the order they were created.
+		 */
+		std::vector<Element*> m_arenaElements;
+
+		/**
+		 * Deletes the framebuffer and texture of the cache.
+		 */
+		void deleteCache();
+
+		/**
+		 * Resets the screen related state of an element that is no longer part of the screen.
+		 *
+		 * @param element A pointer to the element.
+		 */
+		void detachElement(Element *element);
+
+		/**
+		 * Inserts the element into all grid cells it overlaps.
+		 *
+		 * @param element A pointer to the element.
+		 */
+		void insertIntoGrid(Element *element);
+
+		/**
+		 * Removes the element from all grid cells it was inserted into.
+		 *
+		 * @param element A pointer to the element.
+		 */
+		void removeFromGrid(Element *element);
+
+		/**
+		 * Moves the element to the grid cells of its new bounds.
+		 *
+		 * <p>This is called by the element whenever its position or size changes.</p>
+		 *
+		 * @param element A pointer to the element.
+		 */
+		void updateElementBounds(Element *element);
+
+		/**
+		 * Finds the element that receives input events at the given position.
+		 *
+		 * <p>Only the elements in the grid cell of the position are tested, so the cost does not depend on the
+		 * number of elements in the screen. If multiple elements overlap the element with the lowest z index is
+		 * returned, and among elements with the same z index the one that was added last, as new elements are
+		 * inserted in front of those with the same z index. This is the same element that testing all elements in
+		 * order would find.</p>
+		 *
+		 * @param cursorX The x coordinate of the position.
+		 * @param cursorY The y coordinate of the position.
+		 * @return A pointer to the visible and interactable element at the position or <code>nullptr</code> if there
+		 *         is none.
+		 */
+		[[nodiscard]] Element *findElementAt(float cursorX, float cursorY) const;
 
 	public:
 		/**
@@ -117,6 +233,13 @@ namespace cedar
 		 */
 		Screen(const std::string &name, unsigned char zIndex);
 
+		/**
+		 * Destroys the screen, all elements it created and its cache.
+		 *
+		 * <p>Must be called on the OpenGL thread if the screen is cached.</p>
+		 */
+		virtual ~Screen();
+
 		/**
 		 * Method which is called when a mouse button is pressed down.
 		 *
@@ -173,6 +296,9 @@ namespace cedar
 		/**
 		 * Method which updates all elements in the screen.
 		 *
+		 * <p>The tweens of the screen are applied first, then the layout of the containers is updated and the
+		 * update callbacks of the elements are called last.</p>
+		 *
 		 * @param currentTime The current time of the frame in microseconds.
 		 * @param tickCount The current tick count.
 		 */
@@ -181,19 +307,122 @@ namespace cedar
 		/**
 		 * Renders all elements of the screen that are visible.
 		 *
+		 * <p>Cached screens only draw their cache texture, which must have been updated by
+		 * {@link #renderCache(unsigned long, int, int)} before.</p>
+		 *
 		 * @param currentTime The current time of the frame in microseconds.
 		 */
 		virtual void render(unsigned long currentTime);
 
+		/**
+		 * Renders the dirty rectangles of the cache of the screen.
+		 *
+		 * <p>Every dirty rectangle is cleared and only the elements overlapping it are rendered again, clipped to
+		 * the rectangle. A screen without changes does not render anything. The cache is created the first time the
+		 * screen is rendered and recreated when the size of the window changes.</p>
+		 *
+		 * <p>This must be called on the OpenGL thread, outside of the batch of the {@link Renderer2D}.</p>
+		 *
+		 * @param currentTime The current time of the frame in microseconds.
+		 * @param width The width of the window in pixel.
+		 * @param height The height of the window in pixel.
+		 */
+		virtual void renderCache(unsigned long currentTime, int width, int height);
+
+		/**
+		 * Checks whether the screen is rendered into its own texture.
+		 *
+		 * @return <code>true</code> if the screen is cached.
+		 */
+		[[nodiscard]] bool isCached() const;
+
+		/**
+		 * Sets whether the screen is rendered into its own texture.
+		 *
+		 * <p>Cached screens are only rendered again where their elements changed and are drawn with a single quad
+		 * otherwise. This is a good fit for mostly static menus and HUDs. Elements whose look changes every frame
+		 * should not be part of a cached screen, as they have to invalidate the cache every frame.</p>
+		 *
+		 * @param cached Whether the screen will be cached.
+		 */
+		void setCached(bool cached);
+
+		/**
+		 * Marks the whole cache of the screen as dirty.
+		 */
+		void invalidate();
+
+		/**
+		 * Marks a rectangle of the cache of the screen as dirty.
+		 *
+		 * @param posX The x coordinate of the rectangle in pixel.
+		 * @param posY The y coordinate of the rectangle in pixel.
+		 * @param width The width of the rectangle in pixel.
+		 * @param height The height of the rectangle in pixel.
+		 */
+		void invalidate(float posX, float posY, float width, float height);
+
+		/**
+		 * Gets the tween manager animating the elements of the screen.
+		 *
+		 * @return A pointer to the tween manager of the screen.
+		 */
+		[[nodiscard]] TweenManager *getTweenManager();
+
 		/**
 		 * Adds the element to the screen.
 		 *
 		 * @param element A pointer to the element that will be added to the screen.
 		 *
-		 * @throws ElementAddException if <code>element</code> is a <code>nullptr</code>.
+		 * @throws ElementAddException if <code>element</code> is a <code>nullptr</code> or was already added to
+		 *                              another screen.
 		 */
 		virtual void addElement(Element *element);
 
+		/**
+		 * Removes the element from the screen.
+		 *
+		 * <p>The tweens of the element are cancelled. Elements are removed from their screen automatically when they
+		 * are destroyed. An element created by the screen stays in its memory until the elements of the screen are
+		 * cleared.</p>
+		 *
+		 * @param element A pointer to the element that will be removed.
+		 */
+		virtual void removeElement(Element *element);
+
+		/**
+		 * Creates an element in the memory of the screen and adds it to the screen.
+		 *
+		 * <p>The element is allocated from the element arena of the screen instead of the heap, so the elements of
+		 * a screen are placed next to each other in memory. The screen owns the element, it must not be deleted and
+		 * is destroyed by {@link #clearElements()} or when the screen is destroyed.</p>
+		 *
+		 * @tparam T The type of the element.
+		 * @tparam Args The types of the arguments of the constructor of the element.
+		 * @param args The arguments of the constructor of the element.
+		 * @return A pointer to the created element.
+		 */
+		template<typename T, typename... Args>
+		T *createElement(Args &&... args)
+		{
+			static_assert(std::is_base_of<Element, T>::value, "Only elements can be created by a screen!");
+
+			void *memory = this->m_elementArena.allocate(sizeof(T), alignof(T));
+			T *element = new(memory) T(std::forward<Args>(args)...);
+			this->m_arenaElements.push_back(element);
+			this->addElement(element);
+			return element;
+		}
+
+		/**
+		 * Removes all elements from the screen.
+		 *
+		 * <p>Elements created by the screen are destroyed and their memory is reused by the next elements the
+		 * screen creates. Elements that were added with {@link #addElement(Element *)} are only removed and can be
+		 * added to a screen again. This tears a screen down in one go, for example to rebuild a dynamic menu.</p>
+		 */
+		void clearElements();
+
 		/**
 		 * Gets the name of the screen.
 		 *
@@ -237,6 +466,7 @@ namespace cedar
 		void setVisibility(bool visible);
 
 		friend class ScreenRegistry;
+		friend class Element;
 	};
 }
 
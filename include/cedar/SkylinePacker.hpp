@@ -0,0 +1,109 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_SKYLINEPACKER_HPP
+#define CEDAR_SKYLINEPACKER_HPP
+
+#include <vector>
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	/**
+	 * Struct representing a segment of the skyline of a {@link SkylinePacker}.
+	 */
+	struct SkylineNode
+	{
+		/**
+		 * The x coordinate of the left end of the segment.
+		 */
+		int m_x;
+		/**
+		 * The y coordinate of the segment, everything above it is occupied.
+		 */
+		int m_y;
+		/**
+		 * The width of the segment.
+		 */
+		int m_width;
+	};
+
+	/**
+	 * Class for packing rectangles into a fixed size area.
+	 *
+	 * <p>Rectangles are placed with the skyline bottom left heuristic. The packer keeps a list of horizontal segments
+	 * describing the highest occupied row for every column, and a rectangle is placed where its bottom edge ends up
+	 * the lowest. Ties are broken in favour of the narrower segment, which keeps gaps small.</p>
+	 */
+	class SkylinePacker
+	{
+	private:
+		/**
+		 * The width of the area.
+		 */
+		int m_width;
+		/**
+		 * The height of the area.
+		 */
+		int m_height;
+		/**
+		 * The segments of the skyline, sorted by their x coordinate.
+		 */
+		std::vector<SkylineNode> m_skyline;
+
+		/**
+		 * Finds the best position for a rectangle.
+		 *
+		 * @param width The width of the rectangle.
+		 * @param height The height of the rectangle.
+		 * @param x A pointer to the integer the x coordinate of the position is written to.
+		 * @param y A pointer to the integer the y coordinate of the position is written to.
+		 * @return The index of the skyline node the rectangle starts at or -1 if it doesn't fit.
+		 */
+		int findPosition(int width, int height, int *x, int *y) const;
+
+	public:
+		/**
+		 * Creates a new empty skyline packer.
+		 *
+		 * @param width The width of the area.
+		 * @param height The height of the area.
+		 */
+		SkylinePacker(int width, int height);
+
+		/**
+		 * Places a rectangle.
+		 *
+		 * @param width The width of the rectangle.
+		 * @param height The height of the rectangle.
+		 * @param x A pointer to the integer the x coordinate of the top left corner is written to.
+		 * @param y A pointer to the integer the y coordinate of the top left corner is written to.
+		 * @return <code>true</code> if the rectangle was placed, <code>false</code> if there is no room left for it.
+		 */
+		bool insert(int width, int height, int *x, int *y);
+
+		/**
+		 * Removes all rectangles.
+		 */
+		void clear();
+
+		/**
+		 * Gets the width of the area.
+		 *
+		 * @return The width of the area.
+		 */
+		[[nodiscard]] int getWidth() const;
+
+		/**
+		 * Gets the height of the area.
+		 *
+		 * @return The height of the area.
+		 */
+		[[nodiscard]] int getHeight() const;
+	};
+}
+
+#endif //CEDAR_SKYLINEPACKER_HPP
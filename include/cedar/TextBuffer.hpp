@@ -5,6 +5,8 @@
 #ifndef CEDAR_TEXTBUFFER_HPP
 #define CEDAR_TEXTBUFFER_HPP
 
+#include <vector>
+
 #include "cedar/Quad.hpp"
 
 /**
@@ -18,18 +20,24 @@ namespace cedar
 	 * <p>Since when rendering a string the method has to loop over all codepoints and find the
 	 * corresponding glyph models, this is a fast alternative for static strings that need to
 	 * be rendered a lot without changing the text itself.</p>
+	 *
+	 * <p>The texture unit of each quad stores the index of the glyph atlas page the glyph is on.</p>
 	 */
 	class TextBuffer
 	{
 	private:
 		/**
-		 * The texture id of the glyph atlas this text buffer uses.
+		 * The texture ids of the glyph atlas pages this text buffer uses.
 		 */
-		unsigned int m_glyphAtlasId;
+		std::vector<unsigned int> m_glyphAtlasIds;
 		/**
 		 * The number of glyphs stored in this text buffer.
 		 */
 		unsigned int m_glyphCount;
+		/**
+		 * The number of glyphs that fit into the quads of this text buffer.
+		 */
+		unsigned int m_capacity;
 		/**
 		 * A pointer to the quads of the glyphs.
 		 */
@@ -40,15 +48,20 @@ namespace cedar
 		Vector2f m_size;
 
 	public:
+		/**
+		 * Creates a new empty text buffer.
+		 */
+		TextBuffer();
+
 		/**
 		 * Creates a new text buffer.
 		 *
-		 * @param glyphAtlasId The texture id of the glyph atlas this buffer uses.
+		 * @param glyphAtlasIds The texture ids of the glyph atlas pages this buffer uses.
 		 * @param glyphCount The number of glyphs stored in this buffer.
 		 * @param quads A pointer to the array of quads stored in this buffer.
 		 * @param size The size of the text in this buffer in pixel.
 		 */
-		TextBuffer(unsigned int glyphAtlasId, unsigned int glyphCount, Quad *quads, const Vector2f &size);
+		TextBuffer(const std::vector<unsigned int> &glyphAtlasIds, unsigned int glyphCount, Quad *quads, const Vector2f &size);
 
 		/**
 		 * Destroys the text buffer.
@@ -56,11 +69,40 @@ namespace cedar
 		~TextBuffer();
 
 		/**
-		 * Gets the texture id of the glyph atlas of this buffer.
+		 * Makes sure that the given number of glyphs fit into this buffer.
 		 *
-		 * @return The texture id of the glyph atlas of this buffer.
+		 * <p>The quads are only reallocated if the buffer is too small, so a buffer that is filled again with a
+		 * text of the same or a smaller length reuses its quads in place. The content of the quads is undefined
+		 * afterwards.</p>
+		 *
+		 * @param capacity The number of glyphs.
+		 * @return A pointer to the quads of this buffer.
 		 */
-		[[nodiscard]] unsigned int getGlyphAtlas() const;
+		Quad *reserve(unsigned int capacity);
+
+		/**
+		 * Sets the content of this buffer after its quads were written.
+		 *
+		 * @param glyphAtlasIds The texture ids of the glyph atlas pages this buffer uses.
+		 * @param glyphCount The number of glyphs stored in this buffer.
+		 * @param size The size of the text in this buffer in pixel.
+		 */
+		void set(const std::vector<unsigned int> &glyphAtlasIds, unsigned int glyphCount, const Vector2f &size);
+
+		/**
+		 * Gets the texture id of a glyph atlas page of this buffer.
+		 *
+		 * @param page The index of the page.
+		 * @return The texture id of the glyph atlas page.
+		 */
+		[[nodiscard]] unsigned int getGlyphAtlas(unsigned int page) const;
+
+		/**
+		 * Gets the number of glyph atlas pages of this buffer.
+		 *
+		 * @return The number of glyph atlas pages.
+		 */
+		[[nodiscard]] unsigned int getGlyphAtlasCount() const;
 
 		/**
 		 * Gets the number of glyphs stored in this buffer.
@@ -69,6 +111,13 @@ namespace cedar
 		 */
 		[[nodiscard]] unsigned int getGlyphCount() const;
 
+		/**
+		 * Gets the number of glyphs that fit into this buffer without reallocating its quads.
+		 *
+		 * @return The capacity of this buffer.
+		 */
+		[[nodiscard]] unsigned int getCapacity() const;
+
 		/**
 		 * Gets the quads of this buffer.
 		 *
@@ -0,0 +1,287 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_TEXTVIEW_HPP
+#define CEDAR_TEXTVIEW_HPP
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cedar/Element.hpp"
+#include "cedar/Font.hpp"
+#include "cedar/TextBuffer.hpp"
+#include "cedar/Vector4f.hpp"
+
+/**
+ * The size of the chunks a text view stores its text in in bytes.
+ */
+#define CEDAR_TEXT_VIEW_CHUNK_SIZE 65536
+/**
+ * The number of lines a text view scrolls per step of the mouse wheel.
+ */
+#define CEDAR_TEXT_VIEW_SCROLL_LINES 3
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	/**
+	 * Struct representing a line of a {@link TextView}.
+	 */
+	struct TextViewLine
+	{
+		/**
+		 * The sequence number of the chunk the line is stored in.
+		 */
+		size_t m_chunk;
+		/**
+		 * The offset of the first byte of the line in its chunk.
+		 */
+		size_t m_offset;
+		/**
+		 * The length of the line in bytes.
+		 */
+		size_t m_length;
+		/**
+		 * A pointer to the cached layout of the line or <code>nullptr</code> if the line was not laid out.
+		 */
+		TextBuffer *m_textBuffer;
+	};
+
+	/**
+	 * Class representing an element that shows large amounts of text, like logs or consoles.
+	 *
+	 * <p>Unlike a {@link Label} the text is not laid out as a whole. It is stored in chunks of
+	 * {@link CEDAR_TEXT_VIEW_CHUNK_SIZE} bytes together with an index of where each line starts, so appending a line
+	 * never moves the text that is already stored. Only the lines that are visible are laid out, and their layouts
+	 * are cached until they are scrolled out of view again, so the cost of rendering and scrolling depends on the
+	 * height of the view instead of the length of the text.</p>
+	 *
+	 * <p>The view scrolls by whole lines. Lines wider than the view are not wrapped.</p>
+	 */
+	class TextView : public Element
+	{
+	private:
+		/**
+		 * The chunks storing the text of the view.
+		 */
+		std::deque<std::string> m_chunks;
+		/**
+		 * The sequence number of the first chunk in {@link #m_chunks}.
+		 */
+		size_t m_firstChunk;
+		/**
+		 * The index of all lines of the view.
+		 */
+		std::deque<TextViewLine> m_lines;
+		/**
+		 * The maximum number of lines the view keeps, 0 if the number of lines is unlimited.
+		 */
+		size_t m_maxLines;
+		/**
+		 * The index of the first visible line.
+		 */
+		size_t m_scrollLine;
+		/**
+		 * Whether the view keeps scrolling to the last line when lines are appended.
+		 */
+		bool m_followTail;
+		/**
+		 * The index of the first line that may have a cached layout.
+		 */
+		size_t m_cachedFirstLine;
+		/**
+		 * The index after the last line that may have a cached layout.
+		 */
+		size_t m_cachedLastLine;
+		/**
+		 * The text buffers of evicted layouts, which are reused for the next lines that are laid out.
+		 */
+		std::vector<TextBuffer *> m_freeTextBuffers;
+		/**
+		 * A shared pointer to the font of the text.
+		 */
+		std::shared_ptr<Font> m_font;
+		/**
+		 * The color of the text.
+		 */
+		Vector4f m_textColor;
+
+		/**
+		 * Stores a single line without line breaks.
+		 *
+		 * @param line The text of the line.
+		 */
+		void storeLine(const std::string &line);
+
+		/**
+		 * Evicts the cached layouts of all lines in the given range.
+		 *
+		 * <p>The text buffers of the layouts are kept for reuse.</p>
+		 *
+		 * @param firstLine The index of the first line.
+		 * @param lastLine The index after the last line.
+		 */
+		void evictLayouts(size_t firstLine, size_t lastLine);
+
+	public:
+		/**
+		 * Creates a new empty text view.
+		 *
+		 * @param originX The x coordinate of the origin of the element in pixel.
+		 * @param originY The y coordinate of the origin of the element in pixel.
+		 * @param zIndex The z index of the element.
+		 * @param width The width of the view in pixel.
+		 * @param height The height of the view in pixel.
+		 * @param font A shared pointer to the font of the text.
+		 * @param textColor The color of the text.
+		 * @param alignment The alignment of the element.
+		 *
+		 * @throws ElementCreationException if <code>font</code> is a <code>nullptr</code>.
+		 */
+		TextView(float originX, float originY, unsigned char zIndex, float width, float height, const std::shared_ptr<Font> &font,
+				 const Vector4f &textColor, unsigned int alignment = CEDAR_ALIGNMENT_TOP | CEDAR_ALIGNMENT_LEFT);
+
+		/**
+		 * Destroys the text view and all cached layouts.
+		 */
+		~TextView();
+
+		/**
+		 * Renders the visible lines of the text view.
+		 *
+		 * @param currentTime The current time of the frame in microseconds.
+		 */
+		void render(unsigned long currentTime) override;
+
+		/**
+		 * Appends text to the view.
+		 *
+		 * <p>Every line break in the text starts a new line, so a single call can append many lines.</p>
+		 *
+		 * @param text The text that will be appended.
+		 */
+		void appendLine(const std::string &text);
+
+		/**
+		 * Removes all lines of the view.
+		 */
+		void clear();
+
+		/**
+		 * Gets the number of lines of the view.
+		 *
+		 * @return The number of lines.
+		 */
+		[[nodiscard]] size_t getLineCount() const;
+
+		/**
+		 * Gets the text of a line.
+		 *
+		 * @param index The index of the line.
+		 * @return The text of the line or an empty string if the index is out of bounds.
+		 */
+		[[nodiscard]] std::string getLine(size_t index) const;
+
+		/**
+		 * Gets the maximum number of lines the view keeps.
+		 *
+		 * @return The maximum number of lines, 0 if the number of lines is unlimited.
+		 */
+		[[nodiscard]] size_t getMaxLines() const;
+
+		/**
+		 * Sets the maximum number of lines the view keeps.
+		 *
+		 * <p>If more lines are appended the oldest lines are removed.</p>
+		 *
+		 * @param maxLines The maximum number of lines, 0 if the number of lines is unlimited.
+		 */
+		void setMaxLines(size_t maxLines);
+
+		/**
+		 * Gets the number of lines that fit into the view.
+		 *
+		 * @return The number of visible lines.
+		 */
+		[[nodiscard]] size_t getVisibleLineCount() const;
+
+		/**
+		 * Gets the index of the first visible line.
+		 *
+		 * @return The index of the first visible line.
+		 */
+		[[nodiscard]] size_t getScrollLine() const;
+
+		/**
+		 * Scrolls the view so the given line is the first visible line.
+		 *
+		 * <p>The line is clamped so the view never scrolls past the last line.</p>
+		 *
+		 * @param line The index of the line.
+		 */
+		void setScrollLine(size_t line);
+
+		/**
+		 * Scrolls the view by the given number of lines.
+		 *
+		 * @param lines The number of lines, negative values scroll up.
+		 */
+		void scrollBy(long lines);
+
+		/**
+		 * Checks whether the view keeps scrolling to the last line when lines are appended.
+		 *
+		 * @return <code>true</code> if the view follows the last line.
+		 */
+		[[nodiscard]] bool isFollowingTail() const;
+
+		/**
+		 * Sets whether the view keeps scrolling to the last line when lines are appended.
+		 *
+		 * <p>Scrolling up stops following the last line, scrolling back down to it resumes it.</p>
+		 *
+		 * @param followTail Whether the view follows the last line.
+		 */
+		void setFollowTail(bool followTail);
+
+		/**
+		 * Gets the font of the view.
+		 *
+		 * @return A shared pointer to the font of the view.
+		 */
+		[[nodiscard]] std::shared_ptr<Font> getFont() const;
+
+		/**
+		 * Sets the font of the view.
+		 *
+		 * @param newFont A shared pointer to the new font of the view.
+		 *
+		 * @throws ElementUpdateException if the provided font is a <code>nullptr</code>.
+		 */
+		void setFont(const std::shared_ptr<Font> &newFont);
+
+		/**
+		 * Sets the color of the view's text.
+		 *
+		 * @param color The new color of the view's text.
+		 */
+		void setTextColor(const Vector4f &color);
+
+		/**
+		 * Gets the values a tween writes to when it animates a property of the view.
+		 *
+		 * <p>The color properties animate the color of the view's text.</p>
+		 *
+		 * @param property The animated property.
+		 * @return The target of the tween, whose value is <code>nullptr</code> if the property is not supported.
+		 */
+		TweenTarget getTweenTarget(unsigned int property) override;
+	};
+}
+
+#endif //CEDAR_TEXTVIEW_HPP
@@ -5,6 +5,8 @@
 #ifndef CEDAR_TEXTURE_HPP
 #define CEDAR_TEXTURE_HPP
 
+#include <cstddef>
+
 #include "cedar/XException.hpp"
 #include "cedar/GLConstants.hpp"
 
@@ -162,6 +164,13 @@ namespace cedar
 		 * upload data to it.</p>
 		 */
 		bool m_immutable;
+		/**
+		 * The frame the texture was last used in.
+		 *
+		 * <p>This is used by the {@link TextureRegistry} to decide which textures to evict when the memory budget is
+		 * exceeded.</p>
+		 */
+		mutable unsigned long long m_lastUsedFrame;
 
 		/**
 		 * Creates a new texture.
@@ -179,6 +188,43 @@ namespace cedar
 		 * @return The unsized internal format of the given sized internal format.
 		 */
 		static unsigned int sizedToUnsized(unsigned int sizedInternalFormat);
+
+		/**
+		 * Gets the size of a 4x4 pixel block of the given compressed internal format in bytes.
+		 *
+		 * @param internalFormat The compressed internal format.
+		 * @return The size of a block in bytes or 0 if the format is not a compressed format.
+		 */
+		static unsigned int getCompressedBlockSize(unsigned int internalFormat);
+
+		/**
+		 * Checks whether the given internal format is a block compressed format.
+		 *
+		 * @param internalFormat The internal format.
+		 * @return <code>true</code> if the format is one of the <code>CEDAR_COMPRESSED_*</code> formats.
+		 */
+		static bool isCompressedFormat(unsigned int internalFormat);
+
+		/**
+		 * Checks whether the given internal format stores signed or unsigned integers.
+		 *
+		 * <p>Integer textures can't be filtered linearly, neither by samplers nor by framebuffer blits.</p>
+		 *
+		 * @param internalFormat The internal format.
+		 * @return <code>true</code> if the format is one of the <code>CEDAR_*I</code> or <code>CEDAR_*UI</code> formats.
+		 */
+		static bool isIntegerFormat(unsigned int internalFormat);
+
+		/**
+		 * Gets the number of bytes a single pixel of the given uncompressed internal format occupies.
+		 *
+		 * <p>Unsized formats are assumed to be stored with 8 bits per channel.</p>
+		 *
+		 * @param internalFormat The uncompressed internal format.
+		 * @return The size of a pixel in bytes or 0 if the format is a compressed format.
+		 */
+		static unsigned int getBytesPerPixel(unsigned int internalFormat);
+
 		/**
 		 * Destroys the texture.
 		 *
@@ -235,6 +281,32 @@ namespace cedar
 		 */
 		[[nodiscard]] bool isImmutable() const;
 
+		/**
+		 * Gets the amount of memory the texture occupies on the graphics card.
+		 *
+		 * <p>The size is computed from the size, internal format and levels of the texture, so it doesn't include any
+		 * padding the driver may add.</p>
+		 *
+		 * @return The size of the texture in bytes or 0 if the texture is not initialized.
+		 */
+		[[nodiscard]] virtual size_t getMemorySize() const;
+
+		/**
+		 * Marks the texture as used in the given frame.
+		 *
+		 * <p>This is called by the renderers whenever the texture is bound.</p>
+		 *
+		 * @param frame The frame the texture is used in.
+		 */
+		void markUsed(unsigned long long frame) const;
+
+		/**
+		 * Gets the frame the texture was last used in.
+		 *
+		 * @return The frame the texture was last {@link #markUsed(unsigned long long) used} in.
+		 */
+		[[nodiscard]] unsigned long long getLastUsedFrame() const;
+
 		/**
 		 * Sets the given parameter of the texture to the given integer value.
 		 *
@@ -219,6 +219,53 @@ namespace cedar
 		 */
 		void upload(int offsetX, int offsetY, int width, int height, unsigned int format, unsigned int type, const void *data, int level = 0);
 
+		/**
+		 * Uploads a section of the texture from a pixel unpack buffer.
+		 *
+		 * <p>The driver doesn't need to copy the data from client memory, so the call returns immediately and the
+		 * transfer happens asynchronously. The buffer must not be written to until the graphics card finished reading it.
+		 * The accepted formats and types are the same as for
+		 * {@link #upload(int, int, int, int, unsigned int, unsigned int, const void *, int)}.</p>
+		 *
+		 * @param offsetX The x offset to the origin of the texture where the section will be uploaded to.
+		 * @param offsetY The y offset to the origin of the texture where the section will be uploaded to.
+		 * @param width The width of the section that will be uploaded to the texture.
+		 * @param height The height of the section that will be uploaded to the texture.
+		 * @param format The format of the provided data.
+		 * @param type The type of the provided data.
+		 * @param pixelBufferId The id of the pixel unpack buffer the data is read from.
+		 * @param pixelBufferOffset The offset of the data inside the pixel unpack buffer in bytes.
+		 * @param level The level on which the data will be uploaded to.
+		 *
+		 * @throws TextureUploadException if the texture or the pixel buffer is not initialized.
+		 * @throws TextureUploadException if {@link #m_samples} is greater than one.
+		 * @throws TextureUploadException if <code>width</code> or <code>height</code> is smaller than one.
+		 * @throws TextureUploadException if the texture has reserved levels and <code>levels</code> is greater than the reserved amount.
+		 */
+		void uploadFromPixelBuffer(int offsetX, int offsetY, int width, int height, unsigned int format, unsigned int type,
+								   unsigned int pixelBufferId, size_t pixelBufferOffset, int level = 0);
+
+		/**
+		 * Uploads a section of a block compressed texture.
+		 *
+		 * <p>The compressed data is handed to the graphics card as is, so the internal format of the texture must be the
+		 * compressed format of the data. Offsets must be multiples of 4, the width and height too unless the section
+		 * reaches the edge of the level.</p>
+		 *
+		 * @param offsetX The x offset to the origin of the texture where the section will be uploaded to.
+		 * @param offsetY The y offset to the origin of the texture where the section will be uploaded to.
+		 * @param width The width of the section in pixels.
+		 * @param height The height of the section in pixels.
+		 * @param dataSize The size of the compressed data in bytes.
+		 * @param data A pointer to the compressed data.
+		 * @param level The level on which the data will be uploaded to.
+		 *
+		 * @throws TextureUploadException if the texture is not initialized or its internal format is not a compressed format.
+		 * @throws TextureUploadException if <code>width</code> or <code>height</code> is smaller than one.
+		 * @throws TextureUploadException if the texture has reserved levels and <code>levels</code> is greater than the reserved amount.
+		 */
+		void uploadCompressed(int offsetX, int offsetY, int width, int height, int dataSize, const void *data, int level = 0);
+
 		/**
 		 * Gets the width of the texture.
 		 *
@@ -265,6 +312,61 @@ namespace cedar
 		 * @return The number of reserved levels of the texture.
 		 */
 		[[nodiscard]] int getReservedLevels() const;
+
+		/**
+		 * Generates all levels of the texture from level 0 on the graphics card and enables trilinear filtering.
+		 *
+		 * <p>The texture should have been {@link #reserve(int) reserved} with
+		 * {@link #getMipmapLevelCount(int, int) all levels}, otherwise only the reserved levels are generated.</p>
+		 *
+		 * @throws TextureException if the texture is not initialized or multisampled.
+		 */
+		void generateMipmaps() const;
+
+		/**
+		 * Gets the number of levels of a full mipmap chain for a texture of the given size.
+		 *
+		 * @param width The width of the texture.
+		 * @param height The height of the texture.
+		 * @return The number of levels down to 1x1.
+		 */
+		static int getMipmapLevelCount(int width, int height);
+
+		/**
+		 * Gets the amount of memory the texture occupies on the graphics card.
+		 *
+		 * <p>Textures that are not reserved are assumed to have a single level.</p>
+		 *
+		 * @return The size of all levels and samples of the texture in bytes or 0 if the texture is not initialized.
+		 */
+		[[nodiscard]] size_t getMemorySize() const override;
+
+		/**
+		 * Creates a copy of the texture whose largest side is at most <code>maxSize</code> pixels.
+		 *
+		 * <p>If the texture has enough reserved levels, the matching level and all levels below it are copied on the
+		 * graphics card. Otherwise level 0 is blitted into a single level texture, with nearest filtering for integer
+		 * formats and linear filtering for all others. This is not possible for compressed textures.</p>
+		 *
+		 * @param maxSize The maximum width and height of the copy in pixels.
+		 * @return A pointer to the reduced copy or <code>nullptr</code> if the texture already fits into
+		 *         <code>maxSize</code> or can't be reduced.
+		 *
+		 * @throws TextureException if the texture is not initialized or multisampled.
+		 */
+		[[nodiscard]] Texture2D *createReducedCopy(int maxSize) const;
+
+		/**
+		 * Swaps the storage on the graphics card with the one of the given texture.
+		 *
+		 * <p>The id, size, internal format and levels are exchanged, so every shared pointer to this texture renders
+		 * the storage of <code>other</code> afterwards and vice versa.</p>
+		 *
+		 * @param other The texture whose storage will be swapped with the storage of this texture.
+		 *
+		 * @throws TextureException if the textures have different targets.
+		 */
+		void swapStorage(Texture2D &other);
 	};
 }
 
@@ -0,0 +1,210 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_TEXTUREATLAS_HPP
+#define CEDAR_TEXTUREATLAS_HPP
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cedar/Texture2D.hpp"
+#include "cedar/SkylinePacker.hpp"
+#include "cedar/Vector4f.hpp"
+#include "cedar/XException.hpp"
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	/**
+	 * Exception which is thrown when an image could not be added to a texture atlas.
+	 */
+	class TextureAtlasException : public XException
+	{
+	public:
+		/**
+		 * Creates a new texture atlas exception.
+		 *
+		 * @param message The message of the exception.
+		 */
+		explicit TextureAtlasException(const std::string &message);
+	};
+
+	/**
+	 * Struct representing a rectangular section of a texture.
+	 */
+	struct TextureRegion
+	{
+		/**
+		 * A shared pointer to the texture the region is part of.
+		 */
+		std::shared_ptr<Texture> m_texture;
+		/**
+		 * The uv coordinates of the region.
+		 *
+		 * <p>x and y are the coordinates of the top left corner, z and w are the coordinates of the bottom right
+		 * corner, matching the uvs of {@link Renderer2D#drawTexturedRect(float, float, float, float, float, const Vector4f &, const std::shared_ptr<Texture> &, const Vector4f &)}.</p>
+		 */
+		Vector4f m_uvs;
+		/**
+		 * The width of the region in pixels.
+		 */
+		int m_width;
+		/**
+		 * The height of the region in pixels.
+		 */
+		int m_height;
+	};
+
+	/**
+	 * Class for packing many small images into a few large textures.
+	 *
+	 * <p>Every texture used in a batch of the {@link Renderer2D} occupies one of the limited texture units, so a
+	 * screen with many images that each use their own texture has to be split into multiple draw calls. Images added
+	 * to an atlas share one page texture and are referenced by the {@link TextureRegion region} they were packed
+	 * into instead.</p>
+	 *
+	 * <p>Images are placed by a {@link SkylinePacker} per page. A new page is created once an image fits on none of
+	 * the existing pages.</p>
+	 *
+	 * <p>The edge pixels of every image are repeated into the padding around it, so linear filtering never bleeds
+	 * neighbouring images into each other.</p>
+	 *
+	 * <p>All methods that add images must be called on the OpenGL thread.</p>
+	 */
+	class TextureAtlas
+	{
+	private:
+		/**
+		 * The width of each page in pixels.
+		 */
+		int m_pageWidth;
+		/**
+		 * The height of each page in pixels.
+		 */
+		int m_pageHeight;
+		/**
+		 * The number of pixels between two images.
+		 */
+		int m_padding;
+		/**
+		 * The page textures of the atlas.
+		 */
+		std::vector<std::shared_ptr<Texture>> m_pages;
+		/**
+		 * The packers of the pages.
+		 */
+		std::vector<SkylinePacker> m_packers;
+		/**
+		 * The map of all regions in the atlas.
+		 */
+		std::map<std::string, TextureRegion> m_regions;
+
+		/**
+		 * Creates a new empty page.
+		 */
+		void addPage();
+
+	public:
+		/**
+		 * Creates a new texture atlas.
+		 *
+		 * <p>No page is created until the first image is added.</p>
+		 *
+		 * @param pageWidth The width of each page in pixels.
+		 * @param pageHeight The height of each page in pixels.
+		 * @param padding The number of pixels between two images.
+		 *
+		 * @throws TextureAtlasException if the size of the pages is invalid or the padding is negative.
+		 */
+		explicit TextureAtlas(int pageWidth = 2048, int pageHeight = 2048, int padding = 1);
+
+		/**
+		 * Adds an image to the atlas.
+		 *
+		 * <p>The pixels are expanded to RGBA, images with one or two channels are treated as grey and grey alpha
+		 * images.</p>
+		 *
+		 * @param name The name of the region.
+		 * @param pixels A pointer to the pixels of the image, tightly packed.
+		 * @param width The width of the image in pixels.
+		 * @param height The height of the image in pixels.
+		 * @param channels The number of channels of the image.
+		 * @return The region the image was packed into.
+		 *
+		 * @throws TextureAtlasException if a region with the same name already exists, the number of channels is not
+		 *                               supported or the image is larger than a page.
+		 */
+		const TextureRegion &add(const std::string &name, const unsigned char *pixels, int width, int height, int channels);
+
+		/**
+		 * Loads an image and adds it to the atlas.
+		 *
+		 * @param name The name of the region.
+		 * @param path The path to the image file.
+		 * @return The region the image was packed into.
+		 *
+		 * @throws TextureAtlasException if a region with the same name already exists or the image is larger than a
+		 *                               page.
+		 * @throws TextureLoadException if the image file could not be loaded.
+		 */
+		const TextureRegion &addImage(const std::string &name, const std::string &path);
+
+		/**
+		 * Gets the region with the given name.
+		 *
+		 * @param name The name of the region.
+		 * @return A pointer to the region or <code>nullptr</code> if the atlas doesn't contain a region with that name.
+		 */
+		[[nodiscard]] const TextureRegion *getRegion(const std::string &name) const;
+
+		/**
+		 * Gets all regions of the atlas.
+		 *
+		 * @return The map of all regions in the atlas.
+		 */
+		[[nodiscard]] const std::map<std::string, TextureRegion> &getRegions() const;
+
+		/**
+		 * Gets the number of pages of the atlas.
+		 *
+		 * @return The number of pages.
+		 */
+		[[nodiscard]] size_t getPageCount() const;
+
+		/**
+		 * Gets the page texture with the given index.
+		 *
+		 * @param index The index of the page.
+		 * @return A shared pointer to the page texture or <code>nullptr</code> if the index is out of bounds.
+		 */
+		[[nodiscard]] std::shared_ptr<Texture> getPage(size_t index) const;
+
+		/**
+		 * Gets the width of each page.
+		 *
+		 * @return The width of each page in pixels.
+		 */
+		[[nodiscard]] int getPageWidth() const;
+
+		/**
+		 * Gets the height of each page.
+		 *
+		 * @return The height of each page in pixels.
+		 */
+		[[nodiscard]] int getPageHeight() const;
+
+		/**
+		 * Gets the number of pixels between two images.
+		 *
+		 * @return The padding in pixels.
+		 */
+		[[nodiscard]] int getPadding() const;
+	};
+}
+
+#endif //CEDAR_TEXTUREATLAS_HPP
@@ -0,0 +1,145 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_TEXTURECACHE_HPP
+#define CEDAR_TEXTURECACHE_HPP
+
+#include <string>
+#include <vector>
+
+#include "cedar/Texture2D.hpp"
+
+/**
+ * The magic number of the cache signature stored in the reserved section of cached DDS files.
+ */
+#define CEDAR_TEXTURE_CACHE_MAGIC "CDRC"
+/**
+ * The version of the texture cache.
+ *
+ * <p>Cached textures with a different version are rebuilt.</p>
+ */
+#define CEDAR_TEXTURE_CACHE_VERSION 2
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	/**
+	 * Class for caching block compressed versions of source images on disk.
+	 *
+	 * <p>The first time an image is loaded it is decoded, a mipmap chain is generated if mipmaps were requested and
+	 * every level is compressed with the {@link BlockCompressor}. The result is written to the cache directory as a
+	 * DDS file whose reserved header section holds the path, size and modification time of the source image and
+	 * whether it has mipmaps. Later loads validate that signature, map the cached file and upload the blocks without
+	 * decoding anything. An image loaded with and without mipmaps has a cached file for each variant.</p>
+	 *
+	 * <p>The cache is disabled until a {@link #setDirectory(const std::string &) directory} is set.</p>
+	 */
+	class TextureCache
+	{
+	private:
+		/**
+		 * The directory cached textures are written to or an empty string if the cache is disabled.
+		 */
+		static std::string m_directory;
+
+		/**
+		 * Creates a new texture cache.
+		 */
+		TextureCache();
+
+	public:
+		/**
+		 * Sets the directory cached textures are written to and creates it if it doesn't exist.
+		 *
+		 * <p>This should be called before any textures are loaded.</p>
+		 *
+		 * @param directory The path to the cache directory or an empty string to disable the cache.
+		 */
+		static void setDirectory(const std::string &directory);
+
+		/**
+		 * Gets the directory cached textures are written to.
+		 *
+		 * @return The path to the cache directory or an empty string if the cache is disabled.
+		 */
+		static const std::string &getDirectory();
+
+		/**
+		 * Checks whether the given source image is loaded through the cache.
+		 *
+		 * <p>Images inside mounted {@link AssetPack asset packs} and images that are already compressed containers
+		 * bypass the cache.</p>
+		 *
+		 * @param path The path to the source image.
+		 * @return <code>true</code> if the cache is enabled and the image is cacheable.
+		 */
+		static bool isCacheable(const std::string &path);
+
+		/**
+		 * Gets the path of the cached file of the given source image.
+		 *
+		 * @param path The path to the source image.
+		 * @param generateMipmaps Whether the cached file holds a full mipmap chain.
+		 * @return The path to the cached file.
+		 */
+		static std::string getCachePath(const std::string &path, bool generateMipmaps);
+
+		/**
+		 * Checks whether an up to date cached file exists for the given source image.
+		 *
+		 * @param path The path to the source image.
+		 * @param generateMipmaps Whether the cached file holds a full mipmap chain.
+		 * @return <code>true</code> if the cached file exists and matches the source image.
+		 */
+		static bool isValid(const std::string &path, bool generateMipmaps);
+
+		/**
+		 * Decodes and compresses the given source image and writes it to the cache.
+		 *
+		 * <p>This doesn't use the graphics card and can be called from any thread. If the cached file could not be
+		 * written a warning is logged, the returned data can still be used.</p>
+		 *
+		 * @param path The path to the source image.
+		 * @param generateMipmaps Whether a full mipmap chain is compressed or only the full resolution.
+		 * @return The content of the cached DDS file.
+		 *
+		 * @throws TextureLoadException if the source image could not be loaded.
+		 */
+		static std::vector<unsigned char> build(const std::string &path, bool generateMipmaps);
+
+		/**
+		 * Creates a texture from the given cached data or from the cached file if the data is empty.
+		 *
+		 * <p>This must be called on the OpenGL thread.</p>
+		 *
+		 * <p>Textures with a mipmap chain are filtered trilinearly, all others keep the default filter.</p>
+		 *
+		 * @param path The path to the source image.
+		 * @param generateMipmaps Whether the cached file holds a full mipmap chain.
+		 * @param cacheData The data returned by {@link #build(const std::string &, bool)} or an empty vector.
+		 * @return A pointer to the created texture.
+		 *
+		 * @throws TextureLoadException if the cached file could not be loaded.
+		 */
+		static Texture2D *createTexture(const std::string &path, bool generateMipmaps, const std::vector<unsigned char> &cacheData);
+
+		/**
+		 * Loads the given source image through the cache.
+		 *
+		 * <p>The cached file is used if it is up to date, otherwise it is rebuilt first. This must be called on the
+		 * OpenGL thread.</p>
+		 *
+		 * @param path The path to the source image.
+		 * @param generateMipmaps Whether the texture has a full mipmap chain.
+		 * @return A pointer to the loaded texture.
+		 *
+		 * @throws TextureLoadException if the image could not be loaded.
+		 */
+		static Texture2D *loadTexture(const std::string &path, bool generateMipmaps);
+	};
+}
+
+#endif //CEDAR_TEXTURECACHE_HPP
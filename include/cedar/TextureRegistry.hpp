@@ -7,9 +7,23 @@
 
 #include <map>
 #include <memory>
+#include <vector>
+#include <functional>
 #include "Texture2D.hpp"
+#include "TextureAtlas.hpp"
+#include "PixelBufferRing.hpp"
+#include "Thread.hpp"
 #include "XException.hpp"
 
+/**
+ * The maximum width and height in pixels textures are reduced to when they are evicted.
+ */
+#define CEDAR_TEXTURE_EVICTED_SIZE 64
+/**
+ * The number of frames a texture must not have been used in before it can be evicted.
+ */
+#define CEDAR_TEXTURE_EVICTION_IDLE_FRAMES 300
+
 /**
  * Base namespace of the cedar engine.
  */
@@ -30,8 +44,47 @@ namespace cedar
 		explicit TextureRegisterException(const std::string &message);
 	};
 
+	/**
+	 * Struct representing the file a registered texture was loaded from.
+	 *
+	 * <p>Only textures with a source can be evicted, since they need to be reloaded once they are used again.</p>
+	 */
+	struct TextureSource
+	{
+		/**
+		 * The path to the texture file.
+		 */
+		std::string m_path;
+		/**
+		 * Whether a full mipmap chain was generated when the texture was loaded.
+		 */
+		bool m_generateMipmaps;
+		/**
+		 * Whether the texture is currently reduced to {@link CEDAR_TEXTURE_EVICTED_SIZE}.
+		 */
+		bool m_evicted;
+		/**
+		 * Whether the evicted texture is being reloaded from its file right now.
+		 */
+		bool m_restoring;
+		/**
+		 * The minification filter, magnification filter and wrap modes of the texture before it was evicted.
+		 */
+		int m_parameters[4];
+	};
+
 	/**
 	 * Class for creating and handling textures.
+	 *
+	 * <p>If a {@link TextureCache#setDirectory(const std::string &) cache directory} is set, source images are loaded
+	 * through the {@link TextureCache} and uploaded block compressed.</p>
+	 *
+	 * <p>If a {@link #setMemoryBudget(size_t) memory budget} is set, textures loaded from files that weren't used for
+	 * {@link CEDAR_TEXTURE_EVICTION_IDLE_FRAMES} frames are evicted in least recently used order until the textures
+	 * fit into the budget again. An evicted texture stays registered and every shared pointer to it stays valid, but its
+	 * storage is replaced by a copy reduced to {@link CEDAR_TEXTURE_EVICTED_SIZE} pixels. Once it is used again, its file
+	 * is decoded on the {@link ThreadPool#getInstance() shared thread pool} and uploaded through the pixel buffer ring.
+	 * The reduced copy is rendered until the reload finished and the full storage is swapped in.</p>
 	 */
 	class TextureRegistry
 	{
@@ -40,6 +93,89 @@ namespace cedar
 		 * The map of all loaded textures.
 		 */
 		static std::map<std::string, std::shared_ptr<Texture>> m_loadedTextures;
+		/**
+		 * The map of all registered texture regions.
+		 */
+		static std::map<std::string, TextureRegion> m_registeredRegions;
+		/**
+		 * A pointer to the pixel buffer ring textures are uploaded through.
+		 *
+		 * <p>The ring is created when the first texture is loaded.</p>
+		 */
+		static PixelBufferRing *m_pixelBufferRing;
+		/**
+		 * The map of the sources of all textures that were loaded from files.
+		 */
+		static std::map<std::string, TextureSource> m_textureSources;
+		/**
+		 * The maximum amount of memory all registered textures should occupy in bytes or 0 for no limit.
+		 */
+		static size_t m_memoryBudget;
+		/**
+		 * The index of the current frame.
+		 */
+		static unsigned long long m_currentFrame;
+
+		/**
+		 * Loads a texture from the given file without registering it.
+		 *
+		 * @param path The path to the texture file.
+		 * @param generateMipmaps Whether a full mipmap chain is generated.
+		 * @return A pointer to the loaded texture.
+		 *
+		 * @throws TextureLoadException if the texture file could not be loaded.
+		 */
+		static Texture2D *loadTextureFile(const std::string &path, bool generateMipmaps);
+
+		/**
+		 * Loads a texture from the given file asynchronously without registering it.
+		 *
+		 * <p>The image is decoded by the given thread directly into the pixel buffer ring, the texture is created by
+		 * the OpenGL thread. Both callbacks are called on the OpenGL thread. Nothing is called if the pixel buffer
+		 * ring was deleted by a {@link #cleanup() cleanup} in the meantime.</p>
+		 *
+		 * <p>This must be called on the OpenGL thread.</p>
+		 *
+		 * @param path The path to the texture file.
+		 * @param generateMipmaps Whether a full mipmap chain is generated on the decode thread.
+		 * @param decodeThread A pointer to the thread that will decode the image or <code>nullptr</code> to decode it
+		 *                     on the {@link ThreadPool#getInstance() shared thread pool}.
+		 * @param onLoaded The function that takes ownership of the loaded texture.
+		 * @param onError The function that is called with the error message if the texture could not be loaded.
+		 */
+		static void loadTextureFileAsync(const std::string &path, bool generateMipmaps, Thread *decodeThread,
+										 const std::function<void(Texture2D *texture)> &onLoaded,
+										 const std::function<void(const std::string &error)> &onError);
+
+		/**
+		 * Registers a texture that was loaded from a file.
+		 *
+		 * @param name The name of the texture.
+		 * @param texture A shared pointer to the loaded texture.
+		 * @param path The path to the texture file.
+		 * @param generateMipmaps Whether a full mipmap chain was generated.
+		 */
+		static void insertTexture(const std::string &name, const std::shared_ptr<Texture> &texture, const std::string &path,
+								  bool generateMipmaps);
+
+		/**
+		 * Reduces the given texture to {@link CEDAR_TEXTURE_EVICTED_SIZE}.
+		 *
+		 * @param texture A pointer to the texture.
+		 * @param source The source of the texture.
+		 * @return <code>true</code> if the texture was evicted.
+		 */
+		static bool evictTexture(Texture2D *texture, TextureSource &source);
+
+		/**
+		 * Starts reloading the given evicted texture from its file.
+		 *
+		 * <p>The texture keeps its reduced storage until the reload finished on the OpenGL thread.</p>
+		 *
+		 * @param name The name of the texture.
+		 * @param source The source of the texture.
+		 */
+		static void restoreTexture(const std::string &name, TextureSource &source);
 
 		/**
 		 * Creates a new texture registry.
@@ -63,23 +199,167 @@ namespace cedar
 		 *
 		 * @param name The name of the texture.
 		 * @param path The path to the texture file that will be loaded and registered.
+		 * @param generateMipmaps Whether a full mipmap chain is generated and the texture is filtered trilinearly.
 		 * @return A shared pointer to the registered texture.
 		 *
 		 * @throws TextureRegisterException when a texture with the same name is already registered or the name is invalid.
 		 * @throws TextureLoadException if the texture file could not be loaded.
 		 *
-		 * @see ImageLoader#loadTexture(const std::string &, int)
+		 * @see ImageLoader#loadTexture(const std::string &, int, bool)
+		 */
+		static std::shared_ptr<Texture> loadTexture(const std::string &name, const std::string &path, bool generateMipmaps = false);
+
+		/**
+		 * Loads multiple textures and registers them under the given names.
+		 *
+		 * <p>The images are decoded concurrently on the {@link ThreadPool#getInstance() shared thread pool}, only the
+		 * creation of the textures happens on the calling thread. If one of the textures can't be loaded none of them
+		 * are registered.</p>
+		 *
+		 * <p>This must be called on the OpenGL thread.</p>
+		 *
+		 * @param textures The names of the textures paired with the paths to the texture files.
+		 * @param generateMipmaps Whether full mipmap chains are generated on the worker threads and the textures are
+		 *                        filtered trilinearly.
+		 * @return Shared pointers to the registered textures in the order of <code>textures</code>.
+		 *
+		 * @throws TextureRegisterException when a texture with the same name is already registered or a name is invalid
+		 *                                  or used twice.
+		 * @throws TextureLoadException if one of the texture files could not be loaded.
+		 */
+		static std::vector<std::shared_ptr<Texture>> loadTextures(const std::vector<std::pair<std::string, std::string>> &textures,
+																  bool generateMipmaps = false);
+
+		/**
+		 * Loads a texture asynchronously and registers it under the given name.
+		 *
+		 * <p>The image is decoded by the given thread directly into the pixel buffer ring. The texture is then created
+		 * and registered by the OpenGL thread, where the upload is read from the pixel buffer without stalling the
+		 * render loop. Errors are logged, since they can't be thrown to the caller.</p>
+		 *
+		 * <p>This must be called on the OpenGL thread.</p>
+		 *
+		 * @param name The name of the texture.
+		 * @param path The path to the texture file that will be loaded and registered.
+		 * @param decodeThread A pointer to the thread that will decode the image.
+		 * @param callback The function that is called on the OpenGL thread once the texture was registered or
+		 *                 <code>nullptr</code>.
+		 * @param generateMipmaps Whether a full mipmap chain is generated on the decode thread and the texture is
+		 *                        filtered trilinearly.
+		 *
+		 * @throws TextureRegisterException when a texture with the same name is already registered or the name is invalid.
+		 */
+		static void loadTextureAsync(const std::string &name, const std::string &path, Thread *decodeThread,
+									 const std::function<void(const std::shared_ptr<Texture> &)> &callback = nullptr,
+									 bool generateMipmaps = false);
+
+		/**
+		 * Gets the pixel buffer ring textures are uploaded through and creates it if it doesn't exist yet.
+		 *
+		 * <p>This must be called on the OpenGL thread.</p>
+		 *
+		 * @return A pointer to the pixel buffer ring or <code>nullptr</code> if it could not be created.
+		 */
+		static PixelBufferRing *getPixelBufferRing();
+
+		/**
+		 * Reclaims the sections of the pixel buffer ring the graphics card finished reading.
+		 *
+		 * <p>This is called by the OpenGL thread every frame.</p>
+		 */
+		static void reclaimPixelBuffers();
+
+		/**
+		 * Sets the maximum amount of memory all registered textures should occupy.
+		 *
+		 * @param budget The budget in bytes or 0 to disable eviction.
+		 */
+		static void setMemoryBudget(size_t budget);
+
+		/**
+		 * Gets the maximum amount of memory all registered textures should occupy.
+		 *
+		 * @return The budget in bytes or 0 if eviction is disabled.
 		 */
-		static std::shared_ptr<Texture> loadTexture(const std::string &name, const std::string &path);
+		static size_t getMemoryBudget();
+
+		/**
+		 * Gets the amount of memory all registered textures occupy on the graphics card.
+		 *
+		 * @return The sum of the {@link Texture#getMemorySize() memory sizes} of all registered textures in bytes.
+		 */
+		static size_t getMemoryUsage();
+
+		/**
+		 * Gets the index of the current frame.
+		 *
+		 * <p>Renderers {@link Texture#markUsed(unsigned long long) mark} the textures they bind with it.</p>
+		 *
+		 * @return The index of the current frame.
+		 */
+		static unsigned long long getCurrentFrame();
+
+		/**
+		 * Restores the evicted textures used in the current frame, evicts idle textures while the budget is exceeded
+		 * and advances to the next frame.
+		 *
+		 * <p>This is called by the OpenGL thread every frame.</p>
+		 */
+		static void updateResidency();
 
 		/**
 		 * Gets the texture with the given name.
 		 *
+		 * <p>This marks the texture as used, so an evicted texture is restored at the end of the frame.</p>
+		 *
 		 * @param name The name of the texture.
 		 * @return A shared pointer to the texture with the given name or <code>nullptr</code> if no texture is registered under that name.
 		 */
 		static std::shared_ptr<Texture> getTexture(const std::string &name);
 
+		/**
+		 * Registers the given texture region under the given name.
+		 *
+		 * <p>Regions share a namespace separate from textures, so a region and a texture may have the same name.</p>
+		 *
+		 * @param name The name of the region.
+		 * @param region The region that will be registered.
+		 *
+		 * @throws TextureRegisterException when a region with the same name is already registered, the name is invalid
+		 *                                  or the region has no texture.
+		 */
+		static void registerRegion(const std::string &name, const TextureRegion &region);
+
+		/**
+		 * Registers all pages and regions of the given texture atlas.
+		 *
+		 * <p>The pages are registered as textures named <code>name#index</code> and every region is registered under
+		 * its name in the atlas. Regions added to the atlas afterwards must be registered separately. If one of the
+		 * names is taken nothing is registered.</p>
+		 *
+		 * @param name The name of the atlas.
+		 * @param atlas The atlas whose pages and regions will be registered.
+		 *
+		 * @throws TextureRegisterException when a page or region name is already registered or the name is invalid.
+		 */
+		static void registerAtlas(const std::string &name, const TextureAtlas &atlas);
+
+		/**
+		 * Gets the texture region with the given name.
+		 *
+		 * @param name The name of the region.
+		 * @return The region with the given name. Its texture will be <code>nullptr</code> if no region is registered
+		 *         under that name.
+		 */
+		static TextureRegion getRegion(const std::string &name);
+
+		/**
+		 * Deletes the texture region with the given name from the registry.
+		 *
+		 * @param name The name of the region that will be deleted from the registry.
+		 */
+		static void cleanupRegion(const std::string &name);
+
 		/**
 		 * Deletes the texture with the given name from the registry.
 		 *
@@ -88,7 +368,7 @@ namespace cedar
 		static void cleanup(const std::string &name);
 
 		/**
-		 * Clears the registry.
+		 * Clears the textures and regions of the registry and deletes the pixel buffer ring.
 		 */
 		static void cleanup();
 	};
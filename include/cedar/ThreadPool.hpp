@@ -0,0 +1,110 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_THREADPOOL_HPP
+#define CEDAR_THREADPOOL_HPP
+
+#include <thread>
+#include <vector>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	/**
+	 * Class representing a pool of worker threads for short, independent cpu bound jobs like decoding images.
+	 *
+	 * <p>Unlike a {@link Thread} the workers don't tick, they sleep until a job is added and process jobs in the order
+	 * they were added.</p>
+	 */
+	class ThreadPool
+	{
+	private:
+		/**
+		 * The worker threads of the pool.
+		 */
+		std::vector<std::thread> m_workers;
+		/**
+		 * The jobs that were not picked up by a worker yet.
+		 */
+		std::queue<std::function<void()>> m_jobs;
+		/**
+		 * Mutex for {@link #m_jobs} and {@link #m_stopping}.
+		 */
+		std::mutex m_mutex;
+		/**
+		 * The condition variable the workers wait on for new jobs.
+		 */
+		std::condition_variable m_condition;
+		/**
+		 * Whether the pool is shutting down.
+		 */
+		bool m_stopping;
+
+		/**
+		 * Runs the loop of a worker thread.
+		 */
+		void work();
+
+	public:
+		/**
+		 * Creates a new thread pool and starts its workers.
+		 *
+		 * @param threadCount The number of worker threads.
+		 *                    <p>If this is 0 one worker per hardware thread is started.</p>
+		 */
+		explicit ThreadPool(unsigned int threadCount = 0);
+
+		/**
+		 * Finishes all added jobs and stops the workers.
+		 */
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool &) = delete;
+
+		ThreadPool &operator=(const ThreadPool &) = delete;
+
+		/**
+		 * Gets the thread pool shared by the engine.
+		 *
+		 * @return A pointer to the shared thread pool.
+		 */
+		static ThreadPool *getInstance();
+
+		/**
+		 * Adds a job to the pool.
+		 *
+		 * <p>Exceptions thrown by the job are caught and logged.</p>
+		 *
+		 * @param job The job that will be executed by one of the workers.
+		 */
+		void submit(const std::function<void()> &job);
+
+		/**
+		 * Calls the given function for every index in <code>[0, count)</code>, distributed over the workers.
+		 *
+		 * <p>The calling thread works on the indices as well and this method returns once all indices were processed,
+		 * so it can also be called from inside a job of the pool. If the function throws for any index, the remaining
+		 * indices are still processed and the first exception is rethrown afterwards.</p>
+		 *
+		 * @param count The number of indices.
+		 * @param function The function that will be called with every index.
+		 */
+		void parallelFor(size_t count, const std::function<void(size_t)> &function);
+
+		/**
+		 * Gets the number of worker threads of the pool.
+		 *
+		 * @return The number of worker threads.
+		 */
+		[[nodiscard]] unsigned int getThreadCount() const;
+	};
+}
+
+#endif //CEDAR_THREADPOOL_HPP
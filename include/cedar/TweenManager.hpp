@@ -0,0 +1,226 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#ifndef CEDAR_TWEENMANAGER_HPP
+#define CEDAR_TWEENMANAGER_HPP
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cedar/GUIConstants.hpp"
+
+/**
+ * The number of easing functions a tween can use.
+ */
+#define CEDAR_EASING_COUNT 8
+
+/**
+ * Base namespace of the cedar engine.
+ */
+namespace cedar
+{
+	class Element;
+
+	/**
+	 * Struct representing the values a tween writes to when it animates a property of an element.
+	 */
+	struct TweenTarget
+	{
+		/**
+		 * A pointer to the animated value or <code>nullptr</code> if the element can't animate the property.
+		 */
+		float *m_value;
+		/**
+		 * A pointer to a value that is moved by the same amount as the animated value or <code>nullptr</code>.
+		 *
+		 * <p>This keeps the origin of an element in place relative to its position.</p>
+		 */
+		float *m_linkedValue;
+		/**
+		 * Whether the animated value is part of the bounds of the element.
+		 */
+		bool m_bounds;
+	};
+
+	/**
+	 * Struct storing all tweens with the same easing function as a structure of arrays.
+	 *
+	 * <p>The tween at an index is made up of the values at that index in every array.</p>
+	 */
+	struct TweenBucket
+	{
+		/**
+		 * The animated elements.
+		 */
+		std::vector<Element *> m_elements;
+		/**
+		 * The animated values.
+		 */
+		std::vector<float *> m_values;
+		/**
+		 * The values that are moved together with the animated values.
+		 */
+		std::vector<float *> m_linkedValues;
+		/**
+		 * Whether the animated values are part of the bounds of their elements.
+		 */
+		std::vector<unsigned char> m_bounds;
+		/**
+		 * The values at the start of the tweens.
+		 */
+		std::vector<float> m_from;
+		/**
+		 * The differences between the values at the end and the start of the tweens.
+		 */
+		std::vector<float> m_deltas;
+		/**
+		 * The progress of the tweens, negative while the tweens are delayed.
+		 */
+		std::vector<float> m_progress;
+		/**
+		 * The progress the tweens make per microsecond.
+		 */
+		std::vector<float> m_rates;
+		/**
+		 * The values the tweens evaluated to in the current frame.
+		 */
+		std::vector<float> m_results;
+	};
+
+	/**
+	 * Class animating properties of elements over time.
+	 *
+	 * <p>Instead of moving elements in update callbacks, a tween is started once and evaluated by the tween manager
+	 * of the screen before every update. The tweens are stored as a structure of arrays with one bucket per easing
+	 * function, so the progress and values of all tweens of a bucket are calculated in a single branch free loop the
+	 * compiler can vectorize. Only afterwards the results are written to the elements, and every element that was
+	 * touched is notified once, no matter how many of its properties are animated.</p>
+	 *
+	 * <p>Tweens are started and cancelled on the thread that updates the screens.</p>
+	 */
+	class TweenManager
+	{
+	private:
+		/**
+		 * The tweens sorted by their easing function.
+		 */
+		TweenBucket m_buckets[CEDAR_EASING_COUNT];
+		/**
+		 * The bucket and the index of all running tweens, mapped by their animated values.
+		 */
+		std::unordered_map<float *, std::pair<unsigned int, size_t>> m_indices;
+		/**
+		 * The elements that were touched by the tweens of the current frame.
+		 */
+		std::vector<Element *> m_touchedElements;
+		/**
+		 * The time of the last update in microseconds, 0 if the manager was not updated yet.
+		 */
+		unsigned long m_lastTime;
+
+		/**
+		 * Removes a tween by moving the last tween of its bucket in its place.
+		 *
+		 * @param easing The easing function of the tween.
+		 * @param index The index of the tween in its bucket.
+		 */
+		void removeTween(unsigned int easing, size_t index);
+
+	public:
+		/**
+		 * Creates a new tween manager without tweens.
+		 */
+		TweenManager();
+
+		/**
+		 * Advances and applies all tweens.
+		 *
+		 * <p>Tweens that reached their end are removed afterwards. If the manager was not updated for a while, for
+		 * example because its screen was hidden, the time in between is still counted.</p>
+		 *
+		 * @param currentTime The current time of the frame in microseconds.
+		 */
+		void update(unsigned long currentTime);
+
+		/**
+		 * Animates a property of an element from its current value.
+		 *
+		 * <p>A tween that is already animating the property is replaced.</p>
+		 *
+		 * @param element A pointer to the element.
+		 * @param property The property that will be animated.
+		 * @param to The value at the end of the tween.
+		 * @param duration The duration of the tween in microseconds.
+		 * @param easing The easing function of the tween.
+		 * @param delay The time until the tween starts in microseconds.
+		 *
+		 * @throws ElementUpdateException if <code>element</code> is a <code>nullptr</code>, the easing function is
+		 *                                unknown or the element can't animate the property.
+		 */
+		void animate(Element *element, unsigned int property, float to, unsigned long duration, unsigned int easing = CEDAR_EASING_LINEAR,
+					 unsigned long delay = 0);
+
+		/**
+		 * Animates a property of an element.
+		 *
+		 * <p>A tween that is already animating the property is replaced. The property keeps its current value until
+		 * the tween starts.</p>
+		 *
+		 * @param element A pointer to the element.
+		 * @param property The property that will be animated.
+		 * @param from The value at the start of the tween.
+		 * @param to The value at the end of the tween.
+		 * @param duration The duration of the tween in microseconds.
+		 * @param easing The easing function of the tween.
+		 * @param delay The time until the tween starts in microseconds.
+		 *
+		 * @throws ElementUpdateException if <code>element</code> is a <code>nullptr</code>, the easing function is
+		 *                                unknown or the element can't animate the property.
+		 */
+		void animate(Element *element, unsigned int property, float from, float to, unsigned long duration,
+					 unsigned int easing = CEDAR_EASING_LINEAR, unsigned long delay = 0);
+
+		/**
+		 * Stops the tween animating a property of an element.
+		 *
+		 * <p>The property keeps the value it has right now.</p>
+		 *
+		 * @param element A pointer to the element.
+		 * @param property The animated property.
+		 */
+		void cancel(Element *element, unsigned int property);
+
+		/**
+		 * Stops all tweens animating properties of an element.
+		 *
+		 * @param element A pointer to the element.
+		 */
+		void cancel(const Element *element);
+
+		/**
+		 * Stops all tweens.
+		 */
+		void clear();
+
+		/**
+		 * Checks whether a property of an element is animated.
+		 *
+		 * @param element A pointer to the element.
+		 * @param property The property.
+		 * @return <code>true</code> if a tween is animating the property.
+		 */
+		[[nodiscard]] bool isAnimating(Element *element, unsigned int property) const;
+
+		/**
+		 * Gets the number of running tweens.
+		 *
+		 * @return The number of tweens.
+		 */
+		[[nodiscard]] size_t getTweenCount() const;
+	};
+}
+
+#endif //CEDAR_TWEENMANAGER_HPP
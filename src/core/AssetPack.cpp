@@ -0,0 +1,287 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+
+#include "cedar/AssetPack.hpp"
+
+using namespace cedar;
+
+static_assert(sizeof(AssetPackEntry) == 32, "The asset pack entry must match the file layout!");
+
+/**
+ * The list of mounted asset packs in the order they were mounted.
+ */
+std::vector<AssetPack *> MOUNTED_PACKS = std::vector<AssetPack *>();
+/**
+ * The mutex guarding the list of mounted asset packs, since assets are looked up by the workers of the thread pool.
+ */
+std::shared_mutex MOUNTED_PACKS_MUTEX;
+
+AssetPackException::AssetPackException(const std::string &message) : XException(message)
+{}
+
+AssetPack::AssetPack(const std::string &path)
+{
+	try
+	{
+		this->m_file = new MappedFile(path, true);
+	}
+	catch (const FileMapException &exception)
+	{
+		throw AssetPackException(std::string("Could not mount asset pack. ") + exception.what());
+	}
+
+	const unsigned char *data = this->m_file->getData();
+	size_t size = this->m_file->getSize();
+
+	unsigned int version = 0;
+	unsigned int namesSize = 0;
+	this->m_entryCount = 0;
+	if (size >= CEDAR_ASSET_PACK_HEADER_SIZE && std::memcmp(data, CEDAR_ASSET_PACK_MAGIC, 4) == 0)
+	{
+		std::memcpy(&version, data + 4, 4);
+		std::memcpy(&this->m_entryCount, data + 8, 4);
+		std::memcpy(&namesSize, data + 12, 4);
+	}
+
+	size_t tableSize = static_cast<size_t>(this->m_entryCount) * sizeof(AssetPackEntry);
+	if (version != CEDAR_ASSET_PACK_VERSION || size < CEDAR_ASSET_PACK_HEADER_SIZE + tableSize + namesSize)
+	{
+		delete this->m_file;
+		throw AssetPackException("Could not mount asset pack \"" + path + "\". The file is either corrupted or is not an asset pack!");
+	}
+
+	this->m_entries = reinterpret_cast<const AssetPackEntry *>(data + CEDAR_ASSET_PACK_HEADER_SIZE);
+	this->m_names = reinterpret_cast<const char *>(data + CEDAR_ASSET_PACK_HEADER_SIZE + tableSize);
+
+	for (unsigned int n = 0; n < this->m_entryCount; n++)
+	{
+		const AssetPackEntry &entry = this->m_entries[n];
+		if (entry.m_offset > size || entry.m_size > size - entry.m_offset ||
+			static_cast<size_t>(entry.m_nameOffset) + entry.m_nameLength > namesSize)
+		{
+			delete this->m_file;
+			throw AssetPackException("Could not mount asset pack \"" + path + "\". Entry " + std::to_string(n) + " is out of bounds!");
+		}
+	}
+}
+
+AssetPack::~AssetPack()
+{
+	delete this->m_file;
+}
+
+bool AssetPack::find(const std::string &path, const unsigned char **data, size_t *size) const
+{
+	std::string normalizedPath = normalizePath(path);
+	unsigned long long pathHash = hash(normalizedPath);
+
+	const AssetPackEntry *end = this->m_entries + this->m_entryCount;
+	const AssetPackEntry *it = std::lower_bound(this->m_entries, end, pathHash, [](const AssetPackEntry &entry, unsigned long long value) {
+		return entry.m_hash < value;
+	});
+
+	// Compare the paths as well in case two paths share the same hash.
+	for (; it != end && it->m_hash == pathHash; it++)
+	{
+		if (it->m_nameLength != normalizedPath.length() ||
+			std::memcmp(this->m_names + it->m_nameOffset, normalizedPath.data(), it->m_nameLength) != 0)
+			continue;
+
+		if (it->m_compression != CEDAR_ASSET_COMPRESSION_NONE)
+			throw AssetPackException("Could not read asset \"" + path + "\" from asset pack \"" + this->m_file->getPath() +
+									 "\". Unsupported compression method " + std::to_string(it->m_compression) + "!");
+
+		*data = this->m_file->getData() + it->m_offset;
+		*size = static_cast<size_t>(it->m_size);
+		return true;
+	}
+
+	return false;
+}
+
+const std::string &AssetPack::getPath() const
+{
+	return this->m_file->getPath();
+}
+
+unsigned int AssetPack::getEntryCount() const
+{
+	return this->m_entryCount;
+}
+
+std::string AssetPack::normalizePath(const std::string &path)
+{
+	std::string normalizedPath = path;
+	std::replace(normalizedPath.begin(), normalizedPath.end(), '\\', '/');
+	while (normalizedPath.compare(0, 2, "./") == 0)
+		normalizedPath.erase(0, 2);
+	return normalizedPath;
+}
+
+unsigned long long AssetPack::hash(const std::string &path)
+{
+	unsigned long long result = 14695981039346656037ull;
+	for (char character : path)
+	{
+		result ^= static_cast<unsigned char>(character);
+		result *= 1099511628211ull;
+	}
+	return result;
+}
+
+void AssetPack::pack(const std::string &packPath, const std::vector<std::pair<std::string, std::string>> &assets)
+{
+	std::vector<std::string> names;
+	std::vector<AssetPackEntry> entries;
+	names.reserve(assets.size());
+	entries.reserve(assets.size());
+
+	std::string nameTable;
+	for (const auto &asset : assets)
+	{
+		std::string name = normalizePath(asset.first);
+		if (name.length() > 0xFFFFu)
+			throw AssetPackException("Could not pack asset \"" + name + "\". The path is too long!");
+
+		std::error_code error;
+		auto fileSize = std::filesystem::file_size(asset.second, error);
+		if (error)
+			throw AssetPackException("Could not pack asset \"" + name + "\". Could not read file \"" + asset.second + "\": " + error.message());
+
+		AssetPackEntry entry{};
+		entry.m_hash = hash(name);
+		entry.m_size = fileSize;
+		entry.m_nameOffset = static_cast<unsigned int>(nameTable.length());
+		entry.m_nameLength = static_cast<unsigned short>(name.length());
+		entry.m_compression = CEDAR_ASSET_COMPRESSION_NONE;
+		nameTable.append(name);
+
+		names.push_back(name);
+		entries.push_back(entry);
+	}
+
+	// Sort the assets by hash, the order of the data follows the order of the table of contents.
+	std::vector<size_t> order(entries.size());
+	for (size_t n = 0; n < order.size(); n++)
+		order[n] = n;
+	std::sort(order.begin(), order.end(), [&entries, &names](size_t lhs, size_t rhs) {
+		if (entries[lhs].m_hash != entries[rhs].m_hash)
+			return entries[lhs].m_hash < entries[rhs].m_hash;
+		return names[lhs] < names[rhs];
+	});
+
+	for (size_t n = 1; n < order.size(); n++)
+	{
+		if (names[order[n]] == names[order[n - 1]])
+			throw AssetPackException("Could not pack assets. The asset path \"" + names[order[n]] + "\" is used twice!");
+	}
+
+	unsigned long long offset = CEDAR_ASSET_PACK_HEADER_SIZE + entries.size() * sizeof(AssetPackEntry) + nameTable.length();
+	std::vector<AssetPackEntry> table(entries.size());
+	for (size_t n = 0; n < order.size(); n++)
+	{
+		table[n] = entries[order[n]];
+		offset = (offset + CEDAR_ASSET_PACK_ALIGNMENT - 1) & ~static_cast<unsigned long long>(CEDAR_ASSET_PACK_ALIGNMENT - 1);
+		table[n].m_offset = offset;
+		offset += table[n].m_size;
+	}
+
+	std::ofstream packFile(packPath, std::ofstream::binary | std::ofstream::trunc);
+	if (!packFile.is_open())
+		throw AssetPackException("Could not write asset pack \"" + packPath + "\". Could not open file!");
+
+	auto entryCount = static_cast<unsigned int>(table.size());
+	auto namesSize = static_cast<unsigned int>(nameTable.length());
+	unsigned int version = CEDAR_ASSET_PACK_VERSION;
+	packFile.write(CEDAR_ASSET_PACK_MAGIC, 4);
+	packFile.write(reinterpret_cast<const char *>(&version), 4);
+	packFile.write(reinterpret_cast<const char *>(&entryCount), 4);
+	packFile.write(reinterpret_cast<const char *>(&namesSize), 4);
+	packFile.write(reinterpret_cast<const char *>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(AssetPackEntry)));
+	packFile.write(nameTable.data(), static_cast<std::streamsize>(nameTable.length()));
+
+	unsigned long long position = CEDAR_ASSET_PACK_HEADER_SIZE + table.size() * sizeof(AssetPackEntry) + nameTable.length();
+	std::vector<char> padding(CEDAR_ASSET_PACK_ALIGNMENT, 0);
+	for (size_t n = 0; n < order.size(); n++)
+	{
+		packFile.write(padding.data(), static_cast<std::streamsize>(table[n].m_offset - position));
+		position = table[n].m_offset;
+
+		const std::string &filePath = assets[order[n]].second;
+		std::ifstream assetFile(filePath, std::ifstream::binary);
+		if (!assetFile.is_open())
+			throw AssetPackException("Could not pack asset \"" + names[order[n]] + "\". Could not open file \"" + filePath + "\"!");
+
+		// Streaming an empty file would set the fail bit of the pack file.
+		if (table[n].m_size > 0)
+			packFile << assetFile.rdbuf();
+		position += table[n].m_size;
+
+		if (static_cast<unsigned long long>(packFile.tellp()) != position)
+			throw AssetPackException("Could not pack asset \"" + names[order[n]] + "\". The file \"" + filePath + "\" changed while packing!");
+	}
+
+	if (!packFile.good())
+		throw AssetPackException("Could not write asset pack \"" + packPath + "\"!");
+}
+
+void AssetPack::mount(const std::string &path)
+{
+	// The pack is mapped and validated before the lock is taken, so lookups are not blocked by the file access.
+	auto *pack = new AssetPack(path);
+	std::unique_lock<std::shared_mutex> lock(MOUNTED_PACKS_MUTEX);
+	MOUNTED_PACKS.push_back(pack);
+}
+
+bool AssetPack::unmount(const std::string &path)
+{
+	AssetPack *pack = nullptr;
+	{
+		std::unique_lock<std::shared_mutex> lock(MOUNTED_PACKS_MUTEX);
+		for (auto it = MOUNTED_PACKS.begin(); it != MOUNTED_PACKS.end(); it++)
+		{
+			if ((*it)->getPath() == path)
+			{
+				pack = *it;
+				MOUNTED_PACKS.erase(it);
+				break;
+			}
+		}
+	}
+
+	delete pack;
+	return pack != nullptr;
+}
+
+void AssetPack::unmountAll()
+{
+	std::vector<AssetPack *> packs;
+	{
+		std::unique_lock<std::shared_mutex> lock(MOUNTED_PACKS_MUTEX);
+		packs.swap(MOUNTED_PACKS);
+	}
+
+	for (AssetPack *pack : packs)
+	{
+		delete pack;
+	}
+}
+
+bool AssetPack::findAsset(const std::string &path, const unsigned char **data, size_t *size)
+{
+	std::shared_lock<std::shared_mutex> lock(MOUNTED_PACKS_MUTEX);
+	for (auto it = MOUNTED_PACKS.rbegin(); it != MOUNTED_PACKS.rend(); it++)
+	{
+		if ((*it)->find(path, data, size))
+			return true;
+	}
+	return false;
+}
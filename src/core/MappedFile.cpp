@@ -0,0 +1,79 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cedar/MappedFile.hpp"
+
+using namespace cedar;
+
+FileMapException::FileMapException(const std::string &message) : XException(message)
+{}
+
+MappedFile::MappedFile(const std::string &path, const bool sequential)
+{
+	this->m_path = path;
+	this->m_data = nullptr;
+	this->m_size = 0;
+
+	int fileDescriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fileDescriptor < 0)
+		throw FileMapException("Could not map file \"" + path + "\". Could not open file: " + std::strerror(errno));
+
+	struct stat fileStat{};
+	if (fstat(fileDescriptor, &fileStat) != 0)
+	{
+		int error = errno;
+		close(fileDescriptor);
+		throw FileMapException("Could not map file \"" + path + "\". Could not get file size: " + std::strerror(error));
+	}
+
+	this->m_size = static_cast<size_t>(fileStat.st_size);
+	if (this->m_size > 0)
+	{
+		void *data = mmap(nullptr, this->m_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		if (data == MAP_FAILED)
+		{
+			int error = errno;
+			close(fileDescriptor);
+			throw FileMapException("Could not map file \"" + path + "\": " + std::strerror(error));
+		}
+		this->m_data = static_cast<unsigned char *>(data);
+
+		if (sequential)
+		{
+			madvise(this->m_data, this->m_size, MADV_SEQUENTIAL);
+			madvise(this->m_data, this->m_size, MADV_WILLNEED);
+		}
+	}
+
+	// The mapping stays valid after the file descriptor is closed.
+	close(fileDescriptor);
+}
+
+MappedFile::~MappedFile()
+{
+	if (this->m_data)
+		munmap(this->m_data, this->m_size);
+}
+
+const std::string &MappedFile::getPath() const
+{
+	return this->m_path;
+}
+
+const unsigned char *MappedFile::getData() const
+{
+	return this->m_data;
+}
+
+size_t MappedFile::getSize() const
+{
+	return this->m_size;
+}
@@ -0,0 +1,250 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "cedar/BakedFont.hpp"
+#include "cedar/AssetPack.hpp"
+#include "cedar/BlockCompressor.hpp"
+#include "cedar/MappedFile.hpp"
+
+using namespace cedar;
+
+static_assert(sizeof(BakedFontHeader) == 36, "The baked font header must not contain padding!");
+static_assert(sizeof(BakedFontGlyph) == 44, "The baked font glyph must not contain padding!");
+
+/**
+ * Calculates the size of the pixels of an atlas page in a baked font file.
+ *
+ * @param header The header of the baked font file.
+ * @return The size of the pixels of each page in bytes.
+ */
+size_t getBakedPageSize(const BakedFontHeader &header)
+{
+	size_t pixelCount = static_cast<size_t>(header.m_pageSize) * header.m_pageSize;
+	unsigned int channels = Texture::getBytesPerPixel(header.m_internalFormat);
+	if (!(header.m_flags & CEDAR_BAKED_FONT_COMPRESSED))
+		return pixelCount * channels;
+
+	// BC4 blocks are 8 bytes, BC3 blocks 16 bytes, both for 4x4 pixels.
+	return (pixelCount / 16) * (channels == 1 ? 8 : 16);
+}
+
+FontBakeException::FontBakeException(const std::string &message) : FontException(message)
+{}
+
+FontBaker::FontBaker()
+= default;
+
+std::vector<unsigned char> FontBaker::bake(const Font &font, const bool compress)
+{
+	unsigned int channels = Texture::getBytesPerPixel(font.m_internalFormat);
+	if (compress && channels != 1 && channels != 4)
+		throw FontBakeException("Could not bake font " + font.m_name + ". Only fonts with one or four channels can be compressed!");
+
+	std::vector<BakedFontGlyph> glyphs;
+	auto addGlyph = [&glyphs](unsigned int unicode, const Glyph *glyph) {
+		glyphs.push_back({unicode, glyph->m_size.x, glyph->m_size.y, glyph->m_bearing.x, glyph->m_bearing.y, glyph->m_advance,
+						  {glyph->m_uvs.x, glyph->m_uvs.y, glyph->m_uvs.z, glyph->m_uvs.w}, glyph->m_page});
+	};
+	for (unsigned int unicode = 0; unicode < CEDAR_FONT_DIRECT_GLYPH_COUNT; unicode++)
+	{
+		if (font.m_directGlyphs[unicode])
+			addGlyph(unicode, font.m_directGlyphs[unicode]);
+	}
+	for (const FontGlyphSlot &slot : font.m_glyphSlots)
+	{
+		if (slot.m_glyph)
+			addGlyph(slot.m_unicode, slot.m_glyph);
+	}
+	std::sort(glyphs.begin(), glyphs.end(), [](const BakedFontGlyph &a, const BakedFontGlyph &b) { return a.m_unicode < b.m_unicode; });
+
+	BakedFontHeader header = {};
+	std::memcpy(header.m_magic, CEDAR_BAKED_FONT_MAGIC, 4);
+	header.m_version = CEDAR_BAKED_FONT_VERSION;
+	header.m_size = font.m_size;
+	header.m_renderingMode = font.m_renderingMode;
+	header.m_internalFormat = font.m_internalFormat;
+	header.m_pageSize = CEDAR_FONT_ATLAS_PAGE_SIZE;
+	header.m_pageCount = static_cast<unsigned int>(font.m_atlasPages.size());
+	header.m_glyphCount = static_cast<unsigned int>(glyphs.size());
+	header.m_flags = compress ? CEDAR_BAKED_FONT_COMPRESSED : 0;
+
+	std::vector<unsigned char> data(sizeof(BakedFontHeader) + glyphs.size() * sizeof(BakedFontGlyph));
+	std::memcpy(data.data(), &header, sizeof(BakedFontHeader));
+	if (!glyphs.empty())
+		std::memcpy(data.data() + sizeof(BakedFontHeader), glyphs.data(), glyphs.size() * sizeof(BakedFontGlyph));
+
+	data.reserve(data.size() + getBakedPageSize(header) * header.m_pageCount);
+	for (const FontAtlasPage &page : font.m_atlasPages)
+	{
+		if (!compress)
+		{
+			data.insert(data.end(), page.m_pixels.begin(), page.m_pixels.end());
+			continue;
+		}
+
+		try
+		{
+			std::vector<unsigned char> blocks = BlockCompressor::compress(page.m_pixels.data(), CEDAR_FONT_ATLAS_PAGE_SIZE,
+																		  CEDAR_FONT_ATLAS_PAGE_SIZE, static_cast<int>(channels));
+			data.insert(data.end(), blocks.begin(), blocks.end());
+		}
+		catch (const BlockCompressionException &exception)
+		{
+			throw FontBakeException("Could not bake font " + font.m_name + ". " + exception.what());
+		}
+	}
+
+	return data;
+}
+
+void FontBaker::bake(const Font &font, const std::string &destinationPath, const bool compress)
+{
+	std::vector<unsigned char> bakedData = bake(font, compress);
+
+	std::ofstream destinationFile;
+	destinationFile.open(destinationPath, std::ofstream::binary | std::ofstream::trunc);
+	if (!destinationFile.is_open())
+	{
+		std::string message = "Could not bake font. Could not open file \"";
+		message.append(destinationPath);
+		message.append("\" for writing!");
+		throw FontBakeException(message);
+	}
+
+	destinationFile.write(reinterpret_cast<const char *>(bakedData.data()), static_cast<std::streamsize>(bakedData.size()));
+	destinationFile.close();
+	if (!destinationFile.good())
+		throw FontBakeException("Could not bake font. Could not write file \"" + destinationPath + "\"!");
+}
+
+BakedFont::BakedFont(const std::string &name, const std::string &path) : Font(name, 0, CEDAR_R8, CEDAR_RENDERING_SMOOTH)
+{
+	const unsigned char *data;
+	size_t dataSize;
+	MappedFile *file = nullptr;
+	if (!AssetPack::findAsset(path, &data, &dataSize))
+	{
+		try
+		{
+			file = new MappedFile(path, true);
+		}
+		catch (const FileMapException &exception)
+		{
+			throw FontCreationException("Could not create baked font " + name + "! " + exception.what());
+		}
+		data = file->getData();
+		dataSize = file->getSize();
+	}
+
+	try
+	{
+		BakedFontHeader header = {};
+		if (dataSize >= sizeof(BakedFontHeader))
+			std::memcpy(&header, data, sizeof(BakedFontHeader));
+
+		if (dataSize < sizeof(BakedFontHeader) || std::memcmp(header.m_magic, CEDAR_BAKED_FONT_MAGIC, 4) != 0)
+			throw FontCreationException("Could not create baked font " + name + "! " + path + " is not a baked font file!");
+
+		if (header.m_version != CEDAR_BAKED_FONT_VERSION)
+			throw FontCreationException("Could not create baked font " + name + "! Unsupported version " + std::to_string(header.m_version) + "!");
+
+		unsigned int channels = Texture::getBytesPerPixel(header.m_internalFormat);
+		if (channels == 0 || header.m_pageSize == 0 || header.m_pageSize % 4 != 0)
+			throw FontCreationException("Could not create baked font " + name + "! The atlas format of " + path + " is invalid!");
+
+		size_t pageDataSize = getBakedPageSize(header);
+		size_t glyphTableSize = static_cast<size_t>(header.m_glyphCount) * sizeof(BakedFontGlyph);
+		if (dataSize < sizeof(BakedFontHeader) + glyphTableSize + pageDataSize * header.m_pageCount)
+			throw FontCreationException("Could not create baked font " + name + "! " + path + " is truncated!");
+
+		this->m_size = header.m_size;
+		this->m_renderingMode = header.m_renderingMode;
+		this->m_internalFormat = header.m_internalFormat;
+
+		int textureFormat = this->m_internalFormat;
+		if (header.m_flags & CEDAR_BAKED_FONT_COMPRESSED)
+			textureFormat = BlockCompressor::getCompressedFormat(static_cast<int>(channels));
+
+		const unsigned char *pageData = data + sizeof(BakedFontHeader) + glyphTableSize;
+		auto pageSize = static_cast<int>(header.m_pageSize);
+		for (unsigned int n = 0; n < header.m_pageCount; n++)
+		{
+			auto *texture = new Texture2D(pageSize, pageSize, textureFormat, CEDAR_TEXTURE_2D);
+			try
+			{
+				texture->reserve(1);
+				this->initAtlasPage(texture);
+				if (header.m_flags & CEDAR_BAKED_FONT_COMPRESSED)
+					texture->uploadCompressed(0, 0, pageSize, pageSize, static_cast<int>(pageDataSize), pageData);
+				else
+					texture->upload(0, 0, pageSize, pageSize, Texture::sizedToUnsized(this->m_internalFormat), CEDAR_UNSIGNED_BYTE, pageData);
+			}
+			catch (...)
+			{
+				delete texture;
+				throw;
+			}
+
+			// Baked pages are full, glyphs generated later on always start a new page.
+			this->m_atlasPages.push_back({texture, SkylinePacker(0, 0), std::vector<unsigned char>(), 0, 0});
+			pageData += pageDataSize;
+		}
+
+		const unsigned char *glyphTable = data + sizeof(BakedFontHeader);
+		for (unsigned int n = 0; n < header.m_glyphCount; n++)
+		{
+			BakedFontGlyph glyph = {};
+			std::memcpy(&glyph, glyphTable + n * sizeof(BakedFontGlyph), sizeof(BakedFontGlyph));
+			if (glyph.m_page >= header.m_pageCount && glyph.m_width > 0 && glyph.m_height > 0)
+				throw FontCreationException("Could not create baked font " + name + "! The glyph of code point " + std::to_string(glyph.m_unicode) +
+											" is on a page that does not exist!");
+
+			this->insertGlyph(glyph.m_unicode, Glyph(Vector2i(glyph.m_width, glyph.m_height), Vector2i(glyph.m_bearingX, glyph.m_bearingY),
+													 glyph.m_advance, Vector4f(glyph.m_uvs[0], glyph.m_uvs[1], glyph.m_uvs[2], glyph.m_uvs[3]),
+													 glyph.m_page));
+		}
+	}
+	catch (...)
+	{
+		delete file;
+		throw;
+	}
+
+	delete file;
+}
+
+const Glyph *BakedFont::loadGlyph(const unsigned int unicode)
+{
+	const Glyph *replacement = this->findGlyph(0xFFFD);
+	if (!replacement)
+		replacement = this->findGlyph('?');
+
+	// The glyph is stored under the code point, so the replacement is only looked up once per missing character.
+	if (replacement)
+		return this->insertGlyph(unicode, *replacement);
+	else
+		return this->insertGlyph(unicode, Glyph(Vector2i(0, 0), Vector2i(0, 0), 0, Vector4f(0.0f, 0.0f, 0.0f, 0.0f)));
+}
+
+void BakedFont::initAtlasPage(Texture2D *texture) const
+{
+	if (Texture::getBytesPerPixel(this->m_internalFormat) == 1)
+	{
+		int swizzle[] = {CEDAR_ONE, CEDAR_ONE, CEDAR_ONE, CEDAR_RED};
+		texture->setParameteriv(CEDAR_TEXTURE_SWIZZLE_RGBA, swizzle);
+	}
+
+	if (this->m_renderingMode == CEDAR_RENDERING_SHARP)
+	{
+		texture->setParameteri(CEDAR_TEXTURE_MIN_FILTER, CEDAR_NEAREST);
+		texture->setParameteri(CEDAR_TEXTURE_MAG_FILTER, CEDAR_NEAREST);
+	}
+}
+
+void BakedFont::generateGlyphs(const unsigned int firstCharacter, const unsigned int lastCharacter)
+{}
@@ -2,6 +2,9 @@
 // Created by masy on 03.03.20.
 //
 
+#include <algorithm>
+#include <cstring>
+
 #include <cedar/Cedar.hpp>
 #include "cedar/Font.hpp"
 
@@ -10,6 +13,20 @@
 
 using namespace cedar;
 
+/**
+ * Hashes a unicode code point for the glyph hash table of a font.
+ *
+ * @param unicode The unicode code point.
+ * @return The hash of the code point.
+ */
+size_t hashCodePoint(const unsigned int unicode)
+{
+	// Multiplicative hashing spreads neighbouring code points, folding the upper half in makes the low bits depend
+	// on all bits of the code point.
+	unsigned int hash = unicode * 2654435761u;
+	return hash ^ (hash >> 16u);
+}
+
 FontException::FontException(const std::string &message) : XException(message)
 {}
 
@@ -24,30 +41,195 @@ Font::Font(const std::string &name, unsigned int size, int internalFormat, unsig
 	this->m_name = name;
 	this->m_size = size;
 	this->m_renderingMode = renderingMode;
-	this->m_atlasHeight = 128;
 	this->m_internalFormat = internalFormat;
+	this->m_headless = false;
+	this->m_glyphBlocks = std::vector<Glyph *>();
+	this->m_glyphCount = 0;
+	std::fill(std::begin(this->m_directGlyphs), std::end(this->m_directGlyphs), nullptr);
+	this->m_glyphSlots = std::vector<FontGlyphSlot>();
+	this->m_hashedGlyphCount = 0;
+}
 
-	this->m_glyphAtlas = new Texture2D(CEDAR_FONT_ATLAS_WIDTH, this->m_atlasHeight, internalFormat, CEDAR_TEXTURE_2D);
-	this->m_glyphAtlas->init(Texture::sizedToUnsized(internalFormat), CEDAR_UNSIGNED_BYTE, nullptr);
+Font::~Font()
+{
+	for (const FontAtlasPage &page : this->m_atlasPages)
+	{
+		delete page.m_texture;
+	}
+	for (Glyph *block : this->m_glyphBlocks)
+	{
+		delete[] block;
+	}
+}
+
+Glyph *Font::findGlyph(const unsigned int unicode) const
+{
+	if (unicode < CEDAR_FONT_DIRECT_GLYPH_COUNT)
+		return this->m_directGlyphs[unicode];
+
+	if (this->m_glyphSlots.empty())
+		return nullptr;
 
-	this->m_currentOffsetX = 0;
-	this->m_currentOffsetY = 0;
-	this->m_tallestCharacterInRow = 0;
-	this->m_glyphs = std::map<unsigned int, Glyph *>();
-	this->m_glyphData = nullptr;
+	size_t mask = this->m_glyphSlots.size() - 1;
+	for (size_t index = hashCodePoint(unicode) & mask;; index = (index + 1) & mask)
+	{
+		const FontGlyphSlot &slot = this->m_glyphSlots[index];
+		if (!slot.m_glyph || slot.m_unicode == unicode)
+			return slot.m_glyph;
+	}
 }
 
-Font::~Font()
-= default;
+Glyph *Font::insertGlyph(const unsigned int unicode, const Glyph &glyph)
+{
+	if (this->m_glyphCount == this->m_glyphBlocks.size() * CEDAR_FONT_GLYPH_BLOCK_SIZE)
+		this->m_glyphBlocks.push_back(new Glyph[CEDAR_FONT_GLYPH_BLOCK_SIZE]);
+
+	Glyph *arenaGlyph = &this->m_glyphBlocks.back()[this->m_glyphCount % CEDAR_FONT_GLYPH_BLOCK_SIZE];
+	*arenaGlyph = glyph;
+	this->m_glyphCount++;
+
+	if (unicode < CEDAR_FONT_DIRECT_GLYPH_COUNT)
+	{
+		this->m_directGlyphs[unicode] = arenaGlyph;
+		return arenaGlyph;
+	}
+
+	// The table grows once it is more than half full, which keeps the probe sequences short.
+	if ((this->m_hashedGlyphCount + 1) * 2 > this->m_glyphSlots.size())
+	{
+		std::vector<FontGlyphSlot> oldSlots(std::max<size_t>(64, this->m_glyphSlots.size() * 2), {0, nullptr});
+		oldSlots.swap(this->m_glyphSlots);
+		size_t mask = this->m_glyphSlots.size() - 1;
+		for (const FontGlyphSlot &slot : oldSlots)
+		{
+			if (!slot.m_glyph)
+				continue;
+
+			size_t index = hashCodePoint(slot.m_unicode) & mask;
+			while (this->m_glyphSlots[index].m_glyph)
+				index = (index + 1) & mask;
+			this->m_glyphSlots[index] = slot;
+		}
+	}
+
+	size_t mask = this->m_glyphSlots.size() - 1;
+	size_t index = hashCodePoint(unicode) & mask;
+	while (this->m_glyphSlots[index].m_glyph && this->m_glyphSlots[index].m_unicode != unicode)
+		index = (index + 1) & mask;
+
+	if (!this->m_glyphSlots[index].m_glyph)
+		this->m_hashedGlyphCount++;
+	this->m_glyphSlots[index] = {unicode, arenaGlyph};
+	return arenaGlyph;
+}
+
+void Font::initAtlasPage(Texture2D *texture) const
+{}
+
+void Font::addAtlasPage()
+{
+	Texture2D *texture = nullptr;
+	if (!this->m_headless)
+	{
+		texture = new Texture2D(CEDAR_FONT_ATLAS_PAGE_SIZE, CEDAR_FONT_ATLAS_PAGE_SIZE, this->m_internalFormat, CEDAR_TEXTURE_2D);
+		try
+		{
+			texture->reserve(1);
+			this->initAtlasPage(texture);
+		}
+		catch (...)
+		{
+			delete texture;
+			throw;
+		}
+	}
+
+	size_t pageSize = static_cast<size_t>(CEDAR_FONT_ATLAS_PAGE_SIZE) * CEDAR_FONT_ATLAS_PAGE_SIZE * Texture::getBytesPerPixel(this->m_internalFormat);
+	this->m_atlasPages.push_back({texture, SkylinePacker(CEDAR_FONT_ATLAS_PAGE_SIZE, CEDAR_FONT_ATLAS_PAGE_SIZE),
+								  std::vector<unsigned char>(pageSize, 0), 0, 0});
+}
 
-void Font::resize()
+Glyph *Font::addGlyph(const GlyphData &glyphData, const unsigned int scale)
 {
-	this->m_glyphAtlas->setSize(CEDAR_FONT_ATLAS_WIDTH, this->m_atlasHeight * 2);
-	for (auto pair : this->m_glyphs)
+	Vector2i size(glyphData.m_size.x * static_cast<int>(scale), glyphData.m_size.y * static_cast<int>(scale));
+	if (glyphData.m_size.x <= 0 || glyphData.m_size.y <= 0 || !glyphData.m_data)
+	{
+		return this->insertGlyph(glyphData.m_unicode, Glyph(size, glyphData.m_bearing, glyphData.m_advance, Vector4f(0.0f, 0.0f, 0.0f, 0.0f)));
+	}
+
+	int paddedWidth = glyphData.m_size.x + CEDAR_FONT_GLYPH_PADDING * 2;
+	int paddedHeight = glyphData.m_size.y + CEDAR_FONT_GLYPH_PADDING * 2;
+	if (paddedWidth > CEDAR_FONT_ATLAS_PAGE_SIZE || paddedHeight > CEDAR_FONT_ATLAS_PAGE_SIZE)
+		throw FontLoadException("Could not add glyph for code point " + std::to_string(glyphData.m_unicode) + " to font " + this->m_name +
+								"! The glyph is larger than an atlas page!");
+
+	// Earlier pages are tried first, they only fail for glyphs that are too large for their remaining gaps.
+	unsigned int pageIndex = 0;
+	int x = 0;
+	int y = 0;
+	while (pageIndex < this->m_atlasPages.size() && !this->m_atlasPages[pageIndex].m_packer.insert(paddedWidth, paddedHeight, &x, &y))
+		pageIndex++;
+
+	if (pageIndex == this->m_atlasPages.size())
+	{
+		this->addAtlasPage();
+		this->m_atlasPages[pageIndex].m_packer.insert(paddedWidth, paddedHeight, &x, &y);
+	}
+
+	FontAtlasPage &page = this->m_atlasPages[pageIndex];
+	x += CEDAR_FONT_GLYPH_PADDING;
+	y += CEDAR_FONT_GLYPH_PADDING;
+
+	size_t bytesPerPixel = Texture::getBytesPerPixel(this->m_internalFormat);
+	size_t rowSize = static_cast<size_t>(glyphData.m_size.x) * bytesPerPixel;
+	for (int row = 0; row < glyphData.m_size.y; row++)
 	{
-		pair.second->m_uvs.y *= 0.5f;
-		pair.second->m_uvs.w *= 0.5f;
+		std::memcpy(page.m_pixels.data() + ((static_cast<size_t>(y) + row) * CEDAR_FONT_ATLAS_PAGE_SIZE + x) * bytesPerPixel,
+					glyphData.m_data + row * rowSize, rowSize);
 	}
+
+	if (page.m_dirtyBottom <= page.m_dirtyTop)
+	{
+		page.m_dirtyTop = y;
+		page.m_dirtyBottom = y + glyphData.m_size.y;
+	}
+	else
+	{
+		page.m_dirtyTop = std::min(page.m_dirtyTop, y);
+		page.m_dirtyBottom = std::max(page.m_dirtyBottom, y + glyphData.m_size.y);
+	}
+
+	float pixelSize = 1.0f / CEDAR_FONT_ATLAS_PAGE_SIZE;
+	return this->insertGlyph(glyphData.m_unicode,
+							 Glyph(size, glyphData.m_bearing, glyphData.m_advance,
+								   Vector4f(pixelSize * static_cast<float>(x),
+											pixelSize * static_cast<float>(y),
+											pixelSize * static_cast<float>(x + glyphData.m_size.x),
+											pixelSize * static_cast<float>(y + glyphData.m_size.y)),
+								   pageIndex));
+}
+
+void Font::uploadGlyphs()
+{
+	size_t rowSize = static_cast<size_t>(CEDAR_FONT_ATLAS_PAGE_SIZE) * Texture::getBytesPerPixel(this->m_internalFormat);
+	for (FontAtlasPage &page : this->m_atlasPages)
+	{
+		if (page.m_dirtyBottom <= page.m_dirtyTop)
+			continue;
+
+		// Whole rows are uploaded, so the band is contiguous in the memory copy of the page.
+		if (page.m_texture)
+			page.m_texture->upload(0, page.m_dirtyTop, CEDAR_FONT_ATLAS_PAGE_SIZE, page.m_dirtyBottom - page.m_dirtyTop,
+								   Texture::sizedToUnsized(this->m_internalFormat), CEDAR_UNSIGNED_BYTE,
+								   page.m_pixels.data() + page.m_dirtyTop * rowSize);
+		page.m_dirtyTop = 0;
+		page.m_dirtyBottom = 0;
+	}
+}
+
+void Font::setHeadless(const bool headless)
+{
+	this->m_headless = headless;
 }
 
 unsigned int Font::getSize() const
@@ -60,20 +242,29 @@ unsigned int Font::getRenderingMode() const
 	return this->m_renderingMode;
 }
 
+bool Font::isDistanceField() const
+{
+	return this->m_renderingMode == CEDAR_RENDERING_SDF;
+}
+
 const Glyph *Font::getGlyph(const unsigned int unicode)
 {
-	auto it = this->m_glyphs.find(unicode);
-	if (it != this->m_glyphs.end())
-	{
-		return it->second;
-	}
+	const Glyph *glyph = this->findGlyph(unicode);
+	if (glyph)
+		return glyph;
 	else
-	{
 		return this->loadGlyph(unicode);
-	}
 }
 
-const Texture2D *Font::getGlyphAtlas() const
+const Texture2D *Font::getGlyphAtlas(const unsigned int page) const
+{
+	if (page >= this->m_atlasPages.size())
+		return nullptr;
+
+	return this->m_atlasPages[page].m_texture;
+}
+
+unsigned int Font::getGlyphAtlasCount() const
 {
-	return this->m_glyphAtlas;
+	return static_cast<unsigned int>(this->m_atlasPages.size());
 }
@@ -8,6 +8,7 @@
 #include "cedar/FontRegistry.hpp"
 #include "cedar/FreeTypeFont.hpp"
 #include "cedar/PTFFont.hpp"
+#include "cedar/BakedFont.hpp"
 
 using namespace cedar;
 
@@ -16,8 +17,19 @@ std::map<std::string, std::shared_ptr<Font>> FontRegistry::m_loadedFonts = std::
 std::shared_ptr<Font> FontRegistry::loadFont(const std::string &name, const std::string &path, const unsigned int size, const unsigned int firstCharacter,
 							 const unsigned int lastCharacter, const unsigned int renderingMode)
 {
-	std::regex ptfPattern("^.*(\\.ptf)$");
+	std::regex bakedPattern("^.*(\\.cbf)$");
 	std::smatch matcher;
+	std::regex_match(path, matcher, bakedPattern);
+
+	// Baked fonts already contain all their glyphs, the size and character range are part of the file.
+	if (!matcher.empty())
+	{
+		std::shared_ptr<Font> font = std::shared_ptr<Font>(new BakedFont(name, path));
+		m_loadedFonts.insert(std::make_pair(name, font));
+		return font;
+	}
+
+	std::regex ptfPattern("^.*(\\.ptf)$");
 	std::regex_match(path, matcher, ptfPattern);
 
 	if (!matcher.empty())
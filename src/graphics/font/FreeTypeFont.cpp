@@ -2,10 +2,131 @@
 // Created by masy on 11.04.20.
 //
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
 #include "cedar/FreeTypeFont.hpp"
+#include "cedar/AssetPack.hpp"
+#include "cedar/ThreadPool.hpp"
 
 using namespace cedar;
 
+// FreeType renders signed distance fields itself since 2.11.
+#if FREETYPE_MAJOR > 2 || (FREETYPE_MAJOR == 2 && FREETYPE_MINOR >= 11)
+#define CEDAR_FREETYPE_NATIVE_SDF
+#endif
+
+/**
+ * Calculates the squared euclidean distance transform of a single row or column.
+ *
+ * <p>This is the lower envelope of parabolas by Felzenszwalb and Huttenlocher, which is exact and linear in the
+ * number of samples.</p>
+ *
+ * @param f The squared distances of the samples so far, <code>1e20</code> for samples without a feature.
+ * @param d A pointer to the array the squared distances will be written to.
+ * @param n The number of samples.
+ * @param v A pointer to an array with space for <code>n</code> parabola locations.
+ * @param z A pointer to an array with space for <code>n + 1</code> parabola boundaries.
+ */
+void distanceTransform1D(const float *f, float *d, const int n, int *v, float *z)
+{
+	int k = 0;
+	v[0] = 0;
+	z[0] = -1e20f;
+	z[1] = 1e20f;
+	for (int q = 1; q < n; q++)
+	{
+		float s = ((f[q] + static_cast<float>(q * q)) - (f[v[k]] + static_cast<float>(v[k] * v[k]))) / static_cast<float>(2 * (q - v[k]));
+		while (s <= z[k])
+		{
+			k--;
+			s = ((f[q] + static_cast<float>(q * q)) - (f[v[k]] + static_cast<float>(v[k] * v[k]))) / static_cast<float>(2 * (q - v[k]));
+		}
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = 1e20f;
+	}
+
+	k = 0;
+	for (int q = 0; q < n; q++)
+	{
+		while (z[k + 1] < static_cast<float>(q))
+			k++;
+		d[q] = static_cast<float>((q - v[k]) * (q - v[k])) + f[v[k]];
+	}
+}
+
+/**
+ * Converts the coverage bitmap of a glyph to a signed distance field.
+ *
+ * <p>The bitmap grows by the spread on every side, so the field can fade out around the outline. The outline lies
+ * at a value of 128, inside of the glyph the values are higher.</p>
+ *
+ * @param glyphData A pointer to the glyph data whose bitmap will be replaced.
+ * @param spread The distance in pixel at which the field is saturated.
+ */
+void createDistanceField(GlyphData *glyphData, const int spread)
+{
+	int width = glyphData->m_size.x + spread * 2;
+	int height = glyphData->m_size.y + spread * 2;
+	size_t pixelCount = static_cast<size_t>(width) * height;
+
+	// Squared distance of every pixel to the nearest pixel inside and outside of the glyph.
+	std::vector<float> outside(pixelCount, 1e20f);
+	std::vector<float> inside(pixelCount, 0.0f);
+	for (int y = 0; y < glyphData->m_size.y; y++)
+	{
+		for (int x = 0; x < glyphData->m_size.x; x++)
+		{
+			if (glyphData->m_data[y * glyphData->m_size.x + x] >= 128)
+			{
+				size_t index = static_cast<size_t>(y + spread) * width + x + spread;
+				outside[index] = 0.0f;
+				inside[index] = 1e20f;
+			}
+		}
+	}
+
+	int length = std::max(width, height);
+	std::vector<float> f(length);
+	std::vector<float> d(length);
+	std::vector<int> v(length);
+	std::vector<float> z(length + 1);
+	for (std::vector<float> *grid : {&outside, &inside})
+	{
+		for (int x = 0; x < width; x++)
+		{
+			for (int y = 0; y < height; y++)
+				f[y] = (*grid)[static_cast<size_t>(y) * width + x];
+			distanceTransform1D(f.data(), d.data(), height, v.data(), z.data());
+			for (int y = 0; y < height; y++)
+				(*grid)[static_cast<size_t>(y) * width + x] = d[y];
+		}
+		for (int y = 0; y < height; y++)
+		{
+			float *row = grid->data() + static_cast<size_t>(y) * width;
+			distanceTransform1D(row, d.data(), width, v.data(), z.data());
+			std::copy(d.begin(), d.begin() + width, row);
+		}
+	}
+
+	auto *field = new unsigned char[pixelCount];
+	float scale = 128.0f / static_cast<float>(spread);
+	for (size_t n = 0; n < pixelCount; n++)
+	{
+		float distance = std::sqrt(inside[n]) - std::sqrt(outside[n]);
+		field[n] = static_cast<unsigned char>(std::clamp(128.0f + distance * scale, 0.0f, 255.0f));
+	}
+
+	delete[] glyphData->m_data;
+	glyphData->m_data = field;
+	glyphData->m_size = Vector2i(width, height);
+	glyphData->m_bearing = Vector2i(glyphData->m_bearing.x - spread, glyphData->m_bearing.y + spread);
+}
+
 FreeTypeInitException::FreeTypeInitException(const std::string &message) : FontException(message)
 {}
 
@@ -27,44 +148,76 @@ FT_Library &FreeTypeFont::getFontLibrary()
 FreeTypeFont::FreeTypeFont(const std::string &name, const std::string &path, unsigned int size, unsigned int renderingMode)
 						   : Font(name, size, CEDAR_R8, renderingMode)
 {
-	int swizzle[] = {CEDAR_ONE, CEDAR_ONE, CEDAR_ONE, CEDAR_RED};
-	this->m_glyphAtlas->setParameteriv(CEDAR_TEXTURE_SWIZZLE_RGBA, swizzle);
-
+	this->m_path = path;
 	this->m_face = FT_Face();
-	if (FT_New_Face(getFontLibrary(), path.c_str(), 0, &this->m_face))
+	this->m_workerFaces = std::vector<FreeTypeWorkerFace>();
+	this->openFace(getFontLibrary(), &this->m_face);
+}
+
+FreeTypeFont::~FreeTypeFont()
+{
+	for (const FreeTypeWorkerFace &workerFace : this->m_workerFaces)
+	{
+		FT_Done_Face(workerFace.m_face);
+		FT_Done_FreeType(workerFace.m_library);
+	}
+	FT_Done_Face(this->m_face);
+}
+
+void FreeTypeFont::openFace(FT_Library library, FT_Face *face) const
+{
+	// Faces created from memory keep referencing the data, which is fine since asset packs stay mapped while mounted.
+	const unsigned char *packData;
+	size_t packDataSize;
+	FT_Error error;
+	if (AssetPack::findAsset(this->m_path, &packData, &packDataSize))
+		error = FT_New_Memory_Face(library, packData, static_cast<FT_Long>(packDataSize), 0, face);
+	else
+		error = FT_New_Face(library, this->m_path.c_str(), 0, face);
+
+	if (error)
 	{
 		std::string message = "Could not load FreeType font \"";
-		message.append(name);
+		message.append(this->m_name);
 		message.append("\" from file \"");
-		message.append(path);
+		message.append(this->m_path);
 		message.append("\"!");
 		throw FontCreationException(message);
 	}
+
+	// The size is set once here instead of before every glyph.
+	FT_Set_Pixel_Sizes(*face, 0, this->m_size);
 }
 
-FreeTypeFont::~FreeTypeFont()
+void FreeTypeFont::initAtlasPage(Texture2D *texture) const
 {
-	FT_Done_Face(this->m_face);
-	delete this->m_glyphAtlas;
-	for (const auto &pair : this->m_glyphs)
-	{
-		delete pair.second;
-	}
+	int swizzle[] = {CEDAR_ONE, CEDAR_ONE, CEDAR_ONE, CEDAR_RED};
+	texture->setParameteriv(CEDAR_TEXTURE_SWIZZLE_RGBA, swizzle);
 }
 
-const Glyph *FreeTypeFont::loadGlyph(const unsigned int unicode)
+void FreeTypeFont::renderGlyph(FT_Face face, const unsigned int unicode, GlyphData *glyphData) const
 {
-	// Set the size of all glyphs.
-	FT_Set_Pixel_Sizes(this->m_face, 0, this->m_size);
-
-	FT_Render_Mode ftRenderMode = this->m_renderingMode ? FT_RENDER_MODE_NORMAL : FT_RENDER_MODE_MONO;
+	// Expands the eight bits of a byte of a mono bitmap to eight pixels, most significant bit first.
+	static const std::array<std::array<unsigned char, 8>, 256> monoPixels = []() {
+		std::array<std::array<unsigned char, 8>, 256> table{};
+		for (unsigned int byte = 0; byte < 256; byte++)
+		{
+			for (unsigned int bit = 0; bit < 8; bit++)
+				table[byte][bit] = ((byte >> (7 - bit)) & 0x1U) ? 255 : 0;
+		}
+		return table;
+	}();
 
-	this->m_glyphData = new GlyphData();
+	FT_Render_Mode ftRenderMode = this->m_renderingMode == CEDAR_RENDERING_SHARP ? FT_RENDER_MODE_MONO : FT_RENDER_MODE_NORMAL;
+#ifdef CEDAR_FREETYPE_NATIVE_SDF
+	if (this->m_renderingMode == CEDAR_RENDERING_SDF)
+		ftRenderMode = FT_RENDER_MODE_SDF;
+#endif
 
 	// Render glyph image
-	unsigned int glyphIndex = FT_Get_Char_Index(this->m_face, unicode);
-	FT_Load_Glyph(this->m_face, glyphIndex, FT_LOAD_DEFAULT);
-	FT_GlyphSlot glyphSlot = this->m_face->glyph;
+	unsigned int glyphIndex = FT_Get_Char_Index(face, unicode);
+	FT_Load_Glyph(face, glyphIndex, FT_LOAD_DEFAULT);
+	FT_GlyphSlot glyphSlot = face->glyph;
 	FT_Render_Glyph(glyphSlot, ftRenderMode);
 
 	// Get glyph metrics
@@ -73,300 +226,114 @@ const Glyph *FreeTypeFont::loadGlyph(const unsigned int unicode)
 	unsigned int glyphSize = glyphWidth * glyphHeight;
 
 	// Allocate memory for the image data
-	this->m_glyphData->m_data = new unsigned char[glyphSize];
+	glyphData->m_data = new unsigned char[glyphSize];
+
+	// The pitch defines the number of bytes in one row of the bitmap, which may be more than the width.
+	unsigned int glyphPitch = std::abs(glyphSlot->bitmap.pitch);
 
 	// FreeType stores mono rendered glyphs in bits, so it requires special handling
 	if (glyphSlot->bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
 	{
-		// The pitch defines the number of bytes in one row of the bitmap.
-		// Since the image buffer is in bits, there are multiple pixel per byte
-		unsigned int glyphPitch = std::abs(glyphSlot->bitmap.pitch);
-		unsigned int dataIndex = 0;
 		for (unsigned int y = 0; y < glyphHeight; y++)
 		{
-			// Set the number of pixels that need to be read.
-			int pixelLeft = static_cast<int>(glyphWidth);
-			for (int x = 0; x < glyphPitch; x++)
-			{
-				unsigned int byte = glyphSlot->bitmap.buffer[y * glyphPitch + x];
-
-				// Check how many bits need to be read from the byte.
-				// Since the bits are stored left-to-right this is actually the lower boundary.
-				int boundary = std::max(8 - pixelLeft, 0);
-				for (int m = 7; m >= boundary; m--)
-				{
-					this->m_glyphData->m_data[dataIndex++] = ((byte >> m) & 0x1U) ? 255 : 0;
-				}
-				// Update the amount of bits left
-				pixelLeft -= 8;
-			}
+			const unsigned char *row = glyphSlot->bitmap.buffer + y * glyphPitch;
+			unsigned char *destination = glyphData->m_data + y * glyphWidth;
+			unsigned int x = 0;
+			for (; x + 8 <= glyphWidth; x += 8)
+				std::memcpy(destination + x, monoPixels[row[x >> 3]].data(), 8);
+			if (x < glyphWidth)
+				std::memcpy(destination + x, monoPixels[row[x >> 3]].data(), glyphWidth - x);
 		}
 	}
 	else
 	{
-		for (unsigned int n = 0; n < glyphSize; n++)
-		{
-			this->m_glyphData->m_data[n] = glyphSlot->bitmap.buffer[n];
-		}
+		for (unsigned int y = 0; y < glyphHeight; y++)
+			std::memcpy(glyphData->m_data + y * glyphWidth, glyphSlot->bitmap.buffer + y * glyphPitch, glyphWidth);
 	}
 
-	this->m_glyphData->m_unicode = unicode;
-	this->m_glyphData->m_size = Vector2i(static_cast<int>(glyphWidth), static_cast<int>(glyphHeight));
-	this->m_glyphData->m_bearing = Vector2i(glyphSlot->bitmap_left, glyphSlot->bitmap_top);
-	this->m_glyphData->m_advance = static_cast<unsigned int>(glyphSlot->advance.x) >> 6U; // freetype stores the advance as 1/64th pixel
+	glyphData->m_unicode = unicode;
+	glyphData->m_size = Vector2i(static_cast<int>(glyphWidth), static_cast<int>(glyphHeight));
+	glyphData->m_bearing = Vector2i(glyphSlot->bitmap_left, glyphSlot->bitmap_top);
+	glyphData->m_advance = static_cast<unsigned int>(glyphSlot->advance.x) >> 6U; // freetype stores the advance as 1/64th pixel
 
-	auto glyph = this->createGlyph();
-	delete this->m_glyphData;
-	return glyph;
+#ifndef CEDAR_FREETYPE_NATIVE_SDF
+	// Older FreeType versions can't render distance fields, so they are calculated from the smooth bitmap instead.
+	if (this->m_renderingMode == CEDAR_RENDERING_SDF && glyphWidth > 0 && glyphHeight > 0)
+		createDistanceField(glyphData, CEDAR_FONT_SDF_SPREAD);
+#endif
 }
 
-const Glyph *FreeTypeFont::createGlyph()
+const Glyph *FreeTypeFont::loadGlyph(const unsigned int unicode)
 {
-	// Check if the glyph fits on the glyph atlas vertically
-	if (this->m_currentOffsetY + this->m_glyphData->m_size.y >= this->m_atlasHeight)
-		this->resize();
-
-	// Check if the glyph fits on the texture horizontally
-	if (this->m_currentOffsetX + this->m_glyphData->m_size.x >= CEDAR_FONT_ATLAS_WIDTH)
-	{
-		this->m_currentOffsetY += this->m_tallestCharacterInRow;
-
-		// Since we advanced the y offset we need to check for space again
-		if (this->m_currentOffsetY + this->m_glyphData->m_size.y >= this->m_atlasHeight)
-			this->resize();
-
-		// Reset x offset to 0 because of new row
-		this->m_currentOffsetX = 0;
-		this->m_tallestCharacterInRow = this->m_glyphData->m_size.y;
-	}
-	else if (this->m_glyphData->m_size.y > this->m_tallestCharacterInRow)
-	{
-		this->m_tallestCharacterInRow = this->m_glyphData->m_size.y;
-	}
-
-	float pixelWidth = 1.0f / CEDAR_FONT_ATLAS_WIDTH;
-	float pixelHeight = 1.0f / static_cast<float>(this->m_atlasHeight);
-	auto glyph = new Glyph(this->m_glyphData->m_size,
-						   this->m_glyphData->m_bearing,
-						   this->m_glyphData->m_advance,
-						   Vector4f(pixelWidth * static_cast<float>(this->m_currentOffsetX),
-									pixelHeight * static_cast<float>(this->m_currentOffsetY),
-									pixelWidth * static_cast<float>(this->m_currentOffsetX + static_cast<int>(this->m_glyphData->m_size.x)),
-									pixelHeight * static_cast<float>(this->m_currentOffsetY + static_cast<int>(this->m_glyphData->m_size.y))
-								   )
-						  );
-
-	this->m_glyphAtlas->upload(static_cast<int>(this->m_currentOffsetX), static_cast<int>(this->m_currentOffsetY),
-							   static_cast<int>(this->m_glyphData->m_size.x), static_cast<int>(this->m_glyphData->m_size.y),
-							   Texture::sizedToUnsized(this->m_internalFormat), CEDAR_UNSIGNED_BYTE, this->m_glyphData->m_data);
-
-	this->m_currentOffsetX += this->m_glyphData->m_size.x;
-
-	this->m_glyphs.insert(std::make_pair(this->m_glyphData->m_unicode, glyph));
+	GlyphData glyphData;
+	this->renderGlyph(this->m_face, unicode, &glyphData);
+	auto glyph = this->addGlyph(glyphData);
+	this->uploadGlyphs();
 	return glyph;
 }
 
-void FreeTypeFont::stitchAtlas(unsigned int firstIndex, unsigned int lastIndex, const cedar::Vector4ui &region)
+void FreeTypeFont::generateGlyphs(const unsigned int firstCharacter, const unsigned int lastCharacter)
 {
-	float pixelWidth = 1.0f / CEDAR_FONT_ATLAS_WIDTH;
-	float pixelHeight = 1.0f / static_cast<float>(this->m_atlasHeight);
-
-	// Calculate region length
-	unsigned int regionDataLength = region.z * region.w;
-	// Allocate memory with calloc to avoid artifacts near the glyphs since we only write to the region where there are glyph images
-	unsigned char *regionData = reinterpret_cast<unsigned char *>(calloc(regionDataLength, 1));
-
-	// Stitch region together
-	for (unsigned int n = firstIndex; n < lastIndex; n++)
-	{
-		GlyphData *glyphData = &this->m_glyphData[n];
-		Glyph *glyph = new Glyph(glyphData->m_size,
-								 glyphData->m_bearing,
-								 glyphData->m_advance,
-								 Vector4f(pixelWidth * static_cast<float>(glyphData->m_offset.x),
-										  pixelHeight * static_cast<float>(glyphData->m_offset.y),
-										  pixelWidth * static_cast<float>(glyphData->m_offset.x + glyphData->m_size.x),
-										  pixelHeight * static_cast<float>(glyphData->m_offset.y + glyphData->m_size.y)
-										 )
-								);
-
-		// Copy glyph image into region data
-		for (int x = 0; x < glyphData->m_size.x; x++)
-		{
-			for (int y = 0; y < glyphData->m_size.y; y++)
-			{
-				unsigned int regionIndex = region.z * (glyphData->m_offset.y - region.y + y) + x + glyphData->m_offset.x;
-				unsigned int dataIndex = glyphData->m_size.x * y + x;
-				regionData[regionIndex] = glyphData->m_data[dataIndex];
-			}
-		}
-
-		this->m_glyphs.insert(std::make_pair(glyphData->m_unicode, glyph));
-	}
-
-	// Upload region to texture
-	this->m_glyphAtlas->upload(static_cast<int>(region.x), static_cast<int>(region.y),
-							   static_cast<int>(region.z), static_cast<int>(region.w),
-							   Texture::sizedToUnsized(this->m_internalFormat), CEDAR_UNSIGNED_BYTE, regionData);
-
-	free(regionData);
+	this->warmRange(firstCharacter, lastCharacter);
 }
 
-void FreeTypeFont::generateGlyphs(const unsigned int firstCharacter, const unsigned int lastCharacter)
+void FreeTypeFont::warmRange(const unsigned int firstCharacter, const unsigned int lastCharacter)
 {
-	// Set the size of all glyphs.
-	FT_Set_Pixel_Sizes(this->m_face, 0, this->m_size);
-
-	// Count glyphs and allocate memory for them.
-	unsigned int glyphCount = lastCharacter - firstCharacter + 1;
-	this->m_glyphData = new GlyphData[glyphCount];
-
-	FT_Render_Mode ftRenderMode = this->m_renderingMode ? FT_RENDER_MODE_NORMAL : FT_RENDER_MODE_MONO;
-
-	// We split the glyphs into two regions to avoid uploading every single glyph with a call to the graphics card,
-	// but since we might generate glyphs for multiple rows and the first could start somewhere in the middle
-	// of the texture we need two separate regions. If the row does not change while generating glyphs only the first
-	// region is needed.
-	Vector4ui firstRegion(this->m_currentOffsetX, this->m_currentOffsetY, 0, 0);
-	int glyphsInFirstRegion = 0;
-	Vector4ui secondRegion(0, 0, 0, 0);
-	bool needsTwoRegions = false;
-
-	unsigned int glyphDataIndex = 0;
-	for (unsigned int unicode = firstCharacter; unicode <= lastCharacter; unicode++)
+	std::vector<unsigned int> codePoints;
+	for (unsigned int unicode = firstCharacter; unicode >= firstCharacter && unicode <= lastCharacter; unicode++)
 	{
 		// skip already generated glyphs
-		auto it = this->m_glyphs.find(unicode);
-		if (it != this->m_glyphs.end())
-		{
-			// Also reduce the glyph count since we didn't generate data for this one.
-			glyphCount--;
-			continue;
-		}
-
-		// Render glyph image
-		unsigned int glyphIndex = FT_Get_Char_Index(this->m_face, unicode);
-		FT_Load_Glyph(this->m_face, glyphIndex, FT_LOAD_DEFAULT);
-		FT_GlyphSlot glyphSlot = this->m_face->glyph;
-		FT_Render_Glyph(glyphSlot, ftRenderMode);
+		if (!this->findGlyph(unicode))
+			codePoints.push_back(unicode);
+	}
 
-		// Get glyph metrics
-		unsigned int glyphWidth = glyphSlot->bitmap.width;
-		unsigned int glyphHeight = glyphSlot->bitmap.rows;
-		unsigned int glyphSize = glyphWidth * glyphHeight;
+	if (codePoints.empty())
+		return;
 
-		// Allocate memory for the image data
-		this->m_glyphData[glyphDataIndex].m_data = new unsigned char[glyphSize];
+	// Small ranges are not worth creating the worker faces.
+	ThreadPool *threadPool = ThreadPool::getInstance();
+	size_t taskCount = std::min(static_cast<size_t>(threadPool->getThreadCount()) + 1,
+								(codePoints.size() + CEDAR_FREETYPE_GLYPHS_PER_TASK - 1) / CEDAR_FREETYPE_GLYPHS_PER_TASK);
 
-		// Freetype stores mono rendered glyphs in bits, so it requires special handling
-		if (glyphSlot->bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
-		{
-			// The pitch defines the number of bytes in one row of the bitmap.
-			// Since the image buffer is in bits, there are multiple pixel per byte
-			unsigned int glyphPitch = std::abs(glyphSlot->bitmap.pitch);
-			unsigned int dataIndex = 0;
-			for (unsigned int y = 0; y < glyphHeight; y++)
-			{
-				// Set the number of pixels that need to be read.
-				int pixelLeft = static_cast<int>(glyphWidth);
-				for (int x = 0; x < glyphPitch; x++)
-				{
-					unsigned int byte = glyphSlot->bitmap.buffer[y * glyphPitch + x];
-
-					// Check how many bits need to be read from the byte.
-					// Since the bits are stored left-to-right this is actually the lower boundary.
-					int boundary = std::max(8 - pixelLeft, 0);
-					for (int m = 7; m >= boundary; m--)
-					{
-						this->m_glyphData[glyphDataIndex].m_data[dataIndex++] = ((byte >> m) & 0x1U) ? 255 : 0;
-					}
-					// Update the amount of bits left
-					pixelLeft -= 8;
-				}
-			}
-		}
-		else
-		{
-			for (unsigned int n = 0; n < glyphSize; n++)
-			{
-				this->m_glyphData[glyphDataIndex].m_data[n] = glyphSlot->bitmap.buffer[n];
-			}
-		}
-
-		// Check if the glyph fits on the glyph atlas vertically
-		if (this->m_currentOffsetY + glyphHeight >= this->m_atlasHeight)
-			this->resize();
-
-		// Check if the glyph fits on the texture horizontally
-		if (this->m_currentOffsetX + glyphWidth >= CEDAR_FONT_ATLAS_WIDTH)
+	std::vector<GlyphData> glyphData(codePoints.size());
+	if (taskCount <= 1)
+	{
+		for (size_t n = 0; n < codePoints.size(); n++)
+			this->renderGlyph(this->m_face, codePoints[n], &glyphData[n]);
+	}
+	else
+	{
+		// The faces are created here on the calling thread, so the global library is never used concurrently.
+		while (this->m_workerFaces.size() < taskCount)
 		{
-			this->m_currentOffsetY += this->m_tallestCharacterInRow;
+			FreeTypeWorkerFace workerFace = {nullptr, nullptr};
+			if (FT_Init_FreeType(&workerFace.m_library))
+				throw FontCreationException("Could not create worker face of font " + this->m_name + "! Could not initialize FreeType!");
 
-			// Since we advanced the y offset we need to check for space again
-			if (this->m_currentOffsetY + glyphHeight >= this->m_atlasHeight)
-				this->resize();
-
-			if (!needsTwoRegions)
+			try
 			{
-				// Set the width and height of the first region
-				firstRegion.z = this->m_currentOffsetX - firstRegion.x;
-				firstRegion.w = this->m_tallestCharacterInRow;
-				// Set the y coordinate of the second region
-				secondRegion.y = this->m_currentOffsetY;
-				needsTwoRegions = true;
+				this->openFace(workerFace.m_library, &workerFace.m_face);
 			}
-			else
+			catch (...)
 			{
-				secondRegion.w += this->m_tallestCharacterInRow;
-				secondRegion.z = std::max(secondRegion.z, this->m_currentOffsetX);
+				FT_Done_FreeType(workerFace.m_library);
+				throw;
 			}
-			// Reset x offset to 0 because of new row
-			this->m_currentOffsetX = 0;
-			this->m_tallestCharacterInRow = glyphHeight;
+			this->m_workerFaces.push_back(workerFace);
 		}
-		else if (glyphHeight > this->m_tallestCharacterInRow)
-		{
-			this->m_tallestCharacterInRow = glyphHeight;
-			// Also update height of the first region if we are still in it
-			if (!needsTwoRegions)
-				firstRegion.w = glyphHeight;
-		}
-
-		// Set data of the glyph
-		this->m_glyphData[glyphDataIndex].m_unicode = unicode;
-		this->m_glyphData[glyphDataIndex].m_offset = Vector2ui(this->m_currentOffsetX, this->m_currentOffsetY);
-		this->m_glyphData[glyphDataIndex].m_size = Vector2i(static_cast<int>(glyphWidth), static_cast<int>(glyphHeight));
-		this->m_glyphData[glyphDataIndex].m_bearing = Vector2i(glyphSlot->bitmap_left, glyphSlot->bitmap_top);
-		this->m_glyphData[glyphDataIndex].m_advance = static_cast<unsigned int>(glyphSlot->advance.x) >> 6U; // freetype stores the advance as 1/64th pixel
-
-		if (!needsTwoRegions)
-			glyphsInFirstRegion++;
 
-		this->m_currentOffsetX += glyphWidth;
-		glyphDataIndex++;
+		// Every task owns one face and renders every n-th code point, which spreads dense and sparse parts of the
+		// range evenly.
+		threadPool->parallelFor(taskCount, [&](size_t task) {
+			FT_Face face = this->m_workerFaces[task].m_face;
+			for (size_t n = task; n < codePoints.size(); n += taskCount)
+				this->renderGlyph(face, codePoints[n], &glyphData[n]);
+		});
 	}
 
-	// If we only need the first region the width and height hasn't been set yet.
-	if (!needsTwoRegions)
-	{
-		// Set the width and height of the first region
-		firstRegion.z = this->m_currentOffsetX;
-		firstRegion.w = this->m_tallestCharacterInRow;
-	}
-
-	// Stitch the image data of the first region together and upload it to the graphics card
-	this->stitchAtlas(0, glyphsInFirstRegion, firstRegion);
-
-	if (needsTwoRegions)
-	{
-		// Update the size of the region once more since we only update if we start a new one
-		secondRegion.w += this->m_tallestCharacterInRow;
-		secondRegion.z = std::max(secondRegion.z, this->m_currentOffsetX);
-
-		// Stitch the image data of the second region together and upload it to the graphics card
-		this->stitchAtlas(glyphsInFirstRegion, glyphCount, secondRegion);
-	}
+	// The glyphs are only copied to the memory copy of the atlas pages, the changed rows are uploaded once at the end.
+	for (const GlyphData &data : glyphData)
+		this->addGlyph(data);
 
-	// Free the allocated memory for the glyphs data
-	delete[] this->m_glyphData;
+	this->uploadGlyphs();
 }
@@ -9,10 +9,12 @@ using namespace cedar;
 Glyph::Glyph() : Glyph({0, 0}, {0, 0}, 0, {0.0f, 0.0f, 0.0f, 0.0f})
 {}
 
-Glyph::Glyph(const cedar::Vector2i &size, const cedar::Vector2i &bearing, const unsigned int advance, const cedar::Vector4f &uvs)
+Glyph::Glyph(const cedar::Vector2i &size, const cedar::Vector2i &bearing, const unsigned int advance, const cedar::Vector4f &uvs,
+			 const unsigned int page)
 {
 	this->m_size = size;
 	this->m_bearing = bearing;
 	this->m_advance = advance;
 	this->m_uvs = uvs;
+	this->m_page = page;
 }
\ No newline at end of file
@@ -2,416 +2,238 @@
 // Created by masy on 11.04.20.
 //
 
-#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "cedar/PTFFont.hpp"
+#include "cedar/AssetPack.hpp"
 
 using namespace cedar;
 
-PTFFont::PTFFont(const std::string &name, const std::string &path, const unsigned int scale)
-		: Font(name, 1, CEDAR_RGBA8, CEDAR_RENDERING_SHARP)
+/**
+ * The size of the header of a glyph in a PTF font file in bytes.
+ */
+const size_t PTF_GLYPH_HEADER_SIZE = 20;
+
+/**
+ * The largest palette that is expanded with SIMD instructions.
+ *
+ * <p>Every color costs a compare and a select per four pixels, so large palettes are faster with the scalar
+ * lookup.</p>
+ */
+const unsigned int PTF_SIMD_PALETTE_SIZE = 16;
+
+/**
+ * Reads a little endian 32 bit integer from the data of a PTF font file.
+ *
+ * @param data A pointer to the first byte of the integer.
+ * @return The integer.
+ */
+unsigned int readPTFUInt32(const unsigned char *data)
 {
-	this->m_scale = scale;
-	this->m_paletteSize = 0;
-	this->m_palette = nullptr;
-	this->m_dictionary = std::map<unsigned int, unsigned int>();
-
-	this->m_fontPath = path;
-	this->m_fontFile = std::ifstream(path, std::ifstream::binary);
-	if (!this->m_fontFile.is_open())
-		throw FontCreationException("Could not create ptf font " + name + "! Could not open file from path " + path + "!");
-
-	this->m_dictionaryPointer = 0;
-	this->m_fontFile.read(reinterpret_cast<char *>(&this->m_dictionaryPointer), 4);
-	this->m_fontFile.read(reinterpret_cast<char *>(&this->m_size), 4);
-	this->m_size *= scale;
-
-	this->loadPalette();
-	this->loadDictionary();
-	this->m_fontFile.close();
-
-	this->m_glyphAtlas->setParameteri(CEDAR_TEXTURE_MIN_FILTER, CEDAR_NEAREST);
-	this->m_glyphAtlas->setParameteri(CEDAR_TEXTURE_MAG_FILTER, CEDAR_NEAREST);
+	unsigned int value;
+	std::memcpy(&value, data, 4);
+	return value;
 }
 
-PTFFont::~PTFFont()
+/**
+ * Expands palette indices to RGBA colors.
+ *
+ * @param indices A pointer to the palette indices.
+ * @param count The number of indices.
+ * @param palette A pointer to the 256 entries of the palette.
+ * @param paletteSize The number of colors actually used by the palette.
+ * @param destination A pointer to where the colors will be stored.
+ */
+void expandPTFPalette(const unsigned char *indices, const size_t count, const unsigned int *palette, const unsigned int paletteSize,
+					  unsigned int *destination)
 {
-	delete[] this->m_palette;
-	delete this->m_glyphAtlas;
-	for (const auto &pair : this->m_glyphs)
+	size_t n = 0;
+#if defined(__SSE2__)
+	// SSE2 has no gather, so small palettes are expanded by comparing four indices at once with every color and
+	// selecting the matching one.
+	if (paletteSize <= PTF_SIMD_PALETTE_SIZE)
 	{
-		delete pair.second;
-	}
-}
-
-void PTFFont::loadPalette()
-{
-	if (!this->m_fontFile.is_open())
-	{
-		this->m_fontFile.open(this->m_fontPath, std::ifstream::binary);
+		__m128i colors[PTF_SIMD_PALETTE_SIZE];
+		__m128i keys[PTF_SIMD_PALETTE_SIZE];
+		for (unsigned int k = 0; k < paletteSize; k++)
+		{
+			colors[k] = _mm_set1_epi32(static_cast<int>(palette[k]));
+			keys[k] = _mm_set1_epi32(static_cast<int>(k));
+		}
 
-		if (!this->m_fontFile.is_open())
-			throw FontLoadException("Could not load palette of font " + this->m_name + "!");
+		const __m128i zero = _mm_setzero_si128();
+		for (; n + 16 <= count; n += 16)
+		{
+			__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + n));
+			__m128i words[2] = {_mm_unpacklo_epi8(bytes, zero), _mm_unpackhi_epi8(bytes, zero)};
+			for (int group = 0; group < 4; group++)
+			{
+				__m128i groupIndices = group & 1 ? _mm_unpackhi_epi16(words[group >> 1], zero) : _mm_unpacklo_epi16(words[group >> 1], zero);
+				__m128i result = zero;
+				for (unsigned int k = 0; k < paletteSize; k++)
+					result = _mm_or_si128(result, _mm_and_si128(_mm_cmpeq_epi32(groupIndices, keys[k]), colors[k]));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + n + group * 4), result);
+			}
+		}
 	}
-
-	this->m_fontFile.seekg(8);
-	this->m_fontFile.read(reinterpret_cast<char *>(&this->m_paletteSize), 1);
-	this->m_palette = new unsigned int[this->m_paletteSize];
-	for (int n = 0; n < this->m_paletteSize; n++)
-		this->m_fontFile.read(reinterpret_cast<char *>(this->m_palette + n), 4);
+#endif
+	for (; n < count; n++)
+		destination[n] = palette[indices[n]];
 }
 
-void PTFFont::loadDictionary()
+PTFFont::PTFFont(const std::string &name, const std::string &path, const unsigned int scale)
+		: Font(name, 1, CEDAR_RGBA8, CEDAR_RENDERING_SHARP)
 {
-	if (!this->m_fontFile.is_open())
-	{
-		this->m_fontFile.open(this->m_fontPath, std::ifstream::binary);
-
-		if (!this->m_fontFile.is_open())
-			throw FontLoadException("Could not load dictionary of font " + this->m_name + "!");
-	}
+	this->m_scale = scale;
+	this->m_paletteSize = 0;
+	this->m_palette = nullptr;
+	this->m_dictionary = std::vector<PTFDictionaryEntry>();
+	this->m_fontFile = nullptr;
 
-	this->m_fontFile.seekg(this->m_dictionaryPointer);
-	unsigned int dictionarySize;
-	this->m_fontFile.read(reinterpret_cast<char *>(&dictionarySize), 4);
-	for (int n = 0; n < dictionarySize; n++)
+	// Fonts in asset packs are read from the pack mapping, which stays valid while the pack is mounted.
+	if (!AssetPack::findAsset(path, &this->m_fontData, &this->m_fontDataSize))
 	{
-		unsigned int unicode;
-		unsigned int glyphPtr;
-		this->m_fontFile.read(reinterpret_cast<char *>(&unicode), 4);
-		this->m_fontFile.read(reinterpret_cast<char *>(&glyphPtr), 4);
-		this->m_dictionary.insert(std::make_pair(unicode, glyphPtr));
+		try
+		{
+			this->m_fontFile = new MappedFile(path);
+		}
+		catch (const FileMapException &exception)
+		{
+			throw FontCreationException("Could not create ptf font " + name + "! " + exception.what());
+		}
+		this->m_fontData = this->m_fontFile->getData();
+		this->m_fontDataSize = this->m_fontFile->getSize();
 	}
-}
 
-const Glyph *PTFFont::loadGlyph(const unsigned int unicode)
-{
-	if (!this->m_fontFile.is_open())
+	try
 	{
-		this->m_fontFile.open(this->m_fontPath, std::ifstream::binary);
-		if (!this->m_fontFile.is_open())
-			throw FontLoadException("Could not generate glyphs of font " + this->m_name + "! Could not open font file!");
-	}
-
-	this->m_glyphData = new GlyphData();
+		if (this->m_fontDataSize < 9)
+			throw FontCreationException("Could not create ptf font " + name + "! The header of the font file " + path + " is truncated!");
 
-	unsigned long glyphDataPointer;
-	auto dictionaryIt = this->m_dictionary.find(unicode);
-	if (dictionaryIt == this->m_dictionary.end())
-	{
-		dictionaryIt = this->m_dictionary.find(0);
-		if (dictionaryIt == this->m_dictionary.end())
-			throw FontLoadException("Could not generate glyph for code point " + std::to_string(unicode) + "!");
-		else
-			glyphDataPointer = dictionaryIt->second;
+		this->m_size = readPTFUInt32(this->m_fontData + 4) * scale;
+		this->loadPalette();
+		this->loadDictionary(readPTFUInt32(this->m_fontData));
 	}
-	else
+	catch (...)
 	{
-		glyphDataPointer = dictionaryIt->second;
+		delete[] this->m_palette;
+		delete this->m_fontFile;
+		throw;
 	}
+}
 
-	unsigned int width;
-	unsigned int height;
-	unsigned int glyphSize;
-	int bearingX;
-	int bearingY;
-	int advance;
-
-	this->m_fontFile.seekg(glyphDataPointer);
-	this->m_fontFile.read(reinterpret_cast<char *>(&width), 4);
-	this->m_fontFile.read(reinterpret_cast<char *>(&height), 4);
-	this->m_fontFile.read(reinterpret_cast<char *>(&bearingX), 4);
-	this->m_fontFile.read(reinterpret_cast<char *>(&bearingY), 4);
-	this->m_fontFile.read(reinterpret_cast<char *>(&advance), 4);
-
-	glyphSize = width * height;
-	auto *glyphPaletteData = new unsigned char[glyphSize];
-	this->m_fontFile.read(reinterpret_cast<char *>(glyphPaletteData), glyphSize);
-
-	auto *glyphImageData = new unsigned char[glyphSize * 4];
-	auto *intData = reinterpret_cast<unsigned char*>(glyphImageData);
-	for (unsigned int n = 0; n < glyphSize; n++)
-	{
-		intData[n] = this->m_palette[glyphPaletteData[n]];
-	}
+PTFFont::~PTFFont()
+{
+	delete[] this->m_palette;
+	delete this->m_fontFile;
+}
 
-	delete[] glyphPaletteData;
+void PTFFont::initAtlasPage(Texture2D *texture) const
+{
+	texture->setParameteri(CEDAR_TEXTURE_MIN_FILTER, CEDAR_NEAREST);
+	texture->setParameteri(CEDAR_TEXTURE_MAG_FILTER, CEDAR_NEAREST);
+}
 
-	this->m_glyphData->m_unicode = unicode;
-	this->m_glyphData->m_size = Vector2i(static_cast<int>(width), static_cast<int>(height));
-	this->m_glyphData->m_bearing = Vector2i(static_cast<int>(bearingX * this->m_scale), static_cast<int>(bearingY * this->m_scale));
-	this->m_glyphData->m_advance = advance * this->m_scale;
-	this->m_glyphData->m_data = reinterpret_cast<unsigned char*>(glyphImageData);
+void PTFFont::loadPalette()
+{
+	this->m_paletteSize = this->m_fontData[8];
+	if (9 + static_cast<size_t>(this->m_paletteSize) * 4 > this->m_fontDataSize)
+		throw FontCreationException("Could not load palette of font " + this->m_name + "! The palette is truncated!");
 
-	auto glyph = this->createGlyph();
-	delete this->m_glyphData;
-	return glyph;
+	this->m_palette = new unsigned int[256]();
+	std::memcpy(this->m_palette, this->m_fontData + 9, static_cast<size_t>(this->m_paletteSize) * 4);
 }
 
-const Glyph *PTFFont::createGlyph()
+void PTFFont::loadDictionary(const unsigned int dictionaryPointer)
 {
-	// Check if the glyph fits on the glyph atlas vertically
-	if (this->m_currentOffsetY + this->m_glyphData->m_size.y >= this->m_atlasHeight)
-		this->resize();
-
-	// Check if the glyph fits on the texture horizontally
-	if (this->m_currentOffsetX + this->m_glyphData->m_size.x >= CEDAR_FONT_ATLAS_WIDTH)
-	{
-		this->m_currentOffsetY += this->m_tallestCharacterInRow;
+	if (static_cast<size_t>(dictionaryPointer) + 4 > this->m_fontDataSize)
+		throw FontCreationException("Could not load dictionary of font " + this->m_name + "! The dictionary is out of bounds!");
 
-		// Since we advanced the y offset we need to check for space again
-		if (this->m_currentOffsetY + this->m_glyphData->m_size.y >= this->m_atlasHeight)
-			this->resize();
+	unsigned int dictionarySize = readPTFUInt32(this->m_fontData + dictionaryPointer);
+	if ((this->m_fontDataSize - dictionaryPointer - 4) / 8 < dictionarySize)
+		throw FontCreationException("Could not load dictionary of font " + this->m_name + "! The dictionary is truncated!");
 
-		// Reset x offset to 0 because of new row
-		this->m_currentOffsetX = 0;
-		this->m_tallestCharacterInRow = this->m_glyphData->m_size.y;
-	}
-	else if (this->m_glyphData->m_size.y > this->m_tallestCharacterInRow)
-	{
-		this->m_tallestCharacterInRow = this->m_glyphData->m_size.y;
-	}
+	this->m_dictionary.resize(dictionarySize);
+	std::memcpy(this->m_dictionary.data(), this->m_fontData + dictionaryPointer + 4, static_cast<size_t>(dictionarySize) * 8);
 
-	float pixelWidth = 1.0f / CEDAR_FONT_ATLAS_WIDTH;
-	float pixelHeight = 1.0f / static_cast<float>(this->m_atlasHeight);
-	auto glyph = new Glyph(this->m_glyphData->m_size * this->m_scale,
-						   this->m_glyphData->m_bearing,
-						   this->m_glyphData->m_advance,
-						   Vector4f(pixelWidth * static_cast<float>(this->m_currentOffsetX),
-									pixelHeight * static_cast<float>(this->m_currentOffsetY),
-									pixelWidth * static_cast<float>(this->m_currentOffsetX + static_cast<int>(this->m_glyphData->m_size.x)),
-									pixelHeight * static_cast<float>(this->m_currentOffsetY + static_cast<int>(this->m_glyphData->m_size.y))
-								   )
-						  );
-
-	this->m_glyphAtlas->upload(static_cast<int>(this->m_currentOffsetX), static_cast<int>(this->m_currentOffsetY),
-							   static_cast<int>(this->m_glyphData->m_size.x), static_cast<int>(this->m_glyphData->m_size.y),
-							   Texture::sizedToUnsized(this->m_internalFormat), CEDAR_UNSIGNED_BYTE, this->m_glyphData->m_data);
-
-	this->m_currentOffsetX += this->m_glyphData->m_size.x;
-
-	this->m_glyphs.insert(std::make_pair(this->m_glyphData->m_unicode, glyph));
-	return glyph;
+	// A stable sort keeps the first entry of duplicated code points in front, which is the one the lookup finds.
+	std::stable_sort(this->m_dictionary.begin(), this->m_dictionary.end(),
+					 [](const PTFDictionaryEntry &a, const PTFDictionaryEntry &b) { return a.m_unicode < b.m_unicode; });
 }
 
-void PTFFont::stitchAtlas(unsigned int firstIndex, unsigned int lastIndex, const cedar::Vector4ui &region)
+unsigned int PTFFont::findGlyphPointer(const unsigned int unicode) const
 {
-	float pixelWidth = 1.0f / CEDAR_FONT_ATLAS_WIDTH;
-	float pixelHeight = 1.0f / static_cast<float>(this->m_atlasHeight);
-
-	// Calculate region length
-	unsigned int regionDataLength = region.z * region.w * 4;
-	// Allocate memory with calloc to avoid artifacts near the glyphs since we only write to the region where there are glyph images
-	unsigned char *regionData = reinterpret_cast<unsigned char *>(calloc(regionDataLength, 1));
+	auto compare = [](const PTFDictionaryEntry &entry, unsigned int value) { return entry.m_unicode < value; };
 
-	// Stitch region together
-	for (unsigned int n = firstIndex; n < lastIndex; n++)
-	{
-		GlyphData *glyphData = &this->m_glyphData[n];
-		Glyph *glyph = new Glyph(glyphData->m_size * this->m_scale,
-								 glyphData->m_bearing,
-								 glyphData->m_advance,
-								 Vector4f(pixelWidth * static_cast<float>(glyphData->m_offset.x),
-										  pixelHeight * static_cast<float>(glyphData->m_offset.y),
-										  pixelWidth * static_cast<float>(glyphData->m_offset.x + glyphData->m_size.x),
-										  pixelHeight * static_cast<float>(glyphData->m_offset.y + glyphData->m_size.y)
-										 )
-								);
-
-		// Copy glyph image into region data
-		for (int x = 0; x < glyphData->m_size.x; x++)
-		{
-			for (int y = 0; y < glyphData->m_size.y; y++)
-			{
-				unsigned int regionIndex = (region.z * (glyphData->m_offset.y - region.y + y) + x + glyphData->m_offset.x) * 4;
-				unsigned int dataIndex = (glyphData->m_size.x * y + x) * 4;
+	auto it = std::lower_bound(this->m_dictionary.begin(), this->m_dictionary.end(), unicode, compare);
+	if (it != this->m_dictionary.end() && it->m_unicode == unicode)
+		return it->m_glyphPointer;
 
-				regionData[regionIndex] = glyphData->m_data[dataIndex];
-				regionData[regionIndex + 1] = glyphData->m_data[dataIndex + 1];
-				regionData[regionIndex + 2] = glyphData->m_data[dataIndex + 2];
-				regionData[regionIndex + 3] = glyphData->m_data[dataIndex + 3];
-			}
-		}
+	it = std::lower_bound(this->m_dictionary.begin(), this->m_dictionary.end(), 0u, compare);
+	if (it != this->m_dictionary.end() && it->m_unicode == 0)
+		return it->m_glyphPointer;
 
-		this->m_glyphs.insert(std::make_pair(glyphData->m_unicode, glyph));
-	}
+	throw FontLoadException("Could not generate glyph for code point " + std::to_string(unicode) + "!");
+}
 
-	// Upload region to texture
-	this->m_glyphAtlas->upload(static_cast<int>(region.x), static_cast<int>(region.y),
-							   static_cast<int>(region.z), static_cast<int>(region.w),
-							   Texture::sizedToUnsized(this->m_internalFormat), CEDAR_UNSIGNED_BYTE, regionData);
+void PTFFont::readGlyph(const unsigned int unicode, GlyphData *glyphData)
+{
+	size_t glyphDataPointer = this->findGlyphPointer(unicode);
+	if (glyphDataPointer + PTF_GLYPH_HEADER_SIZE > this->m_fontDataSize)
+		throw FontLoadException("Could not generate glyph for code point " + std::to_string(unicode) + "! The glyph is out of bounds!");
+
+	const unsigned char *glyphHeader = this->m_fontData + glyphDataPointer;
+	unsigned int width = readPTFUInt32(glyphHeader);
+	unsigned int height = readPTFUInt32(glyphHeader + 4);
+	auto bearingX = static_cast<int>(readPTFUInt32(glyphHeader + 8));
+	auto bearingY = static_cast<int>(readPTFUInt32(glyphHeader + 12));
+	unsigned int advance = readPTFUInt32(glyphHeader + 16);
+
+	glyphData->m_unicode = unicode;
+	glyphData->m_size = Vector2i(static_cast<int>(width), static_cast<int>(height));
+	glyphData->m_bearing = Vector2i(bearingX * static_cast<int>(this->m_scale), bearingY * static_cast<int>(this->m_scale));
+	glyphData->m_advance = advance * this->m_scale;
+
+	if (width == 0 || height == 0)
+		return;
+
+	size_t dataLeft = this->m_fontDataSize - glyphDataPointer - PTF_GLYPH_HEADER_SIZE;
+	if (width > dataLeft || height > dataLeft / width)
+		throw FontLoadException("Could not generate glyph for code point " + std::to_string(unicode) + "! The glyph is truncated!");
+
+	size_t glyphSize = static_cast<size_t>(width) * height;
+	glyphData->m_data = new unsigned char[glyphSize * 4];
+	expandPTFPalette(glyphHeader + PTF_GLYPH_HEADER_SIZE, glyphSize, this->m_palette, this->m_paletteSize,
+					 reinterpret_cast<unsigned int *>(glyphData->m_data));
+}
 
-	free(regionData);
+const Glyph *PTFFont::loadGlyph(const unsigned int unicode)
+{
+	GlyphData glyphData;
+	this->readGlyph(unicode, &glyphData);
+	auto glyph = this->addGlyph(glyphData, this->m_scale);
+	this->uploadGlyphs();
+	return glyph;
 }
 
 void PTFFont::generateGlyphs(const unsigned int firstCharacter, const unsigned int lastCharacter)
 {
-	if (!this->m_fontFile.is_open())
-	{
-		this->m_fontFile.open(this->m_fontPath, std::ifstream::binary);
-		if (!this->m_fontFile.is_open())
-			throw FontLoadException("Could not generate glyphs of font " + this->m_name + "! Could not open font file!");
-	}
-
-
-	unsigned int glyphCount = lastCharacter - firstCharacter + 1;
-	this->m_glyphData = new GlyphData[glyphCount];
-
-	// We split the glyphs into two regions to avoid uploading every single glyph with a call to the graphics card,
-	// but since we might generate glyphs for multiple rows and the first could start somewhere in the middle
-	// of the texture we need two separate regions. If the row does not change while generating glyphs only the first
-	// region is needed.
-	Vector4ui firstRegion(this->m_currentOffsetX, this->m_currentOffsetY, 0, 0);
-	int glyphsInFirstRegion = 0;
-	Vector4ui secondRegion(0, 0, 0, 0);
-	bool needsTwoRegions = false;
-
-	unsigned int glyphDataIndex = 0;
+	// The glyphs are only copied to the memory copy of the atlas pages, the changed rows are uploaded once at the end.
 	for (unsigned int unicode = firstCharacter; unicode <= lastCharacter; unicode++)
 	{
 		// skip already generated glyphs
-		auto glyphIt = this->m_glyphs.find(unicode);
-		if (glyphIt != this->m_glyphs.end())
-		{
-			// Also reduce the glyph count since we didn't generate data for this one.
-			glyphCount--;
-			continue;
-		}
-
-		unsigned int glyphDataPointer;
-
-
-		auto dictionaryIt = this->m_dictionary.find(unicode);
-		if (dictionaryIt == this->m_dictionary.end())
-		{
-			dictionaryIt = this->m_dictionary.find(0u);
-			if (dictionaryIt == this->m_dictionary.end())
-				throw FontLoadException("Could not generate glyph for code point " + std::to_string(unicode) + "!");
-			else
-				glyphDataPointer = dictionaryIt->second;
-		}
-		else
-		{
-			glyphDataPointer = dictionaryIt->second;
-		}
-
-		unsigned int width;
-		unsigned int height;
-		unsigned int glyphSize;
-		int bearingX;
-		int bearingY;
-		int advance;
-
-		this->m_fontFile.seekg(glyphDataPointer);
-		this->m_fontFile.read(reinterpret_cast<char *>(&width), 4);
-		this->m_fontFile.read(reinterpret_cast<char *>(&height), 4);
-		this->m_fontFile.read(reinterpret_cast<char *>(&bearingX), 4);
-		this->m_fontFile.read(reinterpret_cast<char *>(&bearingY), 4);
-		this->m_fontFile.read(reinterpret_cast<char *>(&advance), 4);
-
-		bearingX *= this->m_scale;
-		bearingY *= this->m_scale;
-		advance *= this->m_scale;
-
-		if (width == 0 || height == 0)
-		{
-			Glyph *glyph = new Glyph(Vector2i(static_cast<int>(width * this->m_scale), static_cast<int>(height * this->m_scale)),
-									 Vector2i(bearingX, bearingY),
-									 advance,
-									 Vector4f(0.0f, 0.0f, 0.0f, 0.0f)
-									);
-			this->m_glyphs.insert(std::make_pair(unicode, glyph));
-			glyphCount--;
+		if (this->findGlyph(unicode))
 			continue;
-		}
-
-		glyphSize = width * height;
-		auto *glyphPaletteData = new unsigned char[glyphSize];
-		this->m_fontFile.read(reinterpret_cast<char *>(glyphPaletteData), glyphSize);
-
-		auto *glyphImageData = new unsigned char[glyphSize * 4];
-		auto *intData = reinterpret_cast<unsigned int*>(glyphImageData);
-		for (int n = 0; n < glyphSize; n++)
-		{
-			intData[n] = this->m_palette[glyphPaletteData[n]];
-		}
-
-		delete[] glyphPaletteData;
-
-		// Check if the glyph fits on the glyph atlas vertically
-		if (this->m_currentOffsetY + height >= this->m_atlasHeight)
-			this->resize();
-
-		// Check if the glyph fits on the texture horizontally
-		if (this->m_currentOffsetX + width >= CEDAR_FONT_ATLAS_WIDTH)
-		{
-			this->m_currentOffsetY += this->m_tallestCharacterInRow;
-
-			// Since we advanced the y offset we need to check for space again
-			if (this->m_currentOffsetY + height >= this->m_atlasHeight)
-				this->resize();
-
-			if (!needsTwoRegions)
-			{
-				// Set the width and height of the first region
-				firstRegion.z = this->m_currentOffsetX - firstRegion.x;
-				firstRegion.w = this->m_tallestCharacterInRow;
-				// Set the y coordinate of the second region
-				secondRegion.y = this->m_currentOffsetY;
-				needsTwoRegions = true;
-			}
-			else
-			{
-				secondRegion.w += this->m_tallestCharacterInRow;
-				secondRegion.z = std::max(secondRegion.z, this->m_currentOffsetX);
-			}
-			// Reset x offset to 0 because of new row
-			this->m_currentOffsetX = 0;
-			this->m_tallestCharacterInRow = height;
-		}
-		else if (height > this->m_tallestCharacterInRow)
-		{
-			this->m_tallestCharacterInRow = height;
-			// Also update height of the first region if we are still in it
-			if (!needsTwoRegions)
-				firstRegion.w = height;
-		}
-
-		// Set data of the glyph
-		this->m_glyphData[glyphDataIndex].m_unicode = unicode;
-		this->m_glyphData[glyphDataIndex].m_offset = Vector2ui(this->m_currentOffsetX, this->m_currentOffsetY);
-		this->m_glyphData[glyphDataIndex].m_size = Vector2i(static_cast<int>(width), static_cast<int>(height));
-		this->m_glyphData[glyphDataIndex].m_bearing = Vector2i(bearingX, bearingY);
-		this->m_glyphData[glyphDataIndex].m_advance = advance;
-		this->m_glyphData[glyphDataIndex].m_data = reinterpret_cast<unsigned char*>(glyphImageData);
-
-		if (!needsTwoRegions)
-			glyphsInFirstRegion++;
-
-		this->m_currentOffsetX += width;
-		glyphDataIndex++;
-	}
-
-	// If we only need the first region the width and height hasn't been set yet.
-	if (!needsTwoRegions)
-	{
-		// Set the width and height of the first region
-		firstRegion.z = this->m_currentOffsetX;
-		firstRegion.w = this->m_tallestCharacterInRow;
-	}
-
-	// Stitch the image data of the first region together and upload it to the graphics card
-	this->stitchAtlas(0, glyphsInFirstRegion, firstRegion);
-
-	if (needsTwoRegions)
-	{
-		// Update the size of the region once more since we only update if we start a new one
-		secondRegion.w += this->m_tallestCharacterInRow;
-		secondRegion.z = std::max(secondRegion.z, this->m_currentOffsetX);
 
-		// Stitch the image data of the second region together and upload it to the graphics card
-		this->stitchAtlas(glyphsInFirstRegion, glyphCount, secondRegion);
+		GlyphData glyphData;
+		this->readGlyph(unicode, &glyphData);
+		this->addGlyph(glyphData, this->m_scale);
 	}
 
-	// Free the allocated memory for the glyphs data
-	delete[] this->m_glyphData;
+	this->uploadGlyphs();
 }
@@ -0,0 +1,56 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <algorithm>
+#include <cstdint>
+
+#include "cedar/ElementArena.hpp"
+
+using namespace cedar;
+
+ElementArena::ElementArena()
+{
+	this->m_blocks = std::vector<ElementArenaBlock>();
+	this->m_currentBlock = 0;
+	this->m_offset = 0;
+}
+
+void *ElementArena::allocate(const size_t size, const size_t alignment)
+{
+	while (this->m_currentBlock < this->m_blocks.size())
+	{
+		ElementArenaBlock &block = this->m_blocks[this->m_currentBlock];
+		auto address = reinterpret_cast<uintptr_t>(block.m_memory.get());
+		size_t offset = ((address + this->m_offset + alignment - 1) & ~(alignment - 1)) - address;
+		if (offset + size <= block.m_size)
+		{
+			this->m_offset = offset + size;
+			return block.m_memory.get() + offset;
+		}
+
+		this->m_currentBlock++;
+		this->m_offset = 0;
+	}
+
+	// The padding for the alignment has to fit into the block as well.
+	size_t blockSize = std::max(static_cast<size_t>(CEDAR_ELEMENT_ARENA_BLOCK_SIZE), size + alignment);
+	this->m_blocks.push_back({std::unique_ptr<unsigned char[]>(new unsigned char[blockSize]), blockSize});
+	this->m_currentBlock = this->m_blocks.size() - 1;
+	this->m_offset = 0;
+	return this->allocate(size, alignment);
+}
+
+void ElementArena::reset()
+{
+	this->m_currentBlock = 0;
+	this->m_offset = 0;
+}
+
+size_t ElementArena::getCapacity() const
+{
+	size_t capacity = 0;
+	for (const ElementArenaBlock &block : this->m_blocks)
+		capacity += block.m_size;
+	return capacity;
+}
@@ -2,12 +2,43 @@
 // Created by masy on 08.03.20.
 //
 
+#include <algorithm>
+#include <cmath>
+
 #include "cedar/Screen.hpp"
+#include "cedar/Cedar.hpp"
 #include "cedar/Intersection.hpp"
 #include "cedar/Input.hpp"
+#include "cedar/Renderer2D.hpp"
+#include "glad/glad.h"
 
 using namespace cedar;
 
+/**
+ * Gets the column or row of the grid cell a coordinate lies in.
+ *
+ * @param coordinate The x or y coordinate in pixel.
+ * @return The column or row of the grid cell.
+ */
+int getGridCell(const float coordinate)
+{
+	// Clamped so elements far outside of the window don't overflow the cell index.
+	float cell = std::floor(coordinate / static_cast<float>(CEDAR_SCREEN_GRID_CELL_SIZE));
+	return static_cast<int>(std::clamp(cell, -1048576.0f, 1048576.0f));
+}
+
+/**
+ * Packs the column and row of a grid cell into the key of the cell.
+ *
+ * @param column The column of the cell.
+ * @param row The row of the cell.
+ * @return The key of the cell.
+ */
+unsigned long long getGridCellKey(const int column, const int row)
+{
+	return (static_cast<unsigned long long>(static_cast<unsigned int>(column)) << 32U) | static_cast<unsigned int>(row);
+}
+
 ScreenException::ScreenException(const std::string &message) : XException(message)
 {}
 
@@ -30,34 +61,36 @@ Screen::Screen(const std::string &name, const unsigned char zIndex)
 	this->m_zIndex = zIndex;
 	this->m_enabled = true;
 	this->m_visible = false;
+	this->m_cached = false;
+	this->m_cacheFramebuffer = 0;
+	this->m_cacheTexture = nullptr;
+}
+
+Screen::~Screen()
+{
+	this->clearElements();
+	this->deleteCache();
 }
 
 bool Screen::onMousePress(const float cursorX, const float cursorY, const int mouseButton, const unsigned int modifiers)
 {
-	for (Element *currElement : this->m_elements)
+	Element *currElement = this->findElementAt(cursorX, cursorY);
+	if (currElement)
 	{
-		// If the element is not visible it can't be interacted with (who would have guessed? not me!)
-		if (currElement->isInteractable() && currElement->isVisible()
-			&& intersection::isPointInsideRectangle2Df(currElement->getPosX(), currElement->getPosY(),
-													   currElement->getPosX() + currElement->getWidth(),
-													   currElement->getPosY() + currElement->getHeight(),
-													   cursorX, cursorY))
+		// If the element is disabled it can't be interacted with but still blocks element behind it to be interacted with
+		if (currElement->isEnabled())
 		{
-			// If the element is disabled it can't be interacted with but still blocks element behind it to be interacted with
-			if (currElement->isEnabled())
+			if (mouseButton == CEDAR_MOUSE_BUTTON_LEFT)
 			{
-				if (mouseButton == CEDAR_MOUSE_BUTTON_LEFT)
-				{
-					PRESSED_ELEMENT = currElement;
-					currElement->setPressed(true);
-				}
-
-				if (currElement->getMousePressCallback())
-					currElement->getMousePressCallback()(currElement, mouseButton, modifiers);
+				PRESSED_ELEMENT = currElement;
+				currElement->setPressed(true);
 			}
 
-			return true;
+			if (currElement->getMousePressCallback())
+				currElement->getMousePressCallback()(currElement, mouseButton, modifiers);
 		}
+
+		return true;
 	}
 
 	return false;
@@ -65,42 +98,35 @@ bool Screen::onMousePress(const float cursorX, const float cursorY, const int mo
 
 bool Screen::onMouseRelease(const float cursorX, const float cursorY, const int mouseButton, const unsigned int modifiers)
 {
-	for (Element *currElement : this->m_elements)
+	Element *currElement = this->findElementAt(cursorX, cursorY);
+	if (currElement)
 	{
-		// If the element is not visible it can't be interacted with (who would have guessed? not me!)
-		if (currElement->isInteractable() && currElement->isVisible()
-			&& intersection::isPointInsideRectangle2Df(currElement->getPosX(), currElement->getPosY(),
-													   currElement->getPosX() + currElement->getWidth(),
-													   currElement->getPosY() + currElement->getHeight(),
-													   cursorX, cursorY))
+		// If the element is disabled it can't be interacted with but still blocks element behind it to be interacted with
+		if (currElement->isEnabled())
 		{
-			// If the element is disabled it can't be interacted with but still blocks element behind it to be interacted with
-			if (currElement->isEnabled())
+			if (mouseButton == CEDAR_MOUSE_BUTTON_LEFT && PRESSED_ELEMENT == currElement)
 			{
-				if (mouseButton == CEDAR_MOUSE_BUTTON_LEFT && PRESSED_ELEMENT == currElement)
-				{
-					currElement->setPressed(false);
-					FOCUSED_ELEMENT = currElement;
+				currElement->setPressed(false);
+				FOCUSED_ELEMENT = currElement;
 
-					if (currElement->getInteractCallback())
-						currElement->getInteractCallback()(currElement);
-				}
+				if (currElement->getInteractCallback())
+					currElement->getInteractCallback()(currElement);
+			}
 
-				if (currElement->getMouseReleaseCallback())
-					currElement->getMouseReleaseCallback()(currElement, mouseButton, modifiers);
+			if (currElement->getMouseReleaseCallback())
+				currElement->getMouseReleaseCallback()(currElement, mouseButton, modifiers);
 
-			}
-			else
+		}
+		else
+		{
+			if (PRESSED_ELEMENT)
 			{
-				if (PRESSED_ELEMENT)
-				{
-					PRESSED_ELEMENT->setPressed(false);
-					PRESSED_ELEMENT = nullptr;
-				}
+				PRESSED_ELEMENT->setPressed(false);
+				PRESSED_ELEMENT = nullptr;
 			}
-
-			return true;
 		}
+
+		return true;
 	}
 
 	if (PRESSED_ELEMENT)
@@ -117,38 +143,31 @@ bool Screen::onMouseMove(const float cursorX, const float cursorY)
 {
 	Element *newHovered = nullptr;
 
-	for (Element *currElement : this->m_elements)
+	Element *currElement = this->findElementAt(cursorX, cursorY);
+	if (currElement)
 	{
-		// If the element is not visible it can't be interacted with (who would have guessed? not me!)
-		if (currElement->isInteractable() && currElement->isVisible()
-			&& intersection::isPointInsideRectangle2Df(currElement->getPosX(), currElement->getPosY(),
-													   currElement->getPosX() + currElement->getWidth(),
-													   currElement->getPosY() + currElement->getHeight(),
-													   cursorX, cursorY))
+		// If the element is disabled it can't be interacted with but still blocks element behind it to be interacted with
+		if (currElement->isEnabled())
 		{
-			// If the element is disabled it can't be interacted with but still blocks element behind it to be interacted with
-			if (currElement->isEnabled())
-			{
-				newHovered = currElement;
+			newHovered = currElement;
 
-				if (newHovered != HOVERED_ELEMENT)
+			if (newHovered != HOVERED_ELEMENT)
+			{
+				if (HOVERED_ELEMENT)
 				{
-					if (HOVERED_ELEMENT)
-					{
-						HOVERED_ELEMENT->setHovered(false);
-						if (HOVERED_ELEMENT->getMouseEnterCallback())
-							HOVERED_ELEMENT->getMouseEnterCallback()(HOVERED_ELEMENT, false);
-					}
-
-					currElement->setHovered(true);
-					if (currElement->getMouseEnterCallback())
-						currElement->getMouseEnterCallback()(currElement, true);
-
-					HOVERED_ELEMENT = newHovered;
+					HOVERED_ELEMENT->setHovered(false);
+					if (HOVERED_ELEMENT->getMouseEnterCallback())
+						HOVERED_ELEMENT->getMouseEnterCallback()(HOVERED_ELEMENT, false);
 				}
+
+				currElement->setHovered(true);
+				if (currElement->getMouseEnterCallback())
+					currElement->getMouseEnterCallback()(currElement, true);
+
+				HOVERED_ELEMENT = newHovered;
 			}
-			return true;
 		}
+		return true;
 	}
 
 	if (HOVERED_ELEMENT)
@@ -166,27 +185,20 @@ bool Screen::onMouseMove(const float cursorX, const float cursorY)
 
 bool Screen::onScroll(const float cursorX, const float cursorY, const float offsetX, const float offsetY, const unsigned int modifiers)
 {
-	for (Element *currElement : this->m_elements)
+	Element *currElement = this->findElementAt(cursorX, cursorY);
+	if (currElement)
 	{
-		// If the element is not visible it can't be interacted with (who would have guessed? not me!)
-		if (currElement->isInteractable() && currElement->isVisible()
-			&& intersection::isPointInsideRectangle2Df(currElement->getPosX(), currElement->getPosY(),
-													   currElement->getPosX() + currElement->getWidth(),
-													   currElement->getPosY() + currElement->getHeight(),
-													   cursorX, cursorY))
+		// If the element is disabled it can't be interacted with but still blocks element behind it to be interacted with
+		if (currElement->isEnabled())
 		{
-			// If the element is disabled it can't be interacted with but still blocks element behind it to be interacted with
-			if (currElement->isEnabled())
-			{
-				if (currElement->getScrollCallback())
-					currElement->getScrollCallback()(currElement, offsetX, offsetY, modifiers);
+			if (currElement->getScrollCallback())
+				currElement->getScrollCallback()(currElement, offsetX, offsetY, modifiers);
 
-				return true;
-			}
-			else
-			{
-				return false;
-			}
+			return true;
+		}
+		else
+		{
+			return false;
 		}
 	}
 
@@ -199,6 +211,10 @@ void Screen::onResize(const int width, const int height, const int deltaWidth, c
 	float halfDeltaHeight = static_cast<float>(deltaHeight) * 0.5f;
 	for (Element *currElement : this->m_elements)
 	{
+		// Elements in containers are positioned by their container.
+		if (currElement->m_parent)
+			continue;
+
 		unsigned int horizontalAlignment = currElement->getAlignment() & 0x03u;
 		unsigned int verticalAlignment = currElement->getAlignment() & 0x0Cu;
 
@@ -240,6 +256,17 @@ void Screen::onResize(const int width, const int height, const int deltaWidth, c
 }
 
 void Screen::onUpdate(unsigned long currentTime, unsigned long tickCount) {
+	this->m_tweenManager.update(currentTime);
+
+	// Containers lay out their children themselves, so only the roots of the layout trees are updated.
+	// List views add their rows to the screen while they are laid out, so the elements are iterated by index.
+	for (size_t n = 0; n < this->m_elements.size(); n++)
+	{
+		Element *element = this->m_elements[n];
+		if (!element->m_parent)
+			element->updateLayout();
+	}
+
 	for (Element *element : this->m_elements)
 	{
 		if (element->isVisible() && element->isEnabled() && element->getUpdateCallback())
@@ -249,30 +276,379 @@ void Screen::onUpdate(unsigned long currentTime, unsigned long tickCount) {
 
 void Screen::render(const unsigned long currentTime)
 {
+	if (this->m_cached && this->m_cacheTexture)
+	{
+		auto *texture = dynamic_cast<Texture2D *>(this->m_cacheTexture.get());
+		Renderer2D::drawLayer(0.0f, 0.0f, 0.0f, static_cast<float>(texture->getWidth()), static_cast<float>(texture->getHeight()),
+							  this->m_cacheTexture);
+		return;
+	}
+
 	for (auto it = this->m_elements.rbegin(); it != this->m_elements.rend(); it++)
 	{
-		if ((*it)->isVisible())
+		// Children of clipping elements are rendered by their parent.
+		if ((*it)->isVisible() && !((*it)->m_parent && (*it)->m_parent->clipsChildren()))
 		{
 			(*it)->render(currentTime);
 		}
 	}
 }
 
+TweenManager *Screen::getTweenManager()
+{
+	return &this->m_tweenManager;
+}
+
 void Screen::addElement(Element *element) {
 	if (!element)
 		throw ElementAddException("Could not add element to the screen. The element can't be a nullptr!");
 
-	auto lastSmallerIt = this->m_elements.begin();
-	for (auto it = this->m_elements.begin(); it != this->m_elements.end(); it++)
+	if (element->m_screen == this)
+		return;
+
+	if (element->m_screen)
+		throw ElementAddException("Could not add element to the screen. The element was already added to the screen " + element->m_screen->getName() + "!");
+
+	// The elements are sorted by z index, and a new element is placed in front of the elements with the same z index.
+	auto insertIt = std::lower_bound(this->m_elements.begin(), this->m_elements.end(), element->getZIndex(),
+									 [](const Element *other, const unsigned char zIndex) {
+										 return other->getZIndex() < zIndex;
+									 });
+
+	// The hit test uses the index to resolve overlapping elements, so all elements behind the new one move back.
+	size_t index = this->m_elements.insert(insertIt, element) - this->m_elements.begin();
+	for (; index < this->m_elements.size(); index++)
+		this->m_elements[index]->m_screenIndex = index;
+
+	element->m_screen = this;
+	this->insertIntoGrid(element);
+	this->invalidate(element->getPosX(), element->getPosY(), element->getWidth(), element->getHeight());
+}
+
+void Screen::detachElement(Element *element)
+{
+	if (HOVERED_ELEMENT == element)
+		HOVERED_ELEMENT = nullptr;
+	if (PRESSED_ELEMENT == element)
+		PRESSED_ELEMENT = nullptr;
+	if (FOCUSED_ELEMENT == element)
+		FOCUSED_ELEMENT = nullptr;
+
+	element->m_screen = nullptr;
+	element->m_screenIndex = 0;
+	element->m_gridMinX = 0;
+	element->m_gridMinY = 0;
+	element->m_gridMaxX = -1;
+	element->m_gridMaxY = -1;
+}
+
+void Screen::removeElement(Element *element)
+{
+	if (!element || element->m_screen != this)
+		return;
+
+	this->m_tweenManager.cancel(element);
+	this->removeFromGrid(element);
+	this->invalidate(element->getPosX(), element->getPosY(), element->getWidth(), element->getHeight());
+
+	size_t index = element->m_screenIndex;
+	this->m_elements.erase(this->m_elements.begin() + static_cast<long>(index));
+	for (; index < this->m_elements.size(); index++)
+		this->m_elements[index]->m_screenIndex = index;
+
+	this->detachElement(element);
+}
+
+void Screen::clearElements()
+{
+	for (Element *element : this->m_elements)
+		this->detachElement(element);
+
+	this->m_elements.clear();
+	this->m_gridCells.clear();
+	this->m_largeElements.clear();
+	this->m_tweenManager.clear();
+
+	// The elements are detached already, so destroying them does not touch the screen anymore.
+	for (auto it = this->m_arenaElements.rbegin(); it != this->m_arenaElements.rend(); it++)
+		(*it)->~Element();
+	this->m_arenaElements.clear();
+	this->m_elementArena.reset();
+
+	this->invalidate();
+}
+
+void Screen::insertIntoGrid(Element *element)
+{
+	int minX = getGridCell(element->getPosX());
+	int minY = getGridCell(element->getPosY());
+	int maxX = getGridCell(element->getPosX() + element->getWidth());
+	int maxY = getGridCell(element->getPosY() + element->getHeight());
+
+	long long cellCount = (static_cast<long long>(maxX) - minX + 1) * (static_cast<long long>(maxY) - minY + 1);
+	if (cellCount > CEDAR_SCREEN_GRID_MAX_CELLS)
 	{
-		if ((*it) == element)
+		// An empty cell range marks elements of the large element list.
+		element->m_gridMinX = 0;
+		element->m_gridMaxX = -1;
+		this->m_largeElements.push_back(element);
+		return;
+	}
+
+	element->m_gridMinX = minX;
+	element->m_gridMinY = minY;
+	element->m_gridMaxX = maxX;
+	element->m_gridMaxY = maxY;
+	for (int row = minY; row <= maxY; row++)
+	{
+		for (int column = minX; column <= maxX; column++)
+			this->m_gridCells[getGridCellKey(column, row)].push_back(element);
+	}
+}
+
+void Screen::removeFromGrid(Element *element)
+{
+	if (element->m_gridMaxX < element->m_gridMinX)
+	{
+		auto it = std::find(this->m_largeElements.begin(), this->m_largeElements.end(), element);
+		if (it != this->m_largeElements.end())
+			this->m_largeElements.erase(it);
+		return;
+	}
+
+	for (int row = element->m_gridMinY; row <= element->m_gridMaxY; row++)
+	{
+		for (int column = element->m_gridMinX; column <= element->m_gridMaxX; column++)
+		{
+			auto cell = this->m_gridCells.find(getGridCellKey(column, row));
+			if (cell == this->m_gridCells.end())
+				continue;
+
+			cell->second.erase(std::find(cell->second.begin(), cell->second.end(), element));
+			if (cell->second.empty())
+				this->m_gridCells.erase(cell);
+		}
+	}
+}
+
+void Screen::updateElementBounds(Element *element)
+{
+	int minX = getGridCell(element->getPosX());
+	int minY = getGridCell(element->getPosY());
+	int maxX = getGridCell(element->getPosX() + element->getWidth());
+	int maxY = getGridCell(element->getPosY() + element->getHeight());
+
+	// The old bounds are only known down to the grid cells, so the cells of the old and the new bounds are redrawn.
+	if (this->m_cached)
+	{
+		if (element->m_gridMaxX < element->m_gridMinX)
+		{
+			this->invalidate();
+		}
+		else
+		{
+			float cellSize = CEDAR_SCREEN_GRID_CELL_SIZE;
+			float dirtyMinX = static_cast<float>(std::min(minX, element->m_gridMinX)) * cellSize;
+			float dirtyMinY = static_cast<float>(std::min(minY, element->m_gridMinY)) * cellSize;
+			float dirtyMaxX = static_cast<float>(std::max(maxX, element->m_gridMaxX) + 1) * cellSize;
+			float dirtyMaxY = static_cast<float>(std::max(maxY, element->m_gridMaxY) + 1) * cellSize;
+			this->invalidate(dirtyMinX, dirtyMinY, dirtyMaxX - dirtyMinX, dirtyMaxY - dirtyMinY);
+		}
+	}
+
+	// Most moves stay inside the same cells, for example while an element is animated by a few pixels.
+	if (minX == element->m_gridMinX && minY == element->m_gridMinY && maxX == element->m_gridMaxX && maxY == element->m_gridMaxY)
+		return;
+
+	this->removeFromGrid(element);
+	this->insertIntoGrid(element);
+}
+
+Element *Screen::findElementAt(const float cursorX, const float cursorY) const
+{
+	Element *hitElement = nullptr;
+	auto testElement = [&hitElement, cursorX, cursorY](Element *element) {
+		// If the element is not visible it can't be interacted with (who would have guessed? not me!)
+		if ((!hitElement || element->m_screenIndex < hitElement->m_screenIndex) && element->isInteractable() && element->isVisible()
+			&& intersection::isPointInsideRectangle2Df(element->getPosX(), element->getPosY(),
+													   element->getPosX() + element->getWidth(),
+													   element->getPosY() + element->getHeight(),
+													   cursorX, cursorY))
+		{
+			// Children of clipping elements can only be hit where they are not clipped.
+			Element *parent = element->m_parent;
+			if (!parent || !parent->clipsChildren()
+				|| intersection::isPointInsideRectangle2Df(parent->getPosX(), parent->getPosY(), parent->getPosX() + parent->getWidth(),
+														   parent->getPosY() + parent->getHeight(), cursorX, cursorY))
+				hitElement = element;
+		}
+	};
+
+	auto cell = this->m_gridCells.find(getGridCellKey(getGridCell(cursorX), getGridCell(cursorY)));
+	if (cell != this->m_gridCells.end())
+	{
+		for (Element *element : cell->second)
+			testElement(element);
+	}
+
+	for (Element *element : this->m_largeElements)
+		testElement(element);
+
+	return hitElement;
+}
+
+void Screen::deleteCache()
+{
+	if (this->m_cacheFramebuffer)
+		glDeleteFramebuffers(1, &this->m_cacheFramebuffer);
+
+	this->m_cacheFramebuffer = 0;
+	this->m_cacheTexture = nullptr;
+}
+
+void Screen::renderCache(const unsigned long currentTime, const int width, const int height)
+{
+	if (!this->m_cached)
+	{
+		if (this->m_cacheTexture)
+			this->deleteCache();
+		return;
+	}
+
+	if (!this->m_visible || width <= 0 || height <= 0)
+		return;
+
+	auto *texture = dynamic_cast<Texture2D *>(this->m_cacheTexture.get());
+	if (!texture || texture->getWidth() != width || texture->getHeight() != height)
+	{
+		this->deleteCache();
+
+		texture = new Texture2D(width, height, CEDAR_RGBA8);
+		this->m_cacheTexture = std::shared_ptr<Texture>(texture);
+		texture->reserve(1);
+		texture->setParameteri(CEDAR_TEXTURE_MIN_FILTER, CEDAR_NEAREST);
+		texture->setParameteri(CEDAR_TEXTURE_MAG_FILTER, CEDAR_NEAREST);
+
+		glCreateFramebuffers(1, &this->m_cacheFramebuffer);
+		glNamedFramebufferTexture(this->m_cacheFramebuffer, GL_COLOR_ATTACHMENT0, texture->getId(), 0);
+		if (glCheckNamedFramebufferStatus(this->m_cacheFramebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			Cedar::getCoreLogger()->warn("Could not create cache of screen %s. The screen will not be cached.", this->m_name.c_str());
+			this->deleteCache();
+			this->m_cached = false;
 			return;
+		}
+
+		this->m_dirtyRects.clear();
+		this->m_dirtyRects.emplace_back(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
+	}
+
+	if (this->m_dirtyRects.empty())
+		return;
+
+	float clearColor[4];
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+	GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+	GLboolean blend = glIsEnabled(GL_BLEND);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, this->m_cacheFramebuffer);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	// Blending the alpha separately leaves premultiplied colors in the cache, which compose correctly over the scene.
+	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	glEnable(GL_SCISSOR_TEST);
+
+	for (const Vector4f &rect : this->m_dirtyRects)
+	{
+		int minX = std::max(static_cast<int>(std::floor(rect.x)), 0);
+		int minY = std::max(static_cast<int>(std::floor(rect.y)), 0);
+		int maxX = std::min(static_cast<int>(std::ceil(rect.z)), width);
+		int maxY = std::min(static_cast<int>(std::ceil(rect.w)), height);
+		if (minX >= maxX || minY >= maxY)
+			continue;
+
+		// The scissor box starts at the bottom left corner of the framebuffer.
+		glScissor(minX, height - maxY, maxX - minX, maxY - minY);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		Renderer2D::beginBatch();
+		for (auto it = this->m_elements.rbegin(); it != this->m_elements.rend(); it++)
+		{
+			Element *element = *it;
+			if (element->isVisible() && !(element->m_parent && element->m_parent->clipsChildren()) && element->getPosX() < static_cast<float>(maxX) && element->getPosY() < static_cast<float>(maxY)
+				&& element->getPosX() + element->getWidth() > static_cast<float>(minX)
+				&& element->getPosY() + element->getHeight() > static_cast<float>(minY))
+				element->render(currentTime);
+		}
+		Renderer2D::endBatch();
+		Renderer2D::flush();
+	}
+	this->m_dirtyRects.clear();
+
+	glDisable(GL_SCISSOR_TEST);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	if (!blend)
+		glDisable(GL_BLEND);
+	if (depthTest)
+		glEnable(GL_DEPTH_TEST);
+	glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
 
-		if (lastSmallerIt == this->m_elements.begin() && element->getZIndex() <= (*it)->getZIndex())
-			lastSmallerIt = it;
+bool Screen::isCached() const
+{
+	return this->m_cached;
+}
+
+void Screen::setCached(const bool cached)
+{
+	// The cache itself is created and deleted by the next call to renderCache on the OpenGL thread.
+	this->m_cached = cached;
+	this->invalidate();
+}
+
+void Screen::invalidate()
+{
+	if (!this->m_cached)
+		return;
+
+	this->m_dirtyRects.clear();
+	this->m_dirtyRects.emplace_back(-1E9f, -1E9f, 1E9f, 1E9f);
+}
+
+void Screen::invalidate(const float posX, const float posY, const float width, const float height)
+{
+	if (!this->m_cached || width <= 0.0f || height <= 0.0f)
+		return;
+
+	Vector4f rect(posX, posY, posX + width, posY + height);
+
+	// Overlapping rectangles are merged until none overlap anymore, so no pixel is rendered twice.
+	bool merged = true;
+	while (merged)
+	{
+		merged = false;
+		for (auto it = this->m_dirtyRects.begin(); it != this->m_dirtyRects.end(); it++)
+		{
+			if (it->x <= rect.z && it->z >= rect.x && it->y <= rect.w && it->w >= rect.y)
+			{
+				rect = Vector4f(std::min(rect.x, it->x), std::min(rect.y, it->y), std::max(rect.z, it->z), std::max(rect.w, it->w));
+				this->m_dirtyRects.erase(it);
+				merged = true;
+				break;
+			}
+		}
+	}
+
+	if (this->m_dirtyRects.size() == CEDAR_SCREEN_MAX_DIRTY_RECTS)
+	{
+		for (const Vector4f &dirtyRect : this->m_dirtyRects)
+			rect = Vector4f(std::min(rect.x, dirtyRect.x), std::min(rect.y, dirtyRect.y), std::max(rect.z, dirtyRect.z), std::max(rect.w, dirtyRect.w));
+		this->m_dirtyRects.clear();
 	}
 
-	this->m_elements.insert(lastSmallerIt, element);
+	this->m_dirtyRects.push_back(rect);
 }
 
 std::string Screen::getName() const
@@ -0,0 +1,254 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <algorithm>
+
+#include "cedar/TweenManager.hpp"
+#include "cedar/Element.hpp"
+
+using namespace cedar;
+
+/**
+ * Advances the progress of all tweens of a bucket and evaluates their values.
+ *
+ * <p>The easing function is a template parameter, so the loop has no branches and can be vectorized.</p>
+ *
+ * @tparam Easing The type of the easing function.
+ * @param bucket The bucket of the tweens.
+ * @param deltaTime The time since the last update in microseconds.
+ * @param easing The easing function mapping the progress to the eased progress.
+ */
+template<typename Easing>
+void evaluateTweens(TweenBucket &bucket, const float deltaTime, Easing easing)
+{
+	size_t count = bucket.m_progress.size();
+	bucket.m_results.resize(count);
+
+	float *progress = bucket.m_progress.data();
+	const float *rates = bucket.m_rates.data();
+	const float *from = bucket.m_from.data();
+	const float *deltas = bucket.m_deltas.data();
+	float *results = bucket.m_results.data();
+	for (size_t n = 0; n < count; n++)
+	{
+		float currentProgress = progress[n] + deltaTime * rates[n];
+		progress[n] = currentProgress;
+		float t = std::min(std::max(currentProgress, 0.0f), 1.0f);
+		results[n] = from[n] + deltas[n] * easing(t);
+	}
+}
+
+TweenManager::TweenManager()
+{
+	this->m_indices = std::unordered_map<float *, std::pair<unsigned int, size_t>>();
+	this->m_touchedElements = std::vector<Element *>();
+	this->m_lastTime = 0;
+}
+
+void TweenManager::removeTween(const unsigned int easing, const size_t index)
+{
+	TweenBucket &bucket = this->m_buckets[easing];
+	size_t last = bucket.m_values.size() - 1;
+	this->m_indices.erase(bucket.m_values[index]);
+
+	if (index != last)
+	{
+		bucket.m_elements[index] = bucket.m_elements[last];
+		bucket.m_values[index] = bucket.m_values[last];
+		bucket.m_linkedValues[index] = bucket.m_linkedValues[last];
+		bucket.m_bounds[index] = bucket.m_bounds[last];
+		bucket.m_from[index] = bucket.m_from[last];
+		bucket.m_deltas[index] = bucket.m_deltas[last];
+		bucket.m_progress[index] = bucket.m_progress[last];
+		bucket.m_rates[index] = bucket.m_rates[last];
+		this->m_indices[bucket.m_values[index]].second = index;
+	}
+
+	bucket.m_elements.pop_back();
+	bucket.m_values.pop_back();
+	bucket.m_linkedValues.pop_back();
+	bucket.m_bounds.pop_back();
+	bucket.m_from.pop_back();
+	bucket.m_deltas.pop_back();
+	bucket.m_progress.pop_back();
+	bucket.m_rates.pop_back();
+}
+
+void TweenManager::update(const unsigned long currentTime)
+{
+	float deltaTime = this->m_lastTime > 0 && currentTime > this->m_lastTime ? static_cast<float>(currentTime - this->m_lastTime) : 0.0f;
+	this->m_lastTime = currentTime;
+	if (this->m_indices.empty())
+		return;
+
+	evaluateTweens(this->m_buckets[CEDAR_EASING_LINEAR], deltaTime, [](float t) {
+		return t;
+	});
+	evaluateTweens(this->m_buckets[CEDAR_EASING_QUAD_IN], deltaTime, [](float t) {
+		return t * t;
+	});
+	evaluateTweens(this->m_buckets[CEDAR_EASING_QUAD_OUT], deltaTime, [](float t) {
+		return t * (2.0f - t);
+	});
+	evaluateTweens(this->m_buckets[CEDAR_EASING_QUAD_IN_OUT], deltaTime, [](float t) {
+		return t < 0.5f ? 2.0f * t * t : (4.0f - 2.0f * t) * t - 1.0f;
+	});
+	evaluateTweens(this->m_buckets[CEDAR_EASING_CUBIC_IN], deltaTime, [](float t) {
+		return t * t * t;
+	});
+	evaluateTweens(this->m_buckets[CEDAR_EASING_CUBIC_OUT], deltaTime, [](float t) {
+		float u = t - 1.0f;
+		return u * u * u + 1.0f;
+	});
+	evaluateTweens(this->m_buckets[CEDAR_EASING_CUBIC_IN_OUT], deltaTime, [](float t) {
+		float u = 2.0f * t - 2.0f;
+		return t < 0.5f ? 4.0f * t * t * t : 0.5f * u * u * u + 1.0f;
+	});
+	evaluateTweens(this->m_buckets[CEDAR_EASING_SMOOTHSTEP], deltaTime, [](float t) {
+		return t * t * (3.0f - 2.0f * t);
+	});
+
+	for (unsigned int easing = 0; easing < CEDAR_EASING_COUNT; easing++)
+	{
+		TweenBucket &bucket = this->m_buckets[easing];
+		size_t count = bucket.m_results.size();
+		for (size_t n = 0; n < count; n++)
+		{
+			// Delayed tweens leave the property untouched until they start.
+			if (bucket.m_progress[n] < 0.0f)
+				continue;
+
+			float *value = bucket.m_values[n];
+			if (bucket.m_linkedValues[n])
+				*bucket.m_linkedValues[n] += bucket.m_results[n] - *value;
+			*value = bucket.m_results[n];
+
+			Element *element = bucket.m_elements[n];
+			if (!element->m_animated)
+			{
+				element->m_animated = true;
+				this->m_touchedElements.push_back(element);
+			}
+			if (bucket.m_bounds[n])
+				element->m_animatedBounds = true;
+		}
+
+		for (size_t n = count; n > 0; n--)
+		{
+			if (bucket.m_progress[n - 1] >= 1.0f)
+				this->removeTween(easing, n - 1);
+		}
+	}
+
+	// Every element is notified once, no matter how many of its properties changed.
+	for (Element *element : this->m_touchedElements)
+	{
+		if (element->m_animatedBounds)
+			element->onBoundsChanged();
+		else
+			element->markDirty();
+
+		element->m_animated = false;
+		element->m_animatedBounds = false;
+	}
+	this->m_touchedElements.clear();
+}
+
+void TweenManager::animate(Element *element, const unsigned int property, const float to, const unsigned long duration, const unsigned int easing,
+						   const unsigned long delay)
+{
+	if (!element)
+		throw ElementUpdateException("Could not animate element. The element can't be a nullptr!");
+
+	TweenTarget target = element->getTweenTarget(property);
+	if (!target.m_value)
+		throw ElementUpdateException("Could not animate element. The element can't animate the property " + std::to_string(property) + "!");
+
+	this->animate(element, property, *target.m_value, to, duration, easing, delay);
+}
+
+void TweenManager::animate(Element *element, const unsigned int property, const float from, const float to, const unsigned long duration,
+						   const unsigned int easing, const unsigned long delay)
+{
+	if (!element)
+		throw ElementUpdateException("Could not animate element. The element can't be a nullptr!");
+
+	if (easing >= CEDAR_EASING_COUNT)
+		throw ElementUpdateException("Could not animate element. Unknown easing function " + std::to_string(easing) + "!");
+
+	TweenTarget target = element->getTweenTarget(property);
+	if (!target.m_value)
+		throw ElementUpdateException("Could not animate element. The element can't animate the property " + std::to_string(property) + "!");
+
+	auto it = this->m_indices.find(target.m_value);
+	if (it != this->m_indices.end())
+		this->removeTween(it->second.first, it->second.second);
+
+	float rate = 1.0f / static_cast<float>(std::max(duration, 1ul));
+	TweenBucket &bucket = this->m_buckets[easing];
+	this->m_indices[target.m_value] = std::make_pair(easing, bucket.m_values.size());
+	bucket.m_elements.push_back(element);
+	bucket.m_values.push_back(target.m_value);
+	bucket.m_linkedValues.push_back(target.m_linkedValue);
+	bucket.m_bounds.push_back(target.m_bounds ? 1 : 0);
+	bucket.m_from.push_back(from);
+	bucket.m_deltas.push_back(to - from);
+	bucket.m_progress.push_back(-static_cast<float>(delay) * rate);
+	bucket.m_rates.push_back(rate);
+}
+
+void TweenManager::cancel(Element *element, const unsigned int property)
+{
+	if (!element)
+		return;
+
+	TweenTarget target = element->getTweenTarget(property);
+	auto it = this->m_indices.find(target.m_value);
+	if (it != this->m_indices.end())
+		this->removeTween(it->second.first, it->second.second);
+}
+
+void TweenManager::cancel(const Element *element)
+{
+	for (unsigned int easing = 0; easing < CEDAR_EASING_COUNT; easing++)
+	{
+		TweenBucket &bucket = this->m_buckets[easing];
+		for (size_t n = bucket.m_elements.size(); n > 0; n--)
+		{
+			if (bucket.m_elements[n - 1] == element)
+				this->removeTween(easing, n - 1);
+		}
+	}
+}
+
+void TweenManager::clear()
+{
+	for (TweenBucket &bucket : this->m_buckets)
+	{
+		bucket.m_elements.clear();
+		bucket.m_values.clear();
+		bucket.m_linkedValues.clear();
+		bucket.m_bounds.clear();
+		bucket.m_from.clear();
+		bucket.m_deltas.clear();
+		bucket.m_progress.clear();
+		bucket.m_rates.clear();
+		bucket.m_results.clear();
+	}
+	this->m_indices.clear();
+}
+
+bool TweenManager::isAnimating(Element *element, const unsigned int property) const
+{
+	if (!element)
+		return false;
+
+	TweenTarget target = element->getTweenTarget(property);
+	return target.m_value && this->m_indices.find(target.m_value) != this->m_indices.end();
+}
+
+size_t TweenManager::getTweenCount() const
+{
+	return this->m_indices.size();
+}
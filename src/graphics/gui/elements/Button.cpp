@@ -26,6 +26,8 @@ Button::Button(const float originX, const float originY, const unsigned char zIn
 
 	if (!text.empty())
 		this->m_textBuffer = Renderer2D::generateTextBuffer(text, font, CEDAR_ALIGNMENT_CENTER | CEDAR_ALIGNMENT_MIDDLE);
+	else
+		this->m_textBuffer = nullptr;
 }
 
 Button::~Button()
@@ -61,26 +63,32 @@ void Button::render(unsigned long currentTime)
 
 void Button::setBackgroundColor(const Vector4f &color) {
 	this->m_backgroundColor = color;
+	this->markDirty();
 }
 
 void Button::setHoveredBackgroundColor(const Vector4f &color) {
 	this->m_hoveredBackgroundColor = color;
+	this->markDirty();
 }
 
 void Button::setPressedBackgroundColor(const Vector4f &color) {
 	this->m_pressedBackgroundColor = color;
+	this->markDirty();
 }
 
 void Button::setTextColor(const Vector4f &color) {
 	this->m_textColor = color;
+	this->markDirty();
 }
 
 void Button::setHoveredTextColor(const Vector4f &color) {
 	this->m_hoveredTextColor = color;
+	this->markDirty();
 }
 
 void Button::setPressedTextColor(const Vector4f &color) {
 	this->m_pressedTextColor = color;
+	this->markDirty();
 }
 
 std::string Button::getText() const {
@@ -92,8 +100,11 @@ void Button::setText(const std::string &text) {
 		throw ElementUpdateException("Could not set text of button. There has to be a font for the button to have text!");
 
 	this->m_text = text;
-	delete this->m_textBuffer;
-	this->m_textBuffer = Renderer2D::generateTextBuffer(text, this->m_font, CEDAR_ALIGNMENT_CENTER | CEDAR_ALIGNMENT_MIDDLE);
+	if (this->m_textBuffer)
+		Renderer2D::updateTextBuffer(this->m_textBuffer, text, this->m_font, CEDAR_ALIGNMENT_CENTER | CEDAR_ALIGNMENT_MIDDLE);
+	else
+		this->m_textBuffer = Renderer2D::generateTextBuffer(text, this->m_font, CEDAR_ALIGNMENT_CENTER | CEDAR_ALIGNMENT_MIDDLE);
+	this->markDirty();
 }
 
 std::shared_ptr<Font> Button::getFont() const {
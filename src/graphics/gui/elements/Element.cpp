@@ -3,6 +3,7 @@
 //
 
 #include "cedar/Element.hpp"
+#include "cedar/Screen.hpp"
 
 using namespace cedar;
 
@@ -18,6 +19,15 @@ ElementUpdateException::ElementUpdateException(const std::string &message) : Ele
 Element::Element(const float originX, const float originY, const unsigned char zIndex, const float width, const float height,
 				 const unsigned int alignment)
 {
+	this->m_screen = nullptr;
+	this->m_screenIndex = 0;
+	this->m_gridMinX = 0;
+	this->m_gridMinY = 0;
+	this->m_gridMaxX = -1;
+	this->m_gridMaxY = -1;
+	this->m_parent = nullptr;
+	this->m_animated = false;
+	this->m_animatedBounds = false;
 	this->m_originX = originX;
 	this->m_originY = originY;
 	this->m_zIndex = zIndex;
@@ -71,7 +81,85 @@ Element::Element(const float originX, const float originY, const unsigned char z
 }
 
 Element::~Element()
-= default;
+{
+	if (this->m_parent)
+		this->m_parent->onChildRemoved(this);
+
+	if (this->m_screen)
+		this->m_screen->removeElement(this);
+}
+
+void Element::onBoundsChanged()
+{
+	if (this->m_screen)
+		this->m_screen->updateElementBounds(this);
+
+	if (this->m_parent)
+		this->m_parent->onChildChanged(this);
+}
+
+void Element::onChildChanged(Element *child)
+{}
+
+void Element::onChildLayoutInvalidated(Element *child)
+{
+	if (this->m_parent)
+		this->m_parent->onChildLayoutInvalidated(this);
+}
+
+void Element::onChildRemoved(Element *child)
+{}
+
+void Element::updateLayout()
+{}
+
+bool Element::isResizable() const
+{
+	return true;
+}
+
+Element *Element::getParent() const
+{
+	return this->m_parent;
+}
+
+bool Element::clipsChildren() const
+{
+	return false;
+}
+
+TweenTarget Element::getTweenTarget(const unsigned int property)
+{
+	switch (property)
+	{
+		case CEDAR_TWEEN_POS_X:
+			return {&this->m_posX, &this->m_originX, true};
+
+		case CEDAR_TWEEN_POS_Y:
+			return {&this->m_posY, &this->m_originY, true};
+
+		case CEDAR_TWEEN_WIDTH:
+			if (this->isResizable())
+				return {&this->m_width, nullptr, true};
+			break;
+
+		case CEDAR_TWEEN_HEIGHT:
+			if (this->isResizable())
+				return {&this->m_height, nullptr, true};
+			break;
+
+		default:
+			break;
+	}
+
+	return {nullptr, nullptr, false};
+}
+
+void Element::markDirty()
+{
+	if (this->m_screen)
+		this->m_screen->invalidate(this->m_posX, this->m_posY, this->m_width, this->m_height);
+}
 
 float Element::getOriginX() const
 {
@@ -83,6 +171,7 @@ void Element::setOriginX(const float newOriginX)
 	float offset = newOriginX - this->m_originX;
 	this->m_originX = newOriginX;
 	this->m_posX += offset;
+	this->onBoundsChanged();
 }
 
 float Element::getOriginY() const
@@ -95,6 +184,7 @@ void Element::setOriginY(const float newOriginY)
 	float offset = newOriginY - this->m_originY;
 	this->m_originY = newOriginY;
 	this->m_posY += offset;
+	this->onBoundsChanged();
 }
 
 void Element::setOrigin(float newOriginX, float newOriginY)
@@ -105,7 +195,7 @@ void Element::setOrigin(float newOriginX, float newOriginY)
 	this->m_originY = newOriginY;
 	this->m_posX += offsetX;
 	this->m_posY += offsetY;
-
+	this->onBoundsChanged();
 }
 
 float Element::getPosX() const
@@ -118,6 +208,7 @@ void Element::setPosX(const float newPosX)
 	float offset = newPosX - this->m_posX;
 	this->m_posX = newPosX;
 	this->m_originX += offset;
+	this->onBoundsChanged();
 }
 
 float Element::getPosY() const
@@ -130,6 +221,7 @@ void Element::setPosY(const float newPosY)
 	float offset = newPosY - this->m_posY;
 	this->m_posY = newPosY;
 	this->m_originY += offset;
+	this->onBoundsChanged();
 }
 
 void Element::setPosition(const float newPosX, const float newPosY)
@@ -140,6 +232,7 @@ void Element::setPosition(const float newPosX, const float newPosY)
 	this->m_posY = newPosY;
 	this->m_originX += offsetX;
 	this->m_originY += offsetY;
+	this->onBoundsChanged();
 }
 
 unsigned char Element::getZIndex() const
@@ -155,6 +248,7 @@ float Element::getWidth() const
 void Element::setWidth(const float newWidth)
 {
 	this->m_width = newWidth;
+	this->onBoundsChanged();
 }
 
 float Element::getHeight() const
@@ -165,12 +259,14 @@ float Element::getHeight() const
 void Element::setHeight(const float newHeight)
 {
 	this->m_height = newHeight;
+	this->onBoundsChanged();
 }
 
 void Element::setSize(const float newWidth, const float newHeight)
 {
 	this->m_width = newWidth;
 	this->m_height = newHeight;
+	this->onBoundsChanged();
 }
 
 unsigned int Element::getAlignment() const
@@ -185,6 +281,9 @@ bool Element::isEnabled() const
 
 void Element::setEnabled(const bool enabled)
 {
+	if (this->m_enabled != enabled)
+		this->markDirty();
+
 	this->m_enabled = enabled;
 }
 
@@ -195,7 +294,15 @@ bool Element::isVisible() const
 
 void Element::setVisibility(const bool visible)
 {
+	if (this->m_visible != visible)
+		this->markDirty();
+
+	bool changed = this->m_visible != visible;
 	this->m_visible = visible;
+
+	// Invisible children take no space in their container.
+	if (changed && this->m_parent)
+		this->m_parent->onChildChanged(this);
 }
 
 bool Element::isInteractable() const
@@ -215,6 +322,9 @@ bool Element::isHovered() const
 
 void Element::setHovered(const bool hovered)
 {
+	if (this->m_hovered != hovered)
+		this->markDirty();
+
 	this->m_hovered = hovered;
 }
 
@@ -225,6 +335,9 @@ bool Element::isPressed() const
 
 void Element::setPressed(const bool pressed)
 {
+	if (this->m_pressed != pressed)
+		this->markDirty();
+
 	this->m_pressed = pressed;
 }
 
@@ -235,6 +348,9 @@ bool Element::isFocused() const
 
 void Element::setFocused(const bool focused)
 {
+	if (this->m_focused != focused)
+		this->markDirty();
+
 	this->m_focused = focused;
 }
 
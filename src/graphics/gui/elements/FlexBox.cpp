@@ -0,0 +1,443 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <algorithm>
+
+#include "cedar/FlexBox.hpp"
+
+using namespace cedar;
+
+FlexBox::FlexBox(const float originX, const float originY, const unsigned char zIndex, const float width, const float height,
+				 const unsigned int direction, const unsigned int alignment)
+		: Element(originX, originY, zIndex, width, height, alignment)
+{
+	// The element only resolves the alignment for sizes that are known, auto sizes are resolved by the first layout.
+	if (width <= 0.0f)
+	{
+		this->m_width = 0.0f;
+		this->m_posX = originX;
+	}
+
+	if (height <= 0.0f)
+	{
+		this->m_height = 0.0f;
+		this->m_posY = originY;
+	}
+
+	this->m_items = std::vector<FlexItem>();
+	this->m_direction = direction;
+	this->m_justify = CEDAR_FLEX_JUSTIFY_START;
+	this->m_align = CEDAR_FLEX_ALIGN_START;
+	this->m_gap = 0.0f;
+	this->m_padding = 0.0f;
+	this->m_autoWidth = width <= 0.0f;
+	this->m_autoHeight = height <= 0.0f;
+	this->m_contentWidth = 0.0f;
+	this->m_contentHeight = 0.0f;
+	this->m_measureDirty = true;
+	this->m_arrangeDirty = true;
+	this->m_childLayoutDirty = false;
+	this->m_arranging = false;
+}
+
+FlexBox::~FlexBox()
+{
+	for (const FlexItem &item : this->m_items)
+		item.m_element->m_parent = nullptr;
+}
+
+void FlexBox::invalidateLayout(const bool measure)
+{
+	bool measureWasDirty = this->m_measureDirty;
+	if (measure)
+		this->m_measureDirty = true;
+	this->m_arrangeDirty = true;
+
+	if (!this->m_parent)
+		return;
+
+	// A new content size may change the layout of the container as well, it is only told once until it measured again.
+	if (measure && !measureWasDirty)
+		this->m_parent->onChildChanged(this);
+
+	// The screen only lays out the root, so every container above has to pass the layout on to this flex box.
+	this->m_parent->onChildLayoutInvalidated(this);
+}
+
+void FlexBox::onBoundsChanged()
+{
+	Element::onBoundsChanged();
+	this->m_arrangeDirty = true;
+}
+
+void FlexBox::onChildChanged(Element *child)
+{
+	// The children are moved by the arrange pass itself, which must not mark the layout dirty again.
+	if (this->m_arranging)
+		return;
+
+	for (FlexItem &item : this->m_items)
+	{
+		if (item.m_element != child)
+			continue;
+
+		// A size other than the arranged size was set from outside, so it is the new basis of the child.
+		if (!dynamic_cast<FlexBox *>(child))
+		{
+			if (child->getWidth() != item.m_arrangedWidth)
+				item.m_basisWidth = child->getWidth();
+			if (child->getHeight() != item.m_arrangedHeight)
+				item.m_basisHeight = child->getHeight();
+		}
+
+		this->invalidateLayout(true);
+		return;
+	}
+}
+
+void FlexBox::onChildLayoutInvalidated(Element *child)
+{
+	// The containers above were already told, until the flex box is laid out again.
+	if (this->m_childLayoutDirty)
+		return;
+
+	this->m_childLayoutDirty = true;
+	if (this->m_parent)
+		this->m_parent->onChildLayoutInvalidated(this);
+}
+
+void FlexBox::onChildRemoved(Element *child)
+{
+	this->removeChild(child);
+}
+
+float FlexBox::getPreferredWidth()
+{
+	this->measure();
+	return this->m_autoWidth ? this->m_contentWidth : this->m_width;
+}
+
+float FlexBox::getPreferredHeight()
+{
+	this->measure();
+	return this->m_autoHeight ? this->m_contentHeight : this->m_height;
+}
+
+void FlexBox::measure()
+{
+	if (!this->m_measureDirty)
+		return;
+
+	bool row = this->m_direction == CEDAR_FLEX_ROW;
+	float mainSize = 0.0f;
+	float crossSize = 0.0f;
+	unsigned int visibleCount = 0;
+	for (const FlexItem &item : this->m_items)
+	{
+		if (!item.m_element->isVisible())
+			continue;
+
+		float width = item.m_basisWidth;
+		float height = item.m_basisHeight;
+		if (auto *box = dynamic_cast<FlexBox *>(item.m_element))
+		{
+			width = box->getPreferredWidth();
+			height = box->getPreferredHeight();
+		}
+
+		mainSize += row ? width : height;
+		crossSize = std::max(crossSize, row ? height : width);
+		visibleCount++;
+	}
+
+	if (visibleCount > 1)
+		mainSize += this->m_gap * static_cast<float>(visibleCount - 1);
+
+	this->m_contentWidth = (row ? mainSize : crossSize) + this->m_padding * 2.0f;
+	this->m_contentHeight = (row ? crossSize : mainSize) + this->m_padding * 2.0f;
+	this->m_measureDirty = false;
+}
+
+void FlexBox::arrange()
+{
+	this->m_arranging = true;
+
+	bool row = this->m_direction == CEDAR_FLEX_ROW;
+	float innerMain = std::max((row ? this->m_width : this->m_height) - this->m_padding * 2.0f, 0.0f);
+	float innerCross = std::max((row ? this->m_height : this->m_width) - this->m_padding * 2.0f, 0.0f);
+
+	// The main and cross size of every visible child.
+	std::vector<std::pair<float, float>> sizes(this->m_items.size());
+	float usedMain = 0.0f;
+	float totalGrow = 0.0f;
+	unsigned int visibleCount = 0;
+	for (size_t n = 0; n < this->m_items.size(); n++)
+	{
+		const FlexItem &item = this->m_items[n];
+		if (!item.m_element->isVisible())
+			continue;
+
+		float width = item.m_basisWidth;
+		float height = item.m_basisHeight;
+		if (auto *box = dynamic_cast<FlexBox *>(item.m_element))
+		{
+			width = box->getPreferredWidth();
+			height = box->getPreferredHeight();
+		}
+
+		sizes[n] = row ? std::make_pair(width, height) : std::make_pair(height, width);
+		usedMain += sizes[n].first;
+		if (item.m_element->isResizable())
+			totalGrow += item.m_grow;
+		visibleCount++;
+	}
+
+	if (visibleCount > 1)
+		usedMain += this->m_gap * static_cast<float>(visibleCount - 1);
+
+	float freeMain = innerMain - usedMain;
+	if (freeMain > 0.0f && totalGrow > 0.0f)
+	{
+		for (size_t n = 0; n < this->m_items.size(); n++)
+		{
+			const FlexItem &item = this->m_items[n];
+			if (item.m_element->isVisible() && item.m_element->isResizable())
+				sizes[n].first += freeMain * item.m_grow / totalGrow;
+		}
+		freeMain = 0.0f;
+	}
+
+	float mainOffset = 0.0f;
+	float spacing = this->m_gap;
+	if (freeMain > 0.0f)
+	{
+		switch (this->m_justify)
+		{
+			case CEDAR_FLEX_JUSTIFY_CENTER:
+				mainOffset = freeMain * 0.5f;
+				break;
+
+			case CEDAR_FLEX_JUSTIFY_END:
+				mainOffset = freeMain;
+				break;
+
+			case CEDAR_FLEX_JUSTIFY_SPACE_BETWEEN:
+				if (visibleCount > 1)
+					spacing += freeMain / static_cast<float>(visibleCount - 1);
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	float innerX = this->m_posX + this->m_padding;
+	float innerY = this->m_posY + this->m_padding;
+	for (size_t n = 0; n < this->m_items.size(); n++)
+	{
+		FlexItem &item = this->m_items[n];
+		Element *element = item.m_element;
+		if (!element->isVisible())
+			continue;
+
+		float mainSize = sizes[n].first;
+		float crossSize = sizes[n].second;
+		if (this->m_align == CEDAR_FLEX_ALIGN_STRETCH && element->isResizable())
+			crossSize = innerCross;
+
+		float crossOffset;
+		switch (this->m_align)
+		{
+			case CEDAR_FLEX_ALIGN_CENTER:
+				crossOffset = (innerCross - crossSize) * 0.5f;
+				break;
+
+			case CEDAR_FLEX_ALIGN_END:
+				crossOffset = innerCross - crossSize;
+				break;
+
+			default:
+				crossOffset = 0.0f;
+				break;
+		}
+
+		float posX = row ? innerX + mainOffset : innerX + crossOffset;
+		float posY = row ? innerY + crossOffset : innerY + mainOffset;
+		float width = row ? mainSize : crossSize;
+		float height = row ? crossSize : mainSize;
+
+		// Unchanged children are not touched, so they don't invalidate the cache of their screen.
+		if (element->getPosX() != posX || element->getPosY() != posY)
+			element->setPosition(posX, posY);
+		if (element->isResizable() && (element->getWidth() != width || element->getHeight() != height))
+			element->setSize(width, height);
+
+		item.m_arrangedWidth = element->getWidth();
+		item.m_arrangedHeight = element->getHeight();
+		mainOffset += mainSize + spacing;
+	}
+
+	this->m_arranging = false;
+	this->m_arrangeDirty = false;
+
+	// Nested flex boxes that were moved, resized or changed themselves are laid out after their new bounds are known.
+	this->updateChildLayouts();
+}
+
+void FlexBox::updateChildLayouts()
+{
+	this->m_childLayoutDirty = false;
+	for (const FlexItem &item : this->m_items)
+	{
+		if (item.m_element->isVisible())
+			item.m_element->updateLayout();
+	}
+}
+
+void FlexBox::render(const unsigned long currentTime)
+{}
+
+void FlexBox::updateLayout()
+{
+	if (!this->m_measureDirty && !this->m_arrangeDirty)
+	{
+		// Only the children below are dirty, they are laid out inside the current bounds.
+		if (this->m_childLayoutDirty)
+			this->updateChildLayouts();
+		return;
+	}
+
+	this->measure();
+
+	// Only flex boxes outside of a container size themselves, nested ones are sized by their container.
+	if (!this->m_parent && (this->m_autoWidth || this->m_autoHeight))
+	{
+		float width = this->m_autoWidth ? this->m_contentWidth : this->m_width;
+		float height = this->m_autoHeight ? this->m_contentHeight : this->m_height;
+		if (width != this->m_width || height != this->m_height)
+		{
+			this->m_width = width;
+			this->m_height = height;
+
+			switch (this->m_alignment & 0x03u)
+			{
+				case CEDAR_ALIGNMENT_CENTER:
+					this->m_posX = this->m_originX - (this->m_width * 0.5f);
+					break;
+
+				case CEDAR_ALIGNMENT_RIGHT:
+					this->m_posX = this->m_originX - this->m_width;
+					break;
+
+				default:
+					this->m_posX = this->m_originX;
+					break;
+			}
+
+			switch (this->m_alignment & 0x0Cu)
+			{
+				case CEDAR_ALIGNMENT_MIDDLE:
+					this->m_posY = this->m_originY - (this->m_height * 0.5f);
+					break;
+
+				case CEDAR_ALIGNMENT_BOTTOM:
+					this->m_posY = this->m_originY - this->m_height;
+					break;
+
+				default:
+					this->m_posY = this->m_originY;
+					break;
+			}
+
+			this->onBoundsChanged();
+		}
+	}
+
+	this->arrange();
+}
+
+void FlexBox::addChild(Element *child, const float grow)
+{
+	if (!child)
+		throw ElementUpdateException("Could not add child to flex box. The child can't be a nullptr!");
+
+	if (child == this)
+		throw ElementUpdateException("Could not add child to flex box. A flex box can't contain itself!");
+
+	if (child->m_parent)
+		throw ElementUpdateException("Could not add child to flex box. The child is already part of a container!");
+
+	child->m_parent = this;
+	this->m_items.push_back({child, std::max(grow, 0.0f), child->getWidth(), child->getHeight(), child->getWidth(), child->getHeight()});
+	this->invalidateLayout(true);
+}
+
+void FlexBox::removeChild(Element *child)
+{
+	for (auto it = this->m_items.begin(); it != this->m_items.end(); it++)
+	{
+		if (it->m_element == child)
+		{
+			child->m_parent = nullptr;
+			this->m_items.erase(it);
+			this->invalidateLayout(true);
+			return;
+		}
+	}
+}
+
+unsigned int FlexBox::getDirection() const
+{
+	return this->m_direction;
+}
+
+void FlexBox::setDirection(const unsigned int direction)
+{
+	this->m_direction = direction;
+	this->invalidateLayout(true);
+}
+
+unsigned int FlexBox::getJustify() const
+{
+	return this->m_justify;
+}
+
+void FlexBox::setJustify(const unsigned int justify)
+{
+	this->m_justify = justify;
+	this->invalidateLayout(false);
+}
+
+unsigned int FlexBox::getAlign() const
+{
+	return this->m_align;
+}
+
+void FlexBox::setAlign(const unsigned int align)
+{
+	this->m_align = align;
+	this->invalidateLayout(false);
+}
+
+float FlexBox::getGap() const
+{
+	return this->m_gap;
+}
+
+void FlexBox::setGap(const float gap)
+{
+	this->m_gap = gap;
+	this->invalidateLayout(true);
+}
+
+float FlexBox::getPadding() const
+{
+	return this->m_padding;
+}
+
+void FlexBox::setPadding(const float padding)
+{
+	this->m_padding = padding;
+	this->invalidateLayout(true);
+}
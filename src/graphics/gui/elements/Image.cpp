@@ -18,6 +18,11 @@ Image::Image(const float originX, const float originY, const unsigned char zInde
 	this->m_uvSection = uvSection;
 }
 
+Image::Image(const float originX, const float originY, const unsigned char zIndex, const float width, const float height,
+			 const TextureRegion &region, const unsigned int alignment)
+		: Image(originX, originY, zIndex, width, height, region.m_texture, region.m_uvs, alignment)
+{}
+
 void Image::render(const unsigned long currentTime)
 {
 	Renderer2D::drawTexturedRect(this->m_posX, this->m_posY, this->m_zIndex, this->m_width, this->m_height,
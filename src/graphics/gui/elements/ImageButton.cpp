@@ -71,8 +71,11 @@ void ImageButton::setCaption(const std::string &newCaption)
 		throw ElementUpdateException("Could not set caption of image button. The font is not set yet!");
 
 	this->m_caption = newCaption;
-	delete this->m_textBuffer;
-	this->m_textBuffer = Renderer2D::generateTextBuffer(newCaption, this->m_font, CEDAR_ALIGNMENT_MIDDLE | CEDAR_ALIGNMENT_CENTER);
+	if (this->m_textBuffer)
+		Renderer2D::updateTextBuffer(this->m_textBuffer, newCaption, this->m_font, CEDAR_ALIGNMENT_MIDDLE | CEDAR_ALIGNMENT_CENTER);
+	else
+		this->m_textBuffer = Renderer2D::generateTextBuffer(newCaption, this->m_font, CEDAR_ALIGNMENT_MIDDLE | CEDAR_ALIGNMENT_CENTER);
+	this->markDirty();
 }
 
 std::shared_ptr<Font> ImageButton::getFont() const
@@ -86,8 +89,11 @@ void ImageButton::setFont(const std::shared_ptr<Font> &newFont)
 		throw ElementUpdateException("Could not set font of image button. The font can't be a nullptr!");
 
 	this->m_font = newFont;
-	delete this->m_textBuffer;
-	this->m_textBuffer = Renderer2D::generateTextBuffer(this->m_caption, this->m_font, CEDAR_ALIGNMENT_MIDDLE | CEDAR_ALIGNMENT_CENTER);
+	if (this->m_textBuffer)
+		Renderer2D::updateTextBuffer(this->m_textBuffer, this->m_caption, this->m_font, CEDAR_ALIGNMENT_MIDDLE | CEDAR_ALIGNMENT_CENTER);
+	else
+		this->m_textBuffer = Renderer2D::generateTextBuffer(this->m_caption, this->m_font, CEDAR_ALIGNMENT_MIDDLE | CEDAR_ALIGNMENT_CENTER);
+	this->markDirty();
 }
 
 Vector4f ImageButton::getDefaultCaptionColor() const
@@ -98,6 +104,7 @@ Vector4f ImageButton::getDefaultCaptionColor() const
 void ImageButton::setDefaultCaptionColor(const Vector4f &newColor)
 {
 	this->m_defaultCaptionColor = newColor;
+	this->markDirty();
 }
 
 Vector4f ImageButton::getHoveredCaptionColor() const
@@ -108,6 +115,7 @@ Vector4f ImageButton::getHoveredCaptionColor() const
 void ImageButton::setHoveredCaptionColor(const Vector4f &newColor)
 {
 	this->m_hoveredCaptionColor = newColor;
+	this->markDirty();
 }
 
 Vector4f ImageButton::getPressedCaptionColor() const
@@ -118,6 +126,7 @@ Vector4f ImageButton::getPressedCaptionColor() const
 void ImageButton::setPressedCaptionColor(const Vector4f &newColor)
 {
 	this->m_pressedCaptionColor = newColor;
+	this->markDirty();
 }
 
 float ImageButton::getDefaultCaptionOffset() const
@@ -128,6 +137,7 @@ float ImageButton::getDefaultCaptionOffset() const
 void ImageButton::setDefaultCaptionOffset(const float newOffset)
 {
 	this->m_defaultCaptionOffset = newOffset;
+	this->markDirty();
 }
 
 float ImageButton::getHoveredCaptionOffset() const
@@ -138,6 +148,7 @@ float ImageButton::getHoveredCaptionOffset() const
 void ImageButton::setHoveredCaptionOffset(const float newOffset)
 {
 	this->m_hoveredCaptionOffset = newOffset;
+	this->markDirty();
 }
 
 float ImageButton::getPressedCaptionOffset() const
@@ -148,6 +159,7 @@ float ImageButton::getPressedCaptionOffset() const
 void ImageButton::setPressedCaptionOffset(const float newOffset)
 {
 	this->m_pressedCaptionOffset = newOffset;
+	this->markDirty();
 }
 
 void ImageButton::render(const unsigned long currentTime)
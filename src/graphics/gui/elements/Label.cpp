@@ -42,9 +42,12 @@ std::string Label::getText() const {
 
 void Label::setText(const std::string &text) {
 	this->m_text = text;
-	delete this->m_textBuffer;
 
-	this->m_textBuffer = Renderer2D::generateTextBuffer(text, this->m_font, this->m_alignment);
+	// The quads of the old text are reused if the new text fits into them.
+	if (this->m_textBuffer)
+		Renderer2D::updateTextBuffer(this->m_textBuffer, text, this->m_font, this->m_alignment);
+	else
+		this->m_textBuffer = Renderer2D::generateTextBuffer(text, this->m_font, this->m_alignment);
 	this->m_width = this->m_textBuffer->getSize().x;
 	this->m_height = this->m_textBuffer->getSize().y;
 
@@ -79,6 +82,8 @@ void Label::setText(const std::string &text) {
 			this->m_posY = this->m_originY;
 			break;
 	}
+
+	this->onBoundsChanged();
 }
 
 std::shared_ptr<Font> Label::getFont() const {
@@ -95,6 +100,31 @@ void Label::setFont(const std::shared_ptr<Font> &newFont) {
 
 void Label::setTextColor(const Vector4f &color) {
 	this->m_textColor = color;
+	this->markDirty();
+}
+
+bool Label::isResizable() const {
+	return false;
+}
+
+TweenTarget Label::getTweenTarget(const unsigned int property) {
+	switch (property)
+	{
+		case CEDAR_TWEEN_COLOR_RED:
+			return {&this->m_textColor.x, nullptr, false};
+
+		case CEDAR_TWEEN_COLOR_GREEN:
+			return {&this->m_textColor.y, nullptr, false};
+
+		case CEDAR_TWEEN_COLOR_BLUE:
+			return {&this->m_textColor.z, nullptr, false};
+
+		case CEDAR_TWEEN_COLOR_ALPHA:
+			return {&this->m_textColor.w, nullptr, false};
+
+		default:
+			return Element::getTweenTarget(property);
+	}
 }
 
 void Label::setWidth(const float newWidth) {
@@ -0,0 +1,286 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include "cedar/ListView.hpp"
+#include "cedar/Renderer2D.hpp"
+#include "cedar/Screen.hpp"
+
+using namespace cedar;
+
+ListView::ListView(const float originX, const float originY, const unsigned char zIndex, const float width, const float height,
+				   const float rowHeight, const std::function<Element *(ListView *listView)> &rowFactory,
+				   const std::function<void(Element *row, size_t index)> &rowBinder, const unsigned int alignment)
+		: Element(originX, originY, zIndex, width, height, alignment)
+{
+	if (rowHeight <= 0.0f)
+		throw ElementCreationException("Could not create list view. The row height must be greater than 0!");
+
+	if (!rowFactory || !rowBinder)
+		throw ElementCreationException("Could not create list view. The list view must have a row factory and a row binder!");
+
+	this->m_itemCount = 0;
+	this->m_rowHeight = rowHeight;
+	this->m_scrollOffset = 0.0;
+	this->m_overscan = CEDAR_LIST_VIEW_OVERSCAN;
+	this->m_rowFactory = rowFactory;
+	this->m_rowBinder = rowBinder;
+	this->m_rows = std::vector<ListViewRow>();
+	this->m_freeRows = std::vector<Element *>();
+	this->m_rowSlots = std::vector<Element *>();
+	this->m_rowsDirty = true;
+	this->m_rebindRows = false;
+
+	// The view must be interactable to receive scroll events.
+	this->m_interactable = true;
+	this->m_scrollCallback = [](Element *element, float offsetX, float offsetY, unsigned int modifiers) {
+		auto *listView = static_cast<ListView *>(element);
+		listView->scrollBy(-offsetY * listView->m_rowHeight * CEDAR_LIST_VIEW_SCROLL_ROWS);
+	};
+}
+
+ListView::~ListView()
+{
+	// The rows must not tell the list view about their destruction while it is destroyed itself.
+	for (const ListViewRow &row : this->m_rows)
+	{
+		row.m_element->m_parent = nullptr;
+		delete row.m_element;
+	}
+
+	for (Element *row : this->m_freeRows)
+	{
+		row->m_parent = nullptr;
+		delete row;
+	}
+}
+
+Element *ListView::createRow()
+{
+	Element *row = this->m_rowFactory(this);
+	if (!row)
+		throw ElementUpdateException("Could not create row of list view. The row factory returned a nullptr!");
+
+	if (row->m_screen || row->m_parent)
+		throw ElementUpdateException("Could not create row of list view. The row is already part of a screen or a container!");
+
+	row->m_parent = this;
+	if (!row->getScrollCallback())
+	{
+		row->setScrollCallback([this](Element *element, float offsetX, float offsetY, unsigned int modifiers) {
+			this->scrollBy(-offsetY * this->m_rowHeight * CEDAR_LIST_VIEW_SCROLL_ROWS);
+		});
+	}
+
+	return row;
+}
+
+void ListView::invalidateRows(const bool rebind)
+{
+	this->m_rowsDirty = true;
+	if (rebind)
+		this->m_rebindRows = true;
+
+	// The screen only lays out the root, so a container above has to pass the layout on to the list view.
+	if (this->m_parent)
+		this->m_parent->onChildLayoutInvalidated(this);
+}
+
+void ListView::updateRows()
+{
+	auto firstVisible = static_cast<size_t>(this->m_scrollOffset / this->m_rowHeight);
+	auto visibleCount = static_cast<size_t>(std::ceil(this->m_height / this->m_rowHeight)) + 1;
+	size_t start = std::min(firstVisible > this->m_overscan ? firstVisible - this->m_overscan : 0, this->m_itemCount);
+	size_t end = std::min(firstVisible + visibleCount + this->m_overscan, this->m_itemCount);
+
+	// Rows that still show an item of the range keep it, all others are hidden and recycled.
+	this->m_rowSlots.assign(end - start, nullptr);
+	for (const ListViewRow &row : this->m_rows)
+	{
+		if (row.m_index >= start && row.m_index < end)
+		{
+			this->m_rowSlots[row.m_index - start] = row.m_element;
+		}
+		else
+		{
+			row.m_element->setVisibility(false);
+			this->m_freeRows.push_back(row.m_element);
+		}
+	}
+
+	this->m_rows.clear();
+	for (size_t index = start; index < end; index++)
+	{
+		Element *row = this->m_rowSlots[index - start];
+		bool bind = this->m_rebindRows;
+		if (!row)
+		{
+			if (this->m_freeRows.empty())
+			{
+				row = this->createRow();
+			}
+			else
+			{
+				row = this->m_freeRows.back();
+				this->m_freeRows.pop_back();
+			}
+			bind = true;
+		}
+
+		if (bind)
+			this->m_rowBinder(row, index);
+
+		auto posY = static_cast<float>(this->m_posY + static_cast<double>(index) * this->m_rowHeight - this->m_scrollOffset);
+		if (row->getPosX() != this->m_posX || row->getPosY() != posY)
+			row->setPosition(this->m_posX, posY);
+		if (row->isResizable() && (row->getWidth() != this->m_width || row->getHeight() != this->m_rowHeight))
+			row->setSize(this->m_width, this->m_rowHeight);
+		if (!row->isVisible())
+			row->setVisibility(true);
+
+		if (this->m_screen && !row->m_screen)
+			this->m_screen->addElement(row);
+
+		this->m_rows.push_back({row, index});
+	}
+
+	this->m_rowsDirty = false;
+	this->m_rebindRows = false;
+}
+
+void ListView::onBoundsChanged()
+{
+	Element::onBoundsChanged();
+	this->invalidateRows(false);
+}
+
+void ListView::onChildRemoved(Element *child)
+{
+	auto it = std::find_if(this->m_rows.begin(), this->m_rows.end(), [child](const ListViewRow &row) {
+		return row.m_element == child;
+	});
+	if (it != this->m_rows.end())
+		this->m_rows.erase(it);
+
+	auto freeIt = std::find(this->m_freeRows.begin(), this->m_freeRows.end(), child);
+	if (freeIt != this->m_freeRows.end())
+		this->m_freeRows.erase(freeIt);
+
+	this->m_rowsDirty = true;
+}
+
+void ListView::render(const unsigned long currentTime)
+{
+	Renderer2D::pushClipRect(this->m_posX, this->m_posY, this->m_width, this->m_height);
+	for (const ListViewRow &row : this->m_rows)
+	{
+		Element *element = row.m_element;
+		if (element->isVisible() && element->getPosY() < this->m_posY + this->m_height
+			&& element->getPosY() + element->getHeight() > this->m_posY)
+			element->render(currentTime);
+	}
+	Renderer2D::popClipRect();
+}
+
+void ListView::updateLayout()
+{
+	if (this->m_rowsDirty)
+		this->updateRows();
+
+	// Rows can be containers themselves.
+	for (const ListViewRow &row : this->m_rows)
+		row.m_element->updateLayout();
+}
+
+bool ListView::clipsChildren() const
+{
+	return true;
+}
+
+size_t ListView::getItemCount() const
+{
+	return this->m_itemCount;
+}
+
+void ListView::setItemCount(const size_t itemCount)
+{
+	this->m_itemCount = itemCount;
+	this->invalidateRows(true);
+	this->setScrollOffset(this->m_scrollOffset);
+}
+
+void ListView::notifyDataChanged()
+{
+	this->invalidateRows(true);
+}
+
+void ListView::notifyItemChanged(const size_t index)
+{
+	for (const ListViewRow &row : this->m_rows)
+	{
+		if (row.m_index == index)
+		{
+			this->m_rowBinder(row.m_element, index);
+			return;
+		}
+	}
+}
+
+float ListView::getRowHeight() const
+{
+	return this->m_rowHeight;
+}
+
+double ListView::getScrollOffset() const
+{
+	return this->m_scrollOffset;
+}
+
+double ListView::getMaxScrollOffset() const
+{
+	return std::max(static_cast<double>(this->m_itemCount) * this->m_rowHeight - this->m_height, 0.0);
+}
+
+void ListView::setScrollOffset(const double scrollOffset)
+{
+	double newScrollOffset = std::min(std::max(scrollOffset, 0.0), this->getMaxScrollOffset());
+	if (newScrollOffset == this->m_scrollOffset)
+		return;
+
+	this->m_scrollOffset = newScrollOffset;
+	this->invalidateRows(false);
+	this->markDirty();
+}
+
+void ListView::scrollBy(const double distance)
+{
+	this->setScrollOffset(this->m_scrollOffset + distance);
+}
+
+void ListView::scrollToItem(const size_t index)
+{
+	double itemTop = static_cast<double>(index) * this->m_rowHeight;
+	if (itemTop < this->m_scrollOffset)
+		this->setScrollOffset(itemTop);
+	else if (itemTop + this->m_rowHeight > this->m_scrollOffset + this->m_height)
+		this->setScrollOffset(itemTop + this->m_rowHeight - this->m_height);
+}
+
+unsigned int ListView::getOverscan() const
+{
+	return this->m_overscan;
+}
+
+void ListView::setOverscan(const unsigned int overscan)
+{
+	this->m_overscan = overscan;
+	this->invalidateRows(false);
+}
+
+size_t ListView::getRowCount() const
+{
+	return this->m_rows.size() + this->m_freeRows.size();
+}
@@ -0,0 +1,294 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <algorithm>
+
+#include "cedar/TextView.hpp"
+#include "cedar/Renderer2D.hpp"
+
+using namespace cedar;
+
+TextView::TextView(const float originX, const float originY, const unsigned char zIndex, const float width, const float height,
+				   const std::shared_ptr<Font> &font, const Vector4f &textColor, const unsigned int alignment)
+		: Element(originX, originY, zIndex, width, height, alignment)
+{
+	if (!font)
+		throw ElementCreationException("Could not create text view. The text view must have a font!");
+
+	this->m_chunks = std::deque<std::string>();
+	this->m_firstChunk = 0;
+	this->m_lines = std::deque<TextViewLine>();
+	this->m_maxLines = 0;
+	this->m_scrollLine = 0;
+	this->m_followTail = true;
+	this->m_cachedFirstLine = 0;
+	this->m_cachedLastLine = 0;
+	this->m_freeTextBuffers = std::vector<TextBuffer *>();
+	this->m_font = font;
+	this->m_textColor = textColor;
+
+	// The view must be interactable to receive scroll events.
+	this->m_interactable = true;
+	this->m_scrollCallback = [](Element *element, float offsetX, float offsetY, unsigned int modifiers) {
+		static_cast<TextView *>(element)->scrollBy(static_cast<long>(-offsetY * CEDAR_TEXT_VIEW_SCROLL_LINES));
+	};
+}
+
+TextView::~TextView()
+{
+	this->evictLayouts(this->m_cachedFirstLine, this->m_cachedLastLine);
+	for (TextBuffer *textBuffer : this->m_freeTextBuffers)
+		delete textBuffer;
+}
+
+void TextView::storeLine(const std::string &line)
+{
+	// Lines never span two chunks, so a line that does not fit into the last chunk starts a new one.
+	if (this->m_chunks.empty() || (!this->m_chunks.back().empty() && this->m_chunks.back().size() + line.size() > CEDAR_TEXT_VIEW_CHUNK_SIZE))
+	{
+		this->m_chunks.emplace_back();
+		this->m_chunks.back().reserve(std::max(line.size(), static_cast<size_t>(CEDAR_TEXT_VIEW_CHUNK_SIZE)));
+	}
+
+	std::string &chunk = this->m_chunks.back();
+	this->m_lines.push_back({this->m_firstChunk + this->m_chunks.size() - 1, chunk.size(), line.size(), nullptr});
+	chunk.append(line);
+
+	if (this->m_maxLines > 0 && this->m_lines.size() > this->m_maxLines)
+	{
+		if (this->m_lines.front().m_textBuffer)
+			this->m_freeTextBuffers.push_back(this->m_lines.front().m_textBuffer);
+		this->m_lines.pop_front();
+
+		// Every index shifts by one line, the cached layouts move with their lines.
+		this->m_cachedFirstLine = this->m_cachedFirstLine > 0 ? this->m_cachedFirstLine - 1 : 0;
+		this->m_cachedLastLine = this->m_cachedLastLine > 0 ? this->m_cachedLastLine - 1 : 0;
+		if (this->m_scrollLine > 0)
+			this->m_scrollLine--;
+
+		while (this->m_firstChunk < this->m_lines.front().m_chunk)
+		{
+			this->m_chunks.pop_front();
+			this->m_firstChunk++;
+		}
+	}
+}
+
+void TextView::evictLayouts(const size_t firstLine, size_t lastLine)
+{
+	lastLine = std::min(lastLine, this->m_lines.size());
+	for (size_t n = firstLine; n < lastLine; n++)
+	{
+		if (this->m_lines[n].m_textBuffer)
+		{
+			this->m_freeTextBuffers.push_back(this->m_lines[n].m_textBuffer);
+			this->m_lines[n].m_textBuffer = nullptr;
+		}
+	}
+}
+
+void TextView::render(const unsigned long currentTime)
+{
+	size_t firstLine = std::min(this->m_scrollLine, this->m_lines.size());
+	size_t lastLine = std::min(firstLine + this->getVisibleLineCount(), this->m_lines.size());
+
+	// Only the layouts of the visible lines are kept.
+	if (this->m_cachedFirstLine < firstLine)
+		this->evictLayouts(this->m_cachedFirstLine, std::min(this->m_cachedLastLine, firstLine));
+	if (this->m_cachedLastLine > lastLine)
+		this->evictLayouts(std::max(this->m_cachedFirstLine, lastLine), this->m_cachedLastLine);
+	this->m_cachedFirstLine = firstLine;
+	this->m_cachedLastLine = lastLine;
+
+	auto lineHeight = static_cast<float>(this->m_font->getSize());
+	for (size_t n = firstLine; n < lastLine; n++)
+	{
+		TextViewLine &line = this->m_lines[n];
+		if (line.m_length == 0)
+			continue;
+
+		if (!line.m_textBuffer)
+		{
+			const std::string &chunk = this->m_chunks[line.m_chunk - this->m_firstChunk];
+			if (this->m_freeTextBuffers.empty())
+			{
+				line.m_textBuffer = Renderer2D::generateTextBuffer(chunk.substr(line.m_offset, line.m_length), this->m_font);
+			}
+			else
+			{
+				// Lines that scrolled out of view hand their buffers to the lines that scrolled into view.
+				line.m_textBuffer = this->m_freeTextBuffers.back();
+				this->m_freeTextBuffers.pop_back();
+				Renderer2D::updateTextBuffer(line.m_textBuffer, chunk.substr(line.m_offset, line.m_length), this->m_font);
+			}
+		}
+
+		Renderer2D::drawText(this->m_posX, this->m_posY + static_cast<float>(n - firstLine) * lineHeight, this->m_zIndex,
+							 line.m_textBuffer, this->m_textColor);
+	}
+}
+
+void TextView::appendLine(const std::string &text)
+{
+	// Every line break ends a line, the text after the last line break only is a line if it is not empty.
+	size_t start = 0;
+	size_t end;
+	while ((end = text.find('\n', start)) != std::string::npos)
+	{
+		size_t length = end - start;
+		if (length > 0 && text[end - 1] == '\r')
+			length--;
+		this->storeLine(text.substr(start, length));
+		start = end + 1;
+	}
+	if (start < text.size() || text.empty())
+		this->storeLine(text.substr(start));
+
+	if (this->m_followTail)
+	{
+		size_t visibleLines = this->getVisibleLineCount();
+		this->m_scrollLine = this->m_lines.size() > visibleLines ? this->m_lines.size() - visibleLines : 0;
+	}
+	this->markDirty();
+}
+
+void TextView::clear()
+{
+	this->evictLayouts(this->m_cachedFirstLine, this->m_cachedLastLine);
+	this->m_lines.clear();
+	this->m_chunks.clear();
+	this->m_firstChunk = 0;
+	this->m_scrollLine = 0;
+	this->m_cachedFirstLine = 0;
+	this->m_cachedLastLine = 0;
+	this->markDirty();
+}
+
+size_t TextView::getLineCount() const
+{
+	return this->m_lines.size();
+}
+
+std::string TextView::getLine(const size_t index) const
+{
+	if (index >= this->m_lines.size())
+		return std::string();
+
+	const TextViewLine &line = this->m_lines[index];
+	return this->m_chunks[line.m_chunk - this->m_firstChunk].substr(line.m_offset, line.m_length);
+}
+
+size_t TextView::getMaxLines() const
+{
+	return this->m_maxLines;
+}
+
+void TextView::setMaxLines(const size_t maxLines)
+{
+	this->m_maxLines = maxLines;
+	if (maxLines == 0 || this->m_lines.size() <= maxLines)
+		return;
+
+	// Dropping the oldest lines shifts all indices, so the layouts are simply laid out again.
+	this->evictLayouts(this->m_cachedFirstLine, this->m_cachedLastLine);
+	size_t removedLines = this->m_lines.size() - maxLines;
+	this->m_lines.erase(this->m_lines.begin(), this->m_lines.begin() + static_cast<long>(removedLines));
+	while (this->m_firstChunk < this->m_lines.front().m_chunk)
+	{
+		this->m_chunks.pop_front();
+		this->m_firstChunk++;
+	}
+
+	this->m_scrollLine = this->m_scrollLine > removedLines ? this->m_scrollLine - removedLines : 0;
+	this->m_cachedFirstLine = 0;
+	this->m_cachedLastLine = 0;
+	this->markDirty();
+}
+
+size_t TextView::getVisibleLineCount() const
+{
+	unsigned int lineHeight = this->m_font->getSize();
+	if (lineHeight == 0 || this->m_height <= 0.0f)
+		return 0;
+
+	return static_cast<size_t>(this->m_height / static_cast<float>(lineHeight));
+}
+
+size_t TextView::getScrollLine() const
+{
+	return this->m_scrollLine;
+}
+
+void TextView::setScrollLine(const size_t line)
+{
+	size_t visibleLines = this->getVisibleLineCount();
+	size_t lastScrollLine = this->m_lines.size() > visibleLines ? this->m_lines.size() - visibleLines : 0;
+	this->m_scrollLine = std::min(line, lastScrollLine);
+	this->m_followTail = this->m_scrollLine == lastScrollLine;
+	this->markDirty();
+}
+
+void TextView::scrollBy(const long lines)
+{
+	if (lines < 0)
+		this->setScrollLine(this->m_scrollLine > static_cast<size_t>(-lines) ? this->m_scrollLine - static_cast<size_t>(-lines) : 0);
+	else
+		this->setScrollLine(this->m_scrollLine + static_cast<size_t>(lines));
+}
+
+bool TextView::isFollowingTail() const
+{
+	return this->m_followTail;
+}
+
+void TextView::setFollowTail(const bool followTail)
+{
+	this->m_followTail = followTail;
+	if (followTail)
+		this->setScrollLine(this->m_lines.size());
+}
+
+std::shared_ptr<Font> TextView::getFont() const
+{
+	return this->m_font;
+}
+
+void TextView::setFont(const std::shared_ptr<Font> &newFont)
+{
+	if (!newFont)
+		throw ElementUpdateException("Could not set font of text view. The new font can't be a nullptr!");
+
+	this->evictLayouts(this->m_cachedFirstLine, this->m_cachedLastLine);
+	this->m_cachedFirstLine = 0;
+	this->m_cachedLastLine = 0;
+	this->m_font = newFont;
+	this->markDirty();
+}
+
+void TextView::setTextColor(const Vector4f &color)
+{
+	this->m_textColor = color;
+	this->markDirty();
+}
+
+TweenTarget TextView::getTweenTarget(const unsigned int property)
+{
+	switch (property)
+	{
+		case CEDAR_TWEEN_COLOR_RED:
+			return {&this->m_textColor.x, nullptr, false};
+
+		case CEDAR_TWEEN_COLOR_GREEN:
+			return {&this->m_textColor.y, nullptr, false};
+
+		case CEDAR_TWEEN_COLOR_BLUE:
+			return {&this->m_textColor.z, nullptr, false};
+
+		case CEDAR_TWEEN_COLOR_ALPHA:
+			return {&this->m_textColor.w, nullptr, false};
+
+		default:
+			return Element::getTweenTarget(property);
+	}
+}
@@ -0,0 +1,346 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include "cedar/BMFConverter.hpp"
+#include "cedar/Cedar.hpp"
+#include "cedar/Math.hpp"
+
+using namespace cedar;
+
+/**
+ * Quantizes the given value to a normalized 16 bit signed integer.
+ *
+ * @param value The value in the range [-1, 1].
+ * @return The quantized value.
+ */
+short toSnorm16(const float value)
+{
+	return static_cast<short>(std::lround(clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+/**
+ * Quantizes the given value to a normalized 16 bit unsigned integer.
+ *
+ * @param value The value in the range [0, 1].
+ * @return The quantized value.
+ */
+unsigned short toUnorm16(const float value)
+{
+	return static_cast<unsigned short>(std::lround(clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+/**
+ * Quantizes the given value to a normalized 8 bit unsigned integer.
+ *
+ * @param value The value in the range [0, 1].
+ * @return The quantized value.
+ */
+unsigned char toUnorm8(const float value)
+{
+	return static_cast<unsigned char>(std::lround(clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+ModelConversionException::ModelConversionException(const std::string &message) : ModelException(message)
+{}
+
+BMFConverter::BMFConverter() = default;
+
+std::vector<unsigned char> BMFConverter::convert(const unsigned char *data, const size_t dataSize, const unsigned int optimizationFlags)
+{
+	if (dataSize >= 4 && std::memcmp(data, CEDAR_BMF_V2_MAGIC, 4) == 0)
+		throw ModelConversionException("Could not convert model. The model is already a version 2 bmf model!");
+
+	if (dataSize < CEDAR_BMF_V1_HEADER_SIZE)
+		throw ModelConversionException("Could not convert model. The data is too small to be a bmf model!");
+
+	unsigned char mode = data[0];
+	unsigned char bitMask = data[1];
+	unsigned int vertexCount;
+	unsigned int indexCount;
+	std::memcpy(&vertexCount, data + 2, 4);
+	std::memcpy(&indexCount, data + 6, 4);
+
+	unsigned int vertexSize = 12;
+	unsigned int outVertexSize = 8;
+	if (bitMask & CEDAR_BMF_UVS)
+	{
+		vertexSize += 8;
+		outVertexSize += 4;
+	}
+	if (bitMask & CEDAR_BMF_NORMALS)
+	{
+		vertexSize += 12;
+		outVertexSize += 4;
+	}
+	if (bitMask & CEDAR_BMF_COLOR)
+	{
+		vertexSize += 12;
+		outVertexSize += 4;
+	}
+	if (bitMask & CEDAR_BMF_ALPHA)
+	{
+		vertexSize += 12;
+		outVertexSize += 4;
+	}
+	if (bitMask & CEDAR_BMF_STENCIL)
+	{
+		vertexSize += 1;
+		outVertexSize += 4;
+	}
+	if (bitMask & CEDAR_BMF_DISPLACEMENT)
+	{
+		vertexSize += 4;
+		outVertexSize += 4;
+	}
+
+	size_t vertexDataSize = static_cast<size_t>(vertexCount) * vertexSize;
+	size_t indexDataSize = static_cast<size_t>(indexCount) * 4;
+	if (dataSize < CEDAR_BMF_V1_HEADER_SIZE + vertexDataSize + indexDataSize)
+	{
+		std::string message = "Could not convert model. The data is either corrupted or is not a bmf model! ";
+		message.append("Read vertex count: ");
+		message.append(std::to_string(vertexCount));
+		message.append(". Read index count: ");
+		message.append(std::to_string(indexCount));
+		message.append(".");
+		throw ModelConversionException(message);
+	}
+
+	const unsigned char *vertexData = data + CEDAR_BMF_V1_HEADER_SIZE;
+	const unsigned char *indexData = vertexData + vertexDataSize;
+
+	for (unsigned int i = 0; i < indexCount; i++)
+	{
+		unsigned int index;
+		std::memcpy(&index, indexData + static_cast<size_t>(i) * 4, 4);
+		if (index >= vertexCount)
+		{
+			std::string message = "Could not convert model. Index ";
+			message.append(std::to_string(i));
+			message.append(" references vertex ");
+			message.append(std::to_string(index));
+			message.append(" but the model only has ");
+			message.append(std::to_string(vertexCount));
+			message.append(" vertices!");
+			throw ModelConversionException(message);
+		}
+	}
+
+	// The optimizer works in place, so it gets a copy of the vertices and indices.
+	std::vector<unsigned char> optimizedVertexData;
+	std::vector<unsigned int> optimizedIndexData;
+	if (mode == 0x02 && optimizationFlags != 0) // triangles
+	{
+		optimizedVertexData.assign(vertexData, vertexData + vertexDataSize);
+		optimizedIndexData.resize(indexCount);
+		std::memcpy(optimizedIndexData.data(), indexData, indexDataSize);
+
+		std::vector<float> positions(static_cast<size_t>(vertexCount) * 3);
+		for (unsigned int v = 0; v < vertexCount; v++)
+			std::memcpy(positions.data() + static_cast<size_t>(v) * 3, vertexData + static_cast<size_t>(v) * vertexSize, 12);
+
+		MeshOptimizationReport report = MeshOptimizer::optimize(optimizedVertexData.data(), &vertexCount, vertexSize,
+																optimizedIndexData.data(), indexCount, positions.data(),
+																optimizationFlags);
+		Cedar::getCoreLogger()->info("Optimized bmf model. ACMR: %.3f -> %.3f, ATVR: %.3f -> %.3f.",
+									 report.m_before.m_acmr, report.m_after.m_acmr, report.m_before.m_atvr, report.m_after.m_atvr);
+
+		vertexData = optimizedVertexData.data();
+		indexData = reinterpret_cast<const unsigned char *>(optimizedIndexData.data());
+	}
+
+	// The positions are quantized relative to the center of the bounding box of the mesh.
+	float min[3] = {0.0f, 0.0f, 0.0f};
+	float max[3] = {0.0f, 0.0f, 0.0f};
+	for (unsigned int v = 0; v < vertexCount; v++)
+	{
+		float position[3];
+		std::memcpy(position, vertexData + static_cast<size_t>(v) * vertexSize, 12);
+		for (int c = 0; c < 3; c++)
+		{
+			if (v == 0 || position[c] < min[c])
+				min[c] = position[c];
+			if (v == 0 || position[c] > max[c])
+				max[c] = position[c];
+		}
+	}
+
+	float offset[3];
+	float scale[3];
+	for (int c = 0; c < 3; c++)
+	{
+		offset[c] = (min[c] + max[c]) * 0.5f;
+		scale[c] = (max[c] - min[c]) * 0.5f;
+	}
+
+	unsigned char indexSize = vertexCount <= 65536 ? 2 : 4;
+	std::vector<unsigned char> result(CEDAR_BMF_V2_HEADER_SIZE + static_cast<size_t>(vertexCount) * outVertexSize +
+									  static_cast<size_t>(indexCount) * indexSize, 0);
+
+	unsigned char *out = result.data();
+	std::memcpy(out, CEDAR_BMF_V2_MAGIC, 4);
+	out[4] = mode;
+	out[5] = bitMask;
+	out[6] = indexSize;
+	out[7] = 0;
+	std::memcpy(out + 8, &vertexCount, 4);
+	std::memcpy(out + 12, &indexCount, 4);
+	std::memcpy(out + 16, offset, 12);
+	std::memcpy(out + 28, scale, 12);
+	out += CEDAR_BMF_V2_HEADER_SIZE;
+
+	for (unsigned int v = 0; v < vertexCount; v++)
+	{
+		const unsigned char *in = vertexData + static_cast<size_t>(v) * vertexSize;
+
+		float position[3];
+		std::memcpy(position, in, 12);
+		in += 12;
+		short quantizedPosition[4];
+		for (int c = 0; c < 3; c++)
+			quantizedPosition[c] = scale[c] > 0.0f ? toSnorm16((position[c] - offset[c]) / scale[c]) : 0;
+		quantizedPosition[3] = 0;
+		std::memcpy(out, quantizedPosition, 8);
+		out += 8;
+
+		if (bitMask & CEDAR_BMF_UVS)
+		{
+			float uv[2];
+			std::memcpy(uv, in, 8);
+			in += 8;
+			for (float component : uv)
+			{
+				// Allow for a small rounding error of the exporter.
+				if (component < -0.0001f || component > 1.0001f)
+				{
+					std::string message = "Could not convert model. The uvs of vertex ";
+					message.append(std::to_string(v));
+					message.append(" are outside the range [0, 1] and can not be stored as normalized integers!");
+					throw ModelConversionException(message);
+				}
+			}
+			unsigned short quantizedUv[2] = {toUnorm16(uv[0]), toUnorm16(uv[1])};
+			std::memcpy(out, quantizedUv, 4);
+			out += 4;
+		}
+
+		if (bitMask & CEDAR_BMF_NORMALS)
+		{
+			float normal[3];
+			std::memcpy(normal, in, 12);
+			in += 12;
+
+			// Octahedral encoding: project onto the octahedron and fold the lower hemisphere over the diagonals.
+			float length = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+			float x = length > 0.0f ? normal[0] / length : 0.0f;
+			float y = length > 0.0f ? normal[1] / length : 0.0f;
+			if (normal[2] < 0.0f)
+			{
+				float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+				float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+				x = foldedX;
+				y = foldedY;
+			}
+			short quantizedNormal[2] = {toSnorm16(x), toSnorm16(y)};
+			std::memcpy(out, quantizedNormal, 4);
+			out += 4;
+		}
+
+		if (bitMask & CEDAR_BMF_COLOR)
+		{
+			float color[3];
+			std::memcpy(color, in, 12);
+			in += 12;
+			out[0] = toUnorm8(color[0]);
+			out[1] = toUnorm8(color[1]);
+			out[2] = toUnorm8(color[2]);
+			out[3] = 255;
+			out += 4;
+		}
+
+		if (bitMask & CEDAR_BMF_ALPHA)
+		{
+			float alpha[3];
+			std::memcpy(alpha, in, 12);
+			in += 12;
+			out[0] = toUnorm8(alpha[0]);
+			out[1] = toUnorm8(alpha[1]);
+			out[2] = toUnorm8(alpha[2]);
+			out[3] = 255;
+			out += 4;
+		}
+
+		if (bitMask & CEDAR_BMF_STENCIL)
+		{
+			out[0] = in[0];
+			in += 1;
+			out += 4;
+		}
+
+		if (bitMask & CEDAR_BMF_DISPLACEMENT)
+		{
+			std::memcpy(out, in, 4);
+			out += 4;
+		}
+	}
+
+	for (unsigned int i = 0; i < indexCount; i++)
+	{
+		unsigned int index;
+		std::memcpy(&index, indexData + static_cast<size_t>(i) * 4, 4);
+
+		if (indexSize == 2)
+		{
+			auto shortIndex = static_cast<unsigned short>(index);
+			std::memcpy(out, &shortIndex, 2);
+			out += 2;
+		}
+		else
+		{
+			std::memcpy(out, &index, 4);
+			out += 4;
+		}
+	}
+
+	return result;
+}
+
+void BMFConverter::convert(const std::string &sourcePath, const std::string &destinationPath, const unsigned int optimizationFlags)
+{
+	std::ifstream sourceFile;
+	sourceFile.open(sourcePath, std::ifstream::binary | std::ifstream::ate);
+	if (!sourceFile.is_open())
+	{
+		std::string message = "Could not convert model. Could not open file \"";
+		message.append(sourcePath);
+		message.append("\"!");
+		throw ModelConversionException(message);
+	}
+
+	size_t fileSize = sourceFile.tellg();
+	sourceFile.seekg(0, std::ios_base::beg);
+
+	std::vector<unsigned char> fileData(fileSize);
+	sourceFile.read(reinterpret_cast<char *>(fileData.data()), static_cast<std::streamsize>(fileSize));
+	sourceFile.close();
+
+	std::vector<unsigned char> convertedData = convert(fileData.data(), fileData.size(), optimizationFlags);
+
+	std::ofstream destinationFile;
+	destinationFile.open(destinationPath, std::ofstream::binary | std::ofstream::trunc);
+	if (!destinationFile.is_open())
+	{
+		std::string message = "Could not convert model. Could not open file \"";
+		message.append(destinationPath);
+		message.append("\" for writing!");
+		throw ModelConversionException(message);
+	}
+
+	destinationFile.write(reinterpret_cast<const char *>(convertedData.data()), static_cast<std::streamsize>(convertedData.size()));
+	destinationFile.close();
+}
@@ -0,0 +1,209 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <cstring>
+
+#include "cedar/DynamicModel.hpp"
+#include "cedar/Cedar.hpp"
+#include "glad/glad.h"
+
+using namespace cedar;
+
+DynamicModel::DynamicModel(const unsigned int drawingMode, const unsigned int vertexAttribCount, const unsigned int vertexSize,
+						   const unsigned int maxVertexCount, const unsigned int maxIndexCount, const unsigned int indexType,
+						   const unsigned int regionCount)
+		: Model(drawingMode, vertexAttribCount)
+{
+	if (vertexSize == 0 || maxVertexCount == 0 || maxIndexCount == 0 || regionCount == 0)
+		throw ModelCreationException("Could not create dynamic model. The vertex size, capacities and region count must be greater than 0!");
+
+	switch (indexType)
+	{
+		case CEDAR_UNSIGNED_INT:
+			this->m_indexSize = 4;
+			break;
+
+		case CEDAR_UNSIGNED_SHORT:
+			this->m_indexSize = 2;
+			break;
+
+		case CEDAR_UNSIGNED_BYTE:
+			this->m_indexSize = 1;
+			break;
+
+		default:
+			throw ModelCreationException("Could not create dynamic model. Index type must be an unsigned data type!");
+	}
+
+	this->m_indexType = indexType;
+	this->m_vertexSize = vertexSize;
+	this->m_maxVertexCount = maxVertexCount;
+	this->m_maxIndexCount = maxIndexCount;
+	this->m_regionCount = regionCount;
+	this->m_writeRegion = regionCount - 1;
+	this->m_renderRegion = 0;
+	this->m_updating = false;
+	this->m_fences = std::vector<void *>(regionCount, nullptr);
+
+	GLsizeiptr vertexBufferSize = static_cast<GLsizeiptr>(vertexSize) * maxVertexCount * regionCount;
+	GLsizeiptr indexBufferSize = static_cast<GLsizeiptr>(this->m_indexSize) * maxIndexCount * regionCount;
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	glGenVertexArrays(1, &this->m_vaoId);
+	glBindVertexArray(this->m_vaoId);
+
+	glGenBuffers(2, &this->m_indexVboId);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->m_indexVboId);
+	glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, indexBufferSize, nullptr, flags);
+	this->m_mappedIndices = static_cast<unsigned char *>(glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, indexBufferSize, flags));
+
+	glBindBuffer(GL_ARRAY_BUFFER, this->m_vertexVboId);
+	glBufferStorage(GL_ARRAY_BUFFER, vertexBufferSize, nullptr, flags);
+	this->m_mappedVertices = static_cast<unsigned char *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, vertexBufferSize, flags));
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	if (!this->m_mappedIndices || !this->m_mappedVertices)
+		throw ModelCreationException("Could not create dynamic model. The buffers could not be mapped persistently!");
+}
+
+DynamicModel::~DynamicModel()
+{
+	for (void *fence : this->m_fences)
+	{
+		if (fence)
+			glDeleteSync(static_cast<GLsync>(fence));
+	}
+
+	if (this->m_mappedVertices)
+		glUnmapNamedBuffer(this->m_vertexVboId);
+	if (this->m_mappedIndices)
+		glUnmapNamedBuffer(this->m_indexVboId);
+}
+
+void DynamicModel::waitForRegion(const unsigned int region)
+{
+	auto fence = static_cast<GLsync>(this->m_fences[region]);
+	if (!fence)
+		return;
+
+	GLenum result = glClientWaitSync(fence, 0, 0);
+	if (result == GL_TIMEOUT_EXPIRED)
+	{
+		Cedar::getGLLogger()->debug("Dynamic model is waiting for region %u. Consider using more regions.", region);
+		do
+		{
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+		} while (result == GL_TIMEOUT_EXPIRED);
+	}
+
+	glDeleteSync(fence);
+	this->m_fences[region] = nullptr;
+}
+
+void DynamicModel::beginUpdate()
+{
+	if (this->m_updating)
+		throw ModelUpdateException("Could not begin update of dynamic model. An update is already in progress!");
+
+	this->m_writeRegion = (this->m_writeRegion + 1) % this->m_regionCount;
+	this->waitForRegion(this->m_writeRegion);
+	this->m_updating = true;
+}
+
+void DynamicModel::endUpdate(const unsigned int vertexCount, const unsigned int indexCount)
+{
+	if (!this->m_updating)
+		throw ModelUpdateException("Could not end update of dynamic model. No update is in progress!");
+
+	if (vertexCount > this->m_maxVertexCount || indexCount > this->m_maxIndexCount)
+		throw ModelUpdateException("Could not end update of dynamic model. The geometry exceeds the capacity of the model!");
+
+	this->m_renderRegion = this->m_writeRegion;
+	this->m_indexCount = indexCount;
+	this->m_updating = false;
+}
+
+void *DynamicModel::getVertexPointer() const
+{
+	if (!this->m_updating)
+		return nullptr;
+
+	return this->m_mappedVertices + static_cast<size_t>(this->m_writeRegion) * this->m_maxVertexCount * this->m_vertexSize;
+}
+
+void *DynamicModel::getIndexPointer() const
+{
+	if (!this->m_updating)
+		return nullptr;
+
+	return this->m_mappedIndices + static_cast<size_t>(this->m_writeRegion) * this->m_maxIndexCount * this->m_indexSize;
+}
+
+void DynamicModel::upload(const unsigned int vertexDataSize, const void *vertexData, const unsigned int indexDataSize, const void *indexData,
+						  const unsigned int indexType, const unsigned int narrowestIndexType)
+{
+	if (indexType != this->m_indexType)
+		throw ModelUploadException("Could not upload dynamic model. The index type does not match the index type of the model!");
+
+	if (vertexDataSize > this->m_maxVertexCount * this->m_vertexSize || indexDataSize > this->m_maxIndexCount * this->m_indexSize)
+		throw ModelUploadException("Could not upload dynamic model. The data exceeds the capacity of the model!");
+
+	if (this->m_updating)
+		throw ModelUploadException("Could not upload dynamic model. An update is already in progress!");
+
+	this->beginUpdate();
+	std::memcpy(this->getVertexPointer(), vertexData, vertexDataSize);
+	std::memcpy(this->getIndexPointer(), indexData, indexDataSize);
+	this->endUpdate(vertexDataSize / this->m_vertexSize, indexDataSize / this->m_indexSize);
+}
+
+void DynamicModel::update(const unsigned int offset, const unsigned int vertexDataSize, const void *vertexData)
+{
+	if (!this->m_updating)
+		throw ModelUpdateException("Could not update dynamic model. No update is in progress!");
+
+	if (static_cast<size_t>(offset) + vertexDataSize > static_cast<size_t>(this->m_maxVertexCount) * this->m_vertexSize)
+		throw ModelUpdateException("Could not update dynamic model. The data exceeds the region!");
+
+	std::memcpy(static_cast<unsigned char *>(this->getVertexPointer()) + offset, vertexData, vertexDataSize);
+}
+
+void DynamicModel::render() const
+{
+	if (this->m_indexCount)
+	{
+		glBindVertexArray(this->m_vaoId);
+		for (unsigned int n = 0; n < this->m_vertexAttribCount; n++)
+		{
+			glEnableVertexAttribArray(n);
+		}
+
+		size_t indexOffset = static_cast<size_t>(this->m_renderRegion) * this->m_maxIndexCount * this->m_indexSize;
+		glDrawElementsBaseVertex(this->m_drawingMode, static_cast<int>(this->m_indexCount), this->m_indexType,
+								 reinterpret_cast<const void *>(indexOffset),
+								 static_cast<int>(this->m_renderRegion * this->m_maxVertexCount));
+
+		for (unsigned int n = 0; n < this->m_vertexAttribCount; n++)
+		{
+			glDisableVertexAttribArray(n);
+		}
+
+		// The region may be drawn multiple times, only the last draw has to be waited on.
+		if (this->m_fences[this->m_renderRegion])
+			glDeleteSync(static_cast<GLsync>(this->m_fences[this->m_renderRegion]));
+		this->m_fences[this->m_renderRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+}
+
+unsigned int DynamicModel::getMaxVertexCount() const
+{
+	return this->m_maxVertexCount;
+}
+
+unsigned int DynamicModel::getMaxIndexCount() const
+{
+	return this->m_maxIndexCount;
+}
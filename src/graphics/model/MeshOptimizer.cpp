@@ -0,0 +1,388 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "cedar/MeshOptimizer.hpp"
+
+/**
+ * The size of the lru cache that is used to score the vertices.
+ */
+#define CEDAR_FORSYTH_CACHE_SIZE 32
+/**
+ * The maximum valence for which the valence score is precomputed.
+ */
+#define CEDAR_FORSYTH_MAX_VALENCE 32
+
+using namespace cedar;
+
+/**
+ * Calculates the forsyth score of a vertex.
+ *
+ * @param cachePosition The position of the vertex in the lru cache or <code>-1</code> if it's not inside the cache.
+ * @param remainingValence The number of triangles that weren't emitted yet and use the vertex.
+ * @return The score of the vertex.
+ */
+float forsythVertexScore(const int cachePosition, const unsigned int remainingValence)
+{
+	static float cacheScores[CEDAR_FORSYTH_CACHE_SIZE];
+	static float valenceScores[CEDAR_FORSYTH_MAX_VALENCE];
+	static bool initialized = false;
+	if (!initialized)
+	{
+		for (int position = 0; position < CEDAR_FORSYTH_CACHE_SIZE; position++)
+		{
+			// The vertices of the last triangle get a fixed score, so the algorithm doesn't prefer triangles that
+			// only share an edge with the triangle that was just emitted.
+			if (position < 3)
+				cacheScores[position] = 0.75f;
+			else
+				cacheScores[position] = std::pow(1.0f - static_cast<float>(position - 3) / (CEDAR_FORSYTH_CACHE_SIZE - 3), 1.5f);
+		}
+
+		for (int valence = 1; valence < CEDAR_FORSYTH_MAX_VALENCE; valence++)
+			valenceScores[valence] = 2.0f / std::sqrt(static_cast<float>(valence));
+		valenceScores[0] = 0.0f;
+
+		initialized = true;
+	}
+
+	if (remainingValence == 0)
+		return -1.0f;
+
+	float score = cachePosition >= 0 ? cacheScores[cachePosition] : 0.0f;
+	score += remainingValence < CEDAR_FORSYTH_MAX_VALENCE ? valenceScores[remainingValence]
+														  : 2.0f / std::sqrt(static_cast<float>(remainingValence));
+	return score;
+}
+
+MeshOptimizer::MeshOptimizer() = default;
+
+void MeshOptimizer::optimizeVertexCache(unsigned int *indices, const size_t indexCount, const unsigned int vertexCount)
+{
+	size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return;
+
+	// Build the vertex to triangle adjacency.
+	std::vector<unsigned int> remainingValence(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; i++)
+		remainingValence[indices[i]]++;
+
+	std::vector<size_t> adjacencyOffsets(vertexCount + 1, 0);
+	for (unsigned int v = 0; v < vertexCount; v++)
+		adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remainingValence[v];
+
+	std::vector<unsigned int> adjacency(triangleCount * 3);
+	std::vector<unsigned int> fillCount(vertexCount, 0);
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			unsigned int vertex = indices[t * 3 + c];
+			adjacency[adjacencyOffsets[vertex] + fillCount[vertex]++] = static_cast<unsigned int>(t);
+		}
+	}
+
+	std::vector<float> vertexScores(vertexCount);
+	for (unsigned int v = 0; v < vertexCount; v++)
+		vertexScores[v] = forsythVertexScore(-1, remainingValence[v]);
+
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	size_t bestTriangle = 0;
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+		if (triangleScores[t] > triangleScores[bestTriangle])
+			bestTriangle = t;
+	}
+
+	std::vector<unsigned int> result(triangleCount * 3);
+	unsigned int cache[CEDAR_FORSYTH_CACHE_SIZE + 3];
+	unsigned int newCache[CEDAR_FORSYTH_CACHE_SIZE + 3];
+	unsigned int cacheCount = 0;
+	size_t fallbackCursor = 0;
+
+	for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+	{
+		if (bestTriangle == SIZE_MAX)
+		{
+			// Dead end, none of the cached vertices has a triangle left. Continue with the next triangle in input order.
+			while (emitted[fallbackCursor])
+				fallbackCursor++;
+			bestTriangle = fallbackCursor;
+		}
+
+		const unsigned int *triangle = indices + bestTriangle * 3;
+		std::memcpy(result.data() + emittedCount * 3, triangle, 3 * sizeof(unsigned int));
+		emitted[bestTriangle] = true;
+
+		// Remove the triangle from the adjacency of its vertices and put them in front of the cache.
+		unsigned int newCacheCount = 0;
+		for (int c = 0; c < 3; c++)
+		{
+			unsigned int vertex = triangle[c];
+			unsigned int *begin = adjacency.data() + adjacencyOffsets[vertex];
+			unsigned int *end = begin + remainingValence[vertex];
+			unsigned int *it = std::find(begin, end, static_cast<unsigned int>(bestTriangle));
+			std::swap(*it, *(end - 1));
+			remainingValence[vertex]--;
+
+			newCache[newCacheCount++] = vertex;
+		}
+
+		for (unsigned int i = 0; i < cacheCount; i++)
+		{
+			unsigned int vertex = cache[i];
+			if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+				newCache[newCacheCount++] = vertex;
+		}
+
+		// Vertices beyond the scoring cache size have been evicted and are only kept to update their scores.
+		for (unsigned int i = 0; i < newCacheCount; i++)
+		{
+			unsigned int vertex = newCache[i];
+			int position = i < CEDAR_FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+
+			float newScore = forsythVertexScore(position, remainingValence[vertex]);
+			float delta = newScore - vertexScores[vertex];
+			vertexScores[vertex] = newScore;
+
+			const unsigned int *adjacent = adjacency.data() + adjacencyOffsets[vertex];
+			for (unsigned int a = 0; a < remainingValence[vertex]; a++)
+				triangleScores[adjacent[a]] += delta;
+		}
+
+		cacheCount = std::min(newCacheCount, static_cast<unsigned int>(CEDAR_FORSYTH_CACHE_SIZE));
+		std::memcpy(cache, newCache, cacheCount * sizeof(unsigned int));
+
+		// Only triangles of cached vertices had their score changed, so the next best triangle is one of those.
+		bestTriangle = SIZE_MAX;
+		float bestScore = -1.0f;
+		for (unsigned int i = 0; i < cacheCount; i++)
+		{
+			unsigned int vertex = cache[i];
+			const unsigned int *adjacent = adjacency.data() + adjacencyOffsets[vertex];
+			for (unsigned int a = 0; a < remainingValence[vertex]; a++)
+			{
+				if (triangleScores[adjacent[a]] > bestScore)
+				{
+					bestScore = triangleScores[adjacent[a]];
+					bestTriangle = adjacent[a];
+				}
+			}
+		}
+	}
+
+	std::memcpy(indices, result.data(), result.size() * sizeof(unsigned int));
+}
+
+void MeshOptimizer::optimizeOverdraw(unsigned int *indices, const size_t indexCount, const float *positions, const unsigned int vertexCount,
+									 const float threshold)
+{
+	size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return;
+
+	float meshAcmr = analyzeVertexCache(indices, indexCount, vertexCount).m_acmr;
+
+	// Split the triangles into clusters at points where the cache would be flushed anyway or where the cluster is
+	// already good enough.
+	std::vector<size_t> clusterStarts;
+	clusterStarts.push_back(0);
+
+	std::vector<unsigned int> cacheTimestamps(vertexCount, 0);
+	unsigned int time = CEDAR_MESH_SIMULATED_CACHE_SIZE + 1;
+	unsigned int clusterMisses = 0;
+	unsigned int clusterTriangles = 0;
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		unsigned int misses = 0;
+		for (int c = 0; c < 3; c++)
+		{
+			unsigned int vertex = indices[t * 3 + c];
+			if (time - cacheTimestamps[vertex] > CEDAR_MESH_SIMULATED_CACHE_SIZE)
+			{
+				cacheTimestamps[vertex] = time++;
+				misses++;
+			}
+		}
+
+		if (misses == 3 && clusterTriangles > 0)
+		{
+			clusterStarts.push_back(t);
+			clusterMisses = 0;
+			clusterTriangles = 0;
+		}
+
+		clusterMisses += misses;
+		clusterTriangles++;
+
+		if (t + 1 < triangleCount && static_cast<float>(clusterMisses) <= threshold * meshAcmr * static_cast<float>(clusterTriangles))
+		{
+			clusterStarts.push_back(t + 1);
+			clusterMisses = 0;
+			clusterTriangles = 0;
+		}
+	}
+	clusterStarts.push_back(triangleCount);
+
+	size_t clusterCount = clusterStarts.size() - 1;
+	if (clusterCount < 2)
+		return;
+
+	// Calculate the area weighted centroid and normal of every cluster and the whole mesh.
+	std::vector<float> clusterData(clusterCount * 6, 0.0f);
+	float meshCentroid[3] = {0.0f, 0.0f, 0.0f};
+	float meshArea = 0.0f;
+	for (size_t cluster = 0; cluster < clusterCount; cluster++)
+	{
+		float *centroid = clusterData.data() + cluster * 6;
+		float *normal = centroid + 3;
+		float clusterArea = 0.0f;
+
+		for (size_t t = clusterStarts[cluster]; t < clusterStarts[cluster + 1]; t++)
+		{
+			const float *p0 = positions + static_cast<size_t>(indices[t * 3]) * 3;
+			const float *p1 = positions + static_cast<size_t>(indices[t * 3 + 1]) * 3;
+			const float *p2 = positions + static_cast<size_t>(indices[t * 3 + 2]) * 3;
+
+			float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+			float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+			float cross[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+			float area = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+
+			for (int c = 0; c < 3; c++)
+			{
+				centroid[c] += (p0[c] + p1[c] + p2[c]) * (area / 3.0f);
+				normal[c] += cross[c];
+				meshCentroid[c] += (p0[c] + p1[c] + p2[c]) * (area / 3.0f);
+			}
+			clusterArea += area;
+		}
+
+		if (clusterArea > 0.0f)
+		{
+			for (int c = 0; c < 3; c++)
+				centroid[c] /= clusterArea;
+		}
+		meshArea += clusterArea;
+	}
+
+	if (meshArea > 0.0f)
+	{
+		for (float &component : meshCentroid)
+			component /= meshArea;
+	}
+
+	// Clusters that face away from the center are drawn first, since they are the most likely occluders.
+	std::vector<float> sortKeys(clusterCount);
+	for (size_t cluster = 0; cluster < clusterCount; cluster++)
+	{
+		const float *centroid = clusterData.data() + cluster * 6;
+		const float *normal = centroid + 3;
+		float normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		float dot = 0.0f;
+		for (int c = 0; c < 3; c++)
+			dot += (centroid[c] - meshCentroid[c]) * normal[c];
+		sortKeys[cluster] = normalLength > 0.0f ? dot / normalLength : 0.0f;
+	}
+
+	std::vector<size_t> clusterOrder(clusterCount);
+	for (size_t cluster = 0; cluster < clusterCount; cluster++)
+		clusterOrder[cluster] = cluster;
+	std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&sortKeys](size_t lhs, size_t rhs) {
+		return sortKeys[lhs] > sortKeys[rhs];
+	});
+
+	std::vector<unsigned int> result;
+	result.reserve(triangleCount * 3);
+	for (size_t cluster : clusterOrder)
+		result.insert(result.end(), indices + clusterStarts[cluster] * 3, indices + clusterStarts[cluster + 1] * 3);
+
+	std::memcpy(indices, result.data(), result.size() * sizeof(unsigned int));
+}
+
+unsigned int MeshOptimizer::optimizeVertexFetch(unsigned char *vertexData, const unsigned int vertexCount, const unsigned int vertexSize,
+												unsigned int *indices, const size_t indexCount)
+{
+	std::vector<unsigned int> remap(vertexCount, UINT_MAX);
+	std::vector<unsigned char> result(static_cast<size_t>(vertexCount) * vertexSize);
+	unsigned int newVertexCount = 0;
+
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		unsigned int vertex = indices[i];
+		if (remap[vertex] == UINT_MAX)
+		{
+			std::memcpy(result.data() + static_cast<size_t>(newVertexCount) * vertexSize,
+						vertexData + static_cast<size_t>(vertex) * vertexSize, vertexSize);
+			remap[vertex] = newVertexCount++;
+		}
+		indices[i] = remap[vertex];
+	}
+
+	std::memcpy(vertexData, result.data(), static_cast<size_t>(newVertexCount) * vertexSize);
+	return newVertexCount;
+}
+
+VertexCacheStatistics MeshOptimizer::analyzeVertexCache(const unsigned int *indices, const size_t indexCount, const unsigned int vertexCount,
+														const unsigned int cacheSize)
+{
+	VertexCacheStatistics statistics = {0, 0.0f, 0.0f};
+	size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return statistics;
+
+	// A vertex is inside the fifo cache if less than cacheSize vertices were inserted after it.
+	std::vector<unsigned int> cacheTimestamps(vertexCount, 0);
+	std::vector<bool> referenced(vertexCount, false);
+	unsigned int time = cacheSize + 1;
+	unsigned int referencedVertices = 0;
+
+	for (size_t i = 0; i < triangleCount * 3; i++)
+	{
+		unsigned int vertex = indices[i];
+		if (time - cacheTimestamps[vertex] > cacheSize)
+		{
+			cacheTimestamps[vertex] = time++;
+			statistics.m_transformedVertices++;
+		}
+
+		if (!referenced[vertex])
+		{
+			referenced[vertex] = true;
+			referencedVertices++;
+		}
+	}
+
+	statistics.m_acmr = static_cast<float>(statistics.m_transformedVertices) / static_cast<float>(triangleCount);
+	statistics.m_atvr = static_cast<float>(statistics.m_transformedVertices) / static_cast<float>(referencedVertices);
+	return statistics;
+}
+
+MeshOptimizationReport MeshOptimizer::optimize(unsigned char *vertexData, unsigned int *vertexCount, const unsigned int vertexSize,
+											   unsigned int *indices, const size_t indexCount, const float *positions, const unsigned int flags)
+{
+	MeshOptimizationReport report{};
+	report.m_before = analyzeVertexCache(indices, indexCount, *vertexCount);
+
+	if (flags & CEDAR_MESH_OPTIMIZE_VERTEX_CACHE)
+		optimizeVertexCache(indices, indexCount, *vertexCount);
+
+	if ((flags & CEDAR_MESH_OPTIMIZE_OVERDRAW) && positions != nullptr)
+		optimizeOverdraw(indices, indexCount, positions, *vertexCount);
+
+	if (flags & CEDAR_MESH_OPTIMIZE_VERTEX_FETCH)
+		*vertexCount = optimizeVertexFetch(vertexData, *vertexCount, vertexSize, indices, indexCount);
+
+	report.m_after = analyzeVertexCache(indices, indexCount, *vertexCount);
+	return report;
+}
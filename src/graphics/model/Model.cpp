@@ -2,11 +2,107 @@
 // Created by masy on 02.03.20.
 //
 
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "cedar/Model.hpp"
 #include "glad/glad.h"
 
 using namespace cedar;
 
+/**
+ * Gets the bitwise or of all the given indices.
+ *
+ * <p>The result is smaller than 2^n if and only if all indices are smaller than 2^n.</p>
+ *
+ * @tparam T The data type of the indices.
+ * @param indices A pointer to the indices.
+ * @param count The number of indices.
+ * @return The bitwise or of all indices.
+ */
+template<typename T>
+unsigned int orIndices(const unsigned char *indices, const size_t count)
+{
+	unsigned int result = 0;
+	size_t i = 0;
+#if defined(__SSE2__)
+	__m128i accumulator = _mm_setzero_si128();
+	const size_t perVector = 16 / sizeof(T);
+	for (; i + perVector <= count; i += perVector)
+		accumulator = _mm_or_si128(accumulator, _mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i * sizeof(T))));
+
+	unsigned int lanes[4];
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), accumulator);
+	result = lanes[0] | lanes[1] | lanes[2] | lanes[3];
+	if (sizeof(T) == 2)
+		result = (result | (result >> 16u)) & 0xFFFFu;
+#endif
+	for (; i < count; i++)
+	{
+		T index;
+		std::memcpy(&index, indices + i * sizeof(T), sizeof(T));
+		result |= index;
+	}
+	return result;
+}
+
+/**
+ * Repacks 32 bit indices which are all smaller than 65536 to 16 bit indices.
+ *
+ * @param indices A pointer to the 32 bit indices.
+ * @param count The number of indices.
+ * @param result A pointer to where the 16 bit indices will be stored.
+ */
+void narrowIndicesTo16(const unsigned char *indices, const size_t count, unsigned short *result)
+{
+	size_t i = 0;
+#if defined(__SSE2__)
+	// There is no unsigned saturating 32 to 16 bit pack in SSE2, so the indices are shifted into the signed range,
+	// packed with signed saturation and shifted back.
+	const __m128i bias32 = _mm_set1_epi32(0x8000);
+	const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i low = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i * 4)), bias32);
+		__m128i high = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i * 4 + 16)), bias32);
+		__m128i packed = _mm_xor_si128(_mm_packs_epi32(low, high), bias16);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(result + i), packed);
+	}
+#endif
+	for (; i < count; i++)
+	{
+		unsigned int index;
+		std::memcpy(&index, indices + i * 4, 4);
+		result[i] = static_cast<unsigned short>(index);
+	}
+}
+
+/**
+ * Repacks 16 bit indices which are all smaller than 256 to 8 bit indices.
+ *
+ * @param indices A pointer to the 16 bit indices.
+ * @param count The number of indices.
+ * @param result A pointer to where the 8 bit indices will be stored.
+ */
+void narrowIndicesTo8(const unsigned short *indices, const size_t count, unsigned char *result)
+{
+	size_t i = 0;
+#if defined(__SSE2__)
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i));
+		__m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i + 8));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(result + i), _mm_packus_epi16(low, high));
+	}
+#endif
+	for (; i < count; i++)
+		result[i] = static_cast<unsigned char>(indices[i]);
+}
+
 ModelException::ModelException(const std::string &message) : XException(message)
 {}
 
@@ -36,6 +132,8 @@ Model::Model(const unsigned int drawingMode, const unsigned int vertexAttribCoun
 	this->m_indexCount = 0;
 	this->m_indexType = CEDAR_UNSIGNED_INT;
 	this->m_vertexAttribCount = vertexAttribCount;
+	this->m_positionOffset = Vector3f(0.0f, 0.0f, 0.0f);
+	this->m_positionScale = Vector3f(1.0f, 1.0f, 1.0f);
 }
 
 Model::~Model()
@@ -44,8 +142,8 @@ Model::~Model()
 	glDeleteVertexArrays(1, &this->m_vaoId);
 }
 
-void Model::upload(const unsigned int vertexDataSize, const void *vertexData, const unsigned int indexDataSize, const void *indexData,
-				   const unsigned int indexType)
+void Model::upload(const unsigned int vertexDataSize, const void *vertexData, unsigned int indexDataSize, const void *indexData,
+				   unsigned int indexType, const unsigned int narrowestIndexType)
 {
 	switch (indexType)
 	{
@@ -64,6 +162,37 @@ void Model::upload(const unsigned int vertexDataSize, const void *vertexData, co
 		default:
 			throw ModelUploadException("Could not bake model. Index type must be an unsigned data type!");
 	}
+
+	if (narrowestIndexType != CEDAR_UNSIGNED_INT && narrowestIndexType != CEDAR_UNSIGNED_SHORT && narrowestIndexType != CEDAR_UNSIGNED_BYTE)
+		throw ModelUploadException("Could not bake model. Narrowest index type must be an unsigned data type!");
+
+	// Repack the indices to the narrowest type that can hold the largest index.
+	std::vector<unsigned short> shortIndices;
+	std::vector<unsigned char> byteIndices;
+	const auto *indexBytes = static_cast<const unsigned char *>(indexData);
+	if (indexType == CEDAR_UNSIGNED_INT && narrowestIndexType != CEDAR_UNSIGNED_INT && orIndices<unsigned int>(indexBytes, this->m_indexCount) < 0x10000u)
+	{
+		shortIndices.resize(this->m_indexCount);
+		narrowIndicesTo16(indexBytes, this->m_indexCount, shortIndices.data());
+		indexData = shortIndices.data();
+		indexDataSize = this->m_indexCount * 2;
+		indexType = CEDAR_UNSIGNED_SHORT;
+	}
+
+	if (indexType == CEDAR_UNSIGNED_SHORT && narrowestIndexType == CEDAR_UNSIGNED_BYTE &&
+		orIndices<unsigned short>(static_cast<const unsigned char *>(indexData), this->m_indexCount) < 0x100u)
+	{
+		if (shortIndices.empty())
+		{
+			shortIndices.resize(this->m_indexCount);
+			std::memcpy(shortIndices.data(), indexData, this->m_indexCount * 2);
+		}
+		byteIndices.resize(this->m_indexCount);
+		narrowIndicesTo8(shortIndices.data(), this->m_indexCount, byteIndices.data());
+		indexData = byteIndices.data();
+		indexDataSize = this->m_indexCount;
+		indexType = CEDAR_UNSIGNED_BYTE;
+	}
 	this->m_indexType = indexType;
 
 	if (this->m_vaoId == 0)
@@ -116,6 +245,43 @@ void Model::render() const
 	}
 }
 
+void Model::setVertexAttribPointer(const unsigned int index, const int size, const unsigned int type, const bool normalized,
+								   const unsigned int stride, const unsigned int offset)
+{
+	if (this->m_vaoId == 0 || this->m_vertexVboId == 0)
+		throw ModelUpdateException("Could not set vertex attribute pointer. The model is not initialized yet!");
+
+	if (index >= this->m_vertexAttribCount)
+		throw ModelUpdateException("Could not set vertex attribute pointer. The index exceeds the vertex attribute count of the model!");
+
+	glBindVertexArray(this->m_vaoId);
+	glBindBuffer(GL_ARRAY_BUFFER, this->m_vertexVboId);
+	glVertexAttribPointer(index, size, type, normalized, static_cast<int>(stride), reinterpret_cast<const void *>(static_cast<size_t>(offset)));
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+void Model::setVertexAttribIPointer(const unsigned int index, const int size, const unsigned int type, const unsigned int stride,
+									const unsigned int offset)
+{
+	if (this->m_vaoId == 0 || this->m_vertexVboId == 0)
+		throw ModelUpdateException("Could not set vertex attribute pointer. The model is not initialized yet!");
+
+	if (index >= this->m_vertexAttribCount)
+		throw ModelUpdateException("Could not set vertex attribute pointer. The index exceeds the vertex attribute count of the model!");
+
+	glBindVertexArray(this->m_vaoId);
+	glBindBuffer(GL_ARRAY_BUFFER, this->m_vertexVboId);
+	glVertexAttribIPointer(index, size, type, static_cast<int>(stride), reinterpret_cast<const void *>(static_cast<size_t>(offset)));
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+unsigned int Model::getIndexType() const
+{
+	return this->m_indexType;
+}
+
 unsigned int Model::getVertexArrayId() const
 {
 	return this->m_vaoId;
@@ -142,6 +308,22 @@ void Model::setVertexAttribCount(unsigned int newVertexAttribCount) {
 	this->m_vertexAttribCount = newVertexAttribCount;
 }
 
+Vector3f Model::getPositionOffset() const
+{
+	return this->m_positionOffset;
+}
+
+Vector3f Model::getPositionScale() const
+{
+	return this->m_positionScale;
+}
+
+void Model::setPositionQuantization(const Vector3f &offset, const Vector3f &scale)
+{
+	this->m_positionOffset = offset;
+	this->m_positionScale = scale;
+}
+
 bool Model::operator==(const Model &rhs) {
 	return this->m_vaoId == rhs.m_vaoId;
 }
@@ -2,10 +2,14 @@
 // Created by masy on 02.03.20.
 //
 
+#include <cstring>
 #include <fstream>
+#include <vector>
 
 #include "cedar/ModelRegistry.hpp"
+#include "cedar/AssetPack.hpp"
 #include "cedar/Cedar.hpp"
+#include "cedar/MeshOptimizer.hpp"
 
 using namespace cedar;
 
@@ -29,99 +33,141 @@ bool ModelRegistry::registerModel(const std::string &name, Model *model)
 	return true;
 }
 
-Model *ModelRegistry::loadBMFModel(const std::string &name, const std::string &path, unsigned char *bitMask)
+/**
+ * Description of a vertex attribute of a bmf model.
+ */
+struct BMFAttribute
 {
-	auto it = LOADED_MODELS.find(name);
-	if (it != LOADED_MODELS.end())
-	{
-		std::string message = "Could not load model ";
-		message.append(name);
-		message.append(". A model with that name already exists!");
-		throw ModelLoadException(message);
-	}
+	/**
+	 * The bit of the bit mask that enables the attribute or <code>0</code> if the attribute is always present.
+	 */
+	unsigned int m_bit;
+	/**
+	 * The number of components of the attribute.
+	 */
+	int m_components;
+	/**
+	 * The data type of the attribute in version 1 files.
+	 */
+	unsigned int m_v1Type;
+	/**
+	 * The size of the attribute in bytes in version 1 files.
+	 */
+	unsigned int m_v1Size;
+	/**
+	 * The data type of the attribute in version 2 files.
+	 */
+	unsigned int m_v2Type;
+	/**
+	 * The size of the attribute in bytes in version 2 files.
+	 */
+	unsigned int m_v2Size;
+	/**
+	 * Whether the attribute is read as an integer.
+	 */
+	bool m_integer;
+};
 
-	std::ifstream modelFile;
-	modelFile.open(path, std::ifstream::binary | std::ifstream::ate);
-	if (!modelFile.is_open())
-	{
-		std::string message = "Could not load model ";
-		message.append(name);
-		message.append(". Could not open file \"");
-		message.append(path);
-		message.append("\"!");
-		throw ModelLoadException(message);
-	}
+/**
+ * The vertex attributes of bmf models in the order they are stored in a vertex.
+ *
+ * <p>Version 2 attributes are padded to 4 bytes each.</p>
+ */
+const BMFAttribute BMF_ATTRIBUTES[] = {
+		{0,                      3, CEDAR_FLOAT,         12, CEDAR_SHORT,          8, false}, // position
+		{CEDAR_BMF_UVS,          2, CEDAR_FLOAT,         8,  CEDAR_UNSIGNED_SHORT, 4, false}, // uvs
+		{CEDAR_BMF_NORMALS,      2, CEDAR_FLOAT,         12, CEDAR_SHORT,          4, false}, // normals
+		{CEDAR_BMF_COLOR,        3, CEDAR_FLOAT,         12, CEDAR_UNSIGNED_BYTE,  4, false}, // color
+		{CEDAR_BMF_ALPHA,        3, CEDAR_FLOAT,         12, CEDAR_UNSIGNED_BYTE,  4, false}, // alpha
+		{CEDAR_BMF_STENCIL,      1, CEDAR_UNSIGNED_BYTE, 1,  CEDAR_UNSIGNED_BYTE,  4, true},  // stencil
+		{CEDAR_BMF_DISPLACEMENT, 1, CEDAR_FLOAT,         4,  CEDAR_FLOAT,          4, false}  // displacement
+};
 
-	unsigned int fileSize = modelFile.tellg();
-	modelFile.seekg(0, std::ios_base::beg);
+/**
+ * Creates a model from the given bmf data.
+ *
+ * @param name The name of the model.
+ * @param path The path of the file the data was read from.
+ * @param data A pointer to the content of the bmf file.
+ * @param dataSize The size of the bmf data in bytes.
+ * @param bitMask A pointer to an unsigned char where the bit mask of the bmf model will be stored.
+ * @param optimizationFlags The bit mask of {@link MeshOptimizer} passes that will be run on triangle meshes.
+ * @return A pointer to the created model.
+ *
+ * @throws ModelLoadException when the data is not a valid bmf model.
+ */
+Model *createBMFModel(const std::string &name, const std::string &path, const unsigned char *data, const size_t dataSize, unsigned char *bitMask,
+					  const unsigned int optimizationFlags)
+{
+	bool version2 = dataSize >= CEDAR_BMF_V2_HEADER_SIZE && std::memcmp(data, CEDAR_BMF_V2_MAGIC, 4) == 0;
 
 	unsigned char mode = 0;
-	unsigned int vertexAttribCount = 1;
+	unsigned char indexSize = 4;
 	unsigned int vertexCount = 0;
 	unsigned int indexCount = 0;
+	Vector3f positionOffset(0.0f);
+	Vector3f positionScale(1.0f);
+	unsigned int headerSize;
 
-	modelFile.read(reinterpret_cast<char *>(&mode), 1);
-	modelFile.read(reinterpret_cast<char *>(bitMask), 1);
-	modelFile.read(reinterpret_cast<char *>(&vertexCount), 4);
-	modelFile.read(reinterpret_cast<char *>(&indexCount), 4);
-
-	unsigned int vertexSize = 12;
-
-	if (*bitMask & 0x01u) // uvs
-	{
-		vertexSize += 8;
-		vertexAttribCount++;
-	}
-
-	if ((*bitMask >> 0x01u) & 0x01u) // normals
-	{
-		vertexSize += 12;
-		vertexAttribCount++;
-	}
-
-	if ((*bitMask >> 0x02u) & 0x01u) // color
-	{
-		vertexSize += 12;
-		vertexAttribCount++;
-	}
-
-	if ((*bitMask >> 0x03u) & 0x01u) // alpha
+	if (version2)
 	{
-		vertexSize += 12;
-		vertexAttribCount++;
+		headerSize = CEDAR_BMF_V2_HEADER_SIZE;
+		mode = data[4];
+		*bitMask = data[5];
+		indexSize = data[6];
+		std::memcpy(&vertexCount, data + 8, 4);
+		std::memcpy(&indexCount, data + 12, 4);
+		std::memcpy(&positionOffset.x, data + 16, 4);
+		std::memcpy(&positionOffset.y, data + 20, 4);
+		std::memcpy(&positionOffset.z, data + 24, 4);
+		std::memcpy(&positionScale.x, data + 28, 4);
+		std::memcpy(&positionScale.y, data + 32, 4);
+		std::memcpy(&positionScale.z, data + 36, 4);
 	}
-
-	if ((*bitMask >> 0x04u) & 0x01u) // stencil
+	else
 	{
-		vertexSize += 1;
-		vertexAttribCount++;
+		headerSize = CEDAR_BMF_V1_HEADER_SIZE;
+		if (dataSize >= headerSize)
+		{
+			mode = data[0];
+			*bitMask = data[1];
+			std::memcpy(&vertexCount, data + 2, 4);
+			std::memcpy(&indexCount, data + 6, 4);
+		}
 	}
 
-	if ((*bitMask >> 0x05u) & 0x01u) // displacement
+	unsigned int vertexAttribCount = 0;
+	unsigned int vertexSize = 0;
+	for (const BMFAttribute &attribute : BMF_ATTRIBUTES)
 	{
-		vertexSize += 4;
-		vertexAttribCount++;
+		if (attribute.m_bit == 0 || (*bitMask & attribute.m_bit))
+		{
+			vertexSize += version2 ? attribute.m_v2Size : attribute.m_v1Size;
+			vertexAttribCount++;
+		}
 	}
 
-	unsigned int vertexDataSize = vertexCount * vertexSize;
-	unsigned int indexDataSize = indexCount * 4;
+	size_t vertexDataSize = static_cast<size_t>(vertexCount) * vertexSize;
+	size_t indexDataSize = static_cast<size_t>(indexCount) * indexSize;
 
-	unsigned int expectedFileSize = vertexDataSize + indexDataSize + 10;
-	if (fileSize < expectedFileSize)
+	size_t expectedFileSize = vertexDataSize + indexDataSize + headerSize;
+	if (dataSize < expectedFileSize || (indexSize != 2 && indexSize != 4))
 	{
-		modelFile.close();
-
 		std::string message = "Could not load model ";
 		message.append(name);
 		message.append(". The model file \"");
 		message.append(path);
 		message.append("\" is either corrupted or is not a model file! ");
-		message.append("Read vertex count: ");
+		message.append("Version: ");
+		message.append(version2 ? "2" : "1");
+		message.append(". Read vertex count: ");
 		message.append(std::to_string(vertexCount));
 		message.append(". Read index count: ");
 		message.append(std::to_string(indexCount));
 		message.append(". VertexSize: ");
 		message.append(std::to_string(vertexSize));
+		message.append(". IndexSize: ");
+		message.append(std::to_string(indexSize));
 		message.append(". Mode: ");
 		message.append(std::to_string(mode));
 		message.append(". BitMask: ");
@@ -130,14 +176,6 @@ Model *ModelRegistry::loadBMFModel(const std::string &name, const std::string &p
 		throw ModelLoadException(message);
 	}
 
-
-	char *vertexData = new char[vertexDataSize];
-	char *indexData = new char[indexDataSize];
-
-	modelFile.read(vertexData, vertexDataSize);
-	modelFile.read(indexData, indexDataSize);
-	modelFile.close();
-
 	unsigned int drawingMode = 0;
 	switch (mode)
 	{
@@ -162,10 +200,167 @@ Model *ModelRegistry::loadBMFModel(const std::string &name, const std::string &p
 			break;
 	}
 
+	const unsigned char *vertexData = data + headerSize;
+	const unsigned char *indexData = vertexData + vertexDataSize;
+
+	// The optimizer works in place and on 32 bit indices, so it gets a copy of the vertices and indices.
+	std::vector<unsigned char> optimizedVertexData;
+	std::vector<unsigned int> optimizedIndexData;
+	std::vector<unsigned short> optimizedShortIndexData;
+	if (drawingMode == CEDAR_TRIANGLES && optimizationFlags != 0)
+	{
+		optimizedIndexData.resize(indexCount);
+		for (unsigned int i = 0; i < indexCount; i++)
+		{
+			if (indexSize == 2)
+			{
+				unsigned short index;
+				std::memcpy(&index, indexData + static_cast<size_t>(i) * 2, 2);
+				optimizedIndexData[i] = index;
+			}
+			else
+			{
+				std::memcpy(&optimizedIndexData[i], indexData + static_cast<size_t>(i) * 4, 4);
+			}
+
+			if (optimizedIndexData[i] >= vertexCount)
+			{
+				std::string message = "Could not load model ";
+				message.append(name);
+				message.append(". Index ");
+				message.append(std::to_string(i));
+				message.append(" of the model file \"");
+				message.append(path);
+				message.append("\" references a vertex that does not exist!");
+				throw ModelLoadException(message);
+			}
+		}
+
+		optimizedVertexData.assign(vertexData, vertexData + vertexDataSize);
+
+		std::vector<float> positions(static_cast<size_t>(vertexCount) * 3);
+		for (unsigned int v = 0; v < vertexCount; v++)
+		{
+			const unsigned char *vertex = vertexData + static_cast<size_t>(v) * vertexSize;
+			float *position = positions.data() + static_cast<size_t>(v) * 3;
+			if (version2)
+			{
+				short quantizedPosition[3];
+				std::memcpy(quantizedPosition, vertex, 6);
+				position[0] = positionOffset.x + positionScale.x * static_cast<float>(quantizedPosition[0]) / 32767.0f;
+				position[1] = positionOffset.y + positionScale.y * static_cast<float>(quantizedPosition[1]) / 32767.0f;
+				position[2] = positionOffset.z + positionScale.z * static_cast<float>(quantizedPosition[2]) / 32767.0f;
+			}
+			else
+			{
+				std::memcpy(position, vertex, 12);
+			}
+		}
+
+		MeshOptimizationReport report = MeshOptimizer::optimize(optimizedVertexData.data(), &vertexCount, vertexSize,
+																optimizedIndexData.data(), indexCount, positions.data(),
+																optimizationFlags);
+		Cedar::getCoreLogger()->info("Optimized model %s. ACMR: %.3f -> %.3f, ATVR: %.3f -> %.3f.", name.c_str(),
+									 report.m_before.m_acmr, report.m_after.m_acmr, report.m_before.m_atvr, report.m_after.m_atvr);
+
+		vertexData = optimizedVertexData.data();
+		vertexDataSize = static_cast<size_t>(vertexCount) * vertexSize;
+		if (indexSize == 2)
+		{
+			optimizedShortIndexData.assign(optimizedIndexData.begin(), optimizedIndexData.end());
+			indexData = reinterpret_cast<const unsigned char *>(optimizedShortIndexData.data());
+		}
+		else
+		{
+			indexData = reinterpret_cast<const unsigned char *>(optimizedIndexData.data());
+		}
+	}
+
 	Model *model = new Model(drawingMode, vertexAttribCount);
-	model->upload(vertexDataSize, vertexData, indexDataSize, indexData);
-	delete[] vertexData;
-	delete[] indexData;
+	try
+	{
+		model->upload(static_cast<unsigned int>(vertexDataSize), vertexData, static_cast<unsigned int>(indexDataSize), indexData,
+					  indexSize == 2 ? CEDAR_UNSIGNED_SHORT : CEDAR_UNSIGNED_INT);
+
+		unsigned int attribIndex = 0;
+		unsigned int attribOffset = 0;
+		for (const BMFAttribute &attribute : BMF_ATTRIBUTES)
+		{
+			if (attribute.m_bit != 0 && !(*bitMask & attribute.m_bit))
+				continue;
+
+			// v1 files store normals as three floats, v2 files as two octahedral encoded shorts.
+			int components = attribute.m_bit == CEDAR_BMF_NORMALS && !version2 ? 3 : attribute.m_components;
+			unsigned int type = version2 ? attribute.m_v2Type : attribute.m_v1Type;
+			if (attribute.m_integer)
+				model->setVertexAttribIPointer(attribIndex, components, type, vertexSize, attribOffset);
+			else
+				model->setVertexAttribPointer(attribIndex, components, type, type != CEDAR_FLOAT, vertexSize, attribOffset);
+
+			attribOffset += version2 ? attribute.m_v2Size : attribute.m_v1Size;
+			attribIndex++;
+		}
+	}
+	catch (const ModelException &exception)
+	{
+		delete model;
+		throw ModelLoadException("Could not load model " + name + ". " + exception.what());
+	}
+
+	model->setPositionQuantization(positionOffset, positionScale);
+	return model;
+}
+
+Model *ModelRegistry::loadBMFModel(const std::string &name, const std::string &path, unsigned char *bitMask, const unsigned int optimizationFlags)
+{
+	auto it = LOADED_MODELS.find(name);
+	if (it != LOADED_MODELS.end())
+	{
+		std::string message = "Could not load model ";
+		message.append(name);
+		message.append(". A model with that name already exists!");
+		throw ModelLoadException(message);
+	}
+
+	const unsigned char *packData;
+	size_t packDataSize;
+	if (AssetPack::findAsset(path, &packData, &packDataSize))
+	{
+		Model *model = createBMFModel(name, path, packData, packDataSize, bitMask, optimizationFlags);
+		LOADED_MODELS.insert(std::make_pair(name, model));
+		return model;
+	}
+
+	std::ifstream modelFile;
+	modelFile.open(path, std::ifstream::binary | std::ifstream::ate);
+	if (!modelFile.is_open())
+	{
+		std::string message = "Could not load model ";
+		message.append(name);
+		message.append(". Could not open file \"");
+		message.append(path);
+		message.append("\"!");
+		throw ModelLoadException(message);
+	}
+
+	size_t fileSize = modelFile.tellg();
+	modelFile.seekg(0, std::ios_base::beg);
+
+	auto *fileData = new unsigned char[fileSize];
+	modelFile.read(reinterpret_cast<char *>(fileData), static_cast<std::streamsize>(fileSize));
+	modelFile.close();
+
+	Model *model;
+	try
+	{
+		model = createBMFModel(name, path, fileData, fileSize, bitMask, optimizationFlags);
+	}
+	catch (...)
+	{
+		delete[] fileData;
+		throw;
+	}
+	delete[] fileData;
 
 	LOADED_MODELS.insert(std::make_pair(name, model));
 	return model;
@@ -6,10 +6,20 @@
 
 using namespace cedar;
 
-TextBuffer::TextBuffer(const unsigned int glyphAtlasId, const unsigned int glyphCount, cedar::Quad *quads, const Vector2f &size)
+TextBuffer::TextBuffer()
 {
-	this->m_glyphAtlasId = glyphAtlasId;
+	this->m_glyphAtlasIds = std::vector<unsigned int>();
+	this->m_glyphCount = 0;
+	this->m_capacity = 0;
+	this->m_quads = nullptr;
+	this->m_size = Vector2f(0.0f, 0.0f);
+}
+
+TextBuffer::TextBuffer(const std::vector<unsigned int> &glyphAtlasIds, const unsigned int glyphCount, cedar::Quad *quads, const Vector2f &size)
+{
+	this->m_glyphAtlasIds = glyphAtlasIds;
 	this->m_glyphCount = glyphCount;
+	this->m_capacity = glyphCount;
 	this->m_quads = quads;
 	this->m_size = size;
 }
@@ -19,9 +29,33 @@ TextBuffer::~TextBuffer()
 	delete[] this->m_quads;
 }
 
-unsigned int TextBuffer::getGlyphAtlas() const
+Quad *TextBuffer::reserve(const unsigned int capacity)
+{
+	if (capacity > this->m_capacity)
+	{
+		delete[] this->m_quads;
+		this->m_quads = new Quad[capacity];
+		this->m_capacity = capacity;
+	}
+
+	return this->m_quads;
+}
+
+void TextBuffer::set(const std::vector<unsigned int> &glyphAtlasIds, const unsigned int glyphCount, const Vector2f &size)
 {
-	return this->m_glyphAtlasId;
+	this->m_glyphAtlasIds = glyphAtlasIds;
+	this->m_glyphCount = glyphCount;
+	this->m_size = size;
+}
+
+unsigned int TextBuffer::getGlyphAtlas(const unsigned int page) const
+{
+	return this->m_glyphAtlasIds[page];
+}
+
+unsigned int TextBuffer::getGlyphAtlasCount() const
+{
+	return static_cast<unsigned int>(this->m_glyphAtlasIds.size());
 }
 
 unsigned int TextBuffer::getGlyphCount() const
@@ -29,6 +63,11 @@ unsigned int TextBuffer::getGlyphCount() const
 	return this->m_glyphCount;
 }
 
+unsigned int TextBuffer::getCapacity() const
+{
+	return this->m_capacity;
+}
+
 const Quad *TextBuffer::getQuads() const
 {
 	return this->m_quads;
@@ -103,6 +103,10 @@ void MasterRenderer::render(unsigned long currentTime, unsigned long tickCount)
 	for (Renderer *renderer : this->m_renderers)
 		renderer->render(currentTime, tickCount);
 
+	// Cached screens render their changes into their own textures first, they are drawn with a single quad below.
+	for (Screen *screen : *ScreenRegistry::getLoadedScreens())
+		screen->renderCache(currentTime, this->m_window->getWidth(), this->m_window->getHeight());
+
 	Renderer2D::beginBatch();
 	for (Screen *screen : *ScreenRegistry::getLoadedScreens())
 	{
@@ -4,6 +4,7 @@
 
 #include "cedar/Renderer2D.hpp"
 #include "cedar/Cedar.hpp"
+#include "cedar/TextureRegistry.hpp"
 #include "glad/glad.h"
 #include <cmath>
 #include <regex>
@@ -27,6 +28,7 @@ unsigned int Renderer2D::textureCount = 0;
 unsigned int Renderer2D::vaoId = 0;
 unsigned int Renderer2D::quadVboId = 0;
 unsigned int Renderer2D::instanceVboId = 0;
+std::vector<Vector4f> Renderer2D::clipRects = std::vector<Vector4f>();
 
 
 Renderer2D::Renderer2D()
@@ -88,7 +90,19 @@ uniform sampler2D[${MAX_TEXTURE_UNITS}] u_samplers;
 
 void main()
 {
-	diffuseColor = texture(u_samplers[f_textureUnit], f_uvs) * f_tint;
+	vec4 texel = texture(u_samplers[f_textureUnit & ${TEXTURE_UNIT_MASK}], f_uvs);
+
+	// Distance field glyphs store the distance to the outline in the alpha channel, 0.5 being the outline itself.
+	// The derivative is taken outside the branch, so it is defined for every fragment.
+	float edgeWidth = max(fwidth(texel.a), 0.0001);
+	float coverage = smoothstep(0.5 - edgeWidth, 0.5 + edgeWidth, texel.a);
+
+	if ((f_textureUnit & ${DISTANCE_FIELD}) != 0)
+		diffuseColor = vec4(f_tint.rgb, f_tint.a * coverage);
+	else if ((f_textureUnit & ${PREMULTIPLIED}) != 0)
+		diffuseColor = vec4(texel.rgb / max(texel.a, 1.0 / 255.0), texel.a) * f_tint;
+	else
+		diffuseColor = texel * f_tint;
 }
 
 )glsl";
@@ -96,6 +110,9 @@ void main()
 	// Replace the sampler array size with the actual maximum number of texture units the graphics card supports
 	std::regex pattern(R"(\$\{MAX_TEXTURE_UNITS\})");
 	std::string guiFragmentShader = std::regex_replace(guiFragmentShaderTemplate, pattern, std::to_string(maxTextureUnits));
+	guiFragmentShader = std::regex_replace(guiFragmentShader, std::regex(R"(\$\{TEXTURE_UNIT_MASK\})"), std::to_string(CEDAR_QUAD_TEXTURE_UNIT_MASK));
+	guiFragmentShader = std::regex_replace(guiFragmentShader, std::regex(R"(\$\{DISTANCE_FIELD\})"), std::to_string(CEDAR_QUAD_DISTANCE_FIELD));
+	guiFragmentShader = std::regex_replace(guiFragmentShader, std::regex(R"(\$\{PREMULTIPLIED\})"), std::to_string(CEDAR_QUAD_PREMULTIPLIED));
 
 	shader = new cedar::ShaderProgram();
 	shader->createVertexShader(guiVertexShader);
@@ -201,6 +218,84 @@ void Renderer2D::flush()
 	shader->unbind();
 }
 
+int Renderer2D::getTextureUnit(const unsigned int textureId)
+{
+	for (unsigned int n = 0; n < textureUnitCount; n++)
+	{
+		if (textures[n] == textureId)
+		{
+			return static_cast<int>(n);
+		}
+		else if (textures[n] == 0)
+		{
+			textures[n] = textureId;
+			textureCount++;
+			return static_cast<int>(n);
+		}
+	}
+
+	endBatch();
+	flush();
+	beginBatch();
+	textures[1] = textureId;
+	textureCount++;
+	return 1;
+}
+
+bool Renderer2D::clipQuad(Quad *quad)
+{
+	const Vector4f &clipRect = clipRects.back();
+	Vector4f &corners = quad->m_corners;
+	Vector4f &uvs = quad->m_uvs;
+	if (corners.x >= clipRect.z || corners.z <= clipRect.x || corners.y >= clipRect.w || corners.w <= clipRect.y)
+		return false;
+
+	// The uvs are interpolated along each axis, the quads of the renderer are never rotated.
+	if (corners.x < clipRect.x)
+	{
+		uvs.x += (uvs.z - uvs.x) * (clipRect.x - corners.x) / (corners.z - corners.x);
+		corners.x = clipRect.x;
+	}
+	if (corners.z > clipRect.z)
+	{
+		uvs.z -= (uvs.z - uvs.x) * (corners.z - clipRect.z) / (corners.z - corners.x);
+		corners.z = clipRect.z;
+	}
+	if (corners.y < clipRect.y)
+	{
+		uvs.y += (uvs.w - uvs.y) * (clipRect.y - corners.y) / (corners.w - corners.y);
+		corners.y = clipRect.y;
+	}
+	if (corners.w > clipRect.w)
+	{
+		uvs.w -= (uvs.w - uvs.y) * (corners.w - clipRect.w) / (corners.w - corners.y);
+		corners.w = clipRect.w;
+	}
+
+	return true;
+}
+
+void Renderer2D::pushClipRect(const float posX, const float posY, const float width, const float height)
+{
+	Vector4f clipRect(posX, posY, posX + width, posY + height);
+	if (!clipRects.empty())
+	{
+		const Vector4f &parentRect = clipRects.back();
+		clipRect.x = std::max(clipRect.x, parentRect.x);
+		clipRect.y = std::max(clipRect.y, parentRect.y);
+		clipRect.z = std::min(clipRect.z, parentRect.z);
+		clipRect.w = std::min(clipRect.w, parentRect.w);
+	}
+
+	clipRects.push_back(clipRect);
+}
+
+void Renderer2D::popClipRect()
+{
+	if (!clipRects.empty())
+		clipRects.pop_back();
+}
+
 void Renderer2D::drawRect(const float posX, const float posY, const float posZ, const float width, const float height, const Vector4f *color)
 {
 	if (quadCount == batchSize)
@@ -213,8 +308,11 @@ void Renderer2D::drawRect(const float posX, const float posY, const float posZ,
 	nextQuad->set(posX, posY, posX + width, posY + height, -posZ, 0,
 				  0.0f, 0.0f, 1.0f, 1.0f, color->x, color->y, color->z, color->w);
 
-	nextQuad++;
-	quadCount++;
+	if (clipRects.empty() || clipQuad(nextQuad))
+	{
+		nextQuad++;
+		quadCount++;
+	}
 }
 
 void Renderer2D::drawTexturedRect(float posX, float posY, float posZ, float width, float height, const Vector4f &uvs,
@@ -233,42 +331,22 @@ void Renderer2D::drawTexturedRect(float posX, float posY, float posZ, float widt
 		beginBatch();
 	}
 
-	int textureUnit = 0;
-	for (unsigned int n = 0; n < textureUnitCount; n++)
-	{
-		if (textures[n] == texture->getId())
-		{
-			textureUnit = static_cast<int>(n);
-			break;
-		}
-		else if (textures[n] == 0)
-		{
-			textures[n] = texture->getId();
-			textureUnit = static_cast<int>(n);
-			textureCount++;
-			break;
-		}
-	}
-
-	if (textureUnit == 0)
-	{
-		endBatch();
-		flush();
-		beginBatch();
-		textureUnit = 1.0f;
-		textures[1] = texture->getId();
-	}
+	int textureUnit = getTextureUnit(texture->getId());
+	texture->markUsed(TextureRegistry::getCurrentFrame());
 
 	nextQuad->set(posX, posY, posX + width, posY + height, -posZ, textureUnit,
 				  uvX1, uvY1, uvX2, uvY2, color.x, color.y, color.z, color.w);
 
-	nextQuad++;
-	quadCount++;
+	if (clipRects.empty() || clipQuad(nextQuad))
+	{
+		nextQuad++;
+		quadCount++;
+	}
 }
 
 void Renderer2D::drawText(const float posX, const float posY, const float posZ, const std::string &text, const std::shared_ptr<Font> &font,
 						  const Vector4f &color,
-						  const unsigned int alignment, Vector2f *size)
+						  const unsigned int alignment, Vector2f *size, const float scale)
 {
 	if (quadCount + text.length() > batchSize)
 	{
@@ -277,31 +355,10 @@ void Renderer2D::drawText(const float posX, const float posY, const float posZ,
 		beginBatch();
 	}
 
-	int textureUnit = 0;
-	for (unsigned int n = 0; n < textureUnitCount; n++)
-	{
-		if (textures[n] == font->getGlyphAtlas()->getId())
-		{
-			textureUnit = static_cast<int>(n);
-			break;
-		}
-		else if (textures[n] == 0)
-		{
-			textures[n] = font->getGlyphAtlas()->getId();
-			textureUnit = static_cast<int>(n);
-			textureCount++;
-			break;
-		}
-	}
-
-	if (textureUnit == 0)
-	{
-		endBatch();
-		flush();
-		beginBatch();
-		textureUnit = 1.0f;
-		textures[1] = font->getGlyphAtlas()->getId();
-	}
+	// Glyphs of one font can be spread over multiple atlas pages, the unit is only looked up again when the page changes.
+	unsigned int page = 0;
+	int textureUnit = -1;
+	int distanceField = font->isDistanceField() ? CEDAR_QUAD_DISTANCE_FIELD : 0;
 
 	float width = 0.0f;
 	float height = 0.0f;
@@ -321,32 +378,42 @@ void Renderer2D::drawText(const float posX, const float posY, const float posZ,
 			{
 				const Glyph *glyph = font->getGlyph(codepoint);
 
-				currentPosX = nextPosX + static_cast<float>(glyph->m_bearing.x);
+				if (textureUnit == -1 || glyph->m_page != page)
+				{
+					page = glyph->m_page;
+					const Texture2D *glyphAtlas = font->getGlyphAtlas(page);
+					textureUnit = (glyphAtlas ? getTextureUnit(glyphAtlas->getId()) : 0) | distanceField;
+				}
+
+				currentPosX = nextPosX + static_cast<float>(glyph->m_bearing.x) * scale;
 
 				switch (verticalAlignment)
 				{
 					case CEDAR_ALIGNMENT_TOP:
-						nextPosY = posY - static_cast<float>(glyph->m_bearing.y) + static_cast<float>(font->getSize());
+						nextPosY = posY - static_cast<float>(glyph->m_bearing.y) * scale + static_cast<float>(font->getSize()) * scale;
 						break;
 
 					case CEDAR_ALIGNMENT_MIDDLE:
-						nextPosY = posY - static_cast<float>(glyph->m_bearing.y) + (static_cast<float>(font->getSize()) * 0.5f);
+						nextPosY = posY - static_cast<float>(glyph->m_bearing.y) * scale + (static_cast<float>(font->getSize()) * scale * 0.5f);
 						break;
 
 					default:
-						nextPosY = posY - static_cast<float>(glyph->m_bearing.y);
+						nextPosY = posY - static_cast<float>(glyph->m_bearing.y) * scale;
 						break;
 				}
 
-				nextQuad->set(Vector4f(currentPosX, nextPosY, currentPosX + static_cast<float>(glyph->m_size.x), nextPosY + static_cast<float>(glyph->m_size.y)),
+				nextQuad->set(Vector4f(currentPosX, nextPosY, currentPosX + static_cast<float>(glyph->m_size.x) * scale, nextPosY + static_cast<float>(glyph->m_size.y) * scale),
 							  -posZ, textureUnit, glyph->m_uvs, color);
 
-				nextQuad++;
-				quadCount++;
+				if (clipRects.empty() || clipQuad(nextQuad))
+				{
+					nextQuad++;
+					quadCount++;
+				}
 
-				nextPosX += static_cast<float>(glyph->m_advance);
-				width += static_cast<float>(glyph->m_advance);
-				height = std::max(height, static_cast<float>(glyph->m_size.y));
+				nextPosX += static_cast<float>(glyph->m_advance) * scale;
+				width += static_cast<float>(glyph->m_advance) * scale;
+				height = std::max(height, static_cast<float>(glyph->m_size.y) * scale);
 			}
 		}
 	}
@@ -359,8 +426,8 @@ void Renderer2D::drawText(const float posX, const float posY, const float posZ,
 			if (!Font::decode(&state, &codepoint, *s))
 			{
 				glyphs[characters] = *font->getGlyph(codepoint);
-				width += static_cast<float>(glyphs[characters].m_advance);
-				height = std::max(height, static_cast<float>(glyphs[characters].m_size.y));
+				width += static_cast<float>(glyphs[characters].m_advance) * scale;
+				height = std::max(height, static_cast<float>(glyphs[characters].m_size.y) * scale);
 				characters++;
 			}
 		}
@@ -372,30 +439,40 @@ void Renderer2D::drawText(const float posX, const float posY, const float posZ,
 
 		for (unsigned int n = 0; n < characters; n++)
 		{
-			currentPosX = nextPosX + static_cast<float>(glyphs[n].m_bearing.x);
+			if (textureUnit == -1 || glyphs[n].m_page != page)
+			{
+				page = glyphs[n].m_page;
+				const Texture2D *glyphAtlas = font->getGlyphAtlas(page);
+				textureUnit = (glyphAtlas ? getTextureUnit(glyphAtlas->getId()) : 0) | distanceField;
+			}
+
+			currentPosX = nextPosX + static_cast<float>(glyphs[n].m_bearing.x) * scale;
 
 			switch (verticalAlignment)
 			{
 				case CEDAR_ALIGNMENT_TOP:
-					nextPosY = posY - static_cast<float>(glyphs[n].m_bearing.y) + static_cast<float>(font->getSize());
+					nextPosY = posY - static_cast<float>(glyphs[n].m_bearing.y) * scale + static_cast<float>(font->getSize()) * scale;
 					break;
 
 				case CEDAR_ALIGNMENT_MIDDLE:
-					nextPosY = posY - static_cast<float>(glyphs[n].m_bearing.y) + (static_cast<float>(font->getSize()) * 0.5f);
+					nextPosY = posY - static_cast<float>(glyphs[n].m_bearing.y) * scale + (static_cast<float>(font->getSize()) * scale * 0.5f);
 					break;
 
 				default:
-					nextPosY = posY - static_cast<float>(glyphs[n].m_bearing.y);
+					nextPosY = posY - static_cast<float>(glyphs[n].m_bearing.y) * scale;
 					break;
 			}
 
-			nextQuad->set(Vector4f(currentPosX, nextPosY, currentPosX + static_cast<float>(glyphs[n].m_size.x), nextPosY + static_cast<float>(glyphs[n].m_size.y)),
+			nextQuad->set(Vector4f(currentPosX, nextPosY, currentPosX + static_cast<float>(glyphs[n].m_size.x) * scale, nextPosY + static_cast<float>(glyphs[n].m_size.y) * scale),
 						  -posZ, textureUnit, glyphs[n].m_uvs, color);
 
-			nextQuad++;
-			quadCount++;
+			if (clipRects.empty() || clipQuad(nextQuad))
+			{
+				nextQuad++;
+				quadCount++;
+			}
 
-			nextPosX += static_cast<float>(glyphs[n].m_advance);
+			nextPosX += static_cast<float>(glyphs[n].m_advance) * scale;
 		}
 	}
 
@@ -403,9 +480,19 @@ void Renderer2D::drawText(const float posX, const float posY, const float posZ,
 		*size = Vector2f(width, height);
 }
 
-TextBuffer *Renderer2D::generateTextBuffer(const std::string &text, const std::shared_ptr<Font> &font, const unsigned int alignment)
+TextBuffer *Renderer2D::generateTextBuffer(const std::string &text, const std::shared_ptr<Font> &font, const unsigned int alignment,
+										  const float scale)
 {
-	Quad *quads = new Quad[text.length()];
+	auto *textBuffer = new TextBuffer();
+	updateTextBuffer(textBuffer, text, font, alignment, scale);
+	return textBuffer;
+}
+
+void Renderer2D::updateTextBuffer(TextBuffer *textBuffer, const std::string &text, const std::shared_ptr<Font> &font, const unsigned int alignment,
+								  const float scale)
+{
+	Quad *quads = textBuffer->reserve(static_cast<unsigned int>(text.length()));
+	int distanceField = font->isDistanceField() ? CEDAR_QUAD_DISTANCE_FIELD : 0;
 
 	float width = 0.0f;
 	float height = 0.0f;
@@ -426,30 +513,30 @@ TextBuffer *Renderer2D::generateTextBuffer(const std::string &text, const std::s
 			{
 				const Glyph *glyph = font->getGlyph(codepoint);
 
-				currentPosX = nextPosX + static_cast<float>(glyph->m_bearing.x);
+				currentPosX = nextPosX + static_cast<float>(glyph->m_bearing.x) * scale;
 
 				switch (verticalAlignment)
 				{
 					case CEDAR_ALIGNMENT_TOP:
-						nextPosY = -static_cast<float>(glyph->m_bearing.y) + static_cast<float>(font->getSize());
+						nextPosY = -static_cast<float>(glyph->m_bearing.y) * scale + static_cast<float>(font->getSize()) * scale;
 						break;
 
 					case CEDAR_ALIGNMENT_MIDDLE:
-						nextPosY = -static_cast<float>(glyph->m_bearing.y) + (static_cast<float>(font->getSize()) * 0.5f);
+						nextPosY = -static_cast<float>(glyph->m_bearing.y) * scale + (static_cast<float>(font->getSize()) * scale * 0.5f);
 						break;
 
 					default:
-						nextPosY = -static_cast<float>(glyph->m_bearing.y);
+						nextPosY = -static_cast<float>(glyph->m_bearing.y) * scale;
 						break;
 				}
 
 				quads[glyphCount++].set(
-						Vector4f(currentPosX, nextPosY, currentPosX + static_cast<float>(glyph->m_size.x), nextPosY + static_cast<float>(glyph->m_size.y)),
-						0.0f, 0, glyph->m_uvs, Vector4f(1.0f, 1.0f, 1.0f, 1.0f));
+						Vector4f(currentPosX, nextPosY, currentPosX + static_cast<float>(glyph->m_size.x) * scale, nextPosY + static_cast<float>(glyph->m_size.y) * scale),
+						0.0f, static_cast<int>(glyph->m_page) | distanceField, glyph->m_uvs, Vector4f(1.0f, 1.0f, 1.0f, 1.0f));
 
-				nextPosX += static_cast<float>(glyph->m_advance);
-				width += static_cast<float>(glyph->m_advance);
-				height = std::max(height, static_cast<float>(glyph->m_size.y));
+				nextPosX += static_cast<float>(glyph->m_advance) * scale;
+				width += static_cast<float>(glyph->m_advance) * scale;
+				height = std::max(height, static_cast<float>(glyph->m_size.y) * scale);
 			}
 		}
 	}
@@ -462,8 +549,8 @@ TextBuffer *Renderer2D::generateTextBuffer(const std::string &text, const std::s
 			if (!Font::decode(&state, &codepoint, *s))
 			{
 				glyphs[characters] = *font->getGlyph(codepoint);
-				width += static_cast<float>(glyphs[characters].m_advance);
-				height = std::max(height, static_cast<float>(glyphs[characters].m_size.y));
+				width += static_cast<float>(glyphs[characters].m_advance) * scale;
+				height = std::max(height, static_cast<float>(glyphs[characters].m_size.y) * scale);
 				characters++;
 			}
 		}
@@ -475,33 +562,38 @@ TextBuffer *Renderer2D::generateTextBuffer(const std::string &text, const std::s
 
 		for (unsigned int n = 0; n < characters; n++)
 		{
-			currentPosX = nextPosX + static_cast<float>(glyphs[n].m_bearing.x);
+			currentPosX = nextPosX + static_cast<float>(glyphs[n].m_bearing.x) * scale;
 
 			switch (verticalAlignment)
 			{
 				case CEDAR_ALIGNMENT_TOP:
-					nextPosY = -static_cast<float>(glyphs[n].m_bearing.y) + static_cast<float>(font->getSize());
+					nextPosY = -static_cast<float>(glyphs[n].m_bearing.y) * scale + static_cast<float>(font->getSize()) * scale;
 					break;
 
 				case CEDAR_ALIGNMENT_MIDDLE:
-					nextPosY = -static_cast<float>(glyphs[n].m_bearing.y) + (static_cast<float>(font->getSize()) * 0.5f);
+					nextPosY = -static_cast<float>(glyphs[n].m_bearing.y) * scale + (static_cast<float>(font->getSize()) * scale * 0.5f);
 					break;
 
 				default:
-					nextPosY = -static_cast<float>(glyphs[n].m_bearing.y);
+					nextPosY = -static_cast<float>(glyphs[n].m_bearing.y) * scale;
 					break;
 			}
 
 			quads[glyphCount++].set(
-					Vector4f(currentPosX, nextPosY, currentPosX + static_cast<float>(glyphs[n].m_size.x), nextPosY + static_cast<float>(glyphs[n].m_size.y)),
-					0.0f, 0, glyphs[n].m_uvs, Vector4f(1.0f, 1.0f, 1.0f, 1.0f)
+					Vector4f(currentPosX, nextPosY, currentPosX + static_cast<float>(glyphs[n].m_size.x) * scale, nextPosY + static_cast<float>(glyphs[n].m_size.y) * scale),
+					0.0f, static_cast<int>(glyphs[n].m_page) | distanceField, glyphs[n].m_uvs, Vector4f(1.0f, 1.0f, 1.0f, 1.0f)
 								   );
 
-			nextPosX += static_cast<float>(glyphs[n].m_advance);
+			nextPosX += static_cast<float>(glyphs[n].m_advance) * scale;
 		}
 	}
 
-	return new TextBuffer(font->getGlyphAtlas()->getId(), glyphCount, quads, Vector2f(width, height));
+	// The atlas ids are collected after all glyphs were loaded, since loading them may have added pages.
+	std::vector<unsigned int> glyphAtlasIds(font->getGlyphAtlasCount());
+	for (unsigned int n = 0; n < font->getGlyphAtlasCount(); n++)
+		glyphAtlasIds[n] = font->getGlyphAtlas(n)->getId();
+
+	textBuffer->set(glyphAtlasIds, glyphCount, Vector2f(width, height));
 }
 
 void Renderer2D::drawText(const float offsetX, const float offsetY, const float offsetZ, const TextBuffer *textBuffer, const Vector4f &color)
@@ -513,37 +605,48 @@ void Renderer2D::drawText(const float offsetX, const float offsetY, const float
 		beginBatch();
 	}
 
+	// The quads of a text buffer store the atlas page of their glyph instead of a texture unit.
+	int page = -1;
 	int textureUnit = 0;
-	for (unsigned int n = 0; n < textureUnitCount; n++)
+	int distanceField = 0;
+	for (int n = 0; n < textBuffer->getGlyphCount(); n++)
 	{
-		if (textures[n] == textBuffer->getGlyphAtlas())
+		if ((textBuffer->getQuads()[n].m_textureUnit & CEDAR_QUAD_TEXTURE_UNIT_MASK) != page)
 		{
-			textureUnit = static_cast<int>(n);
-			break;
+			page = textBuffer->getQuads()[n].m_textureUnit & CEDAR_QUAD_TEXTURE_UNIT_MASK;
+			distanceField = textBuffer->getQuads()[n].m_textureUnit & CEDAR_QUAD_DISTANCE_FIELD;
+			textureUnit = static_cast<unsigned int>(page) < textBuffer->getGlyphAtlasCount() ? getTextureUnit(textBuffer->getGlyphAtlas(page)) : 0;
 		}
-		else if (textures[n] == 0)
+
+		nextQuad->set(textBuffer->getQuads()[n].m_corners + Vector4f(offsetX, offsetY, offsetX, offsetY),
+					  -offsetZ, textureUnit | distanceField, textBuffer->getQuads()[n].m_uvs, color);
+
+		if (clipRects.empty() || clipQuad(nextQuad))
 		{
-			textures[n] = textBuffer->getGlyphAtlas();
-			textureUnit = static_cast<int>(n);
-			textureCount++;
-			break;
+			nextQuad++;
+			quadCount++;
 		}
 	}
+}
 
-	if (textureUnit == 0)
+void Renderer2D::drawLayer(const float posX, const float posY, const float posZ, const float width, const float height,
+						   const std::shared_ptr<Texture> &texture)
+{
+	if (quadCount == batchSize)
 	{
 		endBatch();
 		flush();
 		beginBatch();
-		textureUnit = 1.0f;
-		textures[1] = textBuffer->getGlyphAtlas();
 	}
 
-	for (int n = 0; n < textBuffer->getGlyphCount(); n++)
-	{
-		nextQuad->set(textBuffer->getQuads()[n].m_corners + Vector4f(offsetX, offsetY, offsetX, offsetY),
-					  -offsetZ, textureUnit, textBuffer->getQuads()[n].m_uvs, color);
+	int textureUnit = getTextureUnit(texture->getId());
+
+	// Framebuffers start at the bottom left corner, so the uvs are flipped vertically.
+	nextQuad->set(posX, posY, posX + width, posY + height, -posZ, textureUnit | CEDAR_QUAD_PREMULTIPLIED,
+				  0.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f);
 
+	if (clipRects.empty() || clipQuad(nextQuad))
+	{
 		nextQuad++;
 		quadCount++;
 	}
@@ -0,0 +1,269 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+#include "cedar/BlockCompressor.hpp"
+#include "cedar/GLConstants.hpp"
+#include "cedar/ThreadPool.hpp"
+
+using namespace cedar;
+
+/**
+ * Quantizes an 8 bit RGB color to a 565 color.
+ *
+ * @param color A pointer to the RGB color.
+ * @return The 565 color.
+ */
+unsigned short toRGB565(const float *color)
+{
+	auto red = static_cast<unsigned short>(std::lround(std::clamp(color[0], 0.0f, 255.0f) * 31.0f / 255.0f));
+	auto green = static_cast<unsigned short>(std::lround(std::clamp(color[1], 0.0f, 255.0f) * 63.0f / 255.0f));
+	auto blue = static_cast<unsigned short>(std::lround(std::clamp(color[2], 0.0f, 255.0f) * 31.0f / 255.0f));
+	return static_cast<unsigned short>((red << 11u) | (green << 5u) | blue);
+}
+
+/**
+ * Expands a 565 color to an 8 bit RGB color the way the graphics card does.
+ *
+ * @param color The 565 color.
+ * @param rgb A pointer to the 3 integers the color is written to.
+ */
+void fromRGB565(const unsigned short color, int *rgb)
+{
+	int red = (color >> 11u) & 0x1Fu;
+	int green = (color >> 5u) & 0x3Fu;
+	int blue = color & 0x1Fu;
+	rgb[0] = (red << 3) | (red >> 2);
+	rgb[1] = (green << 2) | (green >> 4);
+	rgb[2] = (blue << 3) | (blue >> 2);
+}
+
+BlockCompressionException::BlockCompressionException(const std::string &message) : XException(message)
+{}
+
+BlockCompressor::BlockCompressor()
+= default;
+
+int BlockCompressor::getCompressedFormat(const int channels)
+{
+	switch (channels)
+	{
+		case 1:
+			return CEDAR_COMPRESSED_RED_RGTC1;
+		case 2:
+			return CEDAR_COMPRESSED_RG_RGTC2;
+		case 3:
+			return CEDAR_COMPRESSED_RGBA_S3TC_DXT1;
+		case 4:
+			return CEDAR_COMPRESSED_RGBA_S3TC_DXT5;
+		default:
+			return 0;
+	}
+}
+
+void BlockCompressor::compressBC1Block(const unsigned char *pixels, unsigned char *block)
+{
+	float mean[3] = {0.0f, 0.0f, 0.0f};
+	for (int n = 0; n < 16; n++)
+	{
+		for (int c = 0; c < 3; c++)
+			mean[c] += pixels[n * 4 + c];
+	}
+	for (float &component : mean)
+		component /= 16.0f;
+
+	// Covariance matrix of the block, the endpoints are fitted along its principal axis.
+	float covariance[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+	for (int n = 0; n < 16; n++)
+	{
+		float red = pixels[n * 4] - mean[0];
+		float green = pixels[n * 4 + 1] - mean[1];
+		float blue = pixels[n * 4 + 2] - mean[2];
+		covariance[0] += red * red;
+		covariance[1] += red * green;
+		covariance[2] += red * blue;
+		covariance[3] += green * green;
+		covariance[4] += green * blue;
+		covariance[5] += blue * blue;
+	}
+
+	float axis[3] = {1.0f, 1.0f, 1.0f};
+	for (int iteration = 0; iteration < 8; iteration++)
+	{
+		float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+		float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+		float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+		float length = std::max(std::fabs(x), std::max(std::fabs(y), std::fabs(z)));
+		if (length < 1e-6f)
+			break;
+		axis[0] = x / length;
+		axis[1] = y / length;
+		axis[2] = z / length;
+	}
+
+	float minProjection = 0.0f;
+	float maxProjection = 0.0f;
+	for (int n = 0; n < 16; n++)
+	{
+		float projection = (pixels[n * 4] - mean[0]) * axis[0] + (pixels[n * 4 + 1] - mean[1]) * axis[1] +
+						   (pixels[n * 4 + 2] - mean[2]) * axis[2];
+		minProjection = std::min(minProjection, projection);
+		maxProjection = std::max(maxProjection, projection);
+	}
+
+	// Inset the endpoints slightly, the outermost colors are rarely hit exactly after quantization.
+	float axisLengthSquared = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+	float inset = (maxProjection - minProjection) / 16.0f;
+	float maxColor[3];
+	float minColor[3];
+	for (int c = 0; c < 3; c++)
+	{
+		maxColor[c] = mean[c] + axis[c] * (maxProjection - inset) / std::max(axisLengthSquared, 1e-6f);
+		minColor[c] = mean[c] + axis[c] * (minProjection + inset) / std::max(axisLengthSquared, 1e-6f);
+	}
+
+	unsigned short color0 = toRGB565(maxColor);
+	unsigned short color1 = toRGB565(minColor);
+	if (color0 < color1)
+		std::swap(color0, color1);
+
+	unsigned int indices = 0;
+	if (color0 != color1)
+	{
+		int palette[4][3];
+		fromRGB565(color0, palette[0]);
+		fromRGB565(color1, palette[1]);
+		for (int c = 0; c < 3; c++)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+
+		for (int n = 0; n < 16; n++)
+		{
+			unsigned int bestIndex = 0;
+			int bestDistance = INT_MAX;
+			for (unsigned int index = 0; index < 4; index++)
+			{
+				int red = pixels[n * 4] - palette[index][0];
+				int green = pixels[n * 4 + 1] - palette[index][1];
+				int blue = pixels[n * 4 + 2] - palette[index][2];
+				int distance = red * red + green * green + blue * blue;
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = index;
+				}
+			}
+			indices |= bestIndex << (n * 2u);
+		}
+	}
+
+	std::memcpy(block, &color0, 2);
+	std::memcpy(block + 2, &color1, 2);
+	std::memcpy(block + 4, &indices, 4);
+}
+
+void BlockCompressor::compressBC4Block(const unsigned char *values, const int stride, unsigned char *block)
+{
+	int minValue = 255;
+	int maxValue = 0;
+	for (int n = 0; n < 16; n++)
+	{
+		minValue = std::min(minValue, static_cast<int>(values[n * stride]));
+		maxValue = std::max(maxValue, static_cast<int>(values[n * stride]));
+	}
+
+	unsigned long long indices = 0;
+	if (maxValue != minValue)
+	{
+		// With the first endpoint being greater than the second, the block uses 6 interpolated values.
+		int palette[8];
+		palette[0] = maxValue;
+		palette[1] = minValue;
+		for (int n = 2; n < 8; n++)
+			palette[n] = ((8 - n) * maxValue + (n - 1) * minValue + 3) / 7;
+
+		for (int n = 0; n < 16; n++)
+		{
+			unsigned long long bestIndex = 0;
+			int bestDistance = 256;
+			for (unsigned int index = 0; index < 8; index++)
+			{
+				int distance = std::abs(values[n * stride] - palette[index]);
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = index;
+				}
+			}
+			indices |= bestIndex << (n * 3u);
+		}
+	}
+
+	block[0] = static_cast<unsigned char>(maxValue);
+	block[1] = static_cast<unsigned char>(minValue);
+	for (int n = 0; n < 6; n++)
+		block[2 + n] = static_cast<unsigned char>(indices >> (n * 8u));
+}
+
+std::vector<unsigned char> BlockCompressor::compress(const unsigned char *pixels, const int width, const int height, const int channels)
+{
+	if (width <= 0 || height <= 0)
+		throw BlockCompressionException("Could not compress image. The width and height must be greater than 0!");
+
+	if (channels < 1 || channels > 4)
+		throw BlockCompressionException("Could not compress image. Unsupported number of channels " + std::to_string(channels) + "!");
+
+	size_t blockSize = channels == 1 || channels == 3 ? 8 : 16;
+	size_t blocksX = (width + 3) / 4;
+	size_t blocksY = (height + 3) / 4;
+	std::vector<unsigned char> blocks(blocksX * blocksY * blockSize);
+
+	ThreadPool::getInstance()->parallelFor(blocksY, [&](size_t blockY) {
+		unsigned char rgba[64];
+		for (size_t blockX = 0; blockX < blocksX; blockX++)
+		{
+			// Blocks at the edge repeat the last row and column of the image.
+			for (int n = 0; n < 16; n++)
+			{
+				size_t x = std::min(blockX * 4 + (n & 3), static_cast<size_t>(width - 1));
+				size_t y = std::min(blockY * 4 + (n >> 2), static_cast<size_t>(height - 1));
+				const unsigned char *pixel = pixels + (y * width + x) * channels;
+				rgba[n * 4] = pixel[0];
+				rgba[n * 4 + 1] = channels > 1 ? pixel[1] : 0;
+				rgba[n * 4 + 2] = channels > 2 ? pixel[2] : 0;
+				rgba[n * 4 + 3] = channels > 3 ? pixel[3] : 255;
+			}
+
+			unsigned char *block = blocks.data() + (blockY * blocksX + blockX) * blockSize;
+			switch (channels)
+			{
+				case 1:
+					compressBC4Block(rgba, 4, block);
+					break;
+
+				case 2:
+					compressBC4Block(rgba, 4, block);
+					compressBC4Block(rgba + 1, 4, block + 8);
+					break;
+
+				case 3:
+					compressBC1Block(rgba, block);
+					break;
+
+				default:
+					compressBC4Block(rgba + 3, 4, block);
+					compressBC1Block(rgba, block + 8);
+					break;
+			}
+		}
+	});
+
+	return blocks;
+}
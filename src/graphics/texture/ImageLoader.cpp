@@ -2,7 +2,21 @@
 // Created by masy on 13.04.20.
 //
 
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
 #include "cedar/ImageLoader.hpp"
+#include "cedar/AssetPack.hpp"
+#include "cedar/MappedFile.hpp"
+#include "cedar/ThreadPool.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -15,15 +29,294 @@ TextureLoadException::TextureLoadException(const std::string &message) : XExcept
 ImageLoader::ImageLoader()
 = default;
 
-Texture2D *ImageLoader::loadTexture(const std::string &path, const int forceComposition) {
+/**
+ * Reads a little endian 32 bit unsigned integer from a texture container.
+ *
+ * @param data A pointer to the integer.
+ * @return The integer.
+ */
+uint32_t readContainerUInt32(const unsigned char *data)
+{
+	uint32_t value;
+	std::memcpy(&value, data, sizeof(uint32_t));
+	return value;
+}
+
+/**
+ * Reads a little endian 64 bit unsigned integer from a texture container.
+ *
+ * @param data A pointer to the integer.
+ * @return The integer.
+ */
+uint64_t readContainerUInt64(const unsigned char *data)
+{
+	uint64_t value;
+	std::memcpy(&value, data, sizeof(uint64_t));
+	return value;
+}
+
+/**
+ * Gets the compressed internal format of the given DDS four character code.
+ *
+ * @param fourCC The four character code of the DDS pixel format.
+ * @return The compressed internal format or 0 if the code is not supported.
+ */
+int ddsFourCCToFormat(const uint32_t fourCC)
+{
+	char code[5] = {0};
+	std::memcpy(code, &fourCC, 4);
+	std::string codeString(code);
+	if (codeString == "DXT1")
+		return CEDAR_COMPRESSED_RGBA_S3TC_DXT1;
+	if (codeString == "DXT2" || codeString == "DXT3")
+		return CEDAR_COMPRESSED_RGBA_S3TC_DXT3;
+	if (codeString == "DXT4" || codeString == "DXT5")
+		return CEDAR_COMPRESSED_RGBA_S3TC_DXT5;
+	if (codeString == "ATI1" || codeString == "BC4U")
+		return CEDAR_COMPRESSED_RED_RGTC1;
+	if (codeString == "BC4S")
+		return CEDAR_COMPRESSED_SIGNED_RED_RGTC1;
+	if (codeString == "ATI2" || codeString == "BC5U")
+		return CEDAR_COMPRESSED_RG_RGTC2;
+	if (codeString == "BC5S")
+		return CEDAR_COMPRESSED_SIGNED_RG_RGTC2;
+	return 0;
+}
+
+/**
+ * Gets the compressed internal format of the given DXGI format of the DX10 DDS header.
+ *
+ * @param dxgiFormat The DXGI format.
+ * @return The compressed internal format or 0 if the format is not supported.
+ */
+int dxgiToFormat(const uint32_t dxgiFormat)
+{
+	switch (dxgiFormat)
+	{
+		case 71:
+			return CEDAR_COMPRESSED_RGBA_S3TC_DXT1;
+		case 72:
+			return CEDAR_COMPRESSED_SRGB_ALPHA_S3TC_DXT1;
+		case 74:
+			return CEDAR_COMPRESSED_RGBA_S3TC_DXT3;
+		case 75:
+			return CEDAR_COMPRESSED_SRGB_ALPHA_S3TC_DXT3;
+		case 77:
+			return CEDAR_COMPRESSED_RGBA_S3TC_DXT5;
+		case 78:
+			return CEDAR_COMPRESSED_SRGB_ALPHA_S3TC_DXT5;
+		case 80:
+			return CEDAR_COMPRESSED_RED_RGTC1;
+		case 81:
+			return CEDAR_COMPRESSED_SIGNED_RED_RGTC1;
+		case 83:
+			return CEDAR_COMPRESSED_RG_RGTC2;
+		case 84:
+			return CEDAR_COMPRESSED_SIGNED_RG_RGTC2;
+		case 95:
+			return CEDAR_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+		case 96:
+			return CEDAR_COMPRESSED_RGB_BPTC_SIGNED_FLOAT;
+		case 98:
+			return CEDAR_COMPRESSED_RGBA_BPTC_UNORM;
+		case 99:
+			return CEDAR_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Gets the compressed internal format of the given Vulkan format of a KTX2 file.
+ *
+ * @param vkFormat The Vulkan format.
+ * @return The compressed internal format or 0 if the format is not supported.
+ */
+int vkFormatToFormat(const uint32_t vkFormat)
+{
+	switch (vkFormat)
+	{
+		case 131:
+			return CEDAR_COMPRESSED_RGB_S3TC_DXT1;
+		case 132:
+			return CEDAR_COMPRESSED_SRGB_S3TC_DXT1;
+		case 133:
+			return CEDAR_COMPRESSED_RGBA_S3TC_DXT1;
+		case 134:
+			return CEDAR_COMPRESSED_SRGB_ALPHA_S3TC_DXT1;
+		case 135:
+			return CEDAR_COMPRESSED_RGBA_S3TC_DXT3;
+		case 136:
+			return CEDAR_COMPRESSED_SRGB_ALPHA_S3TC_DXT3;
+		case 137:
+			return CEDAR_COMPRESSED_RGBA_S3TC_DXT5;
+		case 138:
+			return CEDAR_COMPRESSED_SRGB_ALPHA_S3TC_DXT5;
+		case 139:
+			return CEDAR_COMPRESSED_RED_RGTC1;
+		case 140:
+			return CEDAR_COMPRESSED_SIGNED_RED_RGTC1;
+		case 141:
+			return CEDAR_COMPRESSED_RG_RGTC2;
+		case 142:
+			return CEDAR_COMPRESSED_SIGNED_RG_RGTC2;
+		case 143:
+			return CEDAR_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+		case 144:
+			return CEDAR_COMPRESSED_RGB_BPTC_SIGNED_FLOAT;
+		case 145:
+			return CEDAR_COMPRESSED_RGBA_BPTC_UNORM;
+		case 146:
+			return CEDAR_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Gets the size of a compressed mipmap level in bytes.
+ *
+ * @param width The width of the level in pixels.
+ * @param height The height of the level in pixels.
+ * @param blockSize The size of a 4x4 block in bytes.
+ * @return The size of the level in bytes.
+ */
+size_t compressedLevelSize(const int width, const int height, const unsigned int blockSize)
+{
+	return static_cast<size_t>((width + 3) / 4) * static_cast<size_t>((height + 3) / 4) * blockSize;
+}
+
+/**
+ * Averages a pair of rows into one row of half the width.
+ *
+ * @param row0 A pointer to the first row.
+ * @param row1 A pointer to the second row.
+ * @param width The width of the rows in pixels.
+ * @param channels The number of channels of the image.
+ * @param destination A pointer to the row the result is written to.
+ * @param sums A pointer to a buffer of <code>width * channels</code> shorts for the vertical sums.
+ */
+void downsampleRowPair(const unsigned char *row0, const unsigned char *row1, const int width, const int channels,
+					   unsigned char *destination, unsigned short *sums)
+{
+	size_t rowSize = static_cast<size_t>(width) * channels;
+	size_t n = 0;
+#if defined(__SSE2__)
+	const __m128i zero = _mm_setzero_si128();
+	for (; n + 16 <= rowSize; n += 16)
+	{
+		__m128i upper = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + n));
+		__m128i lower = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + n));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(sums + n),
+						 _mm_add_epi16(_mm_unpacklo_epi8(upper, zero), _mm_unpacklo_epi8(lower, zero)));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(sums + n + 8),
+						 _mm_add_epi16(_mm_unpackhi_epi8(upper, zero), _mm_unpackhi_epi8(lower, zero)));
+	}
+#endif
+	for (; n < rowSize; n++)
+		sums[n] = static_cast<unsigned short>(row0[n] + row1[n]);
+
+	int newWidth = std::max(1, width / 2);
+	for (int x = 0; x < newWidth; x++)
+	{
+		const unsigned short *left = sums + static_cast<size_t>(x) * 2 * channels;
+		const unsigned short *right = sums + static_cast<size_t>(std::min(x * 2 + 1, width - 1)) * channels;
+		for (int c = 0; c < channels; c++)
+			destination[x * channels + c] = static_cast<unsigned char>((left[c] + right[c] + 2) >> 2);
+	}
+}
+
+Texture2D *ImageLoader::loadTexture(const std::string &path, const int forceComposition, const bool generateMipmaps) {
+	if (isCompressedContainer(path))
+		return loadCompressedTexture(path);
+
+	// On the OpenGL thread the graphics card generates the mipmaps faster than the cpu could.
+	DecodedImage image = decodeImage(path, nullptr, forceComposition);
+	return createTexture(image, nullptr, generateMipmaps);
+}
+
+size_t ImageLoader::getMipmapChainSize(const int width, const int height, const int channels)
+{
+	size_t size = 0;
+	int levelWidth = width;
+	int levelHeight = height;
+	for (int level = Texture2D::getMipmapLevelCount(width, height); level > 0; level--)
+	{
+		size += static_cast<size_t>(levelWidth) * levelHeight * channels;
+		levelWidth = std::max(1, levelWidth / 2);
+		levelHeight = std::max(1, levelHeight / 2);
+	}
+	return size;
+}
+
+void ImageLoader::downsampleImage(const unsigned char *pixels, const int width, const int height, const int channels,
+								  unsigned char *destination)
+{
+	int newWidth = std::max(1, width / 2);
+	int newHeight = std::max(1, height / 2);
+	size_t rowSize = static_cast<size_t>(width) * channels;
+	size_t newRowSize = static_cast<size_t>(newWidth) * channels;
+
+	auto downsampleRows = [=](size_t firstRow, size_t lastRow) {
+		std::vector<unsigned short> sums(rowSize);
+		for (size_t y = firstRow; y < lastRow; y++)
+		{
+			const unsigned char *row0 = pixels + y * 2 * rowSize;
+			const unsigned char *row1 = pixels + std::min(y * 2 + 1, static_cast<size_t>(height - 1)) * rowSize;
+			downsampleRowPair(row0, row1, width, channels, destination + y * newRowSize, sums.data());
+		}
+	};
+
+	// Small levels are not worth the synchronization of the thread pool.
+	const size_t rowsPerTask = std::max(static_cast<size_t>(1), static_cast<size_t>(65536) / std::max(newRowSize, static_cast<size_t>(1)));
+	size_t taskCount = (newHeight + rowsPerTask - 1) / rowsPerTask;
+	if (taskCount <= 1)
+	{
+		downsampleRows(0, newHeight);
+		return;
+	}
+
+	ThreadPool::getInstance()->parallelFor(taskCount, [&](size_t task) {
+		downsampleRows(task * rowsPerTask, std::min((task + 1) * rowsPerTask, static_cast<size_t>(newHeight)));
+	});
+}
+
+DecodedImage ImageLoader::decodeImage(const std::string &path, PixelBufferRing *pixelBufferRing, const int forceComposition,
+									  const bool generateMipmaps)
+{
+	const unsigned char *packData;
+	size_t packDataSize;
+	if (AssetPack::findAsset(path, &packData, &packDataSize))
+		return decodeImage(path, packData, packDataSize, pixelBufferRing, forceComposition, generateMipmaps);
+
+	// The file is read in one go instead of letting stb pull it through small buffered reads.
+	std::ifstream imageFile(path, std::ios::binary | std::ios::ate);
+	if (!imageFile.good())
+		throw TextureLoadException("Could not load texture from file " + path + ". Does the file even exist?");
+
+	std::vector<unsigned char> fileData(static_cast<size_t>(imageFile.tellg()));
+	imageFile.seekg(0, std::ios::beg);
+	imageFile.read(reinterpret_cast<char *>(fileData.data()), static_cast<std::streamsize>(fileData.size()));
+	if (!imageFile.good())
+		throw TextureLoadException("Could not load texture from file " + path + ". The file could not be read!");
+
+	return decodeImage(path, fileData.data(), fileData.size(), pixelBufferRing, forceComposition, generateMipmaps);
+}
+
+DecodedImage ImageLoader::decodeImage(const std::string &path, const unsigned char *data, const size_t dataSize,
+									  PixelBufferRing *pixelBufferRing, const int forceComposition, const bool generateMipmaps)
+{
 	int width;
 	int height;
 	int composition;
 
-	unsigned char * imageData = stbi_load(path.c_str(), &width, &height, &composition, forceComposition);
-
+	unsigned char *imageData = stbi_load_from_memory(data, static_cast<int>(dataSize), &width, &height, &composition, forceComposition);
 	if (!imageData)
-		throw TextureLoadException("Could not load texture from file " + path + ". Does the file even exist?");
+		throw TextureLoadException("Could not load texture from file " + path + ". " + stbi_failure_reason());
+
+	// stb reports the composition of the file, not the forced one.
+	if (forceComposition != 0)
+		composition = forceComposition;
 
 	int internalFormat;
 	switch (composition)
@@ -49,8 +342,309 @@ Texture2D *ImageLoader::loadTexture(const std::string &path, const int forceComp
 			throw TextureLoadException("Could not load texture from file " + path + ". Invalid composition! " + std::to_string(composition));
 	}
 
-	Texture2D *texture = new Texture2D(width, height, internalFormat, CEDAR_TEXTURE_2D);
-	texture->init(Texture::sizedToUnsized(internalFormat), CEDAR_UNSIGNED_BYTE, imageData);
-	stbi_image_free(imageData);
+	DecodedImage image = {width, height, internalFormat, {0, 0, nullptr}, imageData, 1};
+	size_t imageSize = static_cast<size_t>(width) * height * composition;
+	int levelCount = Texture2D::getMipmapLevelCount(width, height);
+	if (generateMipmaps && levelCount > 1)
+	{
+		// stb allocates with malloc, so the chain can be released with stbi_image_free like the decoded image.
+		size_t chainSize = getMipmapChainSize(width, height, composition);
+		auto *chain = static_cast<unsigned char *>(std::malloc(chainSize));
+		if (!chain)
+		{
+			stbi_image_free(imageData);
+			throw TextureLoadException("Could not load texture from file " + path + ". Out of memory for the mipmap chain!");
+		}
+
+		std::memcpy(chain, imageData, imageSize);
+		stbi_image_free(imageData);
+
+		unsigned char *level = chain;
+		int levelWidth = width;
+		int levelHeight = height;
+		for (int n = 1; n < levelCount; n++)
+		{
+			unsigned char *nextLevel = level + static_cast<size_t>(levelWidth) * levelHeight * composition;
+			downsampleImage(level, levelWidth, levelHeight, composition, nextLevel);
+			level = nextLevel;
+			levelWidth = std::max(1, levelWidth / 2);
+			levelHeight = std::max(1, levelHeight / 2);
+		}
+
+		imageData = chain;
+		imageSize = chainSize;
+		image.m_pixels = chain;
+		image.m_levels = levelCount;
+	}
+
+	if (pixelBufferRing)
+	{
+		image.m_allocation = pixelBufferRing->allocate(imageSize);
+		if (image.m_allocation.m_data)
+		{
+			std::memcpy(image.m_allocation.m_data, imageData, imageSize);
+			stbi_image_free(imageData);
+			image.m_pixels = nullptr;
+		}
+	}
+
+	return image;
+}
+
+Texture2D *ImageLoader::createTexture(DecodedImage &image, PixelBufferRing *pixelBufferRing, const bool generateMipmaps)
+{
+	Texture2D *texture = nullptr;
+	try
+	{
+		texture = new Texture2D(image.m_width, image.m_height, image.m_internalFormat, CEDAR_TEXTURE_2D);
+		unsigned int format = Texture::sizedToUnsized(image.m_internalFormat);
+		bool inPixelBuffer = image.m_allocation.m_data && pixelBufferRing;
+		int levelCount = image.m_levels;
+		if (levelCount == 1 && generateMipmaps)
+			levelCount = Texture2D::getMipmapLevelCount(image.m_width, image.m_height);
+
+		if (inPixelBuffer || levelCount > 1)
+		{
+			texture->reserve(levelCount);
+
+			int channels = 1;
+			switch (format)
+			{
+				case CEDAR_RG:
+					channels = 2;
+					break;
+
+				case CEDAR_RGB:
+					channels = 3;
+					break;
+
+				case CEDAR_RGBA:
+					channels = 4;
+					break;
+
+				default:
+					break;
+			}
+
+			size_t offset = 0;
+			int levelWidth = image.m_width;
+			int levelHeight = image.m_height;
+			for (int level = 0; level < image.m_levels; level++)
+			{
+				if (inPixelBuffer)
+					texture->uploadFromPixelBuffer(0, 0, levelWidth, levelHeight, format, CEDAR_UNSIGNED_BYTE,
+												   pixelBufferRing->getBufferId(), image.m_allocation.m_offset + offset, level);
+				else
+					texture->upload(0, 0, levelWidth, levelHeight, format, CEDAR_UNSIGNED_BYTE, image.m_pixels + offset, level);
+
+				offset += static_cast<size_t>(levelWidth) * levelHeight * channels;
+				levelWidth = std::max(1, levelWidth / 2);
+				levelHeight = std::max(1, levelHeight / 2);
+			}
+
+			if (image.m_levels < levelCount)
+				texture->generateMipmaps();
+			else if (levelCount > 1)
+				texture->setParameteri(CEDAR_TEXTURE_MIN_FILTER, CEDAR_LINEAR_MIPMAP_LINEAR);
+		}
+		else
+		{
+			texture->init(format, CEDAR_UNSIGNED_BYTE, image.m_pixels);
+		}
+	}
+	catch (...)
+	{
+		delete texture;
+		freeImage(image, pixelBufferRing);
+		throw;
+	}
+
+	freeImage(image, pixelBufferRing);
+	return texture;
+}
+
+void ImageLoader::freeImage(DecodedImage &image, PixelBufferRing *pixelBufferRing)
+{
+	if (image.m_allocation.m_data && pixelBufferRing)
+		pixelBufferRing->release(image.m_allocation);
+	image.m_allocation = {0, 0, nullptr};
+
+	if (image.m_pixels)
+		stbi_image_free(image.m_pixels);
+	image.m_pixels = nullptr;
+}
+
+bool ImageLoader::isCompressedContainer(const std::string &path)
+{
+	size_t extensionStart = path.find_last_of('.');
+	if (extensionStart == std::string::npos)
+		return false;
+
+	std::string extension = path.substr(extensionStart + 1);
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	return extension == "dds" || extension == "ktx2";
+}
+
+Texture2D *ImageLoader::loadCompressedTexture(const std::string &path)
+{
+	const unsigned char *packData;
+	size_t packDataSize;
+	if (AssetPack::findAsset(path, &packData, &packDataSize))
+		return createCompressedTexture(parseCompressedImage(path, packData, packDataSize));
+
+	try
+	{
+		// The blocks are uploaded straight from the mapping, the file is never copied into client memory.
+		MappedFile file(path, true);
+		return createCompressedTexture(parseCompressedImage(path, file.getData(), file.getSize()));
+	}
+	catch (const FileMapException &exception)
+	{
+		throw TextureLoadException("Could not load texture from file " + path + ". " + exception.what());
+	}
+}
+
+CompressedImage ImageLoader::parseCompressedImage(const std::string &path, const unsigned char *data, const size_t dataSize)
+{
+	CompressedImage image = {0, 0, 0, {}};
+	size_t levelCount;
+
+	if (dataSize >= CEDAR_DDS_HEADER_SIZE && std::memcmp(data, CEDAR_DDS_MAGIC, 4) == 0)
+	{
+		if (readContainerUInt32(data + 4) != 124)
+			throw TextureLoadException("Could not load texture from file " + path + ". Invalid DDS header!");
+
+		image.m_height = static_cast<int>(readContainerUInt32(data + 12));
+		image.m_width = static_cast<int>(readContainerUInt32(data + 16));
+		// Writers may leave the mipmap count uninitialized if the mipmap count flag is not set.
+		levelCount = readContainerUInt32(data + 8) & 0x20000u ? std::max(1u, readContainerUInt32(data + 28)) : 1;
+		uint32_t fourCC = readContainerUInt32(data + 84);
+		uint32_t caps2 = readContainerUInt32(data + 112);
+		size_t dataOffset = CEDAR_DDS_HEADER_SIZE;
+
+		// Cube map flag.
+		if (caps2 & 0x200u)
+			throw TextureLoadException("Could not load texture from file " + path + ". Cube maps are not supported!");
+
+		if (std::memcmp(&fourCC, "DX10", 4) == 0)
+		{
+			if (dataSize < CEDAR_DDS_HEADER_SIZE + CEDAR_DDS_DX10_HEADER_SIZE)
+				throw TextureLoadException("Could not load texture from file " + path + ". The DX10 header is truncated!");
+
+			if (readContainerUInt32(data + CEDAR_DDS_HEADER_SIZE + 12) > 1)
+				throw TextureLoadException("Could not load texture from file " + path + ". Texture arrays are not supported!");
+
+			image.m_internalFormat = dxgiToFormat(readContainerUInt32(data + CEDAR_DDS_HEADER_SIZE));
+			dataOffset += CEDAR_DDS_DX10_HEADER_SIZE;
+		}
+		else
+		{
+			image.m_internalFormat = ddsFourCCToFormat(fourCC);
+		}
+
+		if (image.m_internalFormat == 0)
+			throw TextureLoadException("Could not load texture from file " + path + ". Unsupported DDS pixel format!");
+
+		if (image.m_width <= 0 || image.m_height <= 0)
+			throw TextureLoadException("Could not load texture from file " + path + ". Invalid texture size!");
+
+		if (levelCount > static_cast<size_t>(Texture2D::getMipmapLevelCount(image.m_width, image.m_height)))
+			throw TextureLoadException("Could not load texture from file " + path + ". The mipmap count is larger than the mipmap chain!");
+
+		// DDS stores the levels back to back, starting with the full resolution.
+		unsigned int blockSize = Texture::getCompressedBlockSize(image.m_internalFormat);
+		int levelWidth = image.m_width;
+		int levelHeight = image.m_height;
+		for (size_t level = 0; level < levelCount; level++)
+		{
+			size_t levelSize = compressedLevelSize(levelWidth, levelHeight, blockSize);
+			if (dataOffset + levelSize > dataSize)
+				throw TextureLoadException("Could not load texture from file " + path + ". The mipmap chain is truncated!");
+
+			image.m_levels.push_back({levelWidth, levelHeight, data + dataOffset, levelSize});
+			dataOffset += levelSize;
+			levelWidth = std::max(1, levelWidth / 2);
+			levelHeight = std::max(1, levelHeight / 2);
+		}
+	}
+	else if (dataSize >= CEDAR_KTX2_HEADER_SIZE && std::memcmp(data, CEDAR_KTX2_IDENTIFIER, 12) == 0)
+	{
+		image.m_internalFormat = vkFormatToFormat(readContainerUInt32(data + 12));
+		image.m_width = static_cast<int>(readContainerUInt32(data + 20));
+		image.m_height = static_cast<int>(readContainerUInt32(data + 24));
+		uint32_t depth = readContainerUInt32(data + 28);
+		uint32_t layerCount = readContainerUInt32(data + 32);
+		uint32_t faceCount = readContainerUInt32(data + 36);
+		levelCount = std::max(1u, readContainerUInt32(data + 40));
+		uint32_t supercompressionScheme = readContainerUInt32(data + 44);
+
+		if (image.m_internalFormat == 0)
+			throw TextureLoadException("Could not load texture from file " + path + ". Unsupported KTX2 format!");
+
+		if (supercompressionScheme != 0)
+			throw TextureLoadException("Could not load texture from file " + path + ". Supercompressed KTX2 files are not supported!");
+
+		if (depth > 1 || layerCount > 1 || faceCount != 1)
+			throw TextureLoadException("Could not load texture from file " + path + ". Only 2D textures are supported!");
+
+		if (image.m_width <= 0 || image.m_height <= 0)
+			throw TextureLoadException("Could not load texture from file " + path + ". Invalid texture size!");
+
+		if (levelCount > static_cast<size_t>(Texture2D::getMipmapLevelCount(image.m_width, image.m_height)))
+			throw TextureLoadException("Could not load texture from file " + path + ". The mipmap count is larger than the mipmap chain!");
+
+		if (CEDAR_KTX2_HEADER_SIZE + levelCount * 24 > dataSize)
+			throw TextureLoadException("Could not load texture from file " + path + ". The level index is truncated!");
+
+		// The level index always starts with the full resolution, even though the data is stored smallest level first.
+		unsigned int blockSize = Texture::getCompressedBlockSize(image.m_internalFormat);
+		int levelWidth = image.m_width;
+		int levelHeight = image.m_height;
+		for (size_t level = 0; level < levelCount; level++)
+		{
+			const unsigned char *levelIndex = data + CEDAR_KTX2_HEADER_SIZE + level * 24;
+			uint64_t levelOffset = readContainerUInt64(levelIndex);
+			uint64_t levelSize = readContainerUInt64(levelIndex + 8);
+			if (levelOffset > dataSize || levelSize > dataSize - levelOffset)
+				throw TextureLoadException("Could not load texture from file " + path + ". The mipmap chain is truncated!");
+
+			if (levelSize < compressedLevelSize(levelWidth, levelHeight, blockSize))
+				throw TextureLoadException("Could not load texture from file " + path + ". Invalid size of level " + std::to_string(level) + "!");
+
+			image.m_levels.push_back({levelWidth, levelHeight, data + levelOffset, static_cast<size_t>(levelSize)});
+			levelWidth = std::max(1, levelWidth / 2);
+			levelHeight = std::max(1, levelHeight / 2);
+		}
+	}
+	else
+	{
+		throw TextureLoadException("Could not load texture from file " + path + ". The file is neither a DDS nor a KTX2 file!");
+	}
+
+	return image;
+}
+
+Texture2D *ImageLoader::createCompressedTexture(const CompressedImage &image)
+{
+	auto *texture = new Texture2D(image.m_width, image.m_height, image.m_internalFormat, CEDAR_TEXTURE_2D);
+	try
+	{
+		texture->reserve(static_cast<int>(image.m_levels.size()));
+		for (size_t level = 0; level < image.m_levels.size(); level++)
+		{
+			const CompressedImageLevel &imageLevel = image.m_levels[level];
+			texture->uploadCompressed(0, 0, imageLevel.m_width, imageLevel.m_height, static_cast<int>(imageLevel.m_size),
+									  imageLevel.m_data, static_cast<int>(level));
+		}
+
+		if (image.m_levels.size() > 1)
+			texture->setParameteri(CEDAR_TEXTURE_MIN_FILTER, CEDAR_LINEAR_MIPMAP_LINEAR);
+	}
+	catch (...)
+	{
+		delete texture;
+		throw;
+	}
+
 	return texture;
 }
@@ -0,0 +1,166 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include "cedar/PixelBufferRing.hpp"
+#include "glad/glad.h"
+
+using namespace cedar;
+
+PixelBufferException::PixelBufferException(const std::string &message) : XException(message)
+{}
+
+PixelBufferRing::PixelBufferRing(const size_t capacity)
+{
+	if (capacity == 0)
+		throw PixelBufferException("Could not create pixel buffer ring. The capacity must be greater than 0!");
+
+	this->m_capacity = capacity;
+	this->m_head = 0;
+	this->m_tail = 0;
+	this->m_used = 0;
+	this->m_bufferId = 0;
+
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glGenBuffers(1, &this->m_bufferId);
+	if (this->m_bufferId == 0)
+		throw PixelBufferException("Could not create pixel buffer ring. Could not generate buffer ID!");
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, this->m_bufferId);
+	glBufferStorage(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(capacity), nullptr, flags);
+	this->m_mappedData = static_cast<unsigned char *>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(capacity), flags));
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if (!this->m_mappedData)
+	{
+		glDeleteBuffers(1, &this->m_bufferId);
+		throw PixelBufferException("Could not create pixel buffer ring. The buffer could not be mapped persistently!");
+	}
+}
+
+PixelBufferRing::~PixelBufferRing()
+{
+	for (const Block &block : this->m_blocks)
+	{
+		if (block.m_fence)
+			glDeleteSync(static_cast<GLsync>(block.m_fence));
+	}
+
+	glUnmapNamedBuffer(this->m_bufferId);
+	glDeleteBuffers(1, &this->m_bufferId);
+}
+
+PixelBufferAllocation PixelBufferRing::allocate(const size_t size)
+{
+	PixelBufferAllocation allocation = {0, 0, nullptr};
+	size_t alignedSize = (size + CEDAR_PIXEL_BUFFER_RING_ALIGNMENT - 1) & ~static_cast<size_t>(CEDAR_PIXEL_BUFFER_RING_ALIGNMENT - 1);
+	if (alignedSize == 0 || alignedSize > this->m_capacity)
+		return allocation;
+
+	std::lock_guard<std::mutex> lock(this->m_mutex);
+
+	if (this->m_used == 0)
+	{
+		this->m_head = 0;
+		this->m_tail = 0;
+	}
+
+	size_t offset;
+	if (this->m_head >= this->m_tail && (this->m_head != this->m_tail || this->m_used == 0))
+	{
+		// The free space is split into the end and the start of the buffer.
+		if (this->m_capacity - this->m_head >= alignedSize)
+		{
+			offset = this->m_head;
+		}
+		else if (this->m_tail >= alignedSize)
+		{
+			// Skip the end of the buffer, the padding is reclaimed together with the block in front of it.
+			size_t paddingSize = this->m_capacity - this->m_head;
+			if (paddingSize > 0)
+			{
+				this->m_blocks.push_back({this->m_head, paddingSize, true, nullptr});
+				this->m_used += paddingSize;
+			}
+			offset = 0;
+		}
+		else
+		{
+			return allocation;
+		}
+	}
+	else if (this->m_head < this->m_tail && this->m_tail - this->m_head >= alignedSize)
+	{
+		offset = this->m_head;
+	}
+	else
+	{
+		return allocation;
+	}
+
+	this->m_blocks.push_back({offset, alignedSize, false, nullptr});
+	this->m_head = (offset + alignedSize) % this->m_capacity;
+	this->m_used += alignedSize;
+
+	allocation.m_offset = offset;
+	allocation.m_size = size;
+	allocation.m_data = this->m_mappedData + offset;
+	return allocation;
+}
+
+void PixelBufferRing::release(const PixelBufferAllocation &allocation)
+{
+	if (!allocation.m_data)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(this->m_mutex);
+		for (Block &block : this->m_blocks)
+		{
+			if (block.m_offset == allocation.m_offset && !block.m_released)
+			{
+				block.m_released = true;
+				block.m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+				break;
+			}
+		}
+	}
+
+	this->reclaim();
+}
+
+void PixelBufferRing::reclaim()
+{
+	std::lock_guard<std::mutex> lock(this->m_mutex);
+
+	// Blocks are reclaimed in allocation order, so a block that is still written or read keeps the ones after it.
+	while (!this->m_blocks.empty())
+	{
+		Block &block = this->m_blocks.front();
+		if (!block.m_released)
+			break;
+
+		if (block.m_fence)
+		{
+			auto fence = static_cast<GLsync>(block.m_fence);
+			GLenum result = glClientWaitSync(fence, 0, 0);
+			if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+				break;
+			glDeleteSync(fence);
+		}
+
+		this->m_tail = (block.m_offset + block.m_size) % this->m_capacity;
+		this->m_used -= block.m_size;
+		this->m_blocks.pop_front();
+	}
+}
+
+unsigned int PixelBufferRing::getBufferId() const
+{
+	return this->m_bufferId;
+}
+
+size_t PixelBufferRing::getCapacity() const
+{
+	return this->m_capacity;
+}
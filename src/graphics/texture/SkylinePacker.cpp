@@ -0,0 +1,116 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <algorithm>
+#include <climits>
+
+#include "cedar/SkylinePacker.hpp"
+
+using namespace cedar;
+
+SkylinePacker::SkylinePacker(const int width, const int height)
+{
+	this->m_width = width;
+	this->m_height = height;
+	this->clear();
+}
+
+int SkylinePacker::findPosition(const int width, const int height, int *x, int *y) const
+{
+	int bestIndex = -1;
+	int bestBottom = INT_MAX;
+	int bestWidth = INT_MAX;
+	for (size_t n = 0; n < this->m_skyline.size(); n++)
+	{
+		if (this->m_skyline[n].m_x + width > this->m_width)
+			break;
+
+		// The rectangle rests on the highest segment it spans.
+		int top = 0;
+		int widthLeft = width;
+		size_t index = n;
+		while (widthLeft > 0)
+		{
+			top = std::max(top, this->m_skyline[index].m_y);
+			widthLeft -= this->m_skyline[index].m_width;
+			index++;
+		}
+
+		if (top + height > this->m_height)
+			continue;
+
+		if (top + height < bestBottom || (top + height == bestBottom && this->m_skyline[n].m_width < bestWidth))
+		{
+			bestIndex = static_cast<int>(n);
+			bestBottom = top + height;
+			bestWidth = this->m_skyline[n].m_width;
+			*x = this->m_skyline[n].m_x;
+			*y = top;
+		}
+	}
+
+	return bestIndex;
+}
+
+bool SkylinePacker::insert(const int width, const int height, int *x, int *y)
+{
+	if (width <= 0 || height <= 0)
+		return false;
+
+	int nodeIndex = this->findPosition(width, height, x, y);
+	if (nodeIndex == -1)
+		return false;
+
+	this->m_skyline.insert(this->m_skyline.begin() + nodeIndex, {*x, *y + height, width});
+
+	// Cut the segments that are now covered by the rectangle.
+	for (size_t n = nodeIndex + 1; n < this->m_skyline.size();)
+	{
+		const SkylineNode &previous = this->m_skyline[n - 1];
+		int overlap = previous.m_x + previous.m_width - this->m_skyline[n].m_x;
+		if (overlap <= 0)
+			break;
+
+		if (this->m_skyline[n].m_width <= overlap)
+		{
+			this->m_skyline.erase(this->m_skyline.begin() + static_cast<long>(n));
+			continue;
+		}
+
+		this->m_skyline[n].m_x += overlap;
+		this->m_skyline[n].m_width -= overlap;
+		break;
+	}
+
+	for (size_t n = 1; n < this->m_skyline.size();)
+	{
+		if (this->m_skyline[n - 1].m_y == this->m_skyline[n].m_y)
+		{
+			this->m_skyline[n - 1].m_width += this->m_skyline[n].m_width;
+			this->m_skyline.erase(this->m_skyline.begin() + static_cast<long>(n));
+		}
+		else
+		{
+			n++;
+		}
+	}
+
+	return true;
+}
+
+void SkylinePacker::clear()
+{
+	this->m_skyline.clear();
+	this->m_skyline.push_back({0, 0, this->m_width});
+}
+
+int SkylinePacker::getWidth() const
+{
+	return this->m_width;
+}
+
+int SkylinePacker::getHeight() const
+{
+	return this->m_height;
+}
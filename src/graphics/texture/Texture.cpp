@@ -41,6 +41,8 @@ unsigned int Texture::sizedToUnsized(const unsigned int sizedInternalFormat)
 		case CEDAR_R32UI:
 		case CEDAR_R32I:
 		case CEDAR_R32F:
+		case CEDAR_COMPRESSED_RED_RGTC1:
+		case CEDAR_COMPRESSED_SIGNED_RED_RGTC1:
 			return CEDAR_RED;
 
 		case CEDAR_RG8:
@@ -55,6 +57,8 @@ unsigned int Texture::sizedToUnsized(const unsigned int sizedInternalFormat)
 		case CEDAR_RG32UI:
 		case CEDAR_RG32I:
 		case CEDAR_RG32F:
+		case CEDAR_COMPRESSED_RG_RGTC2:
+		case CEDAR_COMPRESSED_SIGNED_RG_RGTC2:
 			return CEDAR_RG;
 
 		case CEDAR_RGB8:
@@ -69,6 +73,10 @@ unsigned int Texture::sizedToUnsized(const unsigned int sizedInternalFormat)
 		case CEDAR_RGB32UI:
 		case CEDAR_RGB32I:
 		case CEDAR_RGB32F:
+		case CEDAR_COMPRESSED_RGB_S3TC_DXT1:
+		case CEDAR_COMPRESSED_SRGB_S3TC_DXT1:
+		case CEDAR_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+		case CEDAR_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
 			return CEDAR_RGB;
 
 		case CEDAR_RGBA8:
@@ -83,6 +91,14 @@ unsigned int Texture::sizedToUnsized(const unsigned int sizedInternalFormat)
 		case CEDAR_RGBA32UI:
 		case CEDAR_RGBA32I:
 		case CEDAR_RGBA32F:
+		case CEDAR_COMPRESSED_RGBA_S3TC_DXT1:
+		case CEDAR_COMPRESSED_RGBA_S3TC_DXT3:
+		case CEDAR_COMPRESSED_RGBA_S3TC_DXT5:
+		case CEDAR_COMPRESSED_SRGB_ALPHA_S3TC_DXT1:
+		case CEDAR_COMPRESSED_SRGB_ALPHA_S3TC_DXT3:
+		case CEDAR_COMPRESSED_SRGB_ALPHA_S3TC_DXT5:
+		case CEDAR_COMPRESSED_RGBA_BPTC_UNORM:
+		case CEDAR_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
 			return CEDAR_RGBA;
 
 		case CEDAR_DEPTH_COMPONENT16:
@@ -104,12 +120,172 @@ unsigned int Texture::sizedToUnsized(const unsigned int sizedInternalFormat)
 	}
 }
 
+unsigned int Texture::getCompressedBlockSize(const unsigned int internalFormat)
+{
+	switch (internalFormat)
+	{
+		case CEDAR_COMPRESSED_RGB_S3TC_DXT1:
+		case CEDAR_COMPRESSED_RGBA_S3TC_DXT1:
+		case CEDAR_COMPRESSED_SRGB_S3TC_DXT1:
+		case CEDAR_COMPRESSED_SRGB_ALPHA_S3TC_DXT1:
+		case CEDAR_COMPRESSED_RED_RGTC1:
+		case CEDAR_COMPRESSED_SIGNED_RED_RGTC1:
+			return 8;
+
+		case CEDAR_COMPRESSED_RGBA_S3TC_DXT3:
+		case CEDAR_COMPRESSED_RGBA_S3TC_DXT5:
+		case CEDAR_COMPRESSED_SRGB_ALPHA_S3TC_DXT3:
+		case CEDAR_COMPRESSED_SRGB_ALPHA_S3TC_DXT5:
+		case CEDAR_COMPRESSED_RG_RGTC2:
+		case CEDAR_COMPRESSED_SIGNED_RG_RGTC2:
+		case CEDAR_COMPRESSED_RGBA_BPTC_UNORM:
+		case CEDAR_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+		case CEDAR_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+		case CEDAR_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+			return 16;
+
+		default:
+			return 0;
+	}
+}
+
+bool Texture::isCompressedFormat(const unsigned int internalFormat)
+{
+	return getCompressedBlockSize(internalFormat) != 0;
+}
+
+bool Texture::isIntegerFormat(const unsigned int internalFormat)
+{
+	switch (internalFormat)
+	{
+		case CEDAR_R8UI:
+		case CEDAR_RG8UI:
+		case CEDAR_RGB8UI:
+		case CEDAR_RGBA8UI:
+		case CEDAR_R8I:
+		case CEDAR_RG8I:
+		case CEDAR_RGB8I:
+		case CEDAR_RGBA8I:
+		case CEDAR_R16UI:
+		case CEDAR_RG16UI:
+		case CEDAR_RGB16UI:
+		case CEDAR_RGBA16UI:
+		case CEDAR_R16I:
+		case CEDAR_RG16I:
+		case CEDAR_RGB16I:
+		case CEDAR_RGBA16I:
+		case CEDAR_R32UI:
+		case CEDAR_RG32UI:
+		case CEDAR_RGB32UI:
+		case CEDAR_RGBA32UI:
+		case CEDAR_R32I:
+		case CEDAR_RG32I:
+		case CEDAR_RGB32I:
+		case CEDAR_RGBA32I:
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+unsigned int Texture::getBytesPerPixel(const unsigned int internalFormat)
+{
+	switch (internalFormat)
+	{
+		case CEDAR_R8:
+		case CEDAR_R8_SNORM:
+		case CEDAR_R8UI:
+		case CEDAR_R8I:
+		case CEDAR_RED:
+		case CEDAR_STENCIL_INDEX1:
+		case CEDAR_STENCIL_INDEX4:
+		case CEDAR_STENCIL_INDEX8:
+		case CEDAR_STENCIL_INDEX:
+			return 1;
+
+		case CEDAR_RG8:
+		case CEDAR_RG8_SNORM:
+		case CEDAR_RG8UI:
+		case CEDAR_RG8I:
+		case CEDAR_RG:
+		case CEDAR_R16:
+		case CEDAR_R16_SNORM:
+		case CEDAR_R16UI:
+		case CEDAR_R16I:
+		case CEDAR_R16F:
+		case CEDAR_DEPTH_COMPONENT16:
+		case CEDAR_STENCIL_INDEX16:
+			return 2;
+
+		case CEDAR_RGB8:
+		case CEDAR_RGB8_SNORM:
+		case CEDAR_RGB8UI:
+		case CEDAR_RGB8I:
+		case CEDAR_RGB:
+		case CEDAR_DEPTH_COMPONENT24:
+			return 3;
+
+		case CEDAR_RGBA8:
+		case CEDAR_RGBA8_SNORM:
+		case CEDAR_RGBA8UI:
+		case CEDAR_RGBA8I:
+		case CEDAR_RGBA:
+		case CEDAR_RG16:
+		case CEDAR_RG16_SNORM:
+		case CEDAR_RG16UI:
+		case CEDAR_RG16I:
+		case CEDAR_RG16F:
+		case CEDAR_R32UI:
+		case CEDAR_R32I:
+		case CEDAR_R32F:
+		case CEDAR_DEPTH_COMPONENT32:
+		case CEDAR_DEPTH_COMPONENT32F:
+		case CEDAR_DEPTH24_STENCIL8:
+		case CEDAR_DEPTH_COMPONENT:
+		case CEDAR_DEPTH_STENCIL:
+			return 4;
+
+		case CEDAR_RGB16:
+		case CEDAR_RGB16_SNORM:
+		case CEDAR_RGB16UI:
+		case CEDAR_RGB16I:
+		case CEDAR_RGB16F:
+			return 6;
+
+		case CEDAR_RGBA16:
+		case CEDAR_RGBA16_SNORM:
+		case CEDAR_RGBA16UI:
+		case CEDAR_RGBA16I:
+		case CEDAR_RGBA16F:
+		case CEDAR_RG32UI:
+		case CEDAR_RG32I:
+		case CEDAR_RG32F:
+		case CEDAR_DEPTH32F_STENCIL8:
+			return 8;
+
+		case CEDAR_RGB32UI:
+		case CEDAR_RGB32I:
+		case CEDAR_RGB32F:
+			return 12;
+
+		case CEDAR_RGBA32UI:
+		case CEDAR_RGBA32I:
+		case CEDAR_RGBA32F:
+			return 16;
+
+		default:
+			return isCompressedFormat(internalFormat) ? 0 : 4;
+	}
+}
+
 Texture::Texture(const int internalFormat, const unsigned int target)
 {
 	this->m_textureId = 0;
 	this->m_target = target;
 	this->m_internalFormat = internalFormat;
 	this->m_immutable = false;
+	this->m_lastUsedFrame = 0;
 
 	switch (internalFormat)
 	{
@@ -184,6 +360,21 @@ bool Texture::isImmutable() const
 	return this->m_immutable;
 }
 
+size_t Texture::getMemorySize() const
+{
+	return 0;
+}
+
+void Texture::markUsed(const unsigned long long frame) const
+{
+	this->m_lastUsedFrame = frame;
+}
+
+unsigned long long Texture::getLastUsedFrame() const
+{
+	return this->m_lastUsedFrame;
+}
+
 void Texture::setParameteri(const unsigned int parameter, const int value) const
 {
 	if (this->m_textureId == 0)
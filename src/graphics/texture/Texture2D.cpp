@@ -2,6 +2,8 @@
 // Created by masy on 23.02.20.
 //
 
+#include <algorithm>
+
 #include "cedar/Texture2D.hpp"
 #include "glad/glad.h"
 
@@ -152,9 +154,10 @@ void Texture2D::upload(int offsetX, int offsetY, int width, int height, unsigned
 	if (level < 0)
 		throw TextureUploadException("Could not upload data to Texture2D. The level must be positive!");
 
-	if (this->m_reservedLevels != 0 && level < this->m_reservedLevels)
+	if (this->m_reservedLevels != 0 && level >= this->m_reservedLevels)
 		throw TextureUploadException("Could not upload data to Texture2D. The given level is greater than the reserved number of levels!");
 
+	// Rows are tightly packed, which an alignment of 3 can't express since only powers of two are valid.
 	int alignment;
 	switch (format)
 	{
@@ -164,7 +167,7 @@ void Texture2D::upload(int offsetX, int offsetY, int width, int height, unsigned
 			break;
 
 		case CEDAR_RGB:
-			alignment = 3;
+			alignment = 1;
 			break;
 
 		case CEDAR_RGBA:
@@ -181,6 +184,47 @@ void Texture2D::upload(int offsetX, int offsetY, int width, int height, unsigned
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 }
 
+void Texture2D::uploadFromPixelBuffer(const int offsetX, const int offsetY, const int width, const int height, const unsigned int format,
+									  const unsigned int type, const unsigned int pixelBufferId, const size_t pixelBufferOffset, const int level)
+{
+	if (pixelBufferId == 0)
+		throw TextureUploadException("Could not upload data to Texture2D. The pixel buffer is not initialized!");
+
+	// While a pixel unpack buffer is bound the data pointer is interpreted as an offset into the buffer.
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBufferId);
+	try
+	{
+		this->upload(offsetX, offsetY, width, height, format, type, reinterpret_cast<const void *>(pixelBufferOffset), level);
+	}
+	catch (const TextureUploadException &)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		throw;
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void Texture2D::uploadCompressed(const int offsetX, const int offsetY, const int width, const int height, const int dataSize,
+								 const void *data, const int level)
+{
+	if (this->m_textureId == 0)
+		throw TextureUploadException("Could not upload compressed data to Texture2D. Texture is not initialized!");
+
+	if (!isCompressedFormat(this->m_internalFormat))
+		throw TextureUploadException("Could not upload compressed data to Texture2D. The internal format is not a compressed format!");
+
+	if (width <= 0 || height <= 0)
+		throw TextureUploadException("Could not upload compressed data to Texture2D. The width and height must be greater than 0!");
+
+	if (level < 0)
+		throw TextureUploadException("Could not upload compressed data to Texture2D. The level must be positive!");
+
+	if (this->m_reservedLevels != 0 && level >= this->m_reservedLevels)
+		throw TextureUploadException("Could not upload compressed data to Texture2D. The given level is greater than the reserved number of levels!");
+
+	glCompressedTextureSubImage2D(this->m_textureId, level, offsetX, offsetY, width, height, this->m_internalFormat, dataSize, data);
+}
+
 int Texture2D::getWidth() const
 {
 	return this->m_width;
@@ -228,7 +272,7 @@ void Texture2D::setSize(int newWidth, int newHeight, bool keepData)
 
 				case CEDAR_RGB:
 					bufferSize *= 3;
-					alignment = 3;
+					alignment = 1;
 					break;
 
 				case CEDAR_RGBA:
@@ -288,3 +332,133 @@ int Texture2D::getReservedLevels() const
 {
 	return this->m_reservedLevels;
 }
+
+void Texture2D::generateMipmaps() const
+{
+	if (this->m_textureId == 0)
+		throw TextureException("Could not generate mipmaps of Texture2D. Texture is not initialized!");
+
+	if (this->m_samples > 1)
+		throw TextureException("Could not generate mipmaps of Texture2D. Multisampled textures don't have mipmaps!");
+
+	glGenerateTextureMipmap(this->m_textureId);
+	glTextureParameteri(this->m_textureId, CEDAR_TEXTURE_MIN_FILTER, CEDAR_LINEAR_MIPMAP_LINEAR);
+}
+
+int Texture2D::getMipmapLevelCount(int width, int height)
+{
+	int levels = 1;
+	int size = std::max(width, height);
+	while (size > 1)
+	{
+		size /= 2;
+		levels++;
+	}
+	return levels;
+}
+
+size_t Texture2D::getMemorySize() const
+{
+	if (this->m_textureId == 0)
+		return 0;
+
+	unsigned int blockSize = getCompressedBlockSize(this->m_internalFormat);
+	unsigned int bytesPerPixel = getBytesPerPixel(this->m_internalFormat);
+	size_t size = 0;
+	int levelWidth = this->m_width;
+	int levelHeight = this->m_height;
+	for (int level = std::max(1, this->m_reservedLevels); level > 0; level--)
+	{
+		if (blockSize != 0)
+			size += static_cast<size_t>((levelWidth + 3) / 4) * ((levelHeight + 3) / 4) * blockSize;
+		else
+			size += static_cast<size_t>(levelWidth) * levelHeight * bytesPerPixel;
+		levelWidth = std::max(1, levelWidth / 2);
+		levelHeight = std::max(1, levelHeight / 2);
+	}
+
+	return size * this->m_samples;
+}
+
+Texture2D *Texture2D::createReducedCopy(const int maxSize) const
+{
+	if (this->m_textureId == 0)
+		throw TextureException("Could not create reduced copy of Texture2D. Texture is not initialized!");
+
+	if (this->m_samples > 1)
+		throw TextureException("Could not create reduced copy of Texture2D. Multisampled textures can't be reduced!");
+
+	int level = 0;
+	int levelWidth = this->m_width;
+	int levelHeight = this->m_height;
+	while (std::max(levelWidth, levelHeight) > std::max(1, maxSize))
+	{
+		levelWidth = std::max(1, levelWidth / 2);
+		levelHeight = std::max(1, levelHeight / 2);
+		level++;
+	}
+
+	if (level == 0)
+		return nullptr;
+
+	auto *copy = new Texture2D(levelWidth, levelHeight, this->m_internalFormat, this->m_target);
+	try
+	{
+		if (level < this->m_reservedLevels)
+		{
+			int levelCount = this->m_reservedLevels - level;
+			copy->reserve(levelCount);
+			for (int n = 0; n < levelCount; n++)
+			{
+				glCopyImageSubData(this->m_textureId, this->m_target, level + n, 0, 0, 0,
+								   copy->m_textureId, copy->m_target, n, 0, 0, 0, levelWidth, levelHeight, 1);
+				levelWidth = std::max(1, levelWidth / 2);
+				levelHeight = std::max(1, levelHeight / 2);
+			}
+
+			if (levelCount > 1)
+				copy->setParameteri(CEDAR_TEXTURE_MIN_FILTER, CEDAR_LINEAR_MIPMAP_LINEAR);
+		}
+		else if (!isCompressedFormat(this->m_internalFormat))
+		{
+			copy->reserve(1);
+			unsigned int framebuffers[2];
+			glCreateFramebuffers(2, framebuffers);
+			glNamedFramebufferTexture(framebuffers[0], GL_COLOR_ATTACHMENT0, this->m_textureId, 0);
+			glNamedFramebufferTexture(framebuffers[1], GL_COLOR_ATTACHMENT0, copy->m_textureId, 0);
+			// Integer formats can't be blitted with linear filtering, the blit would fail and leave the copy empty.
+			glBlitNamedFramebuffer(framebuffers[0], framebuffers[1], 0, 0, this->m_width, this->m_height,
+								   0, 0, levelWidth, levelHeight, GL_COLOR_BUFFER_BIT,
+								   isIntegerFormat(this->m_internalFormat) ? CEDAR_NEAREST : CEDAR_LINEAR);
+			glDeleteFramebuffers(2, framebuffers);
+		}
+		else
+		{
+			delete copy;
+			copy = nullptr;
+		}
+	}
+	catch (...)
+	{
+		delete copy;
+		throw;
+	}
+
+	return copy;
+}
+
+void Texture2D::swapStorage(Texture2D &other)
+{
+	if (this->m_target != other.m_target)
+		throw TextureException("Could not swap storage of Texture2D. The textures have different targets!");
+
+	std::swap(this->m_textureId, other.m_textureId);
+	std::swap(this->m_internalFormat, other.m_internalFormat);
+	std::swap(this->m_depthTexture, other.m_depthTexture);
+	std::swap(this->m_stencilTexture, other.m_stencilTexture);
+	std::swap(this->m_immutable, other.m_immutable);
+	std::swap(this->m_width, other.m_width);
+	std::swap(this->m_height, other.m_height);
+	std::swap(this->m_samples, other.m_samples);
+	std::swap(this->m_reservedLevels, other.m_reservedLevels);
+}
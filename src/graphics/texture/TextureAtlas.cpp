@@ -0,0 +1,177 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <algorithm>
+
+#include "cedar/TextureAtlas.hpp"
+#include "cedar/ImageLoader.hpp"
+
+using namespace cedar;
+
+TextureAtlasException::TextureAtlasException(const std::string &message) : XException(message)
+{}
+
+TextureAtlas::TextureAtlas(const int pageWidth, const int pageHeight, const int padding)
+{
+	if (pageWidth <= 0 || pageHeight <= 0)
+		throw TextureAtlasException("Could not create texture atlas. The width and height of the pages must be greater than 0!");
+
+	if (padding < 0)
+		throw TextureAtlasException("Could not create texture atlas. The padding can't be negative!");
+
+	this->m_pageWidth = pageWidth;
+	this->m_pageHeight = pageHeight;
+	this->m_padding = padding;
+}
+
+void TextureAtlas::addPage()
+{
+	auto *page = new Texture2D(this->m_pageWidth, this->m_pageHeight, CEDAR_RGBA8);
+	try
+	{
+		page->reserve(1);
+		page->setParameteri(CEDAR_TEXTURE_WRAP_S, CEDAR_CLAMP_TO_EDGE);
+		page->setParameteri(CEDAR_TEXTURE_WRAP_T, CEDAR_CLAMP_TO_EDGE);
+	}
+	catch (...)
+	{
+		delete page;
+		throw;
+	}
+
+	this->m_pages.emplace_back(page);
+	this->m_packers.emplace_back(this->m_pageWidth, this->m_pageHeight);
+}
+
+const TextureRegion &TextureAtlas::add(const std::string &name, const unsigned char *pixels, const int width, const int height,
+									   const int channels)
+{
+	if (this->m_regions.find(name) != this->m_regions.end())
+		throw TextureAtlasException("Could not add image to texture atlas. A region with name " + name + " already exists!");
+
+	if (channels < 1 || channels > 4)
+		throw TextureAtlasException("Could not add image " + name + " to texture atlas. Unsupported number of channels " + std::to_string(channels) + "!");
+
+	if (width <= 0 || height <= 0)
+		throw TextureAtlasException("Could not add image " + name + " to texture atlas. The width and height must be greater than 0!");
+
+	int paddedWidth = width + this->m_padding * 2;
+	int paddedHeight = height + this->m_padding * 2;
+	if (paddedWidth > this->m_pageWidth || paddedHeight > this->m_pageHeight)
+		throw TextureAtlasException("Could not add image " + name + " to texture atlas. The image is larger than a page!");
+
+	size_t page = 0;
+	int x = 0;
+	int y = 0;
+	while (page < this->m_packers.size() && !this->m_packers[page].insert(paddedWidth, paddedHeight, &x, &y))
+		page++;
+
+	if (page == this->m_packers.size())
+	{
+		this->addPage();
+		this->m_packers[page].insert(paddedWidth, paddedHeight, &x, &y);
+	}
+
+	// Expand the image to RGBA and repeat its edges into the padding.
+	std::vector<unsigned char> rgba(static_cast<size_t>(paddedWidth) * paddedHeight * 4);
+	for (int row = 0; row < paddedHeight; row++)
+	{
+		int sourceY = std::clamp(row - this->m_padding, 0, height - 1);
+		for (int column = 0; column < paddedWidth; column++)
+		{
+			int sourceX = std::clamp(column - this->m_padding, 0, width - 1);
+			const unsigned char *source = pixels + (static_cast<size_t>(sourceY) * width + sourceX) * channels;
+			unsigned char *destination = rgba.data() + (static_cast<size_t>(row) * paddedWidth + column) * 4;
+			if (channels < 3)
+			{
+				destination[0] = source[0];
+				destination[1] = source[0];
+				destination[2] = source[0];
+				destination[3] = channels == 2 ? source[1] : 255;
+			}
+			else
+			{
+				destination[0] = source[0];
+				destination[1] = source[1];
+				destination[2] = source[2];
+				destination[3] = channels == 4 ? source[3] : 255;
+			}
+		}
+	}
+
+	auto *texture = dynamic_cast<Texture2D *>(this->m_pages[page].get());
+	texture->upload(x, y, paddedWidth, paddedHeight, CEDAR_RGBA, CEDAR_UNSIGNED_BYTE, rgba.data());
+
+	float pageWidth = static_cast<float>(this->m_pageWidth);
+	float pageHeight = static_cast<float>(this->m_pageHeight);
+	TextureRegion region = {
+			this->m_pages[page],
+			Vector4f(static_cast<float>(x + this->m_padding) / pageWidth, static_cast<float>(y + this->m_padding) / pageHeight,
+					 static_cast<float>(x + this->m_padding + width) / pageWidth, static_cast<float>(y + this->m_padding + height) / pageHeight),
+			width,
+			height
+	};
+	return this->m_regions.insert(std::make_pair(name, region)).first->second;
+}
+
+const TextureRegion &TextureAtlas::addImage(const std::string &name, const std::string &path)
+{
+	if (this->m_regions.find(name) != this->m_regions.end())
+		throw TextureAtlasException("Could not add image to texture atlas. A region with name " + name + " already exists!");
+
+	DecodedImage image = ImageLoader::decodeImage(path, nullptr, 4);
+	try
+	{
+		const TextureRegion &region = this->add(name, image.m_pixels, image.m_width, image.m_height, 4);
+		ImageLoader::freeImage(image, nullptr);
+		return region;
+	}
+	catch (...)
+	{
+		ImageLoader::freeImage(image, nullptr);
+		throw;
+	}
+}
+
+const TextureRegion *TextureAtlas::getRegion(const std::string &name) const
+{
+	auto it = this->m_regions.find(name);
+	if (it != this->m_regions.end())
+		return &it->second;
+	else
+		return nullptr;
+}
+
+const std::map<std::string, TextureRegion> &TextureAtlas::getRegions() const
+{
+	return this->m_regions;
+}
+
+size_t TextureAtlas::getPageCount() const
+{
+	return this->m_pages.size();
+}
+
+std::shared_ptr<Texture> TextureAtlas::getPage(const size_t index) const
+{
+	if (index >= this->m_pages.size())
+		return nullptr;
+
+	return this->m_pages[index];
+}
+
+int TextureAtlas::getPageWidth() const
+{
+	return this->m_pageWidth;
+}
+
+int TextureAtlas::getPageHeight() const
+{
+	return this->m_pageHeight;
+}
+
+int TextureAtlas::getPadding() const
+{
+	return this->m_padding;
+}
@@ -0,0 +1,279 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+#include "cedar/TextureCache.hpp"
+#include "cedar/ImageLoader.hpp"
+#include "cedar/BlockCompressor.hpp"
+#include "cedar/AssetPack.hpp"
+#include "cedar/Cedar.hpp"
+
+using namespace cedar;
+
+/**
+ * Struct representing the signature of a source image stored in the reserved section of a cached DDS file.
+ */
+struct TextureCacheSignature
+{
+	/**
+	 * The magic number of the signature.
+	 */
+	char m_magic[4];
+	/**
+	 * The version of the cache the file was written with.
+	 */
+	unsigned int m_version;
+	/**
+	 * The hash of the normalized path of the source image.
+	 */
+	unsigned long long m_pathHash;
+	/**
+	 * The size of the source image in bytes.
+	 */
+	unsigned long long m_sourceSize;
+	/**
+	 * The modification time of the source image.
+	 */
+	long long m_sourceTime;
+	/**
+	 * Whether the file holds a full mipmap chain.
+	 */
+	unsigned int m_mipmapped;
+	/**
+	 * Unused, keeps the padding of the signature zeroed.
+	 */
+	unsigned int m_reserved;
+};
+
+static_assert(sizeof(TextureCacheSignature) <= 44, "The texture cache signature must fit into the reserved DDS header section!");
+
+/**
+ * The offset of the reserved section of the DDS header the signature is stored in.
+ */
+const size_t SIGNATURE_OFFSET = 32;
+
+/**
+ * Creates the signature of the given source image.
+ *
+ * @param path The path to the source image.
+ * @param generateMipmaps Whether the cached file holds a full mipmap chain.
+ * @param signature A pointer to the signature that will be filled.
+ * @return <code>true</code> if the source image exists.
+ */
+bool createSourceSignature(const std::string &path, const bool generateMipmaps, TextureCacheSignature *signature)
+{
+	std::error_code error;
+	auto sourceSize = std::filesystem::file_size(path, error);
+	if (error)
+		return false;
+
+	auto sourceTime = std::filesystem::last_write_time(path, error);
+	if (error)
+		return false;
+
+	std::memcpy(signature->m_magic, CEDAR_TEXTURE_CACHE_MAGIC, 4);
+	signature->m_version = CEDAR_TEXTURE_CACHE_VERSION;
+	signature->m_pathHash = AssetPack::hash(AssetPack::normalizePath(path));
+	signature->m_sourceSize = sourceSize;
+	signature->m_sourceTime = static_cast<long long>(sourceTime.time_since_epoch().count());
+	signature->m_mipmapped = generateMipmaps ? 1 : 0;
+	signature->m_reserved = 0;
+	return true;
+}
+
+std::string TextureCache::m_directory;
+
+TextureCache::TextureCache()
+= default;
+
+void TextureCache::setDirectory(const std::string &directory)
+{
+	if (!directory.empty())
+	{
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+		if (error)
+		{
+			Cedar::getCoreLogger()->warn("Could not create texture cache directory %s: %s", directory.c_str(), error.message().c_str());
+			m_directory.clear();
+			return;
+		}
+	}
+
+	m_directory = directory;
+}
+
+const std::string &TextureCache::getDirectory()
+{
+	return m_directory;
+}
+
+bool TextureCache::isCacheable(const std::string &path)
+{
+	if (m_directory.empty() || ImageLoader::isCompressedContainer(path))
+		return false;
+
+	const unsigned char *packData;
+	size_t packDataSize;
+	return !AssetPack::findAsset(path, &packData, &packDataSize);
+}
+
+std::string TextureCache::getCachePath(const std::string &path, const bool generateMipmaps)
+{
+	char name[17];
+	std::snprintf(name, sizeof(name), "%016llx", AssetPack::hash(AssetPack::normalizePath(path)));
+	return m_directory + "/" + name + (generateMipmaps ? ".dds" : "_base.dds");
+}
+
+bool TextureCache::isValid(const std::string &path, const bool generateMipmaps)
+{
+	TextureCacheSignature sourceSignature = {};
+	if (!createSourceSignature(path, generateMipmaps, &sourceSignature))
+		return false;
+
+	std::ifstream cacheFile(getCachePath(path, generateMipmaps), std::ios::binary);
+	unsigned char header[CEDAR_DDS_HEADER_SIZE];
+	if (!cacheFile.read(reinterpret_cast<char *>(header), CEDAR_DDS_HEADER_SIZE))
+		return false;
+
+	return std::memcmp(header, CEDAR_DDS_MAGIC, 4) == 0 &&
+		   std::memcmp(header + SIGNATURE_OFFSET, &sourceSignature, sizeof(TextureCacheSignature)) == 0;
+}
+
+std::vector<unsigned char> TextureCache::build(const std::string &path, const bool generateMipmaps)
+{
+	TextureCacheSignature signature = {};
+	if (!createSourceSignature(path, generateMipmaps, &signature))
+		throw TextureLoadException("Could not load texture from file " + path + ". Does the file even exist?");
+
+	DecodedImage image = ImageLoader::decodeImage(path, nullptr, 0);
+	int channels;
+	const char *fourCC;
+	switch (image.m_internalFormat)
+	{
+		case CEDAR_R8:
+			channels = 1;
+			fourCC = "BC4U";
+			break;
+
+		case CEDAR_RG8:
+			channels = 2;
+			fourCC = "BC5U";
+			break;
+
+		case CEDAR_RGB8:
+			channels = 3;
+			fourCC = "DXT1";
+			break;
+
+		default:
+			channels = 4;
+			fourCC = "DXT5";
+			break;
+	}
+
+	std::vector<unsigned char> data(CEDAR_DDS_HEADER_SIZE, 0);
+	unsigned int levelCount = 0;
+	unsigned int baseLevelSize = 0;
+	try
+	{
+		std::vector<unsigned char> levelPixels;
+		const unsigned char *pixels = image.m_pixels;
+		int levelWidth = image.m_width;
+		int levelHeight = image.m_height;
+		while (true)
+		{
+			std::vector<unsigned char> blocks = BlockCompressor::compress(pixels, levelWidth, levelHeight, channels);
+			if (levelCount == 0)
+				baseLevelSize = static_cast<unsigned int>(blocks.size());
+			data.insert(data.end(), blocks.begin(), blocks.end());
+			levelCount++;
+
+			// Textures without mipmaps only store the full resolution.
+			if (!generateMipmaps || (levelWidth == 1 && levelHeight == 1))
+				break;
+
+			std::vector<unsigned char> nextLevel(static_cast<size_t>(std::max(1, levelWidth / 2)) * std::max(1, levelHeight / 2) * channels);
+			ImageLoader::downsampleImage(pixels, levelWidth, levelHeight, channels, nextLevel.data());
+			levelPixels.swap(nextLevel);
+			pixels = levelPixels.data();
+			levelWidth = std::max(1, levelWidth / 2);
+			levelHeight = std::max(1, levelHeight / 2);
+		}
+	}
+	catch (const BlockCompressionException &exception)
+	{
+		ImageLoader::freeImage(image, nullptr);
+		throw TextureLoadException("Could not load texture from file " + path + ". " + exception.what());
+	}
+
+	auto writeUInt32 = [&data](size_t offset, unsigned int value) {
+		std::memcpy(data.data() + offset, &value, 4);
+	};
+	std::memcpy(data.data(), CEDAR_DDS_MAGIC, 4);
+	writeUInt32(4, 124);
+	// Caps, height, width, pixel format, linear size and mipmap count if there is a chain.
+	writeUInt32(8, 0x1u | 0x2u | 0x4u | 0x1000u | 0x80000u | (levelCount > 1 ? 0x20000u : 0u));
+	writeUInt32(12, static_cast<unsigned int>(image.m_height));
+	writeUInt32(16, static_cast<unsigned int>(image.m_width));
+	writeUInt32(20, baseLevelSize);
+	writeUInt32(28, levelCount);
+	std::memcpy(data.data() + SIGNATURE_OFFSET, &signature, sizeof(TextureCacheSignature));
+	writeUInt32(76, 32);
+	writeUInt32(80, 0x4u);
+	std::memcpy(data.data() + 84, fourCC, 4);
+	// Texture caps, and complex and mipmap caps if there is a chain.
+	writeUInt32(108, 0x1000u | (levelCount > 1 ? 0x8u | 0x400000u : 0u));
+	ImageLoader::freeImage(image, nullptr);
+
+	// The file is written under a temporary name first, so a crash never leaves a truncated file behind.
+	std::string cachePath = getCachePath(path, generateMipmaps);
+	std::string temporaryPath = cachePath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+	std::ofstream cacheFile(temporaryPath, std::ios::binary | std::ios::trunc);
+	cacheFile.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+	cacheFile.close();
+
+	std::error_code error;
+	if (cacheFile.good())
+		std::filesystem::rename(temporaryPath, cachePath, error);
+	if (!cacheFile.good() || error)
+	{
+		std::filesystem::remove(temporaryPath, error);
+		Cedar::getCoreLogger()->warn("Could not write cached texture of %s to %s", path.c_str(), cachePath.c_str());
+	}
+
+	return data;
+}
+
+Texture2D *TextureCache::createTexture(const std::string &path, const bool generateMipmaps, const std::vector<unsigned char> &cacheData)
+{
+	if (cacheData.empty())
+		return ImageLoader::loadCompressedTexture(getCachePath(path, generateMipmaps));
+
+	return ImageLoader::createCompressedTexture(ImageLoader::parseCompressedImage(path, cacheData.data(), cacheData.size()));
+}
+
+Texture2D *TextureCache::loadTexture(const std::string &path, const bool generateMipmaps)
+{
+	if (isValid(path, generateMipmaps))
+	{
+		try
+		{
+			return createTexture(path, generateMipmaps, std::vector<unsigned char>());
+		}
+		catch (const TextureLoadException &exception)
+		{
+			Cedar::getCoreLogger()->warn("Cached texture of %s is corrupt, rebuilding it: %s", path.c_str(), exception.what());
+		}
+	}
+
+	return createTexture(path, generateMipmaps, build(path, generateMipmaps));
+}
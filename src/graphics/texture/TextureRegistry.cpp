@@ -2,8 +2,17 @@
 // Created by masy on 13.04.20.
 //
 
+#include <set>
+#include <exception>
+#include <algorithm>
+
 #include "cedar/TextureRegistry.hpp"
 #include "cedar/ImageLoader.hpp"
+#include "cedar/OpenGLThread.hpp"
+#include "cedar/ThreadPool.hpp"
+#include "cedar/TextureCache.hpp"
+#include "cedar/Cedar.hpp"
+#include "glad/glad.h"
 
 using namespace cedar;
 
@@ -11,6 +20,11 @@ TextureRegisterException::TextureRegisterException(const std::string &message) :
 {}
 
 std::map<std::string, std::shared_ptr<Texture>> TextureRegistry::m_loadedTextures = std::map<std::string, std::shared_ptr<Texture>>();
+std::map<std::string, TextureRegion> TextureRegistry::m_registeredRegions = std::map<std::string, TextureRegion>();
+PixelBufferRing *TextureRegistry::m_pixelBufferRing = nullptr;
+std::map<std::string, TextureSource> TextureRegistry::m_textureSources = std::map<std::string, TextureSource>();
+size_t TextureRegistry::m_memoryBudget = 0;
+unsigned long long TextureRegistry::m_currentFrame = 1;
 
 TextureRegistry::TextureRegistry()
 = default;
@@ -28,31 +42,506 @@ std::shared_ptr<Texture> TextureRegistry::registerTexture(const std::string &nam
 	return sharedPtr;
 }
 
-std::shared_ptr<Texture> TextureRegistry::loadTexture(const std::string &name, const std::string &path) {
+std::shared_ptr<Texture> TextureRegistry::loadTexture(const std::string &name, const std::string &path, const bool generateMipmaps) {
 	if (name.empty())
 		throw TextureRegisterException("Could not register texture! The name of the texture can't be empty!");
 
 	if (m_loadedTextures.find(name) != m_loadedTextures.end())
 		throw TextureRegisterException("Could not load texture! A texture with name " + name + " is already registered!");
 
-	std::shared_ptr<Texture> sharedPtr = std::shared_ptr<Texture>(ImageLoader::loadTexture(path, 0));
-	m_loadedTextures.insert(std::make_pair(name, sharedPtr));
+	std::shared_ptr<Texture> sharedPtr = std::shared_ptr<Texture>(loadTextureFile(path, generateMipmaps));
+	insertTexture(name, sharedPtr, path, generateMipmaps);
 
 	return sharedPtr;
 }
 
+Texture2D *TextureRegistry::loadTextureFile(const std::string &path, const bool generateMipmaps)
+{
+	if (ImageLoader::isCompressedContainer(path))
+		return ImageLoader::loadCompressedTexture(path);
+
+	if (TextureCache::isCacheable(path))
+		return TextureCache::loadTexture(path, generateMipmaps);
+
+	PixelBufferRing *pixelBufferRing = getPixelBufferRing();
+	DecodedImage image = ImageLoader::decodeImage(path, pixelBufferRing, 0);
+	return ImageLoader::createTexture(image, pixelBufferRing, generateMipmaps);
+}
+
+void TextureRegistry::insertTexture(const std::string &name, const std::shared_ptr<Texture> &texture, const std::string &path,
+									const bool generateMipmaps)
+{
+	texture->markUsed(m_currentFrame);
+	m_loadedTextures.insert(std::make_pair(name, texture));
+	m_textureSources[name] = {path, generateMipmaps, false, false, {0, 0, 0, 0}};
+}
+
+std::vector<std::shared_ptr<Texture>> TextureRegistry::loadTextures(const std::vector<std::pair<std::string, std::string>> &textures,
+																	const bool generateMipmaps)
+{
+	std::set<std::string> names;
+	for (const auto &texture : textures)
+	{
+		if (texture.first.empty())
+			throw TextureRegisterException("Could not register texture! The name of the texture can't be empty!");
+
+		if (m_loadedTextures.find(texture.first) != m_loadedTextures.end() || !names.insert(texture.first).second)
+			throw TextureRegisterException("Could not load texture! A texture with name " + texture.first + " is already registered!");
+	}
+
+	PixelBufferRing *pixelBufferRing = getPixelBufferRing();
+	std::vector<DecodedImage> images(textures.size(), {0, 0, 0, {0, 0, nullptr}, nullptr, 1});
+	std::vector<std::vector<unsigned char>> cacheData(textures.size());
+	std::vector<std::exception_ptr> exceptions(textures.size(), nullptr);
+	ThreadPool::getInstance()->parallelFor(textures.size(), [&](size_t index) {
+		// Compressed containers don't need to be decoded, they are uploaded as they are.
+		if (ImageLoader::isCompressedContainer(textures[index].second))
+			return;
+
+		try
+		{
+			if (TextureCache::isCacheable(textures[index].second))
+			{
+				if (!TextureCache::isValid(textures[index].second, generateMipmaps))
+					cacheData[index] = TextureCache::build(textures[index].second, generateMipmaps);
+			}
+			else
+			{
+				images[index] = ImageLoader::decodeImage(textures[index].second, pixelBufferRing, 0, generateMipmaps);
+			}
+		}
+		catch (...)
+		{
+			exceptions[index] = std::current_exception();
+		}
+	});
+
+	for (const std::exception_ptr &exception : exceptions)
+	{
+		if (exception)
+		{
+			for (DecodedImage &image : images)
+			{
+				ImageLoader::freeImage(image, pixelBufferRing);
+			}
+			std::rethrow_exception(exception);
+		}
+	}
+
+	std::vector<Texture2D *> createdTextures;
+	createdTextures.reserve(textures.size());
+	try
+	{
+		for (size_t n = 0; n < images.size(); n++)
+		{
+			if (ImageLoader::isCompressedContainer(textures[n].second))
+				createdTextures.push_back(ImageLoader::loadCompressedTexture(textures[n].second));
+			else if (TextureCache::isCacheable(textures[n].second))
+				createdTextures.push_back(TextureCache::createTexture(textures[n].second, generateMipmaps, cacheData[n]));
+			else
+				createdTextures.push_back(ImageLoader::createTexture(images[n], pixelBufferRing, generateMipmaps));
+		}
+	}
+	catch (...)
+	{
+		for (size_t n = createdTextures.size() + 1; n < images.size(); n++)
+		{
+			ImageLoader::freeImage(images[n], pixelBufferRing);
+		}
+		for (Texture2D *texture : createdTextures)
+		{
+			delete texture;
+		}
+		throw;
+	}
+
+	std::vector<std::shared_ptr<Texture>> sharedPtrs;
+	sharedPtrs.reserve(textures.size());
+	for (size_t n = 0; n < textures.size(); n++)
+	{
+		std::shared_ptr<Texture> sharedPtr = std::shared_ptr<Texture>(createdTextures[n]);
+		insertTexture(textures[n].first, sharedPtr, textures[n].second, generateMipmaps);
+		sharedPtrs.push_back(sharedPtr);
+	}
+
+	return sharedPtrs;
+}
+
+void TextureRegistry::loadTextureFileAsync(const std::string &path, const bool generateMipmaps, Thread *decodeThread,
+										   const std::function<void(Texture2D *texture)> &onLoaded,
+										   const std::function<void(const std::string &error)> &onError)
+{
+	auto decode = [decodeThread](const std::function<void()> &task) {
+		if (decodeThread)
+			decodeThread->addTask(task);
+		else
+			ThreadPool::getInstance()->submit(task);
+	};
+	auto create = [onLoaded, onError](const std::function<Texture2D *()> &createTexture) {
+		Texture2D *texture;
+		try
+		{
+			texture = createTexture();
+		}
+		catch (const XException &exception)
+		{
+			onError(exception.what());
+			return;
+		}
+		onLoaded(texture);
+	};
+	auto fail = [onError](const std::string &error) {
+		OpenGLThread::getInstance()->addTask([=]() {
+			onError(error);
+		});
+	};
+
+	// Compressed containers are uploaded straight from the mapped file, there is nothing to decode.
+	if (ImageLoader::isCompressedContainer(path))
+	{
+		OpenGLThread::getInstance()->addTask([=]() {
+			create([&]() {
+				return ImageLoader::loadCompressedTexture(path);
+			});
+		});
+		return;
+	}
+
+	if (TextureCache::isCacheable(path))
+	{
+		decode([=]() {
+			std::vector<unsigned char> cacheData;
+			try
+			{
+				if (!TextureCache::isValid(path, generateMipmaps))
+					cacheData = TextureCache::build(path, generateMipmaps);
+			}
+			catch (const TextureLoadException &exception)
+			{
+				fail(exception.what());
+				return;
+			}
+
+			OpenGLThread::getInstance()->addTask([=]() {
+				create([&]() {
+					return TextureCache::createTexture(path, generateMipmaps, cacheData);
+				});
+			});
+		});
+		return;
+	}
+
+	PixelBufferRing *pixelBufferRing = getPixelBufferRing();
+	decode([=]() {
+		DecodedImage image;
+		try
+		{
+			image = ImageLoader::decodeImage(path, pixelBufferRing, 0, generateMipmaps);
+		}
+		catch (const TextureLoadException &exception)
+		{
+			fail(exception.what());
+			return;
+		}
+
+		OpenGLThread::getInstance()->addTask([=]() mutable {
+			// The ring may have been deleted by a cleanup while the image was decoded.
+			if (image.m_allocation.m_data && pixelBufferRing != m_pixelBufferRing)
+				return;
+
+			create([&]() {
+				return ImageLoader::createTexture(image, pixelBufferRing, generateMipmaps);
+			});
+		});
+	});
+}
+
+void TextureRegistry::loadTextureAsync(const std::string &name, const std::string &path, Thread *decodeThread,
+									   const std::function<void(const std::shared_ptr<Texture> &)> &callback, const bool generateMipmaps)
+{
+	if (name.empty())
+		throw TextureRegisterException("Could not register texture! The name of the texture can't be empty!");
+
+	if (m_loadedTextures.find(name) != m_loadedTextures.end())
+		throw TextureRegisterException("Could not load texture! A texture with name " + name + " is already registered!");
+
+	loadTextureFileAsync(path, generateMipmaps, decodeThread, [=](Texture2D *texture) {
+		if (m_loadedTextures.find(name) != m_loadedTextures.end())
+		{
+			delete texture;
+			Cedar::getCoreLogger()->error("Could not load texture %s: A texture with that name is already registered!", name.c_str());
+			return;
+		}
+
+		try
+		{
+			std::shared_ptr<Texture> sharedPtr = std::shared_ptr<Texture>(texture);
+			insertTexture(name, sharedPtr, path, generateMipmaps);
+			if (callback)
+				callback(sharedPtr);
+		}
+		catch (const XException &exception)
+		{
+			Cedar::getCoreLogger()->error("Could not load texture %s: %s", name.c_str(), exception.what());
+		}
+	}, [=](const std::string &error) {
+		Cedar::getCoreLogger()->error("Could not load texture %s: %s", name.c_str(), error.c_str());
+	});
+}
+
+PixelBufferRing *TextureRegistry::getPixelBufferRing()
+{
+	static bool creationFailed = false;
+	if (!m_pixelBufferRing && !creationFailed)
+	{
+		try
+		{
+			m_pixelBufferRing = new PixelBufferRing();
+		}
+		catch (const PixelBufferException &exception)
+		{
+			// Textures are still uploaded from client memory without the ring.
+			Cedar::getGLLogger()->warn("Could not create pixel buffer ring: %s", exception.what());
+			creationFailed = true;
+		}
+	}
+
+	return m_pixelBufferRing;
+}
+
+void TextureRegistry::reclaimPixelBuffers()
+{
+	if (m_pixelBufferRing)
+		m_pixelBufferRing->reclaim();
+}
+
+void TextureRegistry::setMemoryBudget(const size_t budget)
+{
+	m_memoryBudget = budget;
+}
+
+size_t TextureRegistry::getMemoryBudget()
+{
+	return m_memoryBudget;
+}
+
+size_t TextureRegistry::getMemoryUsage()
+{
+	size_t usage = 0;
+	for (const auto &texture : m_loadedTextures)
+	{
+		usage += texture.second->getMemorySize();
+	}
+	return usage;
+}
+
+unsigned long long TextureRegistry::getCurrentFrame()
+{
+	return m_currentFrame;
+}
+
+bool TextureRegistry::evictTexture(Texture2D *texture, TextureSource &source)
+{
+	Texture2D *reduced;
+	try
+	{
+		reduced = texture->createReducedCopy(CEDAR_TEXTURE_EVICTED_SIZE);
+	}
+	catch (const TextureException &exception)
+	{
+		Cedar::getCoreLogger()->warn("Could not evict texture %s: %s", source.m_path.c_str(), exception.what());
+		return false;
+	}
+
+	if (!reduced)
+		return false;
+
+	// Sampler state belongs to the texture object, so it is carried over to the reduced storage.
+	glGetTextureParameteriv(texture->getId(), CEDAR_TEXTURE_MIN_FILTER, &source.m_parameters[0]);
+	glGetTextureParameteriv(texture->getId(), CEDAR_TEXTURE_MAG_FILTER, &source.m_parameters[1]);
+	glGetTextureParameteriv(texture->getId(), CEDAR_TEXTURE_WRAP_S, &source.m_parameters[2]);
+	glGetTextureParameteriv(texture->getId(), CEDAR_TEXTURE_WRAP_T, &source.m_parameters[3]);
+
+	texture->swapStorage(*reduced);
+	delete reduced;
+
+	// A texture with a single level is incomplete with a mipmap filter.
+	int minFilter = source.m_parameters[0];
+	if (texture->getReservedLevels() <= 1 && minFilter != CEDAR_NEAREST && minFilter != CEDAR_LINEAR)
+		minFilter = source.m_parameters[1];
+	texture->setParameteri(CEDAR_TEXTURE_MIN_FILTER, minFilter);
+	texture->setParameteri(CEDAR_TEXTURE_MAG_FILTER, source.m_parameters[1]);
+	texture->setParameteri(CEDAR_TEXTURE_WRAP_S, source.m_parameters[2]);
+	texture->setParameteri(CEDAR_TEXTURE_WRAP_T, source.m_parameters[3]);
+	source.m_evicted = true;
+	return true;
+}
+
+void TextureRegistry::restoreTexture(const std::string &name, TextureSource &source)
+{
+	source.m_restoring = true;
+
+	// The texture may be cleaned up or replaced under the same name while its file is loaded.
+	std::weak_ptr<Texture> weakTexture = m_loadedTextures[name];
+	auto findSource = [name, weakTexture]() -> TextureSource * {
+		std::shared_ptr<Texture> texture = weakTexture.lock();
+		auto textureIt = m_loadedTextures.find(name);
+		auto sourceIt = m_textureSources.find(name);
+		if (!texture || textureIt == m_loadedTextures.end() || textureIt->second != texture || sourceIt == m_textureSources.end())
+			return nullptr;
+		return &sourceIt->second;
+	};
+
+	loadTextureFileAsync(source.m_path, source.m_generateMipmaps, nullptr, [=](Texture2D *loaded) {
+		TextureSource *current = findSource();
+		if (!current || !current->m_restoring)
+		{
+			delete loaded;
+			return;
+		}
+
+		// The reduced storage was rendered until now, the texture object and every pointer to it stay the same.
+		auto *texture = dynamic_cast<Texture2D *>(weakTexture.lock().get());
+		texture->swapStorage(*loaded);
+		delete loaded;
+
+		texture->setParameteri(CEDAR_TEXTURE_MIN_FILTER, current->m_parameters[0]);
+		texture->setParameteri(CEDAR_TEXTURE_MAG_FILTER, current->m_parameters[1]);
+		texture->setParameteri(CEDAR_TEXTURE_WRAP_S, current->m_parameters[2]);
+		texture->setParameteri(CEDAR_TEXTURE_WRAP_T, current->m_parameters[3]);
+		current->m_evicted = false;
+		current->m_restoring = false;
+	}, [=](const std::string &error) {
+		Cedar::getCoreLogger()->error("Could not restore evicted texture %s: %s", name.c_str(), error.c_str());
+
+		// The texture stays reduced if it can't be reloaded, retrying every frame would only repeat the error.
+		TextureSource *current = findSource();
+		if (current)
+		{
+			current->m_evicted = false;
+			current->m_restoring = false;
+		}
+	});
+}
+
+void TextureRegistry::updateResidency()
+{
+	std::vector<std::pair<unsigned long long, std::string>> candidates;
+	for (auto &source : m_textureSources)
+	{
+		auto it = m_loadedTextures.find(source.first);
+		auto *texture = it != m_loadedTextures.end() ? dynamic_cast<Texture2D *>(it->second.get()) : nullptr;
+		if (!texture)
+			continue;
+
+		if (source.second.m_evicted)
+		{
+			if (!source.second.m_restoring && texture->getLastUsedFrame() == m_currentFrame)
+				restoreTexture(source.first, source.second);
+		}
+		else if (m_currentFrame - texture->getLastUsedFrame() >= CEDAR_TEXTURE_EVICTION_IDLE_FRAMES)
+		{
+			candidates.emplace_back(texture->getLastUsedFrame(), source.first);
+		}
+	}
+
+	if (m_memoryBudget != 0 && !candidates.empty())
+	{
+		size_t usage = getMemoryUsage();
+		if (usage > m_memoryBudget)
+		{
+			std::sort(candidates.begin(), candidates.end());
+			for (const auto &candidate : candidates)
+			{
+				if (usage <= m_memoryBudget)
+					break;
+
+				auto *texture = dynamic_cast<Texture2D *>(m_loadedTextures[candidate.second].get());
+				size_t previousSize = texture->getMemorySize();
+				if (evictTexture(texture, m_textureSources[candidate.second]))
+					usage -= previousSize - texture->getMemorySize();
+			}
+		}
+	}
+
+	m_currentFrame++;
+}
+
 std::shared_ptr<Texture> TextureRegistry::getTexture(const std::string &name) {
 	auto it = m_loadedTextures.find(name);
 	if (it != m_loadedTextures.end())
+	{
+		it->second->markUsed(m_currentFrame);
 		return it->second;
+	}
 	else
 		return nullptr;
 }
 
+void TextureRegistry::registerRegion(const std::string &name, const TextureRegion &region)
+{
+	if (name.empty())
+		throw TextureRegisterException("Could not register texture region! The name of the region can't be empty!");
+
+	if (!region.m_texture)
+		throw TextureRegisterException("Could not register texture region " + name + "! The region has no texture!");
+
+	if (m_registeredRegions.find(name) != m_registeredRegions.end())
+		throw TextureRegisterException("Could not register texture region! A region with name " + name + " is already registered!");
+
+	m_registeredRegions.insert(std::make_pair(name, region));
+}
+
+void TextureRegistry::registerAtlas(const std::string &name, const TextureAtlas &atlas)
+{
+	if (name.empty())
+		throw TextureRegisterException("Could not register texture atlas! The name of the atlas can't be empty!");
+
+	for (size_t n = 0; n < atlas.getPageCount(); n++)
+	{
+		std::string pageName = name + "#" + std::to_string(n);
+		if (m_loadedTextures.find(pageName) != m_loadedTextures.end())
+			throw TextureRegisterException("Could not register texture atlas! A texture with name " + pageName + " is already registered!");
+	}
+
+	for (const auto &region : atlas.getRegions())
+	{
+		if (region.first.empty())
+			throw TextureRegisterException("Could not register texture atlas " + name + "! The name of a region can't be empty!");
+
+		if (m_registeredRegions.find(region.first) != m_registeredRegions.end())
+			throw TextureRegisterException("Could not register texture atlas! A region with name " + region.first + " is already registered!");
+	}
+
+	for (size_t n = 0; n < atlas.getPageCount(); n++)
+		m_loadedTextures.insert(std::make_pair(name + "#" + std::to_string(n), atlas.getPage(n)));
+
+	m_registeredRegions.insert(atlas.getRegions().begin(), atlas.getRegions().end());
+}
+
+TextureRegion TextureRegistry::getRegion(const std::string &name)
+{
+	auto it = m_registeredRegions.find(name);
+	if (it != m_registeredRegions.end())
+		return it->second;
+	else
+		return {nullptr, Vector4f(0.0f, 0.0f, 0.0f, 0.0f), 0, 0};
+}
+
+void TextureRegistry::cleanupRegion(const std::string &name)
+{
+	m_registeredRegions.erase(name);
+}
+
 void TextureRegistry::cleanup(const std::string &name) {
 	m_loadedTextures.erase(name);
+	m_textureSources.erase(name);
 }
 
 void TextureRegistry::cleanup() {
 	m_loadedTextures.clear();
+	m_textureSources.clear();
+	m_registeredRegions.clear();
+	delete m_pixelBufferRing;
+	m_pixelBufferRing = nullptr;
 }
@@ -6,6 +6,7 @@
 #include <cedar/FontRegistry.hpp>
 #include <cedar/ScreenRegistry.hpp>
 #include <cedar/ModelRegistry.hpp>
+#include <cedar/AssetPack.hpp>
 #include "cedar/OpenGLThread.hpp"
 #include "cedar/Cedar.hpp"
 
@@ -68,6 +69,8 @@ void OpenGLThread::onTick(unsigned long currentTime, unsigned long tickCount)
 		this->m_postRenderCallback(currentTime, tickCount);
 
 	this->m_window->update(currentTime, tickCount);
+	TextureRegistry::reclaimPixelBuffers();
+	TextureRegistry::updateResidency();
 
 	this->m_frameCount++;
 	this->m_frameTimes += this->m_frameTime;
@@ -90,6 +93,8 @@ void OpenGLThread::onStop()
 	ModelRegistry::cleanup();
 	TextureRegistry::cleanup();
 	FontRegistry::cleanup();
+	// Fonts may still reference mapped pack data, so the packs are unmounted after all assets are gone.
+	AssetPack::unmountAll();
 	delete this->m_window;
 
 	if (this->m_stopCallback)
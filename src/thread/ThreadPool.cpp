@@ -0,0 +1,184 @@
+//
+// Created by masy on 19.10.26.
+//
+
+#include <atomic>
+#include <memory>
+#include <exception>
+
+#include "cedar/ThreadPool.hpp"
+#include "cedar/Cedar.hpp"
+
+using namespace cedar;
+
+/**
+ * Struct holding the shared state of a {@link ThreadPool#parallelFor(size_t, const std::function<void(size_t)> &)} call.
+ *
+ * <p>Helper jobs may start after the call returned, so the state is kept alive by them until they finished.</p>
+ */
+struct ParallelForState
+{
+	/**
+	 * The function that is called with every index.
+	 */
+	std::function<void(size_t)> m_function;
+	/**
+	 * The number of indices.
+	 */
+	size_t m_count;
+	/**
+	 * The next index that will be processed.
+	 */
+	std::atomic<size_t> m_nextIndex;
+	/**
+	 * The number of indices that were processed.
+	 */
+	size_t m_finishedCount;
+	/**
+	 * The first exception that was thrown by the function.
+	 */
+	std::exception_ptr m_exception;
+	/**
+	 * Mutex for {@link #m_finishedCount} and {@link #m_exception}.
+	 */
+	std::mutex m_mutex;
+	/**
+	 * The condition variable the caller waits on until all indices were processed.
+	 */
+	std::condition_variable m_condition;
+
+	/**
+	 * Processes indices until none are left.
+	 */
+	void process()
+	{
+		size_t index;
+		while ((index = this->m_nextIndex.fetch_add(1)) < this->m_count)
+		{
+			std::exception_ptr exception = nullptr;
+			try
+			{
+				this->m_function(index);
+			}
+			catch (...)
+			{
+				exception = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock(this->m_mutex);
+			if (exception && !this->m_exception)
+				this->m_exception = exception;
+			if (++this->m_finishedCount == this->m_count)
+				this->m_condition.notify_all();
+		}
+	}
+};
+
+ThreadPool::ThreadPool(const unsigned int threadCount)
+{
+	unsigned int workerCount = threadCount;
+	if (workerCount == 0)
+		workerCount = std::max(1u, std::thread::hardware_concurrency());
+
+	this->m_stopping = false;
+	this->m_workers.reserve(workerCount);
+	for (unsigned int n = 0; n < workerCount; n++)
+	{
+		this->m_workers.emplace_back(&ThreadPool::work, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->m_mutex);
+		this->m_stopping = true;
+	}
+	this->m_condition.notify_all();
+
+	for (std::thread &worker : this->m_workers)
+	{
+		worker.join();
+	}
+}
+
+ThreadPool *ThreadPool::getInstance()
+{
+	static ThreadPool *instance = new ThreadPool();
+	return instance;
+}
+
+void ThreadPool::work()
+{
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(this->m_mutex);
+			this->m_condition.wait(lock, [this]() {
+				return this->m_stopping || !this->m_jobs.empty();
+			});
+
+			if (this->m_jobs.empty())
+				return;
+
+			job = std::move(this->m_jobs.front());
+			this->m_jobs.pop();
+		}
+
+		try
+		{
+			job();
+		}
+		catch (const std::exception &exception)
+		{
+			Cedar::getCoreLogger()->error("Job of thread pool threw an exception: %s", exception.what());
+		}
+	}
+}
+
+void ThreadPool::submit(const std::function<void()> &job)
+{
+	{
+		std::lock_guard<std::mutex> lock(this->m_mutex);
+		this->m_jobs.push(job);
+	}
+	this->m_condition.notify_one();
+}
+
+void ThreadPool::parallelFor(const size_t count, const std::function<void(size_t)> &function)
+{
+	if (count == 0)
+		return;
+
+	auto state = std::make_shared<ParallelForState>();
+	state->m_function = function;
+	state->m_count = count;
+	state->m_nextIndex = 0;
+	state->m_finishedCount = 0;
+
+	// The calling thread takes part, so one helper less than indices is enough.
+	size_t helperCount = std::min(count - 1, this->m_workers.size());
+	for (size_t n = 0; n < helperCount; n++)
+	{
+		this->submit([state]() {
+			state->process();
+		});
+	}
+
+	state->process();
+
+	// Wait for the indices, not the helpers. A helper that is still queued behind the caller finds nothing left to do.
+	std::unique_lock<std::mutex> lock(state->m_mutex);
+	state->m_condition.wait(lock, [&state]() {
+		return state->m_finishedCount == state->m_count;
+	});
+
+	if (state->m_exception)
+		std::rethrow_exception(state->m_exception);
+}
+
+unsigned int ThreadPool::getThreadCount() const
+{
+	return static_cast<unsigned int>(this->m_workers.size());
+}
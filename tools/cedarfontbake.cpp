@@ -0,0 +1,79 @@
+//
+// Created by masy on 19.10.26.
+//
+// Command line tool for baking fonts into files that are loaded as cedar baked fonts.
+//
+// Usage: cedarfontbake <font> <size> <first character> <last character> <output> [--sharp] [--compress]
+//
+// The font can be any font FreeType can load or a ptf font, for which the size is the scale. The glyphs of all
+// characters in the range are rasterized and written together with the atlas to the output file. No OpenGL context
+// is needed.
+//
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <regex>
+
+#include "cedar/BakedFont.hpp"
+#include "cedar/FreeTypeFont.hpp"
+#include "cedar/PTFFont.hpp"
+
+int main(int argc, char **argv)
+{
+	if (argc < 6)
+	{
+		std::cerr << "Usage: " << argv[0] << " <font> <size> <first character> <last character> <output> [--sharp] [--compress]" << std::endl;
+		return 1;
+	}
+
+	bool sharp = false;
+	bool compress = false;
+	for (int n = 6; n < argc; n++)
+	{
+		if (std::strcmp(argv[n], "--sharp") == 0)
+		{
+			sharp = true;
+		}
+		else if (std::strcmp(argv[n], "--compress") == 0)
+		{
+			compress = true;
+		}
+		else
+		{
+			std::cerr << "Unknown option " << argv[n] << std::endl;
+			return 1;
+		}
+	}
+
+	std::string path = argv[1];
+	try
+	{
+		auto size = static_cast<unsigned int>(std::stoul(argv[2]));
+		auto firstCharacter = static_cast<unsigned int>(std::stoul(argv[3], nullptr, 0));
+		auto lastCharacter = static_cast<unsigned int>(std::stoul(argv[4], nullptr, 0));
+
+		std::unique_ptr<cedar::Font> font;
+		if (std::regex_match(path, std::regex("^.*(\\.ptf)$")))
+			font = std::make_unique<cedar::PTFFont>("bake", path, size);
+		else
+			font = std::make_unique<cedar::FreeTypeFont>("bake", path, size, sharp ? CEDAR_RENDERING_SHARP : CEDAR_RENDERING_SMOOTH);
+
+		font->setHeadless(true);
+		font->generateGlyphs(firstCharacter, lastCharacter);
+		cedar::FontBaker::bake(*font, argv[5], compress);
+		std::cout << "Baked " << path << " with " << font->getGlyphAtlasCount() << " atlas pages into " << argv[5] << std::endl;
+	}
+	catch (const std::logic_error &exception)
+	{
+		std::cerr << "Invalid number: " << exception.what() << std::endl;
+		return 1;
+	}
+	catch (const cedar::FontException &exception)
+	{
+		std::cerr << exception.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,55 @@
+//
+// Created by masy on 19.10.26.
+//
+// Command line tool for writing cedar asset packs.
+//
+// Usage: cedarpack <pack> <file or directory>...
+//
+// Every file is stored under the path it was given with, files inside directories under the directory path followed
+// by their path relative to it. These are the paths the assets are loaded with at runtime.
+//
+
+#include <filesystem>
+#include <iostream>
+
+#include "cedar/AssetPack.hpp"
+
+int main(int argc, char **argv)
+{
+	if (argc < 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <pack> <file or directory>..." << std::endl;
+		return 1;
+	}
+
+	std::vector<std::pair<std::string, std::string>> assets;
+	for (int n = 2; n < argc; n++)
+	{
+		std::filesystem::path path(argv[n]);
+		if (std::filesystem::is_directory(path))
+		{
+			for (const auto &entry : std::filesystem::recursive_directory_iterator(path))
+			{
+				if (entry.is_regular_file())
+					assets.emplace_back(entry.path().generic_string(), entry.path().string());
+			}
+		}
+		else
+		{
+			assets.emplace_back(path.generic_string(), path.string());
+		}
+	}
+
+	try
+	{
+		cedar::AssetPack::pack(argv[1], assets);
+	}
+	catch (const cedar::AssetPackException &exception)
+	{
+		std::cerr << exception.what() << std::endl;
+		return 1;
+	}
+
+	std::cout << "Packed " << assets.size() << " assets into " << argv[1] << std::endl;
+	return 0;
+}